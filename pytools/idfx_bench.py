@@ -0,0 +1,302 @@
+"""
+Idefix benchmark suite
+
+Runs a set of standard problems of the test suite at a given resolution per MPI process,
+for several loop patterns and numbers of processes, and appends the results to a json file
+following the format of doc/source/bench.json.
+
+Usage: python3 -m pytools.idfx_bench [options]  (from $IDEFIX_DIR, or with $IDEFIX_DIR in
+$PYTHONPATH). The build target idefix_bench does the same from any build directory.
+"""
+import argparse
+import datetime
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+from .idfx_test import bcolors
+
+# Standard problems: source directory in test/, input file, and number of dimensions.
+# Each problem is run with size^DIMENSIONS cells per process (X3 is left untouched in 2D).
+benchmarks = {
+  "sod3D": {"dir": "HD/sod", "ini": "idefix.ini", "dims": 3,
+            # The sod test is 1D: we extend it to 3D with periodic transverse boundaries
+            "definitions": "#define COMPONENTS 3\n#define DIMENSIONS 3\n"
+                           "#define GEOMETRY CARTESIAN\n",
+            "extraGrid": {"X2-grid": ["1", "0.0", "1", "u", "1.0"],
+                          "X3-grid": ["1", "0.0", "1", "u", "1.0"]},
+            "extraBoundary": {"X2-beg": ["periodic"], "X2-end": ["periodic"],
+                              "X3-beg": ["periodic"], "X3-end": ["periodic"]}},
+  "OrszagTang3D": {"dir": "MHD/OrszagTang3D", "ini": "idefix.ini", "dims": 3},
+  "FargoPlanet": {"dir": "HD/FargoPlanet", "ini": "idefix.ini", "dims": 2},
+  "SelfGravity": {"dir": "SelfGravity/RandomSphereCartesian", "ini": "idefix.ini", "dims": 3},
+}
+
+def readIni(filename):
+  # ini files are stored as {block: {entry: [values]}}, preserving the order
+  ini = {}
+  block = None
+  with open(filename, 'r') as f:
+    for line in f:
+      line = line.split('#')[0].strip()
+      if not line:
+        continue
+      if line.startswith('['):
+        block = line.strip('[]')
+        ini[block] = {}
+      else:
+        words = line.split()
+        ini[block][words[0]] = words[1:]
+  return ini
+
+def writeIni(ini, filename):
+  with open(filename, 'w') as f:
+    for block, entries in ini.items():
+      f.write("[" + block + "]\n")
+      for entry, values in entries.items():
+        f.write(entry + "    " + "  ".join(values) + "\n")
+      f.write("\n")
+
+def decompose(nproc, dims):
+  # Split nproc in dims directions, giving the prime factors to the least decomposed direction
+  dec = [1]*dims
+  n = nproc
+  factor = 2
+  factors = []
+  while n > 1:
+    while n % factor == 0:
+      factors.append(factor)
+      n = n // factor
+    factor = factor + 1
+  for f in sorted(factors, reverse=True):
+    dec[dec.index(min(dec))] *= f
+  return dec
+
+class idfxBench:
+  def __init__(self):
+    parser = argparse.ArgumentParser(description="Idefix benchmark suite")
+
+    parser.add_argument("-problems",
+                        default=list(benchmarks.keys()),
+                        help="problems to run ("+", ".join(benchmarks.keys())+")",
+                        nargs='+')
+
+    parser.add_argument("-size",
+                        type=int,
+                        default=32,
+                        help="number of cells per process in each direction")
+
+    parser.add_argument("-nprocs",
+                        type=int,
+                        default=[1],
+                        help="numbers of MPI processes (weak scaling)",
+                        nargs='+')
+
+    parser.add_argument("-loop",
+                        default=["Default"],
+                        help="loop patterns (Idefix_LOOP_PATTERN)",
+                        nargs='+')
+
+    parser.add_argument("-cycles",
+                        type=int,
+                        default=50,
+                        help="number of integration cycles of each run")
+
+    parser.add_argument("-label",
+                        default="cpu",
+                        help="name of the architecture (gpumodel entry of the results)")
+
+    parser.add_argument("-output",
+                        default="bench.json",
+                        help="json file to which the results are appended")
+
+    parser.add_argument("-compare",
+                        default="",
+                        help="json file of reference results: fail on a performance regression")
+
+    parser.add_argument("-tolerance",
+                        type=float,
+                        default=0.2,
+                        help="relative loss of performance tolerated by -compare")
+
+    parser.add_argument("-noregions",
+                        help="skip the profiled run giving the timings of each region",
+                        action="store_true")
+
+    parser.add_argument("-cmake",
+                        default=[],
+                        help="CMake options",
+                        nargs='+')
+
+    parser.add_argument("-cuda",
+                        help="Benchmark on Nvidia GPU using CUDA",
+                        action="store_true")
+
+    parser.add_argument("-intel",
+                        help="Benchmark compiling with Intel OneAPI",
+                        action="store_true")
+
+    parser.add_argument("-hip",
+                        help="Benchmark on AMD GPU using HIP",
+                        action="store_true")
+
+    parser.add_argument("-workdir",
+                        default="bench",
+                        help="directory in which the problems are built and run")
+
+    parser.add_argument("-idefixDir",
+                        default=os.getenv("IDEFIX_DIR"),
+                        help="Set directory for idefix source files (default $IDEFIX_DIR)")
+
+    args = parser.parse_args()
+    self.__dict__.update(vars(args))
+
+    for problem in self.problems:
+      if problem not in benchmarks:
+        raise Exception("Unknown benchmark problem "+problem)
+
+    self.mpi = max(self.nprocs) > 1
+    self.workdir = os.path.abspath(self.workdir)
+    try:
+      self.commit = subprocess.run(["git", "rev-parse", "HEAD"], cwd=self.idefixDir,
+                                   capture_output=True, text=True).stdout.strip()
+    except OSError:
+      self.commit = "unknown"
+
+  def prepare(self, problem, loop):
+    # Copy the problem in our work directory, and configure it
+    bench = benchmarks[problem]
+    builddir = os.path.join(self.workdir, problem+"-"+loop)
+    if os.path.exists(builddir):
+      shutil.rmtree(builddir)
+    shutil.copytree(os.path.join(self.idefixDir, "test", bench["dir"]), builddir)
+    definitions = "definitions.hpp"
+    if "definitions" in bench:
+      definitions = "definitions-bench.hpp"
+      with open(os.path.join(builddir, definitions), 'w') as f:
+        f.write(bench["definitions"])
+
+    comm = ["cmake", self.idefixDir,
+            "-DIdefix_DEFS="+definitions,
+            "-DIdefix_LOOP_PATTERN="+loop,
+            "-DIdefix_MPI="+("ON" if self.mpi else "OFF")]
+    if self.cuda:
+      comm.append("-DKokkos_ENABLE_CUDA=ON")
+    if self.intel:
+      comm.append("-DCMAKE_CXX_COMPILER=icpx")
+      comm.append("-DCMAKE_C_COMPILER=icx")
+    if self.hip:
+      comm.append("-DKokkos_ENABLE_HIP=ON")
+    for opt in self.cmake:
+      comm.append("-D"+opt)
+    subprocess.run(comm, cwd=builddir).check_returncode()
+    subprocess.run(["make", "-j8"], cwd=builddir).check_returncode()
+    return builddir
+
+  def writeInput(self, problem, builddir, dec):
+    bench = benchmarks[problem]
+    ini = readIni(os.path.join(builddir, bench["ini"]))
+    for entry, values in bench.get("extraGrid", {}).items():
+      ini["Grid"][entry] = list(values)
+    for entry, values in bench.get("extraBoundary", {}).items():
+      ini["Boundary"][entry] = list(values)
+    for dir in range(bench["dims"]):
+      grid = ini["Grid"]["X%d-grid"%(dir+1)]
+      if grid[0] != "1":
+        raise Exception("Benchmarks only handle single patch grids")
+      grid[2] = str(self.size*dec[dir])
+    # the run is stopped by -maxcycles
+    ini["TimeIntegrator"]["tstop"] = ["1e30"]
+    writeIni(ini, os.path.join(builddir, "idefix-bench.ini"))
+
+  def run(self, builddir, nproc, dec, report, profile=False):
+    comm = ["./idefix", "-i", "idefix-bench.ini", "-nowrite",
+            "-maxcycles", str(self.cycles), "-bench", report]
+    if profile:
+      comm.append("-profile")
+    if self.mpi:
+      comm = ["mpirun", "-np", str(nproc)] + comm + ["-dec"] + [str(d) for d in dec]
+    subprocess.run(comm, cwd=builddir).check_returncode()
+    with open(os.path.join(builddir, report), 'r') as f:
+      return json.load(f)
+
+  def runAll(self):
+    self.entries = []
+    for problem in self.problems:
+      for loop in self.loop:
+        print(bcolors.OKCYAN+"Benchmarking "+problem+" with loop pattern "+loop+bcolors.ENDC)
+        builddir = self.prepare(problem, loop)
+        results = []
+        for nproc in self.nprocs:
+          dec = decompose(nproc, benchmarks[problem]["dims"])
+          self.writeInput(problem, builddir, dec)
+          result = self.run(builddir, nproc, dec, "bench-report.json")
+          if not self.noregions:
+            # profiling fences every region, so that timings come from a separate run
+            profiled = self.run(builddir, nproc, dec, "bench-profile.json", profile=True)
+            result["regions"] = profiled["regions"]
+          print(bcolors.OKGREEN+"%s (%s) on %d processes: %e cell updates/s/process"
+                %(problem, loop, nproc, result["cell_updates"])+bcolors.ENDC)
+          results.append(result)
+        self.entries.append({
+          "date": datetime.datetime.now().strftime("%Y-%m-%d_%H:%M:%S"),
+          "gpumodel": self.label,
+          "idefix_commit": self.commit,
+          "bench_commit": self.commit,
+          "problem": problem,
+          "loop_pattern": loop,
+          "size": self.size,
+          "results": results})
+        sys.stdout.flush()
+
+  def save(self):
+    benches = []
+    if os.path.exists(self.output):
+      with open(self.output, 'r') as f:
+        benches = json.load(f)
+    benches.extend(self.entries)
+    with open(self.output, 'w') as f:
+      json.dump(benches, f, indent=2)
+    print("Results appended to "+self.output)
+
+  def compareTo(self, filename):
+    # Compare with the latest reference obtained in the same conditions
+    with open(filename, 'r') as f:
+      references = json.load(f)
+    success = True
+    for entry in self.entries:
+      matches = [ref for ref in references
+                 if ref.get("gpumodel") == entry["gpumodel"]
+                 and ref.get("problem") == entry["problem"]
+                 and ref.get("loop_pattern") == entry["loop_pattern"]
+                 and ref.get("size") == entry["size"]]
+      if not matches:
+        success = False
+        print(bcolors.FAIL+"No reference for "+entry["problem"]+" ("+entry["gpumodel"]+")"
+              +bcolors.ENDC)
+        continue
+      for result in entry["results"]:
+        refResults = [r for r in matches[-1]["results"] if r["nbgpu"] == result["nbgpu"]]
+        if not refResults:
+          success = False
+          print(bcolors.FAIL+"No reference for %s on %d processes"
+                %(entry["problem"], result["nbgpu"])+bcolors.ENDC)
+          continue
+        ratio = result["cell_updates"]/refResults[0]["cell_updates"]
+        if ratio < 1-self.tolerance:
+          success = False
+          print(bcolors.FAIL+"%s (%s) on %d processes is %.0f%% slower than the reference"
+                %(entry["problem"], entry["loop_pattern"], result["nbgpu"], 100*(1-ratio))
+                +bcolors.ENDC)
+    return success
+
+if __name__ == "__main__":
+  bench = idfxBench()
+  bench.runAll()
+  bench.save()
+  if bench.compare:
+    if not bench.compareTo(bench.compare):
+      sys.exit(1)
+    print(bcolors.OKGREEN+"No performance regression"+bcolors.ENDC)
@@ -70,6 +70,10 @@ class idfxTest:
                         help="Enable single precision",
                         action="store_true")
 
+    parser.add_argument("-mixed",
+                        help="Enable mixed precision (single precision storage)",
+                        action="store_true")
+
     parser.add_argument("-vectPot",
                         help="Enable vector potential formulation",
                         action="store_true")
@@ -99,11 +103,18 @@ class idfxTest:
                     help="Consider warnings as errors",
                     action="store_true")
 
+    parser.add_argument("-tile",
+                    default="",
+                    help="Tiles of the cache-blocked loops (ni nj nk), passed to idefix",
+                    nargs=3)
+
 
     args, unknown=parser.parse_known_args()
 
     # transform all arguments from args into attributes of this instance
     self.__dict__.update(vars(args))
+    # rms error tolerated in mixed precision against the double precision references
+    self.mixedTolerance = 1e-4
     self.referenceDirectory = os.path.join(idefix_dir_env,"reference")
     # current directory relative to $IDEFIX_DIR/test (used to retrieve the path ot reference files)
     self.testDir=os.path.relpath(os.curdir,os.path.join(idefix_dir_env,"test"))
@@ -137,6 +148,8 @@ class idfxTest:
     #if we use single precision
     if(self.single):
       comm.append("-DIdefix_PRECISION=Single")
+    elif(self.mixed):
+      comm.append("-DIdefix_PRECISION=Mixed")
     else:
       comm.append("-DIdefix_PRECISION=Double")
 
@@ -189,7 +202,7 @@ class idfxTest:
         print("***************************************************"+bcolors.ENDC)
         raise e
 
-  def run(self, inputFile="", np=2, nowrite=False, restart=-1):
+  def run(self, inputFile="", np=2, nowrite=False, restart=-1, remap=False):
       comm=["./idefix"]
       if inputFile:
           comm.append("-i")
@@ -214,9 +227,15 @@ class idfxTest:
       if self.Werror:
         comm.append("-Werror")
 
+      if self.tile:
+        comm.append("-tile")
+        comm.extend(self.tile)
+
       if restart>=0:
         comm.append("-restart")
         comm.append(str(restart))
+        if remap:
+          comm.append("-remap")
 
       try:
           make=subprocess.run(comm)
@@ -242,6 +261,11 @@ class idfxTest:
     else:
       self.single = False
 
+    if "MIXED PRECISION" in log:
+      self.mixed = True
+    else:
+      self.mixed = False
+
     if "Kokkos CUDA target ENABLED" in log:
       self.cuda = True
     else:
@@ -319,6 +343,11 @@ class idfxTest:
     if not(os.path.exists(filetest)):
       raise Exception("Test file "+filetest+ " doesn't exist")
 
+    # Mixed precision runs are compared to the double precision references, up to the
+    # rounding errors of the single precision storage
+    if self.mixed:
+      tolerance = max(tolerance, self.mixedTolerance)
+
     Vref=readDump(fileref)
     Vtest=readDump(filetest)
     error=self._computeError(Vref,Vtest)
@@ -348,6 +377,8 @@ class idfxTest:
 
   def makeReference(self,filename):
     self._readLog()
+    if self.mixed:
+      raise Exception("References cannot be made in mixed precision: use double precision")
     targetDir = os.path.join(self.referenceDirectory,self.testDir)
     if not os.path.exists(targetDir):
       print("Creating reference directory")
@@ -374,6 +405,8 @@ class idfxTest:
     print("Input File: "+self.inifile)
     if(self.single):
       print("Precision: Single")
+    elif(self.mixed):
+      print("Precision: Mixed")
     else:
       print("Precision: Double")
     if(self.reconstruction==2):
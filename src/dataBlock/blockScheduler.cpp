@@ -0,0 +1,234 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include "blockScheduler.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "dataBlock.hpp"
+#include "fluid.hpp"
+
+// Cell-centered arrays of the fluids of a block which are exchanged between blocks
+static std::vector<IdefixArray4D<realStore>> FluidArrays(DataBlock &block) {
+  std::vector<IdefixArray4D<realStore>> arrays;
+  arrays.push_back(block.hydro->Vc);
+  for(auto &fluid : block.dust) {
+    arrays.push_back(fluid->Vc);
+  }
+  return(arrays);
+}
+
+// Copy the cells [beg,end) of src along dir (and the whole extent of the other directions)
+// to dst, shifted by offset cells along dir
+static void CopyRegion(IdefixArray4D<realStore> src, IdefixArray4D<realStore> dst,
+                       const int dir, const int beg, const int end, const int offset) {
+  int lo[3] = {0, 0, 0};
+  int hi[3] = {static_cast<int>(src.extent(3)),
+               static_cast<int>(src.extent(2)),
+               static_cast<int>(src.extent(1))};
+  lo[dir] = beg;
+  hi[dir] = end;
+  const int di = (dir == IDIR) ? offset : 0;
+  const int dj = (dir == JDIR) ? offset : 0;
+  const int dk = (dir == KDIR) ? offset : 0;
+  idefix_for("BlockScheduler::Copy",
+             0, src.extent(0),
+             lo[KDIR], hi[KDIR],
+             lo[JDIR], hi[JDIR],
+             lo[IDIR], hi[IDIR],
+    KOKKOS_LAMBDA (int n, int k, int j, int i) {
+      dst(n,k+dk,j+dj,i+di) = src(n,k,j,i);
+    });
+}
+
+BlockScheduler::BlockScheduler(Input &input, DataBlock *datain) {
+  idfx::pushRegion("BlockScheduler::BlockScheduler");
+  this->data = datain;
+  Grid *grid = data->mygrid;
+  this->dir = grid->blockDir;
+
+  if(DefaultPhysics::mhd || data->haveFargo || data->haveGravity
+      || data->haveGridCoarsening != GridCoarsening::disabled || data->haveFusedDust
+      || data->haveAxis || data->hydro->haveRKLParabolicTerms) {
+    IDEFIX_ERROR("Blocks are not compatible with MHD, Fargo, gravity, grid coarsening, "
+                 "fused dust, axis boundaries and RKL parabolic terms");
+  }
+  for(int d = 0 ; d < 3 ; d++) {
+    if(grid->lbound[d] == shearingbox || grid->rbound[d] == shearingbox) {
+      IDEFIX_ERROR("Blocks are not compatible with shearing box boundaries");
+    }
+  }
+
+  // When dir is periodic, the first and last blocks are neighbours (dir is never decomposed
+  // between processes when blocks are used)
+  this->isPeriodic = (grid->lbound[dir] == periodic);
+
+  for(int b = 0 ; b < grid->nblocks ; b++) {
+    blocks.push_back(std::make_unique<DataBlock>(*grid, input, b));
+  }
+
+  // The state of the process is made of the states of its blocks, so that the time integrator
+  // copies and combines the stages of all of the blocks at once
+  data->states["current"] = StateContainer();
+  for(int b = 0 ; b < blocks.size() ; b++) {
+    data->states["current"].PushStates(blocks[b]->states["current"],
+                                       "Block"+std::to_string(b)+"_");
+  }
+  idfx::popRegion();
+}
+
+BlockScheduler::~BlockScheduler() {
+  // Nothing to be done (defined here, where DataBlock is a complete type)
+}
+
+void BlockScheduler::SyncTime() {
+  for(auto &block : blocks) {
+    block->t = data->t;
+    block->dt = data->dt;
+  }
+}
+
+// Fill the ghost zones of each block along dir with the active cells of its neighbours
+void BlockScheduler::ExchangeBlocks() {
+  idfx::pushRegion("BlockScheduler::ExchangeBlocks");
+  const int nb = blocks.size();
+  const int ng = data->nghost[dir];
+  for(int b = 0 ; b < nb ; b++) {
+    int l = b-1;
+    if(l < 0) {
+      if(!isPeriodic) continue;
+      l = nb-1;
+    }
+    DataBlock &left = *blocks[l];
+    DataBlock &right = *blocks[b];
+    std::vector<IdefixArray4D<realStore>> arraysLeft = FluidArrays(left);
+    std::vector<IdefixArray4D<realStore>> arraysRight = FluidArrays(right);
+    for(int n = 0 ; n < arraysLeft.size() ; n++) {
+      // Last active cells of the left block to the left ghost zone of the right block
+      CopyRegion(arraysLeft[n], arraysRight[n], dir,
+                 left.end[dir]-ng, left.end[dir], ng-left.end[dir]);
+      // First active cells of the right block to the right ghost zone of the left block
+      CopyRegion(arraysRight[n], arraysLeft[n], dir,
+                 right.beg[dir], right.beg[dir]+ng, left.end[dir]-right.beg[dir]);
+    }
+  }
+  idfx::popRegion();
+}
+
+void BlockScheduler::SetBoundaries() {
+  idfx::pushRegion("BlockScheduler::SetBoundaries");
+  SyncTime();
+  for(auto &block : blocks) {
+    block->SetBoundaries();
+  }
+  // The ghost zones of the other directions are complete, so that the corners are consistent
+  ExchangeBlocks();
+  gathered = false;
+  idfx::popRegion();
+}
+
+void BlockScheduler::StartBoundaries() {
+  idfx::pushRegion("BlockScheduler::StartBoundaries");
+  SyncTime();
+  for(auto &block : blocks) {
+    block->StartBoundaries();
+  }
+  // The exchanges between blocks only need their active cells, which are ready
+  ExchangeBlocks();
+  idfx::popRegion();
+}
+
+bool BlockScheduler::IsReady(DataBlock &block) {
+  if(!block.hydro->boundary->ExchangeReceived()) return(false);
+  for(auto &fluid : block.dust) {
+    if(!fluid->boundary->ExchangeReceived()) return(false);
+  }
+  return(true);
+}
+
+// Evolve all of the blocks by one stage. The blocks whose MPI ghost zones have been received are
+// evolved first, so that the exchanges of the other blocks complete in the meantime.
+void BlockScheduler::EvolveStage() {
+  idfx::pushRegion("BlockScheduler::EvolveStage");
+  SyncTime();
+  const int nb = blocks.size();
+  std::vector<bool> evolved(nb, false);
+  int remaining = nb;
+  while(remaining > 0) {
+    bool progress = false;
+    for(int b = 0 ; b < nb ; b++) {
+      if(!evolved[b] && IsReady(*blocks[b])) {
+        blocks[b]->EvolveStage();
+        evolved[b] = true;
+        remaining--;
+        progress = true;
+      }
+    }
+    if(!progress) {
+      // No block is ready: the first remaining one waits for its ghost zones (computing its
+      // inner cells in the meantime when the MPI exchanges are overlapped)
+      int b = 0;
+      while(evolved[b]) b++;
+      blocks[b]->EvolveStage();
+      evolved[b] = true;
+      remaining--;
+    }
+  }
+  gathered = false;
+  idfx::popRegion();
+}
+
+void BlockScheduler::Scatter() {
+  idfx::pushRegion("BlockScheduler::Scatter");
+  const std::vector<int> &offset = data->mygrid->blockDecomposition;
+  std::vector<IdefixArray4D<realStore>> arrays = FluidArrays(*data);
+  for(int b = 0 ; b < blocks.size() ; b++) {
+    std::vector<IdefixArray4D<realStore>> arraysBlock = FluidArrays(*blocks[b]);
+    for(int n = 0 ; n < arrays.size() ; n++) {
+      CopyRegion(arrays[n], arraysBlock[n], dir,
+                 offset[b], offset[b]+blocks[b]->np_tot[dir], -offset[b]);
+    }
+  }
+  gathered = true;
+  idfx::popRegion();
+}
+
+void BlockScheduler::Gather() {
+  if(gathered) return;
+  idfx::pushRegion("BlockScheduler::Gather");
+  const std::vector<int> &offset = data->mygrid->blockDecomposition;
+  const int nb = blocks.size();
+  std::vector<IdefixArray4D<realStore>> arrays = FluidArrays(*data);
+  for(int b = 0 ; b < nb ; b++) {
+    std::vector<IdefixArray4D<realStore>> arraysBlock = FluidArrays(*blocks[b]);
+    // Active cells, and the ghost zones of the process on its edges
+    const int beg = (b == 0) ? 0 : blocks[b]->beg[dir];
+    const int end = (b == nb-1) ? blocks[b]->np_tot[dir] : blocks[b]->end[dir];
+    for(int n = 0 ; n < arrays.size() ; n++) {
+      CopyRegion(arraysBlock[n], arrays[n], dir, beg, end, offset[b]);
+    }
+  }
+  gathered = true;
+  idfx::popRegion();
+}
+
+void BlockScheduler::ShowConfig() {
+  const std::vector<int> &offset = data->mygrid->blockDecomposition;
+  int nmin = offset.back();
+  int nmax = 0;
+  for(int b = 0 ; b < blocks.size() ; b++) {
+    nmin = std::min(nmin, offset[b+1]-offset[b]);
+    nmax = std::max(nmax, offset[b+1]-offset[b]);
+  }
+  idfx::cout << "BlockScheduler: " << blocks.size() << " blocks of ";
+  if(nmin == nmax) {
+    idfx::cout << nmin;
+  } else {
+    idfx::cout << nmin << " to " << nmax;
+  }
+  idfx::cout << " points along X" << dir+1 << " per process." << std::endl;
+}
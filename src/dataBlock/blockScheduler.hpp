@@ -0,0 +1,54 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef DATABLOCK_BLOCKSCHEDULER_HPP_
+#define DATABLOCK_BLOCKSCHEDULER_HPP_
+
+#include <memory>
+#include <vector>
+#include "idefix.hpp"
+#include "input.hpp"
+
+// Forward class declaration
+class DataBlock;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Over-decomposition of the domain of the current process in several blocks, split along
+/// Grid::blockDir. Each block is a DataBlock with its own fluids, which exchanges its ghost zones
+/// with the other processes through its own Mpi objects, while the ghost zones shared by two
+/// blocks of the process are filled by direct device copies. During a stage, the blocks whose
+/// MPI exchanges have completed are evolved first.
+/// The DataBlock of the process keeps a copy of the primitive variables of its blocks, which is
+/// used for the initial conditions, the outputs and the restarts. Its fluids allocate no other
+/// field (conservative variables, fluxes, work arrays or MPI buffers), since they are not evolved.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+class BlockScheduler {
+ public:
+  BlockScheduler(Input &, DataBlock *);
+  ~BlockScheduler();
+
+  void SetBoundaries();     ///< Set the ghost zones of all of the blocks
+  void StartBoundaries();   ///< Same, possibly leaving the MPI exchanges in flight
+  void EvolveStage();       ///< Evolve all of the blocks, those ready first
+  void SyncTime();          ///< Copy the time and timestep of the process to the blocks
+  void Scatter();           ///< Copy the fields of the DataBlock of the process to the blocks
+  void Gather();            ///< Copy the fields of the blocks to the DataBlock of the process
+  void ShowConfig();
+
+  std::vector<std::unique_ptr<DataBlock>> blocks;
+
+ private:
+  void ExchangeBlocks();          // Fill the ghost zones shared by two blocks
+  bool IsReady(DataBlock &);      // Whether the MPI ghost zones of a block have been received
+
+  DataBlock *data;          // DataBlock of the process
+  int dir;                  // direction along which the blocks are split
+  bool isPeriodic{false};   // whether the first and last blocks are neighbours
+  bool gathered{true};      // whether the DataBlock of the process is up to date
+};
+
+#endif // DATABLOCK_BLOCKSCHEDULER_HPP_
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 #include "idefix.hpp"
 #include "dataBlock.hpp"
 #include "fluid.hpp"
@@ -19,10 +20,11 @@
 #include "xdmf.hpp"
 #endif
 
-DataBlock::DataBlock(Grid &grid, Input &input) {
+DataBlock::DataBlock(Grid &grid, Input &input, int block) {
   idfx::pushRegion("DataBlock::DataBlock");
 
   this->mygrid=&grid;
+  this->blockIndex = block;
 
   // Make a local copy of the grid for future usage.
   GridHost gridHost(grid);
@@ -32,33 +34,48 @@ DataBlock::DataBlock(Grid &grid, Input &input) {
   // Get the number of points from the parent grid object
   for(int dir = 0 ; dir < 3 ; dir++) {
     nghost[dir] = grid.nghost[dir];
-    // Domain decomposition: decompose the full domain size in grid by the number of processes
-    // in that direction
-    np_int[dir] = grid.np_int[dir]/grid.nproc[dir];
+    // Domain decomposition: the size of the slab of the current process in that direction
+    const std::vector<int> &slabs = grid.decomposition[dir];
+    np_int[dir] = slabs[grid.xproc[dir]+1] - slabs[grid.xproc[dir]];
+    int start = slabs[grid.xproc[dir]];
+    bool firstBlock = true;
+    bool lastBlock = true;
+    if(block >= 0 && dir == grid.blockDir) {
+      // Only a part of the slab belongs to this block
+      np_int[dir] = grid.blockDecomposition[block+1] - grid.blockDecomposition[block];
+      start += grid.blockDecomposition[block];
+      firstBlock = (block == 0);
+      lastBlock = (block == grid.nblocks-1);
+    }
     np_tot[dir] = np_int[dir]+2*nghost[dir];
 
     // Boundary conditions
-    if (grid.xproc[dir]==0) {
+    if (grid.xproc[dir]==0 && firstBlock) {
       lbound[dir] = grid.lbound[dir];
       if(lbound[dir]==axis) this->haveAxis = true;
     } else {
       lbound[dir] = internal;
     }
 
-    if (grid.xproc[dir] == grid.nproc[dir]-1) {
+    if (grid.xproc[dir] == grid.nproc[dir]-1 && lastBlock) {
       rbound[dir] = grid.rbound[dir];
       if(rbound[dir]==axis) this->haveAxis = true;
     } else {
       rbound[dir] = internal;
     }
 
+    // The periodicity along the blocks is enforced by the exchanges between blocks
+    if(block >= 0 && dir == grid.blockDir) {
+      if(lbound[dir] == periodic) lbound[dir] = internal;
+      if(rbound[dir] == periodic) rbound[dir] = internal;
+    }
+
     beg[dir] = grid.nghost[dir];
     end[dir] = grid.nghost[dir]+np_int[dir];
 
     // Where does this datablock starts and end in the grid?
-    // This assumes even distribution of points between procs
-    gbeg[dir] = grid.nghost[dir] + grid.xproc[dir]*np_int[dir];
-    gend[dir] = grid.nghost[dir] + (grid.xproc[dir]+1)*np_int[dir];
+    gbeg[dir] = grid.nghost[dir] + start;
+    gend[dir] = gbeg[dir] + np_int[dir];
 
     // Local start and end of current datablock
     xbeg[dir] = gridHost.xl[dir](gbeg[dir]);
@@ -114,8 +131,10 @@ DataBlock::DataBlock(Grid &grid, Input &input) {
   // Initialize the Dump object
   this->dump = std::make_unique<Dump>(input, this);
 
-  // Initialize the VTK object
-  this->vtk = std::make_unique<Vtk>(input, this, "data");
+  // Initialize the VTK object (refined levels are written in their own files)
+  std::string vtkBase = "data";
+  if(grid.level > 0) vtkBase += ".level" + std::to_string(grid.level);
+  this->vtk = std::make_unique<Vtk>(input, this, vtkBase);
 
   // Init XDMF objects for HDF5 outputs
   #ifdef WITH_HDF5
@@ -123,9 +142,19 @@ DataBlock::DataBlock(Grid &grid, Input &input) {
   #endif
 
 
+  // Is the domain of the process split in blocks? (the fluids of the process then only hold
+  // their primitive variables, see BlockScheduler)
+  this->haveBlocks = (block < 0 && grid.nblocks > 1);
+
   // Initialize the hydro object attached to this datablock
   this->hydro = std::make_unique<Fluid<DefaultPhysics>>(grid, input, this);
 
+  // Evolve all of the dust species at once if needed (before Fargo which shifts its arrays)
+  if(input.CheckBlock("Dust") && input.GetOrSet<bool>("Dust","fused",0,false)) {
+    this->fusedDust = std::make_unique<FusedDust>(input, this);
+    this->haveFusedDust = true;
+  }
+
   // Initialise Fargo if needed
   if(input.CheckBlock("Fargo")) {
     this->fargo = std::make_unique<Fargo>(input, DefaultPhysics::nvar, this);
@@ -151,11 +180,24 @@ DataBlock::DataBlock(Grid &grid, Input &input) {
     for(int i = 0 ; i < nSpecies ; i++) {
       dust.emplace_back(std::make_unique<Fluid<DustPhysics>>(grid, input, this, i));
     }
+    if(haveFusedDust) fusedDust->Link();
   }
   // Register variables that need to be saved in case of restart dump
   dump->RegisterVariable(&t, "time");
   dump->RegisterVariable(&dt, "dt");
 
+  // Split the domain of the process in blocks if needed
+  if(haveBlocks) {
+    this->scheduler = std::make_unique<BlockScheduler>(input, this);
+  }
+
+  // Refine a part of the domain with a finer level if needed
+  if(input.CheckBlock("Refinement")
+      && grid.level < input.Get<int>("Refinement", "levels", 0)) {
+    this->refinement = std::make_unique<StaticRefinement>(input, this);
+    this->haveRefinement = true;
+  }
+
   idfx::popRegion();
 }
 
@@ -177,9 +219,9 @@ DataBlock::DataBlock(SubGrid *subgrid) {
   // Get the number of points from the parent grid object
   for(int dir = 0 ; dir < 3 ; dir++) {
     nghost[dir] = grid->nghost[dir];
-    // Domain decomposition: decompose the full domain size in grid by the number of processes
-    // in that direction
-    np_int[dir] = grid->np_int[dir]/grid->nproc[dir];
+    // Domain decomposition: the size of the slab of the current process in that direction
+    const std::vector<int> &slabs = grid->decomposition[dir];
+    np_int[dir] = slabs[grid->xproc[dir]+1] - slabs[grid->xproc[dir]];
     np_tot[dir] = np_int[dir]+2*nghost[dir];
 
     // Boundary conditions
@@ -201,9 +243,8 @@ DataBlock::DataBlock(SubGrid *subgrid) {
     end[dir] = grid->nghost[dir]+np_int[dir];
 
     // Where does this datablock starts and end in the grid?
-    // This assumes even distribution of points between procs
-    gbeg[dir] = grid->nghost[dir] + grid->xproc[dir]*np_int[dir];
-    gend[dir] = grid->nghost[dir] + (grid->xproc[dir]+1)*np_int[dir];
+    gbeg[dir] = grid->nghost[dir] + slabs[grid->xproc[dir]];
+    gend[dir] = gbeg[dir] + np_int[dir];
 
     // Local start and end of current datablock
     xbeg[dir] = gridHost.xl[dir](gbeg[dir]);
@@ -251,8 +292,14 @@ DataBlock::DataBlock(SubGrid *subgrid) {
 }
 
 void DataBlock::ResetStage() {
+  if(haveBlocks) {
+    for(auto &block : scheduler->blocks) block->ResetStage();
+    return;
+  }
   this->hydro->ResetStage();
-  if(haveDust) {
+  if(haveFusedDust) {
+    fusedDust->ResetStage();
+  } else if(haveDust) {
     for(int i = 0 ; i < dust.size() ; i++) {
       dust[i]->ResetStage();
     }
@@ -260,8 +307,14 @@ void DataBlock::ResetStage() {
 }
 
 void DataBlock::ConsToPrim() {
+  if(haveBlocks) {
+    for(auto &block : scheduler->blocks) block->ConsToPrim();
+    return;
+  }
   this->hydro->ConvertConsToPrim();
-  if(haveDust) {
+  if(haveFusedDust) {
+    fusedDust->ConvertConsToPrim();
+  } else if(haveDust) {
     for(int i = 0 ; i < dust.size() ; i++) {
       dust[i]->ConvertConsToPrim();
     }
@@ -269,16 +322,69 @@ void DataBlock::ConsToPrim() {
 }
 
 void DataBlock::PrimToCons() {
+  if(haveBlocks) {
+    for(auto &block : scheduler->blocks) block->PrimToCons();
+    return;
+  }
   this->hydro->ConvertPrimToCons();
-  if(haveDust) {
+  if(haveFusedDust) {
+    fusedDust->ConvertPrimToCons();
+  } else if(haveDust) {
     for(int i = 0 ; i < dust.size() ; i++) {
       dust[i]->ConvertPrimToCons();
     }
   }
 }
 
+// Streamlined stages of the time integrator (not available with fused dust): the conversions
+// are restricted to the active cells, the conservative variables of the fluids are stored in
+// the "begin" state by PrimToConsAndStore, and they are combined with it by AddAndConsToPrim.
+// The other states (magnetic field) are still handled by the StateContainer.
+std::vector<std::string> DataBlock::StreamlinedStates() {
+  std::vector<std::string> names;
+  names.push_back(hydro->prefix+"_Uc");
+  if(haveDust) {
+    for(int i = 0 ; i < dust.size() ; i++) {
+      names.push_back(dust[i]->prefix+"_Uc");
+    }
+  }
+  return(names);
+}
+
+void DataBlock::PrimToConsAndStore(bool store) {
+  IdefixArray4D<realStore> Uc0;
+  if(store) Uc0 = states["begin"].GetArray<realStore>(hydro->prefix+"_Uc");
+  hydro->ConvertPrimToConsAndStore(Uc0);
+  if(haveDust) {
+    for(int i = 0 ; i < dust.size() ; i++) {
+      if(store) Uc0 = states["begin"].GetArray<realStore>(dust[i]->prefix+"_Uc");
+      dust[i]->ConvertPrimToConsAndStore(Uc0);
+    }
+  }
+  if(store) states["begin"].CopyFrom(states["current"], StreamlinedStates());
+}
+
+void DataBlock::AddAndConsToPrim(real wc, real w0, bool add) {
+  IdefixArray4D<realStore> Uc0;
+  if(add) {
+    states["current"].AddAndStore(wc, w0, states["begin"], StreamlinedStates());
+    Uc0 = states["begin"].GetArray<realStore>(hydro->prefix+"_Uc");
+  }
+  hydro->AddAndConvertConsToPrim(wc, w0, Uc0);
+  if(haveDust) {
+    for(int i = 0 ; i < dust.size() ; i++) {
+      if(add) Uc0 = states["begin"].GetArray<realStore>(dust[i]->prefix+"_Uc");
+      dust[i]->AddAndConvertConsToPrim(wc, w0, Uc0);
+    }
+  }
+}
+
 // Set the boundaries of the data structures in this datablock
 void DataBlock::SetBoundaries() {
+  if(haveBlocks) {
+    scheduler->SetBoundaries();
+    return;
+  }
   if(haveGridCoarsening) {
     ComputeGridCoarseningLevels();
     hydro->CoarsenFlow(hydro->Vc);
@@ -291,12 +397,38 @@ void DataBlock::SetBoundaries() {
       }
     }
   }
-  if(haveDust) {
+  if(haveFusedDust) {
+    fusedDust->SetBoundaries(t);
+  } else if(haveDust) {
     for(int i = 0 ; i < dust.size() ; i++) {
       dust[i]->boundary->SetBoundaries(t);
     }
   }
   hydro->boundary->SetBoundaries(t);
+  // Ghost zones at the edges of a refined level
+  if(parentRefinement != nullptr) parentRefinement->ProlongBoundaries(t);
+}
+
+// Start the boundary conditions of all of the fluids. When MPI exchanges are overlapped with
+// the computation, the ghost zones are only completed during EvolveStage.
+void DataBlock::StartBoundaries() {
+  if(haveBlocks) {
+    scheduler->StartBoundaries();
+    return;
+  }
+  if(haveGridCoarsening) {
+    SetBoundaries();
+    return;
+  }
+  if(haveFusedDust) {
+    fusedDust->SetBoundaries(t);
+  } else if(haveDust) {
+    for(int i = 0 ; i < dust.size() ; i++) {
+      dust[i]->boundary->StartBoundaries(t);
+    }
+  }
+  hydro->boundary->StartBoundaries(t);
+  if(parentRefinement != nullptr) parentRefinement->ProlongBoundaries(t);
 }
 
 
@@ -310,6 +442,8 @@ void DataBlock::ShowConfig() {
         << "...." << xend[dir] << std::endl;
     }
   }
+  if(haveBlocks) scheduler->ShowConfig();
+  if(haveRefinement) refinement->ShowConfig();
   hydro->ShowConfig();
   if(haveFargo) fargo->ShowConfig();
   if(haveplanetarySystem) planetarySystem->ShowConfig();
@@ -322,6 +456,7 @@ void DataBlock::ShowConfig() {
     idfx::cout << "DataBlock: evolving " << dust.size() << " dust species." << std::endl;
     // Only show the config the first dust specie
     dust[0]->ShowConfig();
+    if(haveFusedDust) fusedDust->ShowConfig();
     /*
     for(int i = 0 ; i < dust.size() ; i++) {
       dust[i]->ShowConfig();
@@ -332,27 +467,47 @@ void DataBlock::ShowConfig() {
 
 real DataBlock::ComputeTimestep() {
   // Compute the timestep using all of the enabled modules in the current dataBlock
+  if(haveBlocks) {
+    real dt = scheduler->blocks[0]->ComputeTimestep();
+    for(int b = 1 ; b < scheduler->blocks.size() ; b++) {
+      dt = std::min(dt, scheduler->blocks[b]->ComputeTimestep());
+    }
+    return(dt);
+  }
 
   // First with the hydro block
   auto InvDt = hydro->InvDt;
+  // With nan tracking, Nans in the timestep are counted by the reduction itself
+  bool nanTracking = hydro->nanTracking;
+  auto nanCount = hydro->nanCount;
   real dt;
   idefix_reduce("Timestep_reduction",
           beg[KDIR], end[KDIR],
           beg[JDIR], end[JDIR],
           beg[IDIR], end[IDIR],
           KOKKOS_LAMBDA (int k, int j, int i, real &dtmin) {
+                  if(nanTracking && std::isnan(InvDt(k,j,i))) {
+                    Kokkos::atomic_increment(&nanCount(0));
+                  }
                   dtmin=FMIN(ONE_F/InvDt(k,j,i),dtmin);
               },
           Kokkos::Min<real>(dt));
-  if(haveDust) {
+  if(haveFusedDust) {
+    dt = std::min(dt,fusedDust->ComputeTimestep());
+  } else if(haveDust) {
     for(int n = 0 ; n < dust.size() ; n++) {
       real dtDust;
       auto InvDt = dust[n]->InvDt;
+      nanTracking = dust[n]->nanTracking;
+      nanCount = dust[n]->nanCount;
       idefix_reduce("Timestep_reduction_dust",
           beg[KDIR], end[KDIR],
           beg[JDIR], end[JDIR],
           beg[IDIR], end[IDIR],
           KOKKOS_LAMBDA (int k, int j, int i, real &dtmin) {
+                  if(nanTracking && std::isnan(InvDt(k,j,i))) {
+                    Kokkos::atomic_increment(&nanCount(0));
+                  }
                   dtmin=FMIN(ONE_F/InvDt(k,j,i),dtmin);
               },
           Kokkos::Min<real>(dtDust));
@@ -360,6 +515,8 @@ real DataBlock::ComputeTimestep() {
     }
   }
   Kokkos::fence();
+  // The refined levels are subcycled with half of the timestep
+  if(haveRefinement) dt = std::min(dt, refinement->dtEstimate);
   return(dt);
 }
 
@@ -373,6 +530,11 @@ void DataBlock::DeriveVectorPotential() {
 }
 
 void DataBlock::LaunchUserStepLast() {
+  if(haveBlocks) {
+    scheduler->SyncTime();
+    for(auto &block : scheduler->blocks) block->LaunchUserStepLast();
+    return;
+  }
   if(haveUserStepLast) {
     idfx::pushRegion("User::UserStepLast");
     if(userStepLast != nullptr)
@@ -384,6 +546,11 @@ void DataBlock::LaunchUserStepLast() {
 }
 
 void DataBlock::LaunchUserStepFirst() {
+  if(haveBlocks) {
+    scheduler->SyncTime();
+    for(auto &block : scheduler->blocks) block->LaunchUserStepFirst();
+    return;
+  }
   if(haveUserStepFirst) {
     idfx::pushRegion("User::UserStepFirst");
     if(userStepFirst != nullptr)
@@ -20,6 +20,9 @@
 #include "planetarySystem.hpp"
 #include "gravity.hpp"
 #include "stateContainer.hpp"
+#include "fusedDust.hpp"
+#include "blockScheduler.hpp"
+#include "refinement.hpp"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 /// The DataBlock class is designed to store the data and child class instances that belongs to the
@@ -115,6 +118,8 @@ class DataBlock {
   std::unique_ptr<Fluid<DefaultPhysics>> hydro;   ///< The Hydro object attached to this datablock
   bool haveDust{false};
   std::vector<std::unique_ptr<Fluid<DustPhysics>>> dust; ///< Holder for zero pressure dust fluid
+  bool haveFusedDust{false};
+  std::unique_ptr<FusedDust> fusedDust; ///< Engine evolving all of the dust species at once
 
   std::unique_ptr<Vtk> vtk;
   std::unique_ptr<Dump> dump;
@@ -123,7 +128,8 @@ class DataBlock {
   #endif
 
 
-  DataBlock(Grid &, Input &);     ///< init from a Grid object
+  DataBlock(Grid &, Input &, int block = -1); ///< init from a Grid object (the whole domain of
+                                              ///< the process, or one of its blocks)
   explicit DataBlock(SubGrid *);           ///< init a minimal datablock for a subgrid
 
   void ExtractSubdomain();        ///< initialise datablock sub-domain according to domain decomp.
@@ -131,6 +137,8 @@ class DataBlock {
   void DumpToFile(std::string);   ///< Dump current datablock to a file for inspection
   void Validate();                ///< error out early in case problems are found in IC
   int CheckNan();                 ///< Return the number of cells which have Nans
+  void EnableNanTracking();       ///< Count the Nans in the kernels reading every cell
+  int GetTrackedNans();           ///< Return the number of Nans found by the tracking
 
   // The Planetary system
   bool haveplanetarySystem{false};
@@ -142,8 +150,11 @@ class DataBlock {
   void EvolveStage();             ///< Evolve this DataBlock by dt
   void EvolveRKLStage();          ///< Evolve this DataBlock by dt for terms impacted by RKL
   void SetBoundaries();       ///< Enforce boundary conditions to this datablock
+  void StartBoundaries();     ///< Same, possibly leaving MPI exchanges in flight until EvolveStage
   void ConsToPrim();       ///< Convert conservative to primitive variables
   void PrimToCons();       ///< Convert primitive to conservative variables
+  void PrimToConsAndStore(bool);  ///< PrimToCons in active cells, storing the "begin" state
+  void AddAndConsToPrim(real, real, bool); ///< Combine stages and ConsToPrim in active cells
   void DeriveVectorPotential(); ///< Compute magnetic fields from vector potential where applicable
   void Coarsen();             ///< Coarsen this datablock and its objects
   void ShowConfig();              ///< Show the datablock's configuration
@@ -163,6 +174,16 @@ class DataBlock {
   bool haveGravity{false};
   std::unique_ptr<Gravity> gravity;
 
+  // Is the domain of the process split in several blocks?
+  bool haveBlocks{false};
+  std::unique_ptr<BlockScheduler> scheduler;
+  int blockIndex{-1};             ///< index of this block in the process (-1: whole process)
+
+  // Is a part of the domain refined by a finer level?
+  bool haveRefinement{false};
+  std::unique_ptr<StaticRefinement> refinement;
+  StaticRefinement *parentRefinement{nullptr};  ///< refinement holding this level (if refined)
+
   // User step functions (before or after the main integrator step)
   void LaunchUserStepFirst();     ///< perform user-defined step before main integration step
   void LaunchUserStepLast();      ///< Perform user-defined step after main integration step
@@ -173,6 +194,7 @@ class DataBlock {
  private:
   void WriteVariable(FILE* , int , int *, char *, void*);
   void ComputeGridCoarseningLevels();   ///< Call user defined function to define Coarsening levels
+  std::vector<std::string> StreamlinedStates(); ///< States handled by the streamlined stages
 
   // User Steps (either before or after the main integration loop)
   bool haveUserStepFirst{false};
@@ -33,10 +33,11 @@ class DataBlockHost {
   IdefixHostArray3D<real> dV;     ///< cell volume
   std::array<IdefixHostArray3D<real>,3> A;   ///< cell right interface area
 
-  IdefixHostArray4D<real> Vc;     ///< Main cell-centered primitive variables index
+  IdefixHostArray4D<realStore> Vc;  ///< Main cell-centered primitive variables index
 
   bool haveDust{false};
-  std::vector<IdefixHostArray4D<real>> dustVc; ///< Cell-centered primitive variables index for dust
+  std::vector<IdefixHostArray4D<realStore>> dustVc; ///< Cell-centered primitive variables
+                                                     ///< index for dust
 
   #if MHD == YES
   IdefixHostArray4D<real> Vs;     ///< Main face-centered primitive variables index
@@ -48,7 +49,7 @@ class DataBlockHost {
   IdefixHostArray3D<real> Ex3;    ///< x3 electric field
 
   #endif
-  IdefixHostArray4D<real> Uc;     ///< Main cell-centered conservative variables
+  IdefixHostArray4D<realStore> Uc;  ///< Main cell-centered conservative variables
   IdefixHostArray3D<real> InvDt;  ///< Inverse of maximum timestep in each cell
 
   std::array<IdefixHostArray2D<int>,3> coarseningLevel; ///< Grid coarsening level
@@ -81,8 +81,11 @@ void DataBlock::DumpToFile(std::string filebase)  {
   fwrite (header, sizeof(char), HEADERSIZE, fileHdl);
 
   // Write Vc
-  IdefixArray4D<real>::HostMirror locVc = Kokkos::create_mirror_view(this->hydro->Vc);
-  Kokkos::deep_copy(locVc,this->hydro->Vc);
+  // Vc is written in double precision whatever its storage precision
+  IdefixArray4D<real> devVc("DumpVc", NVAR, np_tot[KDIR], np_tot[JDIR], np_tot[IDIR]);
+  Kokkos::deep_copy(devVc,this->hydro->Vc);
+  IdefixArray4D<real>::HostMirror locVc = Kokkos::create_mirror_view(devVc);
+  Kokkos::deep_copy(locVc,devVc);
   dims[0] = this->np_tot[IDIR];
   dims[1] = this->np_tot[JDIR];
   dims[2] = this->np_tot[KDIR];
@@ -12,10 +12,19 @@
 // Evolve one step forward in time of hydro
 void DataBlock::EvolveStage() {
   idfx::pushRegion("DataBlock::EvolveStage");
+  if(haveBlocks) {
+    scheduler->EvolveStage();
+    idfx::popRegion();
+    return;
+  }
 
   hydro->EvolveStage(this->t,this->dt);
 
-  if(haveDust) {
+  if(haveFusedDust) {
+    fusedDust->EvolveStage(this->t,this->dt);
+    // Add implicit term for dust drag
+    if(dust[0]->haveDrag && dust[0]->drag->IsImplicit()) fusedDust->AddImplicitDrag(this->dt);
+  } else if(haveDust) {
     for(int i = 0 ; i < dust.size() ; i++) {
       dust[i]->EvolveStage(this->t,this->dt);
     }
@@ -112,8 +112,13 @@ Fargo::Fargo(Input &input, int nmax, DataBlock *data) {
       nvar = std::max(nvar,static_cast<int>(data->dust[n]->Vc.extent(0)));
     }
   }
+  // The fused dust species are shifted at once
+  int nvarScratch = nvar;
+  if(data->haveFusedDust) {
+    nvarScratch = std::max(nvar, static_cast<int>(data->fusedDust->Uc.extent(0)));
+  }
 
-  this->scrhUc = IdefixArray4D<real>("FargoVcScratchSpace",nvar
+  this->scrhUc = IdefixArray4D<real>("FargoVcScratchSpace",nvarScratch
                                       ,end[KDIR]-beg[KDIR] + 2*nghost[KDIR]
                                       ,end[JDIR]-beg[JDIR] + 2*nghost[JDIR]
                                       ,end[IDIR]-beg[IDIR] + 2*nghost[IDIR]);
@@ -143,6 +148,13 @@ Fargo::Fargo(Input &input, int nmax, DataBlock *data) {
       #else
         this->mpi.Init(data->mygrid, vars, this->nghost.data(), data->np_int.data());
       #endif
+      this->nvarMpi = nvar;
+      if(nvarScratch > nvar) {
+        for(int i=nvar ; i < nvarScratch ; i++) {
+          vars.push_back(i);
+        }
+        this->mpiFusedDust.Init(data->mygrid, vars, this->nghost.data(), data->np_int.data());
+      }
     }
   #endif
 
@@ -288,7 +300,11 @@ void Fargo::ShiftSolution(const real t, const real dt) {
   idfx::pushRegion("Fargo::ShiftFluid");
 
   this->ShiftFluid(t,dt,data->hydro.get());
-  if(data->haveDust) {
+  if(data->haveFusedDust) {
+    // All of the species are stored in the same array, and shifted by the same kernel
+    this->ShiftFluid(t, dt, data->dust[0].get(), data->fusedDust->Uc,
+                     static_cast<int>(data->fusedDust->Uc.extent(0)));
+  } else if(data->haveDust) {
     for(int i = 0 ; i < data->dust.size() ; i++) {
       this->ShiftFluid(t,dt,data->dust[i].get());
     }
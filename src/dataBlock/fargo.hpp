@@ -47,8 +47,12 @@ class Fargo {
   template <typename Phys>
   void ShiftFluid(const real t, const real dt, Fluid<Phys>* );
 
+  // Shift the nvar first variables of Uc, which belong to fluid(s) with the physics of Phys
   template <typename Phys>
-  void StoreToScratch(Fluid<Phys>*);
+  void ShiftFluid(const real t, const real dt, Fluid<Phys>*, IdefixArray4D<realStore>, int nvar);
+
+  template <typename Phys>
+  void StoreToScratch(Fluid<Phys>*, IdefixArray4D<realStore>, int nvar);
 
   void GetFargoVelocity(real);
 
@@ -64,7 +68,9 @@ class Fargo {
 
 #ifdef WITH_MPI
   Mpi mpi;                      // Fargo-specific MPI layer
+  Mpi mpiFusedDust;             // MPI layer for the species-indexed array of the fused dust
 #endif
+  int nvarMpi{0};               // # of variables exchanged by mpi
 
   std::array<int,3> beg;
   std::array<int,3> end;
@@ -175,7 +181,7 @@ void Fargo::AddVelocityFluid(const real t, Fluid<Phys>* hydro ) {
     GetFargoVelocity(t);
   }
   IdefixArray1D<real> x1 = data->x[IDIR];
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   IdefixArray2D<real> meanV = this->meanVelocity;
   [[maybe_unused]] FargoType fargoType = type;
   [[maybe_unused]] real sbS = hydro->sbS;
@@ -211,7 +217,7 @@ void Fargo::SubstractVelocityFluid(const real t, Fluid<Phys>* hydro) {
     GetFargoVelocity(t);
   }
   IdefixArray1D<real> x1 = data->x[IDIR];
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   [[maybe_unused]] IdefixArray2D<real> meanV = this->meanVelocity;
   [[maybe_unused]] FargoType fargoType = type;
   [[maybe_unused]] real sbS = hydro->sbS;
@@ -241,14 +247,13 @@ void Fargo::SubstractVelocityFluid(const real t, Fluid<Phys>* hydro) {
 }
 
 template<typename Phys>
-void Fargo::StoreToScratch(Fluid<Phys>* hydro) {
-  IdefixArray4D<real> Uc = hydro->Uc;
+void Fargo::StoreToScratch(Fluid<Phys>* hydro, IdefixArray4D<realStore> Uc, int nvar) {
   IdefixArray4D<real> scrhUc = this->scrhUc;
   bool haveDomainDecomposition = this->haveDomainDecomposition;
   int maxShift = this->maxShift;
 
   idefix_for("Fargo:StoreUc",
-            0,Phys::nvar+hydro->nTracer,
+            0,nvar,
             data->beg[KDIR],data->end[KDIR],
             data->beg[JDIR],data->end[JDIR],
             data->beg[IDIR],data->end[IDIR],
@@ -290,17 +295,32 @@ void Fargo::StoreToScratch(Fluid<Phys>* hydro) {
   }
   #if WITH_MPI
     if(haveDomainDecomposition) {
-      #if GEOMETRY == CARTESIAN || GEOMETRY == POLAR
-        this->mpi.ExchangeX2(scrhUc, scrhVs);
-      #elif GEOMETRY == SPHERICAL
-        this->mpi.ExchangeX3(scrhUc, scrhVs);
-      #endif
+      if(nvar > nvarMpi) {
+        // The fused dust species hold more variables than any single fluid
+        #if GEOMETRY == CARTESIAN || GEOMETRY == POLAR
+          this->mpiFusedDust.ExchangeX2(scrhUc);
+        #elif GEOMETRY == SPHERICAL
+          this->mpiFusedDust.ExchangeX3(scrhUc);
+        #endif
+      } else {
+        #if GEOMETRY == CARTESIAN || GEOMETRY == POLAR
+          this->mpi.ExchangeX2(scrhUc, scrhVs);
+        #elif GEOMETRY == SPHERICAL
+          this->mpi.ExchangeX3(scrhUc, scrhVs);
+        #endif
+      }
     }
   #endif
 }
 
 template<typename Phys>
 void Fargo::ShiftFluid(const real t, const real dt, Fluid<Phys>* hydro) {
+  ShiftFluid(t, dt, hydro, hydro->Uc, Phys::nvar+hydro->nTracer);
+}
+
+template<typename Phys>
+void Fargo::ShiftFluid(const real t, const real dt, Fluid<Phys>* hydro,
+                       IdefixArray4D<realStore> Uc, int nvar) {
   idfx::pushRegion("Fargo::ShiftFluid");
 
   #if GEOMETRY == CYLINDRICAL
@@ -321,7 +341,6 @@ void Fargo::ShiftFluid(const real t, const real dt, Fluid<Phys>* hydro) {
     IDEFIX_ERROR(message);
   }
 
-  IdefixArray4D<real> Uc = hydro->Uc;
   IdefixArray4D<real> scrh = this->scrhUc;
   IdefixArray2D<real> meanV = this->meanVelocity;
   IdefixArray1D<real> x1 = data->x[IDIR];
@@ -350,10 +369,10 @@ void Fargo::ShiftFluid(const real t, const real dt, Fluid<Phys>* hydro) {
   #endif
 
   // move Uc to scratch, and fill the ghost zones if required.
-  StoreToScratch(hydro);
+  StoreToScratch(hydro, Uc, nvar);
 
   idefix_for("Fargo:ShiftVc",
-              0,Phys::nvar+hydro->nTracer,
+              0,nvar,
               data->beg[KDIR],data->end[KDIR],
               data->beg[JDIR],data->end[JDIR],
               data->beg[IDIR],data->end[IDIR],
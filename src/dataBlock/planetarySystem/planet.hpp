@@ -47,6 +47,7 @@ class Planet {
     void activatePlanet(const real);
     // refresh the force
     Point computeAccel(DataBlock&, bool&);
+    Point forceToAccel() const;
     void computeForce(DataBlock&, bool&);
 
  protected:
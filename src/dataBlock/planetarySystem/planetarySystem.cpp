@@ -15,6 +15,122 @@
 #include "gravity.hpp"
 
 
+// Force exerted by the disk on several bodies, reduced in a single pass over the disk.
+// The 12 components of the force on each body are stored contiguously, in the order of the
+// Force struct (f_inner, f_ex_inner, f_outer, f_ex_outer).
+struct DiskForceReducer {
+  using value_type = real[];
+  using size_type = int;
+  size_type value_count;
+
+  IdefixArray1D<real> x1, x2, x3;
+  IdefixArray4D<realStore> Vc;
+  IdefixArray3D<real> dV;
+  // (body, [xp, yp, zp, distance to the origin, smoothing length, Hill radius])
+  IdefixArray2D<real> bodies;
+  int nbody;
+  int kb, jb, ib;
+  int nj, ni;
+  bool excludeHill;
+  PlanetarySystem::SmoothingFunction smoothingFunction;
+
+  KOKKOS_INLINE_FUNCTION void operator()(const int idx, value_type force) const {
+    const int k = idx / (nj*ni) + kb;
+    const int j = (idx / ni) % nj + jb;
+    const int i = idx % ni + ib;
+
+    real cellMass = dV(k,j,i)*Vc(RHO,k,j,i);
+    real xc, yc, zc;
+    #if GEOMETRY == CARTESIAN
+      xc = x1(i);
+      yc = x2(j);
+      zc = x3(k);
+    #elif GEOMETRY == POLAR
+      xc = x1(i)*cos(x2(j));
+      yc = x1(i)*sin(x2(j));
+      zc = x3(k);
+    #elif GEOMETRY == SPHERICAL
+      xc = x1(i)*sin(x2(j))*cos(x3(k));
+      yc = x1(i)*sin(x2(j))*sin(x3(k));
+      zc = x1(i)*cos(x2(j));
+    #endif
+    real distc = sqrt(xc*xc+yc*yc+zc*zc);
+
+    for(int n = 0 ; n < nbody ; n++) {
+      const real xp = bodies(n,0);
+      const real yp = bodies(n,1);
+      const real zp = bodies(n,2);
+      const real distPlanet = bodies(n,3);
+      const real smoothing = bodies(n,4);
+      const real rh = bodies(n,5);
+
+      real dist2 = ((xc-xp)*(xc-xp) + (yc-yp)*(yc-yp) + (zc-zp)*(zc-zp));
+      real hillcut = ONE_F;
+
+      if(excludeHill) {
+        real squaredist2 = sqrt(dist2);
+        if (squaredist2/rh < 0.5) {
+          hillcut = ZERO_F;
+        } else {
+          if (squaredist2 > rh) {
+            hillcut = ONE_F;
+          } else {
+            hillcut = pow(sin((squaredist2/rh-.5)*M_PI),2.);
+          }
+        }
+      }
+
+      real forceCell = ZERO_F;
+      switch(smoothingFunction) {
+        case PlanetarySystem::SmoothingFunction::PLUMMER:
+          {
+            dist2 += smoothing*smoothing;
+            real distance = sqrt(dist2);
+            real InvDist3 = ONE_F/(dist2*distance);
+            forceCell = cellMass * InvDist3;
+            break;
+          }
+        case PlanetarySystem::SmoothingFunction::POLYNOMIAL:
+          {
+            real rmrp = sqrt(dist2);
+            if (rmrp/smoothing < 1) {
+              forceCell = -cellMass*(3.0*rmrp/smoothing - 4.0)/smoothing/smoothing/smoothing;
+            } else {
+              forceCell = cellMass/rmrp/rmrp/rmrp;
+            }
+            break;
+          }
+        default: // do nothing
+          break;
+      }
+      // inner force in components 0-2 (3-5 when the Hill sphere is excluded),
+      // outer force in components 6-8 (9-11)
+      real *f = force + 12*n + (distc < distPlanet ? 0 : 6);
+      f[0] += (xc-xp)*forceCell;
+      f[1] += (yc-yp)*forceCell;
+      f[2] += (zc-zp)*forceCell;
+      if(excludeHill) {
+        f[3] += (xc-xp)*forceCell*hillcut;
+        f[4] += (yc-yp)*forceCell*hillcut;
+        f[5] += (zc-zp)*forceCell*hillcut;
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION void init(value_type force) const {
+    for(int n = 0 ; n < value_count ; n++) {
+      force[n] = ZERO_F;
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION void join(value_type dst, const value_type src) const {
+    for(int n = 0 ; n < value_count ; n++) {
+      dst[n] += src[n];
+    }
+  }
+};
+
+
 PlanetarySystem::PlanetarySystem(Input &input, DataBlock *datain) {
   idfx::pushRegion("PlanetarySystem::Init");
   this->data = datain;
@@ -170,21 +286,11 @@ void PlanetarySystem::EvolveSystem(DataBlock& data, const real& dt) {
 
 void PlanetarySystem::AdvancePlanetFromDisk(DataBlock& data, const real& dt) {
   idfx::pushRegion("PlanetarySystem::AdvancePlanetFromDisk");
+  // The forces on all of the planets are reduced at once, since the planets do not move here
+  this->ComputeForces(data);
   for(int ip=0; ip< this->nbp ; ip++) {
     if (!(planet[ip].m_isActive)) continue;
-    Point gamma;
-    bool isp = true;
-
-    real qp = planet[ip].m_qp;
-    real xp = planet[ip].m_xp;
-    real yp = planet[ip].m_yp;
-    real zp = planet[ip].m_zp;
-    real vxp = planet[ip].m_vxp;
-    real vyp = planet[ip].m_vyp;
-    real vzp = planet[ip].m_vzp;
-    real r = sqrt(xp*xp + yp*yp + zp*zp);
-
-    gamma = planet[ip].computeAccel (data, isp);
+    Point gamma = planet[ip].forceToAccel();
 
     planet[ip].m_vxp += dt * gamma.x*this->torqueNormalization;
     planet[ip].m_vyp += dt * gamma.y*this->torqueNormalization;
@@ -193,6 +299,101 @@ void PlanetarySystem::AdvancePlanetFromDisk(DataBlock& data, const real& dt) {
   idfx::popRegion();
 }
 
+void PlanetarySystem::ComputeForces(DataBlock& data) {
+  idfx::pushRegion("PlanetarySystem::ComputeForces");
+  std::vector<Point> position(nbp);
+  std::vector<real> mass(nbp);
+  std::vector<Force> force(nbp);
+  for(int ip=0; ip< this->nbp ; ip++) {
+    position[ip].x = planet[ip].m_xp;
+    position[ip].y = planet[ip].m_yp;
+    position[ip].z = planet[ip].m_zp;
+    mass[ip] = planet[ip].m_qp;
+  }
+  ReduceDiskForces(data, position, mass, force);
+  for(int ip=0; ip< this->nbp ; ip++) {
+    planet[ip].m_force = force[ip];
+  }
+  idfx::popRegion();
+}
+
+/*
+Be careful: you need to substract
+the azimuthally averaged density
+prior to the torque evaluation (BM08 trick)
+*/
+void PlanetarySystem::ReduceDiskForces(DataBlock& data, const std::vector<Point> &position,
+                                       const std::vector<real> &mass, std::vector<Force> &force) {
+  // since we cannot throw an error in kokkos kernel, with throw this one before the kernel.
+  #if GEOMETRY == CYLINDRICAL
+    IDEFIX_ERROR("Planet::ComputeForce is not compatible with the GEOMETRY you intend to use");
+  #endif
+  const int nbody = position.size();
+  if(nbody == 0) return;
+
+  // Parameters of each body
+  if(static_cast<int>(bodies.extent(0)) != nbody) {
+    bodies = IdefixArray2D<real>("PlanetarySystemBodies", nbody, 6);
+  }
+  IdefixArray2D<real>::HostMirror bodiesHost = Kokkos::create_mirror_view(bodies);
+  for(int n = 0 ; n < nbody ; n++) {
+    real distPlanet = sqrt(position[n].x*position[n].x + position[n].y*position[n].y
+                          + position[n].z*position[n].z);
+    bodiesHost(n,0) = position[n].x;
+    bodiesHost(n,1) = position[n].y;
+    bodiesHost(n,2) = position[n].z;
+    bodiesHost(n,3) = distPlanet;
+    bodiesHost(n,4) = smoothingValue * pow(distPlanet,ONE_F+smoothingExponent);
+    bodiesHost(n,5) = pow(mass[n]/3., 1./3.)*distPlanet;
+  }
+  Kokkos::deep_copy(bodies, bodiesHost);
+
+  DiskForceReducer reducer;
+  reducer.value_count = 12*nbody;
+  reducer.x1 = data.x[IDIR];
+  reducer.x2 = data.x[JDIR];
+  reducer.x3 = data.x[KDIR];
+  reducer.Vc = data.hydro->Vc;
+  reducer.dV = data.dV;
+  reducer.bodies = bodies;
+  reducer.nbody = nbody;
+  reducer.kb = data.beg[KDIR];
+  reducer.jb = data.beg[JDIR];
+  reducer.ib = data.beg[IDIR];
+  reducer.nj = data.end[JDIR] - data.beg[JDIR];
+  reducer.ni = data.end[IDIR] - data.beg[IDIR];
+  reducer.excludeHill = excludeHill;
+  reducer.smoothingFunction = myPlanetarySmoothing;
+
+  const int ncells = (data.end[KDIR] - data.beg[KDIR])*reducer.nj*reducer.ni;
+  std::vector<real> forceLoc(12*nbody);
+  Kokkos::parallel_reduce("ComputeForce", Kokkos::RangePolicy<>(0, ncells), reducer,
+                          forceLoc.data());
+
+  if(halfdisk) {
+    for(int n = 0 ; n < nbody ; n++) {
+      for(int c = 0 ; c < 12 ; c++) {
+        // Cancel vertical component and multiply by 2 the remaining components
+        forceLoc[12*n+c] *= (c % 3 == 2) ? ZERO_F : 2;
+      }
+    }
+  }
+
+  #ifdef WITH_MPI
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, forceLoc.data(), 12*nbody, realMPI, MPI_SUM,
+                                MPI_COMM_WORLD));
+  #endif
+
+  for(int n = 0 ; n < nbody ; n++) {
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      force[n].f_inner[dir] = forceLoc[12*n+dir];
+      force[n].f_ex_inner[dir] = forceLoc[12*n+3+dir];
+      force[n].f_outer[dir] = forceLoc[12*n+6+dir];
+      force[n].f_ex_outer[dir] = forceLoc[12*n+9+dir];
+    }
+  }
+}
+
 void PlanetarySystem::IntegratePlanets(DataBlock& data, const real& dt) {
     switch(this->myPlanetaryIntegrator) {
         case ANALYTICAL:
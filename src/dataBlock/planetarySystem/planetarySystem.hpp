@@ -38,6 +38,9 @@ class PlanetarySystem {
     void ShowConfig();
     void AddPlanetsPotential(IdefixArray3D<real> &, real);
     std::vector<PointSpeed> ComputeRHS(real&, std::vector<Planet>);
+    // Compute the force exerted by the disk on all of the planets (stored in Planet::m_force)
+    // with a single pass over the disk
+    void ComputeForces(DataBlock&);
 
     // number of planets
     int nbp{0};
@@ -49,6 +52,8 @@ class PlanetarySystem {
  protected:
     void AdvancePlanetFromDisk(DataBlock&, const real&);
     void IntegratePlanets(DataBlock&, const real&);
+    void ReduceDiskForces(DataBlock&, const std::vector<Point>&, const std::vector<real>&,
+                          std::vector<Force>&);
     friend class Planet;
     real massTaper{ZERO_F};
     real smoothingValue;
@@ -61,6 +66,7 @@ class PlanetarySystem {
     Integrator myPlanetaryIntegrator;
     SmoothingFunction myPlanetarySmoothing;
     DataBlock *data;
+    IdefixArray2D<real> bodies;   // parameters of the bodies on which the disk force is reduced
 };
 
 #endif // DATABLOCK_PLANETARYSYSTEM_PLANETARYSYSTEM_HPP_
@@ -0,0 +1,971 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include "refinement.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include "dataBlock.hpp"
+#include "fluid.hpp"
+#include "gridHost.hpp"
+#include "timeIntegrator.hpp"
+#include "vtk.hpp"
+#ifdef WITH_MPI
+#include "mpi.hpp"
+#endif
+
+KOKKOS_INLINE_FUNCTION real Refinement_MinMod(const real dl, const real dr) {
+  if(dl*dr <= ZERO_F) return(ZERO_F);
+  return(FABS(dl) < FABS(dr) ? dl : dr);
+}
+
+// Area of the face normal to dir located at xf, and spanning [l,r] along the other directions
+// (same expressions as DataBlock::MakeGeometry)
+KOKKOS_INLINE_FUNCTION real Refinement_FaceArea(const int dir, const real xf,
+                                                const real l[3], const real r[3]) {
+  [[maybe_unused]] const real dx1 = r[IDIR]-l[IDIR];
+  [[maybe_unused]] const real dx2 = r[JDIR]-l[JDIR];
+  [[maybe_unused]] const real dx3 = r[KDIR]-l[KDIR];
+  [[maybe_unused]] const real x1 = HALF_F*(l[IDIR]+r[IDIR]);
+#if GEOMETRY == CARTESIAN
+  if(dir == IDIR) return(D_EXPAND(ONE_F, *dx2, *dx3));
+  if(dir == JDIR) return(D_EXPAND(dx1, *ONE_F, *dx3));
+  return(D_EXPAND(dx1, *dx2, *ONE_F));
+#elif GEOMETRY == CYLINDRICAL
+  if(dir == IDIR) return(D_EXPAND(FABS(xf), *dx2, *ONE_F));
+  if(dir == JDIR) return(D_EXPAND(FABS(x1), *dx1, *ONE_F));
+  return(ONE_F);
+#elif GEOMETRY == POLAR
+  if(dir == IDIR) return(D_EXPAND(FABS(xf), *dx2, *dx3));
+  if(dir == JDIR) return(D_EXPAND(dx1, *ONE_F, *dx3));
+  return(D_EXPAND(x1*dx1, *dx2, *ONE_F));
+#elif GEOMETRY == SPHERICAL
+  if(dir == IDIR) return(D_EXPAND(xf*xf, *FABS(cos(l[JDIR]) - cos(r[JDIR])), *dx3));
+  if(dir == JDIR) return(D_EXPAND(x1*dx1, *FABS(sin(xf)), *dx3));
+  return(D_EXPAND(x1*dx1, *dx2, *ONE_F));
+#endif
+}
+
+// Weight of a conservative variable in the averages of the restriction, so that the quantities
+// conserved by the scheme (e.g. the angular momentum rather than the azimuthal momentum) are
+// conserved by the restriction
+template <typename Phys>
+KOKKOS_INLINE_FUNCTION real Refinement_Weight(const int nv, const int k, const int j, const int i,
+                                              const IdefixArray3D<real> &dV,
+                                              const IdefixArray1D<real> &x1,
+                                              const IdefixArray1D<real> &dx1,
+                                              const IdefixArray1D<real> &dx2,
+                                              const IdefixArray1D<real> &sinx2) {
+  if(nv < Phys::nvar) {
+    #if GEOMETRY != CARTESIAN && defined(iMPHI)
+      if(nv == iMPHI) {
+        #if GEOMETRY == SPHERICAL
+          return(dV(k,j,i)*x1(i)*FABS(sinx2(j)));
+        #else
+          return(dV(k,j,i)*x1(i));
+        #endif
+      }
+    #endif
+    if constexpr(Phys::mhd) {
+      // Components whose fluxes are line fluxes (see Fluid_CalcRHSFunctor)
+      #if (GEOMETRY == POLAR || GEOMETRY == CYLINDRICAL) && defined(iBPHI)
+        if(nv == iBPHI) return(dx1(i)*dx2(j));
+      #elif GEOMETRY == SPHERICAL
+        #if COMPONENTS >= 2
+          if(nv == iBTH) return(x1(i)*dx1(i)*dx2(j));
+        #endif
+        #if COMPONENTS == 3
+          if(nv == iBPHI) return(x1(i)*dx1(i)*dx2(j));
+        #endif
+      #endif
+    }
+  }
+  return(dV(k,j,i));
+}
+
+#if MHD == YES
+// Divergence-free prolongation of the face-centered magnetic field of the coarse level (combined
+// in time) in clusters of 2^DIMENSIONS fine cells, one coarse cell per thread. The fluxes through
+// the outer faces of a cluster are interpolated with minmod slopes along the faces and corrected
+// so that they add up to the coarse fluxes. The fluxes through the faces inside the cluster
+// are then the closest ones to their interpolation which make each fine cell divergence-free.
+// When filling the ghost zones along dir, the faces on the edge of the fine level are kept, and
+// the difference between their fluxes and the interpolated ones is propagated along dir, so that
+// the ghost cells stay divergence-free.
+struct Refinement_ProlongMagFieldFunctor {
+  Refinement_ProlongMagFieldFunctor(DataBlock *coarse, DataBlock *fine, IdefixArray4D<real> VsOld,
+                                    real w) {
+    this->VsOld = VsOld;
+    this->VsNew = coarse->hydro->Vs;
+    this->Vs = fine->hydro->Vs;
+    this->w = w;
+    for(int d = 0 ; d < 3 ; d++) {
+      xc[d] = coarse->x[d];
+      xlc[d] = coarse->xl[d];
+      xrc[d] = coarse->xr[d];
+      Ac[d] = coarse->A[d];
+      beg[d] = fine->beg[d];
+      ntot[d] = fine->np_tot[d];
+    }
+  }
+
+  IdefixArray4D<real> VsOld;
+  IdefixArray4D<real> VsNew;
+  IdefixArray4D<real> Vs;
+  IdefixArray1D<real> xc[3];
+  IdefixArray1D<real> xlc[3];
+  IdefixArray1D<real> xrc[3];
+  IdefixArray3D<real> Ac[3];
+  real w;
+  int lo[3];        // first cell of the fine level in the coarse level
+  int beg[3];       // first active cell of the fine level
+  int ntot[3];      // size of the fine arrays
+  int last[3];      // last cluster+1 in each direction
+  int dir{IDIR};    // direction of the ghost zones
+  int edgeCell;     // coarse index of the face on the edge of the fine level along dir
+  int edgeFace;     // fine index of that face
+
+  KOKKOS_INLINE_FUNCTION real Bc(const int c, const int ic[3]) const {
+    return((ONE_F-w)*VsOld(c,ic[KDIR],ic[JDIR],ic[IDIR]) + w*VsNew(c,ic[KDIR],ic[JDIR],ic[IDIR]));
+  }
+
+  // Directions tangential to the faces normal to c (in increasing order)
+  KOKKOS_INLINE_FUNCTION static void Tangential(const int c, int t[2]) {
+    t[0] = (c == IDIR) ? JDIR : IDIR;
+    t[1] = (c == KDIR) ? JDIR : KDIR;
+  }
+
+  KOKKOS_INLINE_FUNCTION int FineIndex(const int d, const int ic) const {
+    return((d < DIMENSIONS) ? beg[d] + 2*(ic-lo[d]) : ic);
+  }
+
+  // Extent of the sub-face s (=b0+2*b1, bn being the half along t[n]) of the coarse cell ic
+  KOKKOS_INLINE_FUNCTION void SubFace(const int c, const int s, const int ic[3],
+                                      real l[3], real r[3]) const {
+    int t[2];
+    Tangential(c, t);
+    l[c] = r[c] = ZERO_F;
+    for(int a = 0 ; a < 2 ; a++) {
+      const int d = t[a];
+      l[d] = xlc[d](ic[d]);
+      r[d] = xrc[d](ic[d]);
+      if(d < DIMENSIONS) {
+        const real xm = HALF_F*(l[d]+r[d]);
+        if((s >> a) & 1) {
+          l[d] = xm;
+        } else {
+          r[d] = xm;
+        }
+      }
+    }
+  }
+
+  // Fluxes through the sub-faces of the coarse face normal to c on the left of cell ic
+  KOKKOS_INLINE_FUNCTION void SubFaceFluxes(const int c, const int ic[3],
+                                            real phi[4], real area[4]) const {
+    int t[2];
+    Tangential(c, t);
+    const real B = Bc(c, ic);
+    real slope[2] = {ZERO_F, ZERO_F};
+    for(int a = 0 ; a < 2 ; a++) {
+      const int d = t[a];
+      if(d >= DIMENSIONS) continue;
+      int im[3] = {ic[IDIR], ic[JDIR], ic[KDIR]};
+      int ip[3] = {ic[IDIR], ic[JDIR], ic[KDIR]};
+      im[d]--;
+      ip[d]++;
+      const real dl = (B - Bc(c, im))/(xc[d](ic[d]) - xc[d](ic[d]-1));
+      const real dr = (Bc(c, ip) - B)/(xc[d](ic[d]+1) - xc[d](ic[d]));
+      // variation between the centers of the two halves
+      slope[a] = HALF_F*Refinement_MinMod(dl, dr)*(xrc[d](ic[d]) - xlc[d](ic[d]));
+    }
+    const int nsub = 1 << (DIMENSIONS-1);
+    const real xf = xlc[c](ic[c]);
+    real sum = ZERO_F;
+    for(int s = 0 ; s < nsub ; s++) {
+      real l[3], r[3];
+      SubFace(c, s, ic, l, r);
+      area[s] = Refinement_FaceArea(c, xf, l, r);
+      const real b = B + HALF_F*((2*(s & 1)-1)*slope[0] + (2*((s >> 1) & 1)-1)*slope[1]);
+      phi[s] = area[s]*b;
+      sum += phi[s];
+    }
+    const real err = Ac[c](ic[KDIR],ic[JDIR],ic[IDIR])*B - sum;
+    for(int s = 0 ; s < nsub ; s++) phi[s] += err/nsub;
+  }
+
+  // Whether a face of the fine level exists and is not kept
+  KOKKOS_INLINE_FUNCTION bool Writable(const int c, const int f[3]) const {
+    for(int d = 0 ; d < DIMENSIONS ; d++) {
+      if(f[d] < 0 || f[d] > ntot[d] || (f[d] == ntot[d] && d != c)) return(false);
+    }
+    return(c != dir || f[c] != edgeFace);
+  }
+
+  KOKKOS_INLINE_FUNCTION void operator() (const int kc, const int jc, const int ic) const {
+    const int idx[3] = {ic, jc, kc};
+    constexpr int nsub = 1 << (DIMENSIONS-1);
+    constexpr int ncell = 1 << DIMENSIONS;
+
+    // Fluxes through the outer faces of the cluster
+    real phi[3][2][4];
+    real area[3][2][4];
+    for(int c = 0 ; c < DIMENSIONS ; c++) {
+      for(int side = 0 ; side < 2 ; side++) {
+        int cf[3] = {idx[IDIR], idx[JDIR], idx[KDIR]};
+        cf[c] += side;
+        SubFaceFluxes(c, cf, phi[c][side], area[c][side]);
+      }
+    }
+
+    // Match the faces kept on the edge of the fine level
+    int tEdge[2];
+    Tangential(dir, tEdge);
+    int cEdge[3] = {idx[IDIR], idx[JDIR], idx[KDIR]};
+    cEdge[dir] = edgeCell;
+    real phiEdge[4], areaEdge[4];
+    SubFaceFluxes(dir, cEdge, phiEdge, areaEdge);
+    for(int s = 0 ; s < nsub ; s++) {
+      int f[3];
+      for(int d = 0 ; d < 3 ; d++) f[d] = FineIndex(d, idx[d]);
+      f[dir] = edgeFace;
+      for(int a = 0 ; a < 2 ; a++) {
+        if(tEdge[a] < DIMENSIONS) f[tEdge[a]] += (s >> a) & 1;
+      }
+      bool inside = true;
+      for(int a = 0 ; a < 2 ; a++) {
+        const int d = tEdge[a];
+        if(d < DIMENSIONS && (f[d] < 0 || f[d] >= ntot[d])) inside = false;
+      }
+      if(!inside) continue;
+      const real shift = areaEdge[s]*Vs(dir,f[KDIR],f[JDIR],f[IDIR]) - phiEdge[s];
+      phi[dir][0][s] += shift;
+      phi[dir][1][s] += shift;
+    }
+
+    // Fluxes through the inner faces, first guess
+    real phiIn[3][4];
+    real areaIn[3][4];
+    for(int c = 0 ; c < DIMENSIONS ; c++) {
+      const real xf = HALF_F*(xlc[c](idx[c]) + xrc[c](idx[c]));
+      for(int s = 0 ; s < nsub ; s++) {
+        real l[3], r[3];
+        SubFace(c, s, idx, l, r);
+        areaIn[c][s] = Refinement_FaceArea(c, xf, l, r);
+        phiIn[c][s] = areaIn[c][s]*(phi[c][0][s] + phi[c][1][s])
+                      / (area[c][0][s] + area[c][1][s]);
+      }
+    }
+
+    // Divergence of the fine cells (cell q is at the position (q >> d) & 1 along d)
+    real div[ncell];
+    for(int q = 0 ; q < ncell ; q++) {
+      div[q] = ZERO_F;
+      for(int c = 0 ; c < DIMENSIONS ; c++) {
+        int t[2];
+        Tangential(c, t);
+        const int s = ((q >> t[0]) & 1) + 2*((q >> t[1]) & 1);
+        if((q >> c) & 1) {
+          div[q] += phi[c][1][s] - phiIn[c][s];
+        } else {
+          div[q] += phiIn[c][s] - phi[c][0][s];
+        }
+      }
+    }
+
+    // Minimal correction of the inner fluxes cancelling the divergence: grad(mu), where mu
+    // solves L mu = -div, L being the graph Laplacian of the cluster. Its pseudo-inverse only
+    // depends on the number of directions along which two cells differ.
+    #if DIMENSIONS == 1
+      const real invL[2] = {0.25, -0.25};
+    #elif DIMENSIONS == 2
+      const real invL[3] = {5.0/16.0, -1.0/16.0, -3.0/16.0};
+    #else
+      const real invL[4] = {29.0/96.0, 1.0/96.0, -7.0/96.0, -11.0/96.0};
+    #endif
+    real mu[ncell];
+    for(int q = 0 ; q < ncell ; q++) {
+      mu[q] = ZERO_F;
+      for(int p = 0 ; p < ncell ; p++) {
+        const int h = ((p^q) & 1) + (((p^q) >> 1) & 1) + (((p^q) >> 2) & 1);
+        mu[q] -= invL[h]*div[p];
+      }
+    }
+    for(int c = 0 ; c < DIMENSIONS ; c++) {
+      int t[2];
+      Tangential(c, t);
+      for(int s = 0 ; s < nsub ; s++) {
+        int a = 0;
+        if(t[0] < DIMENSIONS) a += (s & 1) << t[0];
+        if(t[1] < DIMENSIONS) a += ((s >> 1) & 1) << t[1];
+        phiIn[c][s] += mu[a] - mu[a | (1 << c)];
+      }
+    }
+
+    // Write the inner faces and the left faces of the cluster (and the right faces of the last
+    // clusters)
+    for(int c = 0 ; c < DIMENSIONS ; c++) {
+      int t[2];
+      Tangential(c, t);
+      for(int s = 0 ; s < nsub ; s++) {
+        int f[3];
+        for(int d = 0 ; d < 3 ; d++) f[d] = FineIndex(d, idx[d]);
+        for(int a = 0 ; a < 2 ; a++) {
+          if(t[a] < DIMENSIONS) f[t[a]] += (s >> a) & 1;
+        }
+        if(Writable(c, f)) Vs(c,f[KDIR],f[JDIR],f[IDIR]) = phi[c][0][s]/area[c][0][s];
+        f[c]++;
+        if(Writable(c, f)) Vs(c,f[KDIR],f[JDIR],f[IDIR]) = phiIn[c][s]/areaIn[c][s];
+        f[c]++;
+        if(idx[c] == last[c]-1 && Writable(c, f)) {
+          Vs(c,f[KDIR],f[JDIR],f[IDIR]) = phi[c][1][s]/area[c][1][s];
+        }
+      }
+    }
+  }
+};
+#endif // MHD
+
+template <typename F>
+void StaticRefinement::ForEachFluid(F function) {
+  function(coarse->hydro.get(), fine->hydro.get(), 0);
+  for(int n = 0 ; n < coarse->dust.size() ; n++) {
+    function(coarse->dust[n].get(), fine->dust[n].get(), n+1);
+  }
+}
+
+template <typename Phys>
+void StaticRefinement::AddRegisters(Fluid<Phys> *coarseFluid, Fluid<Phys> *fineFluid,
+                                    const std::array<int,3> &size,
+                                    const std::array<int,3> &ratio) {
+  const std::array<int,3> one = {1, 1, 1};
+  coarseFluid->fluxRegisters.push_back(std::make_unique<FluxRegister<Phys>>(
+                    coarseFluid, lo, size, one, refinedSide,
+                    coarseFluid->prefix+"_FluxRegisterCoarse"+std::to_string(grid->level)));
+  fineFluid->fluxRegisters.push_back(std::make_unique<FluxRegister<Phys>>(
+                    fineFluid, fine->beg, size, ratio, refinedSide,
+                    fineFluid->prefix+"_FluxRegisterFine"+std::to_string(grid->level)));
+}
+
+StaticRefinement::StaticRefinement(Input &input, DataBlock *data) {
+  idfx::pushRegion("StaticRefinement::StaticRefinement");
+  this->coarse = data;
+  this->dtEstimate = std::numeric_limits<real>::max();
+  Grid *parent = data->mygrid;
+  const int level = parent->level;
+
+  bool haveRKL = data->hydro->haveRKLParabolicTerms;
+  for(auto &fluid : data->dust) haveRKL = haveRKL || fluid->haveRKLParabolicTerms;
+  if(data->haveFargo || data->haveBlocks || data->haveFusedDust || data->haveplanetarySystem
+      || data->haveGridCoarsening != GridCoarsening::disabled || data->haveAxis || haveRKL) {
+    IDEFIX_ERROR("Static mesh refinement is not compatible with Fargo, blocks, fused dust, "
+                 "planets, grid coarsening, axis boundaries and RKL parabolic terms");
+  }
+  if(data->haveGravity && data->gravity->haveSelfGravityPotential) {
+    IDEFIX_ERROR("Static mesh refinement is not compatible with self-gravity");
+  }
+  #ifdef EVOLVE_VECTOR_POTENTIAL
+    IDEFIX_ERROR("Static mesh refinement is not compatible with EVOLVE_VECTOR_POTENTIAL");
+  #endif
+
+  // Region of this level, snapped to the faces of the coarse grid
+  GridHost gridHost(*parent);
+  gridHost.SyncFromDevice();
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    const int n = parent->np_int[dir];
+    const int ng = parent->nghost[dir];
+    patchBeg[dir] = 0;
+    patchEnd[dir] = n;
+    const std::string entry = "X"+std::to_string(dir+1)+"-region";
+    if(dir >= DIMENSIONS || input.CheckEntry("Refinement", entry) < 0) continue;
+    if(parent->lbound[dir] == shearingbox || parent->rbound[dir] == shearingbox) {
+      IDEFIX_ERROR("Static mesh refinement is not compatible with shearing box boundaries");
+    }
+    for(int side = 0 ; side < 2 ; side++) {
+      const real x = input.Get<real>("Refinement", entry, 2*level+side);
+      int face = 0;
+      for(int f = 1 ; f <= n ; f++) {
+        if(FABS(gridHost.xl[dir](f+ng) - x) < FABS(gridHost.xl[dir](face+ng) - x)) face = f;
+      }
+      if(side == 0) {
+        patchBeg[dir] = face;
+      } else {
+        patchEnd[dir] = face;
+      }
+    }
+
+    std::stringstream msg;
+    msg << "The region of refinement level " << level+1 << " along X" << dir+1;
+    if(patchEnd[dir] <= patchBeg[dir]) {
+      msg << " is empty.";
+      IDEFIX_ERROR(msg);
+    }
+    if(parent->lbound[dir] == periodic && (patchBeg[dir] == 0) != (patchEnd[dir] == n)) {
+      msg << " can only reach a periodic boundary if it spans the whole domain.";
+      IDEFIX_ERROR(msg);
+    }
+    if((parent->lbound[dir] == internal && patchBeg[dir] == 0)
+        || (parent->rbound[dir] == internal && patchEnd[dir] == n)) {
+      msg << " must be strictly inside the region of level " << level << ".";
+      IDEFIX_ERROR(msg);
+    }
+    // The coarse cells next to an edge of the region must be on the same proc as the region
+    const std::vector<int> &slabs = parent->decomposition[dir];
+    for(int p = 0 ; p < parent->nproc[dir] ; p++) {
+      if((p > 0 && (slabs[p] == patchBeg[dir] || slabs[p] == patchEnd[dir]))) {
+        msg << " has an edge on the boundary between two MPI subdomains. Move the region or "
+            << "change the domain decomposition.";
+        IDEFIX_ERROR(msg);
+      }
+      const int clipped = std::min(slabs[p+1], patchEnd[dir]) - std::max(slabs[p], patchBeg[dir]);
+      if(clipped > 0 && 2*clipped < ng) {
+        msg << " has less than " << ng << " cells in one of the MPI subdomains.";
+        IDEFIX_ERROR(msg);
+      }
+    }
+  }
+
+  this->grid = std::make_unique<Grid>(parent, patchBeg, patchEnd);
+
+  if(grid->haveLocalDomain) {
+    this->fine = std::make_unique<DataBlock>(*grid, input);
+    fine->parentRefinement = this;
+
+    // Part of the region held by this proc
+    std::array<int,3> size;
+    std::array<int,3> ratio;
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      const int slabBeg = data->gbeg[dir] - data->nghost[dir];
+      const int slabEnd = data->gend[dir] - data->nghost[dir];
+      lo[dir] = data->beg[dir] + std::max(patchBeg[dir] - slabBeg, 0);
+      hi[dir] = data->beg[dir] + std::min(patchEnd[dir] - slabBeg, data->np_int[dir]);
+      size[dir] = hi[dir] - lo[dir];
+      ratio[dir] = (dir < DIMENSIONS) ? 2 : 1;
+      refinedSide[dir][0] = (grid->lbound[dir] == internal) && (patchBeg[dir] >= slabBeg);
+      refinedSide[dir][1] = (grid->rbound[dir] == internal) && (patchEnd[dir] <= slabEnd);
+    }
+
+    // Registers of the fluxes through the edges of the fine level, on both levels (before the
+    // integrator of the fine level, which allocates its begin state from the current one)
+    this->coarseRegister = data->hydro->fluxRegisters.size();
+    this->fineRegister = fine->hydro->fluxRegisters.size();
+    ForEachFluid([&](auto *coarseFluid, auto *fineFluid, int n) {
+      AddRegisters(coarseFluid, fineFluid, size, ratio);
+      VcOld.push_back(IdefixArray4D<realStore>(coarseFluid->prefix+"_VcOld",
+                                               coarseFluid->Vc.extent(0),
+                                               coarseFluid->Vc.extent(1),
+                                               coarseFluid->Vc.extent(2),
+                                               coarseFluid->Vc.extent(3)));
+    });
+    #if MHD == YES
+      VsOld = IdefixArray4D<real>("Hydro_VsOld", data->hydro->Vs.extent(0),
+                                  data->hydro->Vs.extent(1),
+                                  data->hydro->Vs.extent(2),
+                                  data->hydro->Vs.extent(3));
+    #endif
+
+    this->integrator = std::make_unique<TimeIntegrator>(input, *fine);
+    integrator->isSilent = true;
+  }
+  idfx::popRegion();
+}
+
+StaticRefinement::~StaticRefinement() {
+  // Nothing to be done (defined here, where DataBlock and TimeIntegrator are complete types)
+}
+
+void StaticRefinement::StartStep() {
+  if(!fine) return;
+  idfx::pushRegion("StaticRefinement::StartStep");
+  ForEachFluid([&](auto *coarseFluid, auto *fineFluid, int n) {
+    coarseFluid->fluxRegisters[coarseRegister]->Reset();
+    fineFluid->fluxRegisters[fineRegister]->Reset();
+    Kokkos::deep_copy(VcOld[n], coarseFluid->Vc);
+  });
+  #if MHD == YES
+    Kokkos::deep_copy(VsOld, coarse->hydro->Vs);
+  #endif
+  this->t0 = coarse->t;
+  this->dt = coarse->dt;
+  idfx::popRegion();
+}
+
+void StaticRefinement::Advance(real tStep, real dtStep) {
+  idfx::pushRegion("StaticRefinement::Advance");
+  // Ghost zones of the coarse level at the end of its step, which are interpolated in the
+  // ghost zones of the fine level
+  coarse->SetBoundaries();
+
+  if(fine) {
+    fine->t = tStep;
+    real dtFine = std::numeric_limits<real>::max();
+    for(int substep = 0 ; substep < 2 ; substep++) {
+      fine->dt = HALF_F*dtStep;
+      dtFine = std::min(dtFine, integrator->Substep(*fine));
+    }
+    fine->t = tStep + dtStep;
+    dtEstimate = TWO_F*dtFine;
+
+    ForEachFluid([&](auto *coarseFluid, auto *fineFluid, int) {
+      Reflux(coarseFluid, fineFluid);
+    });
+    #if MHD == YES
+      CorrectEMF();
+    #endif
+    Restrict();
+  }
+  idfx::popRegion();
+}
+
+void StaticRefinement::Restrict() {
+  ForEachFluid([&](auto *coarseFluid, auto *fineFluid, int) {
+    RestrictFlow(coarseFluid, fineFluid);
+  });
+  #if MHD == YES
+    RestrictMagField();
+    coarse->hydro->boundary->ReconstructVcField(coarse->hydro->Uc);
+  #endif
+  coarse->ConsToPrim();
+}
+
+// Correct the coarse cells around the region with the difference between the fluxes of the
+// fine and coarse levels through its edges (integrated over the step)
+template <typename Phys>
+void StaticRefinement::Reflux(Fluid<Phys> *coarseFluid, Fluid<Phys> *fineFluid) {
+  idfx::pushRegion("StaticRefinement::Reflux");
+  FluxRegister<Phys> *regCoarse = coarseFluid->fluxRegisters[coarseRegister].get();
+  FluxRegister<Phys> *regFine = fineFluid->fluxRegisters[fineRegister].get();
+  IdefixArray4D<realStore> Uc = coarseFluid->Uc;
+  IdefixArray3D<real> dV = coarse->dV;
+  IdefixArray1D<real> x1 = coarse->x[IDIR];
+  IdefixArray1D<real> dx1 = coarse->dx[IDIR];
+  IdefixArray1D<real> dx2 = coarse->dx[JDIR];
+  IdefixArray1D<real> dx3 = coarse->dx[KDIR];
+  IdefixArray1D<real> rt = coarse->rt;
+  IdefixArray1D<real> dmu = coarse->dmu;
+  IdefixArray1D<real> sinx2 = coarse->sinx2;
+
+  // Rotation (treated as a source term in cartesian geometry)
+  bool haveRotation = coarseFluid->haveRotation;
+  #if GEOMETRY == CARTESIAN
+    haveRotation = false;
+  #endif
+  const real Omega = coarseFluid->OmegaZ;
+
+  // Work of the gravitational forces, computed from the mass fluxes
+  bool needPotential = false;
+  bool needBodyForce = false;
+  IdefixArray3D<real> phiP;
+  IdefixArray4D<real> bodyForce;
+  if(coarse->haveGravity) {
+    needPotential = coarse->gravity->havePotential;
+    phiP = coarse->gravity->phiP;
+    needBodyForce = coarse->gravity->haveBodyForce;
+    bodyForce = coarse->gravity->bodyForceVector;
+  }
+
+  const int lo[3] = {this->lo[IDIR], this->lo[JDIR], this->lo[KDIR]};
+  const int hi[3] = {this->hi[IDIR], this->hi[JDIR], this->hi[KDIR]};
+  const int nvar = Uc.extent(0);
+
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    IdefixArray4D<real> Rc = regCoarse->flux[dir];
+    IdefixArray4D<real> Rf = regFine->flux[dir];
+    for(int side = 0 ; side < 2 ; side++) {
+      if(!refinedSide[dir][side]) continue;
+      // The coarse cell is on the left of the left side, and on the right of the right side
+      const real sgn = (side == 0) ? ONE_F : -ONE_F;
+      const int cell = (side == 0) ? lo[dir]-1 : hi[dir];
+      int b[3] = {0, 0, 0};
+      int e[3] = {static_cast<int>(Rc.extent(3)),
+                  static_cast<int>(Rc.extent(2)),
+                  static_cast<int>(Rc.extent(1))};
+      b[dir] = side;
+      e[dir] = side+1;
+      idefix_for("StaticRefinement::Reflux",
+                 b[KDIR], e[KDIR],
+                 b[JDIR], e[JDIR],
+                 b[IDIR], e[IDIR],
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          int c[3] = {lo[IDIR]+i, lo[JDIR]+j, lo[KDIR]+k};
+          c[dir] = cell;
+          const int ci = c[IDIR];
+          const int cj = c[JDIR];
+          const int ck = c[KDIR];
+          const real invdV = ONE_F/dV(ck,cj,ci);
+
+          real delta[Phys::nvar];
+          real dR[Phys::nvar];
+          for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+            dR[nv] = Rf(nv,k,j,i) - Rc(nv,k,j,i);
+            delta[nv] = -sgn*invdV*dR[nv];
+          }
+
+          // Curvature terms (see Fluid_CalcRHSFunctor)
+          #if GEOMETRY != CARTESIAN
+            if(dir == IDIR) {
+              #ifdef iMPHI
+                delta[iMPHI] = delta[iMPHI] / x1(ci);
+              #endif
+              if constexpr(Phys::mhd) {
+                #if (GEOMETRY == POLAR || GEOMETRY == CYLINDRICAL) &&  (defined iBPHI)
+                  delta[iBPHI] = -sgn / dx1(ci) * dR[iBPHI];
+                #elif (GEOMETRY == SPHERICAL)
+                  const real q = sgn / (x1(ci)*dx1(ci));
+                  EXPAND(                                  ,
+                         delta[iBTH]  = -q * dR[iBTH];     ,
+                         delta[iBPHI] = -q * dR[iBPHI];    )
+                #endif
+              }
+            } else if(dir == JDIR) {
+              #if (GEOMETRY == SPHERICAL) && (COMPONENTS == 3)
+                delta[iMPHI] /= FABS(sinx2(cj));
+                if constexpr(Phys::mhd) {
+                  delta[iBPHI] = -sgn / (rt(ci)*dx2(cj)) * dR[iBPHI];
+                }
+              #endif
+            }
+          #endif
+
+          // Rotation
+          if(haveRotation) {
+            real meanV = ZERO_F;
+            #if GEOMETRY == POLAR && DIMENSIONS >= 2
+              if(dir == IDIR) meanV = Omega*x1(ci);
+              const int meanDir = JDIR;
+            #elif GEOMETRY == SPHERICAL && DIMENSIONS == 3
+              if(dir == IDIR || dir == JDIR) meanV = Omega*x1(ci)*sinx2(cj);
+              const int meanDir = KDIR;
+            #else
+              const int meanDir = 0;
+            #endif
+            delta[MX1+meanDir] -= meanV*delta[RHO];
+            if constexpr(Phys::pressure) {
+              delta[ENG] -= meanV * (HALF_F*meanV*delta[RHO] + delta[MX1+meanDir]);
+            }
+          }
+
+          // Work of the gravitational forces
+          if constexpr(Phys::pressure) {
+            const real dRho = dR[RHO]*invdV;
+            if(needPotential) {
+              int o[3] = {0, 0, 0};
+              o[dir] = 1;
+              const real dphi = - 1.0/12.0 * (
+                      - phiP(ck+2*o[KDIR],cj+2*o[JDIR],ci+2*o[IDIR])
+                      + 8.0 * phiP(ck+o[KDIR],cj+o[JDIR],ci+o[IDIR])
+                      - 8.0 * phiP(ck-o[KDIR],cj-o[JDIR],ci-o[IDIR])
+                      + phiP(ck-2*o[KDIR],cj-2*o[JDIR],ci-2*o[IDIR]));
+              delta[ENG] += HALF_F * dRho * dphi;
+            }
+            if(needBodyForce) {
+              real dl = (dir == IDIR) ? dx1(ci) : ((dir == JDIR) ? dx2(cj) : dx3(ck));
+              #if GEOMETRY == POLAR
+                if(dir == JDIR) dl = dl*x1(ci);
+              #elif GEOMETRY == SPHERICAL
+                if(dir == JDIR) {
+                  dl = dl*rt(ci);
+                } else if(dir == KDIR) {
+                  dl = dl*rt(ci)*dmu(cj)/dx2(cj);
+                }
+              #endif
+              delta[ENG] += HALF_F * dl * dRho * bodyForce(dir,ck,cj,ci);
+            }
+          }
+
+          for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+            // The field components evolved by CT are corrected with the EMFs
+            if constexpr(Phys::mhd) {
+              if(D_EXPAND(nv == BX1, || nv == BX2, || nv == BX3)) continue;
+            }
+            Uc(nv,ck,cj,ci) += delta[nv];
+          }
+          // Passive tracers
+          for(int nv = Phys::nvar ; nv < nvar ; nv++) {
+            Uc(nv,ck,cj,ci) += -sgn*invdV*(Rf(nv,k,j,i) - Rc(nv,k,j,i));
+          }
+        });
+    }
+  }
+  idfx::popRegion();
+}
+
+// Replace the conservative variables of the coarse cells of the region by the average of the
+// fine cells
+template <typename Phys>
+void StaticRefinement::RestrictFlow(Fluid<Phys> *coarseFluid, Fluid<Phys> *fineFluid) {
+  idfx::pushRegion("StaticRefinement::RestrictFlow");
+  IdefixArray4D<realStore> Uc = coarseFluid->Uc;
+  IdefixArray4D<realStore> UcFine = fineFluid->Uc;
+  IdefixArray3D<real> dV = coarse->dV;
+  IdefixArray1D<real> x1 = coarse->x[IDIR];
+  IdefixArray1D<real> dx1 = coarse->dx[IDIR];
+  IdefixArray1D<real> dx2 = coarse->dx[JDIR];
+  IdefixArray1D<real> sinx2 = coarse->sinx2;
+  IdefixArray3D<real> dVFine = fine->dV;
+  IdefixArray1D<real> x1Fine = fine->x[IDIR];
+  IdefixArray1D<real> dx1Fine = fine->dx[IDIR];
+  IdefixArray1D<real> dx2Fine = fine->dx[JDIR];
+  IdefixArray1D<real> sinx2Fine = fine->sinx2;
+  const int lo[3] = {this->lo[IDIR], this->lo[JDIR], this->lo[KDIR]};
+  const int beg[3] = {fine->beg[IDIR], fine->beg[JDIR], fine->beg[KDIR]};
+
+  idefix_for("StaticRefinement::RestrictFlow",
+             0, Uc.extent(0),
+             lo[KDIR], hi[KDIR],
+             lo[JDIR], hi[JDIR],
+             lo[IDIR], hi[IDIR],
+    KOKKOS_LAMBDA (int n, int k, int j, int i) {
+      const int c[3] = {i, j, k};
+      int f[3];
+      int r[3];
+      for(int d = 0 ; d < 3 ; d++) {
+        f[d] = (d < DIMENSIONS) ? beg[d] + 2*(c[d]-lo[d]) : c[d];
+        r[d] = (d < DIMENSIONS) ? 2 : 1;
+      }
+      real sum = ZERO_F;
+      for(int fk = f[KDIR] ; fk < f[KDIR]+r[KDIR] ; fk++) {
+        for(int fj = f[JDIR] ; fj < f[JDIR]+r[JDIR] ; fj++) {
+          for(int fi = f[IDIR] ; fi < f[IDIR]+r[IDIR] ; fi++) {
+            sum += Refinement_Weight<Phys>(n, fk, fj, fi, dVFine, x1Fine, dx1Fine, dx2Fine,
+                                           sinx2Fine) * UcFine(n,fk,fj,fi);
+          }
+        }
+      }
+      Uc(n,k,j,i) = sum / Refinement_Weight<Phys>(n, k, j, i, dV, x1, dx1, dx2, sinx2);
+    });
+  idfx::popRegion();
+}
+
+// Interpolate the primitive variables of the coarse level (combined in time) in the ghost zones
+// of the fine level at its edges, with minmod slopes
+template <typename Phys>
+void StaticRefinement::ProlongFlow(Fluid<Phys> *coarseFluid, Fluid<Phys> *fineFluid,
+                                   IdefixArray4D<realStore> VcOld, real w) {
+  idfx::pushRegion("StaticRefinement::ProlongFlow");
+  IdefixArray4D<realStore> VcNew = coarseFluid->Vc;
+  IdefixArray4D<realStore> Vc = fineFluid->Vc;
+  IdefixArray1D<real> x1 = coarse->x[IDIR];
+  IdefixArray1D<real> x2 = coarse->x[JDIR];
+  IdefixArray1D<real> x3 = coarse->x[KDIR];
+  IdefixArray1D<real> x1Fine = fine->x[IDIR];
+  IdefixArray1D<real> x2Fine = fine->x[JDIR];
+  IdefixArray1D<real> x3Fine = fine->x[KDIR];
+  const int lo[3] = {this->lo[IDIR], this->lo[JDIR], this->lo[KDIR]};
+  const int beg[3] = {fine->beg[IDIR], fine->beg[JDIR], fine->beg[KDIR]};
+
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    for(int side = 0 ; side < 2 ; side++) {
+      if(!refinedSide[dir][side]) continue;
+      // Fine cells to fill
+      int b[3] = {0, 0, 0};
+      int e[3] = {fine->np_tot[IDIR], fine->np_tot[JDIR], fine->np_tot[KDIR]};
+      if(side == 0) {
+        e[dir] = fine->beg[dir];
+      } else {
+        b[dir] = fine->end[dir];
+      }
+      idefix_for("StaticRefinement::ProlongFlow",
+                 0, Vc.extent(0),
+                 b[KDIR], e[KDIR],
+                 b[JDIR], e[JDIR],
+                 b[IDIR], e[IDIR],
+        KOKKOS_LAMBDA (int n, int k, int j, int i) {
+          const int f[3] = {i, j, k};
+          int c[3];
+          for(int d = 0 ; d < 3 ; d++) {
+            c[d] = (d < DIMENSIONS) ? lo[d] + (f[d]+beg[d])/2 - beg[d] : f[d];
+          }
+          const real w0 = ONE_F - w;
+          const real v = w0*VcOld(n,c[KDIR],c[JDIR],c[IDIR]) + w*VcNew(n,c[KDIR],c[JDIR],c[IDIR]);
+          real vf = v;
+          for(int d = 0 ; d < DIMENSIONS ; d++) {
+            int o[3] = {0, 0, 0};
+            o[d] = 1;
+            const int km = c[KDIR]-o[KDIR], jm = c[JDIR]-o[JDIR], im = c[IDIR]-o[IDIR];
+            const int kp = c[KDIR]+o[KDIR], jp = c[JDIR]+o[JDIR], ip = c[IDIR]+o[IDIR];
+            const real vm = w0*VcOld(n,km,jm,im) + w*VcNew(n,km,jm,im);
+            const real vp = w0*VcOld(n,kp,jp,ip) + w*VcNew(n,kp,jp,ip);
+            const IdefixArray1D<real> &x = (d == IDIR) ? x1 : ((d == JDIR) ? x2 : x3);
+            const IdefixArray1D<real> &xFine = (d == IDIR) ? x1Fine : ((d == JDIR) ? x2Fine
+                                                                                  : x3Fine);
+            const real slope = Refinement_MinMod((v - vm)/(x(c[d]) - x(c[d]-1)),
+                                                 (vp - v)/(x(c[d]+1) - x(c[d])));
+            vf += slope*(xFine(f[d]) - x(c[d]));
+          }
+          Vc(n,k,j,i) = vf;
+        });
+    }
+  }
+  idfx::popRegion();
+}
+
+#if MHD == YES
+void StaticRefinement::ProlongMagField(real w) {
+  idfx::pushRegion("StaticRefinement::ProlongMagField");
+  Refinement_ProlongMagFieldFunctor prolong(coarse, fine.get(), VsOld, w);
+  int b[3];
+  int e[3];
+  for(int d = 0 ; d < 3 ; d++) {
+    // Coarse cells covering the fine level and its ghost zones
+    const int nc = (d < DIMENSIONS) ? (fine->nghost[d]+1)/2 : 0;
+    prolong.lo[d] = lo[d];
+    b[d] = lo[d] - nc;
+    e[d] = hi[d] + nc;
+    prolong.last[d] = e[d];
+  }
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    for(int side = 0 ; side < 2 ; side++) {
+      if(!refinedSide[dir][side]) continue;
+      int bs[3] = {b[IDIR], b[JDIR], b[KDIR]};
+      int es[3] = {e[IDIR], e[JDIR], e[KDIR]};
+      if(side == 0) {
+        es[dir] = lo[dir];
+        prolong.edgeCell = lo[dir];
+        prolong.edgeFace = fine->beg[dir];
+      } else {
+        bs[dir] = hi[dir];
+        prolong.edgeCell = hi[dir];
+        prolong.edgeFace = fine->end[dir];
+      }
+      prolong.dir = dir;
+      prolong.last[dir] = es[dir];
+      idefix_for("StaticRefinement::ProlongMagField",
+                 bs[KDIR], es[KDIR], bs[JDIR], es[JDIR], bs[IDIR], es[IDIR], prolong);
+      prolong.last[dir] = e[dir];
+    }
+  }
+  idfx::popRegion();
+}
+
+// Replace the magnetic field of the coarse faces of the region by the average of the fine faces
+void StaticRefinement::RestrictMagField() {
+  idfx::pushRegion("StaticRefinement::RestrictMagField");
+  IdefixArray4D<real> Vs = coarse->hydro->Vs;
+  IdefixArray4D<real> VsFine = fine->hydro->Vs;
+  const int lo[3] = {this->lo[IDIR], this->lo[JDIR], this->lo[KDIR]};
+  const int beg[3] = {fine->beg[IDIR], fine->beg[JDIR], fine->beg[KDIR]};
+  for(int c = 0 ; c < DIMENSIONS ; c++) {
+    IdefixArray3D<real> A = coarse->A[c];
+    IdefixArray3D<real> AFine = fine->A[c];
+    int r[3];
+    int e[3] = {hi[IDIR], hi[JDIR], hi[KDIR]};
+    for(int d = 0 ; d < 3 ; d++) r[d] = (d < DIMENSIONS && d != c) ? 2 : 1;
+    e[c]++;
+    idefix_for("StaticRefinement::RestrictMagField",
+               lo[KDIR], e[KDIR],
+               lo[JDIR], e[JDIR],
+               lo[IDIR], e[IDIR],
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        const int cf[3] = {i, j, k};
+        int f[3];
+        for(int d = 0 ; d < 3 ; d++) {
+          f[d] = (d < DIMENSIONS) ? beg[d] + 2*(cf[d]-lo[d]) : cf[d];
+        }
+        real sum = ZERO_F;
+        for(int fk = f[KDIR] ; fk < f[KDIR]+r[KDIR] ; fk++) {
+          for(int fj = f[JDIR] ; fj < f[JDIR]+r[JDIR] ; fj++) {
+            for(int fi = f[IDIR] ; fi < f[IDIR]+r[IDIR] ; fi++) {
+              sum += AFine(fk,fj,fi)*VsFine(c,fk,fj,fi);
+            }
+          }
+        }
+        Vs(c,k,j,i) = sum / A(k,j,i);
+      });
+  }
+  idfx::popRegion();
+}
+
+// Correct the coarse faces around the region with the difference between the EMFs of the fine
+// and coarse levels on its edges (integrated over the step)
+void StaticRefinement::CorrectEMF() {
+  idfx::pushRegion("StaticRefinement::CorrectEMF");
+  ConstrainedTransport<DefaultPhysics> *emf = coarse->hydro->emf.get();
+  FluxRegister<DefaultPhysics> *regCoarse = coarse->hydro->fluxRegisters[coarseRegister].get();
+  FluxRegister<DefaultPhysics> *regFine = fine->hydro->fluxRegisters[fineRegister].get();
+  const int lo[3] = {this->lo[IDIR], this->lo[JDIR], this->lo[KDIR]};
+  for(int c = 0 ; c < 3 ; c++) {
+    if(!regCoarse->emf[c].is_allocated()) continue;
+    IdefixArray3D<real> E = (c == IDIR) ? emf->ex : ((c == JDIR) ? emf->ey : emf->ez);
+    IdefixArray4D<real> Ec = regCoarse->emf[c];
+    IdefixArray4D<real> Ef = regFine->emf[c];
+    Kokkos::deep_copy(E, ZERO_F);
+    idefix_for("StaticRefinement::CorrectEMF",
+               0, Ec.extent(1),
+               0, Ec.extent(2),
+               0, Ec.extent(3),
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        E(lo[KDIR]+k, lo[JDIR]+j, lo[IDIR]+i) = Ef(0,k,j,i) - Ec(0,k,j,i);
+      });
+  }
+  // Apply the time-integrated EMF corrections (hence dt=1)
+  emf->EvolveMagField(coarse->t, ONE_F, coarse->hydro->Vs);
+  idfx::popRegion();
+}
+#endif // MHD
+
+void StaticRefinement::ProlongBoundaries(real t) {
+  idfx::pushRegion("StaticRefinement::ProlongBoundaries");
+  // Time interpolation between the beginning and the end of the coarse step
+  real w = ONE_F;
+  if(dt > ZERO_F) w = std::fmin(ONE_F, std::fmax(ZERO_F, (t-t0)/dt));
+  ForEachFluid([&](auto *coarseFluid, auto *fineFluid, int n) {
+    ProlongFlow(coarseFluid, fineFluid, VcOld[n], w);
+  });
+  #if MHD == YES
+    ProlongMagField(w);
+    fine->hydro->boundary->ReconstructVcField(fine->hydro->Vc);
+  #endif
+  idfx::popRegion();
+}
+
+void StaticRefinement::InitializeLevels() {
+  if(!fine) return;
+  idfx::pushRegion("StaticRefinement::InitializeLevels");
+  this->t0 = coarse->t;
+  this->dt = ZERO_F;
+  fine->t = coarse->t;
+  fine->dt = coarse->dt;
+  // The coarse level is made consistent with the initial conditions of the fine levels
+  if(fine->haveRefinement) fine->refinement->InitializeLevels();
+  fine->PrimToCons();
+  coarse->PrimToCons();
+  Restrict();
+  ForEachFluid([&](auto *coarseFluid, auto *fineFluid, int n) {
+    Kokkos::deep_copy(VcOld[n], coarseFluid->Vc);
+  });
+  #if MHD == YES
+    Kokkos::deep_copy(VsOld, coarse->hydro->Vs);
+  #endif
+  idfx::popRegion();
+}
+
+void StaticRefinement::WriteVtk() {
+  if(!fine) return;
+  // Same number as the file of the coarse level, which has just been written
+  fine->vtk->vtkFileNumber = coarse->vtk->vtkFileNumber - 1;
+  fine->vtk->Write();
+  if(fine->haveRefinement) fine->refinement->WriteVtk();
+}
+
+void StaticRefinement::ShowConfig() {
+  idfx::cout << "StaticRefinement: level " << grid->level << " spans ";
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(dir > 0) idfx::cout << " x ";
+    idfx::cout << "[" << grid->xbeg[dir] << "," << grid->xend[dir] << "]";
+  }
+  idfx::cout << " with ";
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(dir > 0) idfx::cout << "x";
+    idfx::cout << grid->np_int[dir];
+  }
+  idfx::cout << " points, subcycled twice per step of level " << grid->level-1 << "."
+             << std::endl;
+  if(fine && fine->haveRefinement) fine->refinement->ShowConfig();
+}
@@ -0,0 +1,86 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef DATABLOCK_REFINEMENT_HPP_
+#define DATABLOCK_REFINEMENT_HPP_
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "idefix.hpp"
+#include "input.hpp"
+#include "grid.hpp"
+
+// Forward class declaration
+class DataBlock;
+class TimeIntegrator;
+template <typename Phys> class Fluid;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Static mesh refinement: a region of the domain of a DataBlock (the coarse level), fixed in time,
+/// is covered by a finer level, twice as resolved along each dimension, which is itself a
+/// DataBlock (with its own Grid, fluids, outputs and refinement if more levels are requested).
+/// The fine level is evolved with two substeps per step of the coarse level. Its ghost zones at the
+/// edges of the region are interpolated in space and time from the coarse level (with a
+/// divergence-free prolongation of the face-centered magnetic field). Once the fine level has
+/// caught up, the coarse cells of the region are replaced by the average of the fine cells, and
+/// the coarse cells around the region are corrected with the fluxes and EMFs of the fine level
+/// (reflux), so that the total mass, momentum, energy and magnetic flux are conserved.
+/// Refined levels are not written in restart dumps, so that restarts are refused when the
+/// refinement is enabled.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+class StaticRefinement {
+ public:
+  StaticRefinement(Input &, DataBlock *);
+  ~StaticRefinement();
+
+  void StartStep();                   ///< Save the coarse level at the beginning of its step
+  void Advance(real, real);           ///< Evolve the fine level by a step of the coarse level
+  void ProlongBoundaries(real);       ///< Interpolate the ghost zones of the fine level
+  void InitializeLevels();            ///< Make the levels consistent with the initial conditions
+  void WriteVtk();                    ///< Write the vtk files of the refined levels
+  void ShowConfig();
+
+  std::unique_ptr<Grid> grid;         ///< Grid of the fine level
+  std::unique_ptr<DataBlock> fine;    ///< Fine level (null if this proc holds no part of it)
+
+  /// Largest stable timestep of the coarse level imposed by the fine level (twice the stable
+  /// timestep of the fine level)
+  real dtEstimate;
+
+ private:
+  template <typename F> void ForEachFluid(F);  // call F(coarse fluid, fine fluid, index)
+  template <typename Phys> void AddRegisters(Fluid<Phys> *, Fluid<Phys> *,
+                                             const std::array<int,3> &, const std::array<int,3> &);
+  template <typename Phys> void Reflux(Fluid<Phys> *, Fluid<Phys> *);
+  template <typename Phys> void RestrictFlow(Fluid<Phys> *, Fluid<Phys> *);
+  template <typename Phys> void ProlongFlow(Fluid<Phys> *, Fluid<Phys> *,
+                                            IdefixArray4D<realStore>, real);
+  void CorrectEMF();                  // Correct the magnetic field around the region
+  void RestrictMagField();            // Average the fine magnetic field on the coarse faces
+  void ProlongMagField(real);         // Divergence-free interpolation of the magnetic field
+  void Restrict();                    // Replace the coarse level by the fine one in the region
+
+  DataBlock *coarse;                  // Coarse level
+  std::unique_ptr<TimeIntegrator> integrator;   // Integrator of the fine level
+
+  std::array<int,3> patchBeg;         // Region, in active cells of the coarse grid (from 0)
+  std::array<int,3> patchEnd;
+  std::array<int,3> lo;               // Part of the region held by this proc, in local indices
+  std::array<int,3> hi;               // of the coarse level ([lo,hi) cells)
+  std::array<std::array<bool,2>,3> refinedSide;  // Whether each side of [lo,hi) is an edge of
+                                                 // the fine level
+  int coarseRegister;                 // Index of the flux registers of this refinement in
+  int fineRegister;                   // Fluid::fluxRegisters of the coarse and fine fluids
+
+  std::vector<IdefixArray4D<realStore>> VcOld;   // Coarse Vc of each fluid at the beginning
+  IdefixArray4D<real> VsOld;                     // and Vs, for the time interpolation
+  real t0{0};                         // Beginning and timestep of the current coarse step
+  real dt{0};
+};
+
+#endif // DATABLOCK_REFINEMENT_HPP_
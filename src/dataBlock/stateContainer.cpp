@@ -16,7 +16,7 @@ StateContainer::StateContainer() {
   // do nothing
 }
 
-void StateContainer::CopyFrom(StateContainer &in) {
+void StateContainer::CopyFrom(StateContainer &in, const std::vector<std::string> &exclude) {
   idfx::pushRegion("StateContainer::CopyFrom");
   // Make a deep copy from in
   if(in.stateVector.size() != this->stateVector.size()) {
@@ -27,8 +27,15 @@ void StateContainer::CopyFrom(StateContainer &in) {
     if(this->stateVector[s].type != in.stateVector[s].type) {
       IDEFIX_ERROR("Cannot copy from a stateContainer with different types");
     }
+    if(std::find(exclude.begin(), exclude.end(), in.stateVector[s].name) != exclude.end()) {
+      continue;
+    }
     if(this->stateVector[s].type == State::idefixArray4D) {
       Kokkos::deep_copy(this->stateVector[s].array, in.stateVector[s].array);
+    #ifdef MIXED_PRECISION
+    } else if(this->stateVector[s].type == State::idefixArray4DStore) {
+      Kokkos::deep_copy(this->stateVector[s].arrayStore, in.stateVector[s].arrayStore);
+    #endif
     } else {
       IDEFIX_ERROR("Cannot copy states which are undefined");
     }
@@ -49,6 +56,14 @@ void StateContainer::AllocateAs(StateContainer &in) {
                                                               stateIn.array.extent(1),
                                                               stateIn.array.extent(2),
                                                               stateIn.array.extent(3));
+    #ifdef MIXED_PRECISION
+    } else if(stateIn.type == State::idefixArray4DStore) {
+      stateOut.arrayStore = IdefixArray4D<realStore>(stateIn.name,
+                                                     stateIn.arrayStore.extent(0),
+                                                     stateIn.arrayStore.extent(1),
+                                                     stateIn.arrayStore.extent(2),
+                                                     stateIn.arrayStore.extent(3));
+    #endif
     } else {
       IDEFIX_ERROR("Cannot allocate a state with type none");
     }
@@ -71,8 +86,33 @@ void StateContainer::PushArray(IdefixArray4D<real>& in,
   idfx::popRegion();
 }
 
+#ifdef MIXED_PRECISION
+void StateContainer::PushArray(IdefixArray4D<realStore>& in,
+                               State::TypeLocation loc,
+                               std::string name) {
+  idfx::pushRegion("StateContainer::PushArray");
+  State state;
+  state.arrayStore = in;
+  state.type = State::idefixArray4DStore;
+  state.name = name;
+  state.location = loc;
+  this->stateVector.push_back(state);
+  idfx::popRegion();
+}
+#endif
 
-void StateContainer::AddAndStore(const real wl, const real wr, StateContainer & in) {
+void StateContainer::PushStates(StateContainer &in, const std::string &prefix) {
+  idfx::pushRegion("StateContainer::PushStates");
+  for(State state : in.stateVector) {
+    // Shallow copy: the arrays are shared with in
+    state.name = prefix + state.name;
+    this->stateVector.push_back(state);
+  }
+  idfx::popRegion();
+}
+
+void StateContainer::AddAndStore(const real wl, const real wr, StateContainer & in,
+                                 const std::vector<std::string> &exclude) {
   idfx::pushRegion("StateContainer::AddAndStore");
 
   if(in.stateVector.size() != this->stateVector.size()) {
@@ -85,6 +125,9 @@ void StateContainer::AddAndStore(const real wl, const real wr, StateContainer &
     if(stateIn.type != stateOut.type) {
       IDEFIX_ERROR("Cannot add and store states of different type");
     }
+    if(std::find(exclude.begin(), exclude.end(), stateIn.name) != exclude.end()) {
+      continue;
+    }
     if(stateIn.type == State::idefixArray4D) {
       auto Vin = stateIn.array;
       auto Vout = stateOut.array;
@@ -96,6 +139,77 @@ void StateContainer::AddAndStore(const real wl, const real wr, StateContainer &
                   KOKKOS_LAMBDA(int n, int k, int j, int i) {
                     Vout(n,k,j,i) = wl * Vout(n,k,j,i) + wr * Vin(n,k,j,i);
                   } );
+    #ifdef MIXED_PRECISION
+    } else if(stateIn.type == State::idefixArray4DStore) {
+      auto Vin = stateIn.arrayStore;
+      auto Vout = stateOut.arrayStore;
+      idefix_for("StateContainer::AddAndStore",
+                  0, Vin.extent(0),
+                  0, Vin.extent(1),
+                  0, Vin.extent(2),
+                  0, Vin.extent(3),
+                  KOKKOS_LAMBDA(int n, int k, int j, int i) {
+                    // combination computed in double precision, then stored
+                    Vout(n,k,j,i) = wl * static_cast<real>(Vout(n,k,j,i))
+                                    + wr * static_cast<real>(Vin(n,k,j,i));
+                  } );
+    #endif
+    } else {
+      IDEFIX_ERROR("Cannot Add and store from state of unknown type");
+    }
+  }
+  idfx::popRegion();
+}
+
+void StateContainer::AddAndStore(const real wl, const real wr, StateContainer & in,
+                                 const real wlIn, const real wrIn,
+                                 const std::vector<std::string> &exclude) {
+  idfx::pushRegion("StateContainer::AddAndStore");
+
+  if(in.stateVector.size() != this->stateVector.size()) {
+    IDEFIX_ERROR("You cannot add two state containers of different sizes.");
+  }
+  for(int s = 0 ; s < this->stateVector.size() ; s++) {
+    State stateIn = in.stateVector[s];
+    State stateOut = this->stateVector[s];
+
+    if(stateIn.type != stateOut.type) {
+      IDEFIX_ERROR("Cannot add and store states of different type");
+    }
+    if(std::find(exclude.begin(), exclude.end(), stateIn.name) != exclude.end()) {
+      continue;
+    }
+    if(stateIn.type == State::idefixArray4D) {
+      auto Vin = stateIn.array;
+      auto Vout = stateOut.array;
+      idefix_for("StateContainer::AddAndStore2",
+                  0, Vin.extent(0),
+                  0, Vin.extent(1),
+                  0, Vin.extent(2),
+                  0, Vin.extent(3),
+                  KOKKOS_LAMBDA(int n, int k, int j, int i) {
+                    const real q = Vout(n,k,j,i);
+                    const real qIn = wlIn * Vin(n,k,j,i) + wrIn * q;
+                    Vin(n,k,j,i) = qIn;
+                    Vout(n,k,j,i) = wl * q + wr * qIn;
+                  } );
+    #ifdef MIXED_PRECISION
+    } else if(stateIn.type == State::idefixArray4DStore) {
+      auto Vin = stateIn.arrayStore;
+      auto Vout = stateOut.arrayStore;
+      idefix_for("StateContainer::AddAndStore2",
+                  0, Vin.extent(0),
+                  0, Vin.extent(1),
+                  0, Vin.extent(2),
+                  0, Vin.extent(3),
+                  KOKKOS_LAMBDA(int n, int k, int j, int i) {
+                    // combinations computed in double precision, using the stored value of in
+                    const real q = Vout(n,k,j,i);
+                    const realStore qIn = wlIn * static_cast<real>(Vin(n,k,j,i)) + wrIn * q;
+                    Vin(n,k,j,i) = qIn;
+                    Vout(n,k,j,i) = wl * q + wr * static_cast<real>(qIn);
+                  } );
+    #endif
     } else {
       IDEFIX_ERROR("Cannot Add and store from state of unknown type");
     }
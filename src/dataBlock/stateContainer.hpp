@@ -15,10 +15,13 @@
 class State{
  public:
   enum TypeLocation{undefined, center, face, edge};
-  enum TypeState{none, idefixArray4D};
+  enum TypeState{none, idefixArray4D, idefixArray4DStore};
 
   TypeState type{none};           ///< type of data contained by this state
   IdefixArray4D<real> array;      ///< only defined if type==IdefixArray4D
+  #ifdef MIXED_PRECISION
+  IdefixArray4D<realStore> arrayStore;  ///< only defined if type==IdefixArray4DStore
+  #endif
   TypeLocation location{undefined};    ///< location of array when type==IdefixArray4D
                                        ///< (otherwise undefined)
   std::string name;               ///< Name of the full state (always applicable)
@@ -27,14 +30,46 @@ class State{
 class StateContainer {
  public:
   StateContainer();
-  void CopyFrom(StateContainer &);    // Return a deepcopy of the current state container
+  // Deep copy of in, excluding the states whose name is listed in exclude
+  void CopyFrom(StateContainer &, const std::vector<std::string> &exclude = {});
   void AllocateAs(StateContainer &);    // Return a deepcopy of the current state container
   void PushArray(IdefixArray4D<real> &, State::TypeLocation, std::string);
-  void AddAndStore(const real, const real, StateContainer&);
+  #ifdef MIXED_PRECISION
+  void PushArray(IdefixArray4D<realStore> &, State::TypeLocation, std::string);
+  #endif
+  // Reference the states of another container, prefixing their names
+  void PushStates(StateContainer &, const std::string &prefix);
+  void AddAndStore(const real, const real, StateContainer&,
+                   const std::vector<std::string> &exclude = {});
+  // Fused update of both registers, as required by low-storage Runge-Kutta schemes:
+  // in = wlIn*in + wrIn*this, then this = wl*this + wr*in (using the updated in)
+  void AddAndStore(const real wl, const real wr, StateContainer& in,
+                   const real wlIn, const real wrIn,
+                   const std::vector<std::string> &exclude = {});
 
+  // Array of the state called name
+  template<typename T>
+  IdefixArray4D<T> GetArray(const std::string &);
 
  private:
   std::vector<State> stateVector;
 };
 
+template<typename T>
+IdefixArray4D<T> StateContainer::GetArray(const std::string &name) {
+  for(State &state : stateVector) {
+    if(state.name != name) continue;
+    if constexpr(std::is_same<T,real>::value) {
+      if(state.type == State::idefixArray4D) return(state.array);
+    }
+    #ifdef MIXED_PRECISION
+    if constexpr(std::is_same<T,realStore>::value) {
+      if(state.type == State::idefixArray4DStore) return(state.arrayStore);
+    }
+    #endif
+  }
+  IDEFIX_ERROR("StateContainer: cannot find an array of the requested type named "+name);
+  return(IdefixArray4D<T>());
+}
+
 #endif // DATABLOCK_STATECONTAINER_HPP_
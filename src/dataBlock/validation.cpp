@@ -10,6 +10,12 @@
 
 int DataBlock::CheckNan() {
   idfx::pushRegion("DataBlock::Check");
+  if(haveBlocks) {
+    int nNans = 0;
+    for(auto &block : scheduler->blocks) nNans += block->CheckNan();
+    idfx::popRegion();
+    return(nNans);
+  }
   int nNans = hydro->CheckNan();
   if(haveDust) {
     for(int n = 0 ; n < dust.size() ; n++) {
@@ -20,6 +26,51 @@ int DataBlock::CheckNan() {
   return(nNans);
 }
 
+// Let the fluids count their Nans as a side effect of ConsToPrim and ComputeTimestep
+void DataBlock::EnableNanTracking() {
+  idfx::pushRegion("DataBlock::EnableNanTracking");
+  if(haveBlocks) {
+    for(auto &block : scheduler->blocks) block->EnableNanTracking();
+    idfx::popRegion();
+    return;
+  }
+  hydro->EnableNanTracking();
+  if(haveFusedDust) {
+    fusedDust->EnableNanTracking();
+  } else if(haveDust) {
+    for(int n = 0 ; n < dust.size() ; n++) {
+      dust[n]->EnableNanTracking();
+    }
+  }
+  idfx::popRegion();
+}
+
+// Total number of Nans found by the fluids of all of the processes since the tracking was enabled
+int DataBlock::GetTrackedNans() {
+  idfx::pushRegion("DataBlock::GetTrackedNans");
+  if(haveBlocks) {
+    // Each block already sums its Nans over all of the processes
+    int nNans = 0;
+    for(auto &block : scheduler->blocks) nNans += block->GetTrackedNans();
+    idfx::popRegion();
+    return(nNans);
+  }
+  int nNans = hydro->GetTrackedNans();
+  if(haveFusedDust) {
+    nNans += fusedDust->GetTrackedNans();
+  } else if(haveDust) {
+    for(int n = 0 ; n < dust.size() ; n++) {
+      nNans += dust[n]->GetTrackedNans();
+    }
+  }
+  #ifdef WITH_MPI
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, &nNans, 1, MPI_INT, MPI_SUM,
+                                mygrid->CartComm));
+  #endif
+  idfx::popRegion();
+  return(nNans);
+}
+
 void DataBlock::Validate() {
   idfx::pushRegion("DataBlock::Validate");
 
@@ -14,17 +14,71 @@
 #include "flux.hpp"
 #include "convertConsToPrim.hpp"
 
+// HLL flux of a pressureless dust fluid through an interface, from the primitive variables
+// on the left (vL) and right (vR) of the interface. Returns the maximum wave speed.
+template <typename Phys, const int DIR>
+KOKKOS_FORCEINLINE_FUNCTION real K_HllDust(real vL[], real vR[], real flux[]) {
+  constexpr int Xn = DIR+MX1;
+
+  // Conservative variables
+  real uL[Phys::nvar];
+  real uR[Phys::nvar];
+
+  // Flux (left and right)
+  real fluxL[Phys::nvar];
+  real fluxR[Phys::nvar];
+
+  // 2-- Get the wave speed
+
+  real SL = vL[Xn];
+  real SR = vR[Xn];
+
+  real cmax  = FMAX(FABS(SL), FABS(SR));
+
+  // 3-- Compute the conservative variables: do this by extrapolation
+  K_PrimToCons<Phys>(uL, vL, NULL); // Set gamma to 0 implicitly
+  K_PrimToCons<Phys>(uR, vR, NULL);
+
+  // 4-- Compute the left and right fluxes (wave speed is null)
+  K_Flux<Phys,DIR>(fluxL, vL, uL, 0);
+  K_Flux<Phys,DIR>(fluxR, vR, uR, 0);
+
+  // 5-- Compute the flux from the left and right states
+  if (SL > 0) {
+#pragma unroll
+    for (int nv = 0 ; nv < Phys::nvar; nv++) {
+      flux[nv] = fluxL[nv];
+    }
+  } else if (SR < 0) {
+#pragma unroll
+    for (int nv = 0 ; nv < Phys::nvar; nv++) {
+      flux[nv] = fluxR[nv];
+    }
+  } else {
+    real dS = SR-SL;
+    if(std::abs(dS) < SMALL_NUMBER) {
+      dS = SMALL_NUMBER;
+    }
+#pragma unroll
+    for(int nv = 0 ; nv < Phys::nvar; nv++) {
+      flux[nv] = SL*SR*uR[nv] - SL*SR*uL[nv] + SR*fluxL[nv] - SL*fluxR[nv];
+      flux[nv] /= dS;
+    }
+  }
+  return(cmax);
+}
+
 // Compute Riemann fluxes from states using HLL solver
 template <typename Phys>
 template<const int DIR>
-void RiemannSolver<Phys>::HllDust(IdefixArray4D<real> &Flux) {
+void RiemannSolver<Phys>::HllDust(IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("RiemannSolver::HLL_Dust");
 
   constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
   constexpr int joffset = (DIR==JDIR) ? 1 : 0;
   constexpr int koffset = (DIR==KDIR) ? 1 : 0;
 
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray3D<real> cMax = this->cMax;
 
   // Required for high order interpolations
@@ -33,66 +87,27 @@ void RiemannSolver<Phys>::HllDust(IdefixArray4D<real> &Flux) {
 
   ExtrapolateToFaces<Phys,DIR> extrapol = *this->GetExtrapolator<DIR>();
 
-  idefix_for("HLL_Kernel",
-             data->beg[KDIR],data->end[KDIR]+koffset,
-             data->beg[JDIR],data->end[JDIR]+joffset,
-             data->beg[IDIR],data->end[IDIR]+ioffset,
+  idefix_for_tiled<DIR>("HLL_Kernel",
+                        hydro->updateBeg[KDIR],hydro->updateEnd[KDIR]+koffset,
+                        hydro->updateBeg[JDIR],hydro->updateEnd[JDIR]+joffset,
+                        hydro->updateBeg[IDIR],hydro->updateEnd[IDIR]+ioffset,
     KOKKOS_LAMBDA (int k, int j, int i) {
-      // Init the directions (should be in the kernel for proper optimisation by the compilers)
-      constexpr int Xn = DIR+MX1;
-
       // Primitive variables
       real vL[Phys::nvar];
       real vR[Phys::nvar];
 
-      // Conservative variables
-      real uL[Phys::nvar];
-      real uR[Phys::nvar];
-
-      // Flux (left and right)
-      real fluxL[Phys::nvar];
-      real fluxR[Phys::nvar];
-
+      // Flux
+      real flux[Phys::nvar];
 
       // 1-- Store the primitive variables on the left, right, and averaged states
       extrapol.ExtrapolatePrimVar(i, j, k, vL, vR);
 
-      // 2-- Get the wave speed
+      // 2 to 5-- Compute the HLL flux
+      real cmax = K_HllDust<Phys,DIR>(vL, vR, flux);
 
-      real SL = vL[Xn];
-      real SR = vR[Xn];
-
-      real cmax  = FMAX(FABS(SL), FABS(SR));
-
-      // 3-- Compute the conservative variables: do this by extrapolation
-      K_PrimToCons<Phys>(uL, vL, NULL); // Set gamma to 0 implicitly
-      K_PrimToCons<Phys>(uR, vR, NULL);
-
-      // 4-- Compute the left and right fluxes (wave speed is null)
-      K_Flux<Phys,DIR>(fluxL, vL, uL, 0);
-      K_Flux<Phys,DIR>(fluxR, vR, uR, 0);
-
-      // 5-- Compute the flux from the left and right states
-      if (SL > 0) {
-#pragma unroll
-        for (int nv = 0 ; nv < Phys::nvar; nv++) {
-          Flux(nv,k,j,i) = fluxL[nv];
-        }
-      } else if (SR < 0) {
-#pragma unroll
-        for (int nv = 0 ; nv < Phys::nvar; nv++) {
-          Flux(nv,k,j,i) = fluxR[nv];
-        }
-      } else {
-        real dS = SR-SL;
-        if(std::abs(dS) < SMALL_NUMBER) {
-          dS = SMALL_NUMBER;
-        }
 #pragma unroll
-        for(int nv = 0 ; nv < Phys::nvar; nv++) {
-          Flux(nv,k,j,i) = SL*SR*uR[nv] - SL*SR*uL[nv] + SR*fluxL[nv] - SL*fluxR[nv];
-          Flux(nv,k,j,i) /= dS;
-        }
+      for (int nv = 0 ; nv < Phys::nvar; nv++) {
+        Flux(nv,k,j,i) = flux[nv];
       }
 
       //6-- Compute maximum wave speed for this sweep
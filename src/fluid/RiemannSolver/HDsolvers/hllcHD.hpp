@@ -14,148 +14,170 @@
 #include "flux.hpp"
 #include "convertConsToPrim.hpp"
 
-// Compute Riemann fluxes from states using HLLC solver
-template <typename Phys>
-template<const int DIR>
-void RiemannSolver<Phys>::HllcHD(IdefixArray4D<real> &Flux) {
-  idfx::pushRegion("RiemannSolver::HLLC_Solver");
-
-  constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
-  constexpr int joffset = (DIR==JDIR) ? 1 : 0;
-  constexpr int koffset = (DIR==KDIR) ? 1 : 0;
-
-  IdefixArray4D<real> Vc = this->Vc;
-  IdefixArray4D<real> Vs = this->Vs;
-  IdefixArray3D<real> cMax = this->cMax;
-
-  EquationOfState eos = *(hydro->eos.get());
-
-  ExtrapolateToFaces<Phys,DIR> extrapol = *this->GetExtrapolator<DIR>();
-
-  idefix_for("HLLC_Kernel",
-             data->beg[KDIR],data->end[KDIR]+koffset,
-             data->beg[JDIR],data->end[JDIR]+joffset,
-             data->beg[IDIR],data->end[IDIR]+ioffset,
-    KOKKOS_LAMBDA (int k, int j, int i) {
-      // Init the directions (should be in the kernel for proper optimisation by the compilers)
-      EXPAND( constexpr int Xn = DIR+MX1;                    ,
-              constexpr int Xt = (DIR == IDIR ? MX2 : MX1);  ,
-              constexpr int Xb = (DIR == KDIR ? MX2 : MX3);  )
-
-      // Primitive variables
-      real vL[Phys::nvar];
-      real vR[Phys::nvar];
-
-      // Conservative variables
-      real uL[Phys::nvar];
-      real uR[Phys::nvar];
-
-      // Flux (left and right)
-      real fluxL[Phys::nvar];
-      real fluxR[Phys::nvar];
-
-      // Signal speeds
-      real cL, cR, cmax;
-
-      // 1-- Store the primitive variables on the left, right, and averaged states
-      extrapol.ExtrapolatePrimVar(i, j, k, vL, vR);
-
-      // 2-- Get the wave speed
-      #if HAVE_ENERGY
-        cL = std::sqrt(eos.GetGamma(vL[PRS],vL[RHO])*(vL[PRS]/vL[RHO]));
-        cR = std::sqrt(eos.GetGamma(vR[PRS],vR[RHO])*(vR[PRS]/vR[RHO]));
-      #else
-        cL = HALF_F*(eos.GetWaveSpeed(k,j,i)
-                    +eos.GetWaveSpeed(k-koffset,j-joffset,i-ioffset));
-        cR = cL;
-      #endif
+// Compute the HLLC flux at interface (k,j,i) in direction DIR
+template <typename Phys, int DIR>
+struct HllcHD_FluxFunctor {
+  HllcHD_FluxFunctor(const ExtrapolateToFaces<Phys,DIR> &extrapol,
+                     const EquationOfState &eos): extrapol(extrapol), eos(eos) {}
+
+  ExtrapolateToFaces<Phys,DIR> extrapol;
+  EquationOfState eos;
+
+  KOKKOS_INLINE_FUNCTION void operator() (const int k, const int j, const int i,
+                                          real flux[], real &cmax) const {
+    // Init the directions (should be in the kernel for proper optimisation by the compilers)
+    EXPAND( constexpr int Xn = DIR+MX1;                    ,
+            constexpr int Xt = (DIR == IDIR ? MX2 : MX1);  ,
+            constexpr int Xb = (DIR == KDIR ? MX2 : MX3);  )
+
+    // Primitive variables
+    real vL[Phys::nvar];
+    real vR[Phys::nvar];
+
+    // Conservative variables
+    real uL[Phys::nvar];
+    real uR[Phys::nvar];
+
+    // Flux (left and right)
+    real fluxL[Phys::nvar];
+    real fluxR[Phys::nvar];
+
+    // Signal speeds
+    real cL, cR;
+
+    // 1-- Store the primitive variables on the left, right, and averaged states
+    extrapol.ExtrapolatePrimVar(i, j, k, vL, vR);
+
+    // 2-- Get the wave speed
+    #if HAVE_ENERGY
+      cL = std::sqrt(eos.GetGamma(vL[PRS],vL[RHO])*(vL[PRS]/vL[RHO]));
+      cR = std::sqrt(eos.GetGamma(vR[PRS],vR[RHO])*(vR[PRS]/vR[RHO]));
+    #else
+      constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
+      constexpr int joffset = (DIR==JDIR) ? 1 : 0;
+      constexpr int koffset = (DIR==KDIR) ? 1 : 0;
+      cL = HALF_F*(eos.GetWaveSpeed(k,j,i)
+                  +eos.GetWaveSpeed(k-koffset,j-joffset,i-ioffset));
+      cR = cL;
+    #endif
+
+    real cminL = vL[Xn] - cL;
+    real cmaxL = vL[Xn] + cL;
+
+    real cminR = vR[Xn] - cR;
+    real cmaxR = vR[Xn] + cR;
+
+    real SL = FMIN(cminL, cminR);
+    real SR = FMAX(cmaxL, cmaxR);
+
+    cmax  = FMAX(FABS(SL), FABS(SR));
+
+    // 3-- Compute the conservative variables
+    K_PrimToCons<Phys>(uL, vL, &eos);
+    K_PrimToCons<Phys>(uR, vR, &eos);
+
+    // 4-- Compute the left and right fluxes
+    K_Flux<Phys,DIR>(fluxL, vL, uL, cL*cL);
+    K_Flux<Phys,DIR>(fluxR, vR, uR, cR*cR);
+
+    // 5-- Compute the flux from the left and right states
+    if (SL > 0) {
+#pragma unroll
+      for (int nv = 0 ; nv < Phys::nvar; nv++) {
+        flux[nv] = fluxL[nv];
+      }
+    } else if (SR < 0) {
+#pragma unroll
+      for (int nv = 0 ; nv < Phys::nvar; nv++) {
+        flux[nv] = fluxR[nv];
+      }
+    } else {
+      real usL[Phys::nvar];
+      real usR[Phys::nvar];
+      real vs;
 
-      real cminL = vL[Xn] - cL;
-      real cmaxL = vL[Xn] + cL;
+#if HAVE_ENERGY
+      real qL, qR, wL, wR;
+      qL = vL[PRS] + uL[Xn]*(vL[Xn] - SL);
+      qR = vR[PRS] + uR[Xn]*(vR[Xn] - SR);
 
-      real cminR = vR[Xn] - cR;
-      real cmaxR = vR[Xn] + cR;
+      wL = vL[RHO]*(vL[Xn] - SL);
+      wR = vR[RHO]*(vR[Xn] - SR);
 
-      real SL = FMIN(cminL, cminR);
-      real SR = FMAX(cmaxL, cmaxR);
+      vs = (qR - qL)/(wR - wL); // wR - wL > 0 since SL < 0, SR > 0
 
-      cmax  = FMAX(FABS(SL), FABS(SR));
+      usL[RHO] = uL[RHO]*(SL - vL[Xn])/(SL - vs);
+      usR[RHO] = uR[RHO]*(SR - vR[Xn])/(SR - vs);
+      EXPAND(usL[Xn] = usL[RHO]*vs;     usR[Xn] = usR[RHO]*vs;      ,
+              usL[Xt] = usL[RHO]*vL[Xt]; usR[Xt] = usR[RHO]*vR[Xt];  ,
+              usL[Xb] = usL[RHO]*vL[Xb]; usR[Xb] = usR[RHO]*vR[Xb];)
 
-      // 3-- Compute the conservative variables
-      K_PrimToCons<Phys>(uL, vL, &eos);
-      K_PrimToCons<Phys>(uR, vR, &eos);
+      usL[ENG] =    uL[ENG]/vL[RHO]
+                  + (vs - vL[Xn])*(vs + vL[PRS]/(vL[RHO]*(SL - vL[Xn])));
+      usR[ENG] =    uR[ENG]/vR[RHO]
+                  + (vs - vR[Xn])*(vs + vR[PRS]/(vR[RHO]*(SR - vR[Xn])));
 
-      // 4-- Compute the left and right fluxes
-      K_Flux<Phys,DIR>(fluxL, vL, uL, cL*cL);
-      K_Flux<Phys,DIR>(fluxR, vR, uR, cR*cR);
+      usL[ENG] *= usL[RHO];
+      usR[ENG] *= usR[RHO];
+#else
+      real scrh = 1.0/(SR - SL);
+      real rho  = (SR*uR[RHO] - SL*uL[RHO] - fluxR[RHO] + fluxL[RHO])*scrh;
+      real mx   = (SR*uR[Xn] - SL*uL[Xn] - fluxR[Xn] + fluxL[Xn])*scrh;
+
+      usL[RHO] = usR[RHO] = rho;
+      usL[Xn] = usR[Xn] = mx;
+      vs  = (  SR*fluxL[RHO] - SL*fluxR[RHO]
+              + SR*SL*(uR[RHO] - uL[RHO]));
+      vs *= scrh;
+      vs /= rho;
+      EXPAND(                                            ,
+              usL[Xt] = rho*vL[Xt]; usR[Xt] = rho*vR[Xt]; ,
+              usL[Xb] = rho*vL[Xb]; usR[Xb] = rho*vR[Xb];)
+#endif
 
-      // 5-- Compute the flux from the left and right states
-      if (SL > 0) {
+      // Compute the flux from the left and right states
+      if (vs >= 0.0) {
 #pragma unroll
-        for (int nv = 0 ; nv < Phys::nvar; nv++) {
-          Flux(nv,k,j,i) = fluxL[nv];
+        for(int nv = 0 ; nv < Phys::nvar; nv++) {
+          flux[nv] = fluxL[nv] + SL*(usL[nv] - uL[nv]);
         }
-      } else if (SR < 0) {
+      } else {
 #pragma unroll
-        for (int nv = 0 ; nv < Phys::nvar; nv++) {
-          Flux(nv,k,j,i) = fluxR[nv];
+        for(int nv = 0 ; nv < Phys::nvar; nv++) {
+          flux[nv] = fluxR[nv] + SR*(usR[nv] - uR[nv]);
         }
-      } else {
-        real usL[Phys::nvar];
-        real usR[Phys::nvar];
-        real vs;
+      }
+    }
+  }
+};
 
-#if HAVE_ENERGY
-        real qL, qR, wL, wR;
-        qL = vL[PRS] + uL[Xn]*(vL[Xn] - SL);
-        qR = vR[PRS] + uR[Xn]*(vR[Xn] - SR);
+// Compute Riemann fluxes from states using HLLC solver
+template <typename Phys>
+template<const int DIR>
+void RiemannSolver<Phys>::HllcHD(IdefixArray4D<realStore> &Flux) {
+  idfx::pushRegion("RiemannSolver::HLLC_Solver");
 
-        wL = vL[RHO]*(vL[Xn] - SL);
-        wR = vR[RHO]*(vR[Xn] - SR);
+  constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
+  constexpr int joffset = (DIR==JDIR) ? 1 : 0;
+  constexpr int koffset = (DIR==KDIR) ? 1 : 0;
 
-        vs = (qR - qL)/(wR - wL); // wR - wL > 0 since SL < 0, SR > 0
+  IdefixArray3D<real> cMax = this->cMax;
 
-        usL[RHO] = uL[RHO]*(SL - vL[Xn])/(SL - vs);
-        usR[RHO] = uR[RHO]*(SR - vR[Xn])/(SR - vs);
-        EXPAND(usL[Xn] = usL[RHO]*vs;     usR[Xn] = usR[RHO]*vs;      ,
-                usL[Xt] = usL[RHO]*vL[Xt]; usR[Xt] = usR[RHO]*vR[Xt];  ,
-                usL[Xb] = usL[RHO]*vL[Xb]; usR[Xb] = usR[RHO]*vR[Xb];)
+  HllcHD_FluxFunctor<Phys,DIR> hllcFlux(*this->GetExtrapolator<DIR>(), *(hydro->eos.get()));
 
-        usL[ENG] =    uL[ENG]/vL[RHO]
-                    + (vs - vL[Xn])*(vs + vL[PRS]/(vL[RHO]*(SL - vL[Xn])));
-        usR[ENG] =    uR[ENG]/vR[RHO]
-                    + (vs - vR[Xn])*(vs + vR[PRS]/(vR[RHO]*(SR - vR[Xn])));
+  idefix_for_tiled<DIR>("HLLC_Kernel",
+                        hydro->updateBeg[KDIR],hydro->updateEnd[KDIR]+koffset,
+                        hydro->updateBeg[JDIR],hydro->updateEnd[JDIR]+joffset,
+                        hydro->updateBeg[IDIR],hydro->updateEnd[IDIR]+ioffset,
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      real flux[Phys::nvar];
+      real cmax;
 
-        usL[ENG] *= usL[RHO];
-        usR[ENG] *= usR[RHO];
-#else
-        real scrh = 1.0/(SR - SL);
-        real rho  = (SR*uR[RHO] - SL*uL[RHO] - fluxR[RHO] + fluxL[RHO])*scrh;
-        real mx   = (SR*uR[Xn] - SL*uL[Xn] - fluxR[Xn] + fluxL[Xn])*scrh;
-
-        usL[RHO] = usR[RHO] = rho;
-        usL[Xn] = usR[Xn] = mx;
-        vs  = (  SR*fluxL[RHO] - SL*fluxR[RHO]
-                + SR*SL*(uR[RHO] - uL[RHO]));
-        vs *= scrh;
-        vs /= rho;
-        EXPAND(                                            ,
-                usL[Xt] = rho*vL[Xt]; usR[Xt] = rho*vR[Xt]; ,
-                usL[Xb] = rho*vL[Xb]; usR[Xb] = rho*vR[Xb];)
-#endif
+      hllcFlux(k, j, i, flux, cmax);
 
-    // Compute the flux from the left and right states
-        if (vs >= 0.0) {
 #pragma unroll
-          for(int nv = 0 ; nv < Phys::nvar; nv++) {
-            Flux(nv,k,j,i) = fluxL[nv] + SL*(usL[nv] - uL[nv]);
-          }
-        } else {
-#pragma unroll
-          for(int nv = 0 ; nv < Phys::nvar; nv++) {
-            Flux(nv,k,j,i) = fluxR[nv] + SR*(usR[nv] - uR[nv]);
-          }
-        }
+      for(int nv = 0 ; nv < Phys::nvar; nv++) {
+        Flux(nv,k,j,i) = flux[nv];
       }
 
       //6-- Compute maximum wave speed for this sweep
@@ -38,14 +38,14 @@
 // Compute Riemann fluxes from states using ROE solver
 template <typename Phys>
 template<const int DIR>
-void RiemannSolver<Phys>::RoeHD(IdefixArray4D<real> &Flux) {
+void RiemannSolver<Phys>::RoeHD(IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("RiemannSolver::ROE_Solver");
 
   constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
   constexpr int joffset = (DIR==JDIR) ? 1 : 0;
   constexpr int koffset = (DIR==KDIR) ? 1 : 0;
 
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
   IdefixArray3D<real> cMax = this->cMax;
 
@@ -53,10 +53,10 @@ void RiemannSolver<Phys>::RoeHD(IdefixArray4D<real> &Flux) {
 
   ExtrapolateToFaces<Phys,DIR> extrapol = *this->GetExtrapolator<DIR>();
 
-  idefix_for("ROE_Kernel",
-             data->beg[KDIR],data->end[KDIR]+koffset,
-             data->beg[JDIR],data->end[JDIR]+joffset,
-             data->beg[IDIR],data->end[IDIR]+ioffset,
+  idefix_for_tiled<DIR>("ROE_Kernel",
+                        hydro->updateBeg[KDIR],hydro->updateEnd[KDIR]+koffset,
+                        hydro->updateBeg[JDIR],hydro->updateEnd[JDIR]+joffset,
+                        hydro->updateBeg[IDIR],hydro->updateEnd[IDIR]+ioffset,
     KOKKOS_LAMBDA (int k, int j, int i) {
       // Init the directions (should be in the kernel for proper optimisation by the compilers)
       EXPAND( const int Xn = DIR+MX1;                    ,
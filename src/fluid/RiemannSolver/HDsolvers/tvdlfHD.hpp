@@ -14,80 +14,100 @@
 #include "flux.hpp"
 #include "convertConsToPrim.hpp"
 
-// Compute Riemann fluxes from states using TVDLF solver
-template <typename Phys>
-template<const int DIR>
-void RiemannSolver<Phys>::TvdlfHD(IdefixArray4D<real> &Flux) {
-  idfx::pushRegion("RiemannSolver::TVDLF_Solver");
+// Compute the TVDLF flux at interface (k,j,i) in direction DIR
+template <typename Phys, int DIR>
+struct TvdlfHD_FluxFunctor {
+  TvdlfHD_FluxFunctor(const ExtrapolateToFaces<Phys,DIR> &extrapol,
+                      const EquationOfState &eos): extrapol(extrapol), eos(eos) {}
 
-  constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
-  constexpr int joffset = (DIR==JDIR) ? 1 : 0;
-  constexpr int koffset = (DIR==KDIR) ? 1 : 0;
+  ExtrapolateToFaces<Phys,DIR> extrapol;
+  EquationOfState eos;
 
-  IdefixArray4D<real> Vc = this->Vc;
-  IdefixArray4D<real> Vs = this->Vs;
-  IdefixArray3D<real> cMax = this->cMax;
-  EquationOfState eos = *(hydro->eos.get());
+  KOKKOS_INLINE_FUNCTION void operator() (const int k, const int j, const int i,
+                                          real flux[], real &cmax) const {
+    // Init the directions (should be in the kernel for proper optimisation by the compilers)
+    constexpr int Xn = DIR+MX1;
 
-  // Required for high order interpolations
-  IdefixArray1D<real> dx = this->data->dx[DIR];
+    // Primitive variables
+    real vL[Phys::nvar];
+    real vR[Phys::nvar];
+    real vRL[Phys::nvar];
 
-  ExtrapolateToFaces<Phys,DIR> extrapol = *this->GetExtrapolator<DIR>();
+    // Conservative variables
+    real uL[Phys::nvar];
+    real uR[Phys::nvar];
 
-  idefix_for("TVDLF_Kernel",
-             data->beg[KDIR],data->end[KDIR]+koffset,
-             data->beg[JDIR],data->end[JDIR]+joffset,
-             data->beg[IDIR],data->end[IDIR]+ioffset,
-    KOKKOS_LAMBDA (int k, int j, int i) {
-      // Init the directions (should be in the kernel for proper optimisation by the compilers)
-      constexpr int Xn = DIR+MX1;
+    // Flux (left and right)
+    real fluxL[Phys::nvar];
+    real fluxR[Phys::nvar];
 
-      // Primitive variables
-      real vL[Phys::nvar];
-      real vR[Phys::nvar];
-      real vRL[Phys::nvar];
+    // Signal speeds
+    real cRL;
 
-      // Conservative variables
-      real uL[Phys::nvar];
-      real uR[Phys::nvar];
-
-      // Flux (left and right)
-      real fluxL[Phys::nvar];
-      real fluxR[Phys::nvar];
-
-      // Signal speeds
-      real cRL, cmax;
-
-      // 1-- Read primitive variables
-      extrapol.ExtrapolatePrimVar(i, j, k, vL, vR);
+    // 1-- Read primitive variables
+    extrapol.ExtrapolatePrimVar(i, j, k, vL, vR);
 
 #pragma unroll
-      for(int nv = 0 ; nv < Phys::nvar; nv++) {
-        vRL[nv] = HALF_F*(vL[nv]+vR[nv]);
-      }
+    for(int nv = 0 ; nv < Phys::nvar; nv++) {
+      vRL[nv] = HALF_F*(vL[nv]+vR[nv]);
+    }
 
-      // 2-- Get the wave speed
+    // 2-- Get the wave speed
 #if HAVE_ENERGY
-      cRL = std::sqrt(eos.GetGamma(vRL[PRS],vRL[RHO])*(vRL[PRS]/vRL[RHO]));
+    cRL = std::sqrt(eos.GetGamma(vRL[PRS],vRL[RHO])*(vRL[PRS]/vRL[RHO]));
 #else
-      cRL = HALF_F*(eos.GetWaveSpeed(k,j,i)
-                   +eos.GetWaveSpeed(k-koffset,j-joffset,i-ioffset));
+    constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
+    constexpr int joffset = (DIR==JDIR) ? 1 : 0;
+    constexpr int koffset = (DIR==KDIR) ? 1 : 0;
+    cRL = HALF_F*(eos.GetWaveSpeed(k,j,i)
+                 +eos.GetWaveSpeed(k-koffset,j-joffset,i-ioffset));
 #endif
-      cmax = FMAX(FABS(vRL[Xn]+cRL),FABS(vRL[Xn]-cRL));
+    cmax = FMAX(FABS(vRL[Xn]+cRL),FABS(vRL[Xn]-cRL));
+
+
+    // 3-- Compute the conservative variables
+    K_PrimToCons<Phys>(uL, vL, &eos);
+    K_PrimToCons<Phys>(uR, vR, &eos);
 
+    // 4-- Compute the left and right fluxes
+    K_Flux<Phys,DIR>(fluxL, vL, uL, cRL*cRL);
+    K_Flux<Phys,DIR>(fluxR, vR, uR, cRL*cRL);
 
-      // 3-- Compute the conservative variables
-      K_PrimToCons<Phys>(uL, vL, &eos);
-      K_PrimToCons<Phys>(uR, vR, &eos);
+    // 5-- Compute the flux from the left and right states
+#pragma unroll
+    for(int nv = 0 ; nv < Phys::nvar; nv++) {
+      flux[nv] = HALF_F*(fluxL[nv]+fluxR[nv] - cmax*(uR[nv]-uL[nv]));
+    }
+  }
+};
+
+// Compute Riemann fluxes from states using TVDLF solver
+template <typename Phys>
+template<const int DIR>
+void RiemannSolver<Phys>::TvdlfHD(IdefixArray4D<realStore> &Flux) {
+  idfx::pushRegion("RiemannSolver::TVDLF_Solver");
+
+  constexpr int ioffset = (DIR==IDIR) ? 1 : 0;
+  constexpr int joffset = (DIR==JDIR) ? 1 : 0;
+  constexpr int koffset = (DIR==KDIR) ? 1 : 0;
+
+  IdefixArray3D<real> cMax = this->cMax;
+
+  TvdlfHD_FluxFunctor<Phys,DIR> tvdlfFlux(*this->GetExtrapolator<DIR>(), *(hydro->eos.get()));
+
+  idefix_for_tiled<DIR>("TVDLF_Kernel",
+                        hydro->updateBeg[KDIR],hydro->updateEnd[KDIR]+koffset,
+                        hydro->updateBeg[JDIR],hydro->updateEnd[JDIR]+joffset,
+                        hydro->updateBeg[IDIR],hydro->updateEnd[IDIR]+ioffset,
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      real flux[Phys::nvar];
+      real cmax;
 
-      // 4-- Compute the left and right fluxes
-      K_Flux<Phys,DIR>(fluxL, vL, uL, cRL*cRL);
-      K_Flux<Phys,DIR>(fluxR, vR, uR, cRL*cRL);
+      tvdlfFlux(k, j, i, flux, cmax);
 
-      // 5-- Compute the flux from the left and right states
 #pragma unroll
       for(int nv = 0 ; nv < Phys::nvar; nv++) {
-        Flux(nv,k,j,i) = HALF_F*(fluxL[nv]+fluxR[nv] - cmax*(uR[nv]-uL[nv]));
+        Flux(nv,k,j,i) = flux[nv];
       }
 
       //6-- Compute maximum wave speed for this sweep
@@ -50,7 +50,7 @@
 // Compute Riemann fluxes from states using ROE solver
 template <typename Phys>
 template<const int DIR>
-void RiemannSolver<Phys>::RoeMHD(IdefixArray4D<real> &Flux) {
+void RiemannSolver<Phys>::RoeMHD(IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("RiemannSolver::ROE_MHD");
 
   using EMF = ConstrainedTransport<Phys>;
@@ -72,7 +72,7 @@ void RiemannSolver<Phys>::RoeMHD(IdefixArray4D<real> &Flux) {
     constexpr int kextend = 0;
   #endif
 
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
   IdefixArray3D<real> cMax = this->cMax;
 
@@ -172,10 +172,10 @@ void RiemannSolver<Phys>::RoeMHD(IdefixArray4D<real> &Flux) {
       IDEFIX_ERROR("Wrong direction");
   }
 
-  idefix_for("CalcRiemannFlux",
-             data->beg[KDIR]-kextend,data->end[KDIR]+koffset+kextend,
-             data->beg[JDIR]-jextend,data->end[JDIR]+joffset+jextend,
-             data->beg[IDIR]-iextend,data->end[IDIR]+ioffset+iextend,
+  idefix_for_tiled<DIR>("CalcRiemannFlux",
+                        data->beg[KDIR]-kextend,data->end[KDIR]+koffset+kextend,
+                        data->beg[JDIR]-jextend,data->end[JDIR]+joffset+jextend,
+                        data->beg[IDIR]-iextend,data->end[IDIR]+ioffset+iextend,
     KOKKOS_LAMBDA (int k, int j, int i) {
       // Init the directions (should be in the kernel for proper optimisation by the compilers)
       EXPAND( const int Xn = DIR+MX1;                    ,
@@ -18,7 +18,7 @@
 // Compute Riemann fluxes from states using TVDLF solver
 template <typename Phys>
 template<const int DIR>
-void RiemannSolver<Phys>::TvdlfMHD(IdefixArray4D<real> &Flux) {
+void RiemannSolver<Phys>::TvdlfMHD(IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("RiemannSolver::TVDLF_MHD");
 
   using EMF = ConstrainedTransport<Phys>;
@@ -40,7 +40,7 @@ void RiemannSolver<Phys>::TvdlfMHD(IdefixArray4D<real> &Flux) {
     constexpr int kextend = 0;
   #endif
 
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
   IdefixArray3D<real> cMax = this->cMax;
 
@@ -135,10 +135,10 @@ void RiemannSolver<Phys>::TvdlfMHD(IdefixArray4D<real> &Flux) {
       IDEFIX_ERROR("Wrong direction");
   }
 
-  idefix_for("CalcRiemannFlux",
-             data->beg[KDIR]-kextend,data->end[KDIR]+koffset+kextend,
-             data->beg[JDIR]-jextend,data->end[JDIR]+joffset+jextend,
-             data->beg[IDIR]-iextend,data->end[IDIR]+ioffset+iextend,
+  idefix_for_tiled<DIR>("CalcRiemannFlux",
+                        data->beg[KDIR]-kextend,data->end[KDIR]+koffset+kextend,
+                        data->beg[JDIR]-jextend,data->end[JDIR]+joffset+jextend,
+                        data->beg[IDIR]-iextend,data->end[IDIR]+ioffset+iextend,
     KOKKOS_LAMBDA (int k, int j, int i) {
       // Init the directions (should be in the kernel for proper optimisation by the compilers)
       const int Xn = DIR+MX1;
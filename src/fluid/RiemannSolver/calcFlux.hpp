@@ -26,13 +26,29 @@
 // Compute Riemann fluxes from states
 template <typename Phys>
 template <int dir>
-void RiemannSolver<Phys>::CalcFlux(IdefixArray4D<real> &flux) {
+void RiemannSolver<Phys>::CalcFlux(IdefixArray4D<realStore> &flux) {
   idfx::pushRegion("RiemannSolver::CalcFlux");
   if constexpr(dir == IDIR) {
     // enable shock flattening
     if(haveShockFlattening) shockFlattening->FindShock();
   }
 
+  if(cacheFaceStates) {
+    // Compute the face states of each cell once, for all of the faces we need
+    std::array<int,3> beg = hydro->updateBeg;
+    std::array<int,3> end = hydro->updateEnd;
+    if constexpr(Phys::mhd) {
+      // MHD solvers also compute fluxes in the transverse ghost cells, for the EMFs
+      for(int d = 0 ; d < DIMENSIONS ; d++) {
+        if(d != dir) {
+          beg[d] = 0;
+          end[d] = data->np_tot[d];
+        }
+      }
+    }
+    GetExtrapolator<dir>()->CacheFaceStates(beg, end);
+  }
+
   if constexpr(Phys::mhd) {
     switch (mySolver) {
       case TVDLF_MHD:
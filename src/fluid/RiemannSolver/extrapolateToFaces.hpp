@@ -7,6 +7,8 @@
 #ifndef FLUID_RIEMANNSOLVER_EXTRAPOLATETOFACES_HPP_
 #define FLUID_RIEMANNSOLVER_EXTRAPOLATETOFACES_HPP_
 
+#include <array>
+
 #include "fluid.hpp"
 #include "dataBlock.hpp"
 #include "shockFlattening.hpp"
@@ -38,6 +40,10 @@ class ExtrapolateToFaces {
             if(!isRegularGrid) {
               ComputePLMweights(rSolver->hydro->data);
             }
+            if(rSolver->cacheFaceStates) {
+              cacheL = rSolver->faceStateL;
+              cacheR = rSolver->faceStateR;
+            }
   }
 
   void ComputePLMweights(DataBlock *data) {
@@ -81,234 +87,384 @@ class ExtrapolateToFaces {
     constexpr int joffset = (dir==JDIR ? 1 : 0);
     constexpr int koffset = (dir==KDIR ? 1 : 0);
 
+    if(haveCache) {
+      // Face states have already been computed by CacheFaceStates
+      for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+        vL[nv] = cacheR(nv,k-koffset,j-joffset,i-ioffset);
+        vR[nv] = cacheL(nv,k,j,i);
+      }
+      return;
+    }
+
     for(int nv = 0 ; nv < Phys::nvar ; nv++) {
-      if constexpr(order == 1) {
-        vL[nv] = Vc(nv,k-koffset,j-joffset,i-ioffset);
-        vR[nv] = Vc(nv,k,j,i);
-      } else if constexpr(order == 2) {
-        if(isRegularGrid) {
-          /////////////////////////////////////
-          // Regular Grid, PLM reconstruction
-          /////////////////////////////////////
-          real dvm = Vc(nv,k-koffset,j-joffset,i-ioffset)
-                    -Vc(nv,k-2*koffset,j-2*joffset,i-2*ioffset);
-          real dvp = Vc(nv,k,j,i)-Vc(nv,k-koffset,j-joffset,i-ioffset);
-
-          real dv;
-          if(shockFlattening) {
-            if(flags(k-koffset,j-joffset,i-ioffset) == FlagShock::Shock) {
-              // Force slope limiter to minmod
-              dv = SL::MinModLim(dvp,dvm);
-            } else {
-              dv = SL::PLMLim(dvp,dvm);
-            }
-          } else { // No shock flattening
-            dv = SL::PLMLim(dvp,dvm);
-          }
+      // vL= left side of current interface (i-1/2)= right side of cell i-1
+      vL[nv] = GetRightFaceState(nv,k-koffset,j-joffset,i-ioffset);
+      // vR= right side of current interface (i-1/2)= left side of cell i
+      vR[nv] = GetLeftFaceState(nv,k,j,i);
+    }
+  }
 
-          vL[nv] = Vc(nv,k-koffset,j-joffset,i-ioffset) + HALF_F*dv;
+  // Compute the face states of all of the cells in the range required by the fluxes computed
+  // on the faces [beg, end+1) in direction dir. The result is read by ExtrapolatePrimVar, so
+  // that the limited slopes of each cell are computed only once.
+  void CacheFaceStates(const std::array<int,3> &beg, const std::array<int,3> &end) {
+    idfx::pushRegion("ExtrapolateToFaces::CacheFaceStates");
+    // ExtrapolatePrimVar should not read the cache while we fill it
+    haveCache = false;
+    auto extrapol = *this;
+    auto faceL = cacheL;
+    auto faceR = cacheR;
+    constexpr int ioffset = (dir==IDIR ? 1 : 0);
+    constexpr int joffset = (dir==JDIR ? 1 : 0);
+    constexpr int koffset = (dir==KDIR ? 1 : 0);
 
-          dvm = dvp;
-          dvp = Vc(nv,k+koffset,j+joffset,i+ioffset) - Vc(nv,k,j,i);
+    // The slopes along j and k read the neighbouring rows and planes: cache-blocked loop
+    idefix_for_tiled<dir>("CacheFaceStates",0,Phys::nvar,
+                                 beg[KDIR]-koffset,end[KDIR]+koffset,
+                                 beg[JDIR]-joffset,end[JDIR]+joffset,
+                                 beg[IDIR]-ioffset,end[IDIR]+ioffset,
+                KOKKOS_LAMBDA(int nv, int k, int j, int i) {
+                  real vl, vr;
+                  extrapol.GetFaceStates(nv,k,j,i,vl,vr);
+                  faceL(nv,k,j,i) = vl;
+                  faceR(nv,k,j,i) = vr;
+                });
+    haveCache = true;
+    idfx::popRegion();
+  }
 
-          if(shockFlattening) {
-            if(flags(k,j,i) == FlagShock::Shock) {
-              dv = SL::MinModLim(dvp,dvm);
-            } else {
-              dv = SL::PLMLim(dvp,dvm);
-            }
-          } else { // No shock flattening
-            dv = SL::PLMLim(dvp,dvm);
-          }
+  // Extrapolate the primitive variable nv of cell (k,j,i) to both faces of the cell, the slope
+  // being limited only once (same results as GetLeftFaceState and GetRightFaceState)
+  KOKKOS_FORCEINLINE_FUNCTION void GetFaceStates(const int nv, const int k,
+                                                 const int j, const int i,
+                                                 real &vl, real &vr,
+                                                 const int offset = 0) const {
+    constexpr int ioffset = (dir==IDIR ? 1 : 0);
+    constexpr int joffset = (dir==JDIR ? 1 : 0);
+    constexpr int koffset = (dir==KDIR ? 1 : 0);
+    const int n = offset + nv;   // index of the variable in Vc
+
+    if constexpr(order == 1) {
+      vl = Vc(n,k,j,i);
+      vr = vl;
+    } else if constexpr(order == 2) {
+      const real v0 = Vc(n,k,j,i);
+      // (differences computed in the storage precision, as in GetLeftFaceState)
+      real dvm = Vc(n,k,j,i)-Vc(n,k-koffset,j-joffset,i-ioffset);
+      real dvp = Vc(n,k+koffset,j+joffset,i+ioffset) - Vc(n,k,j,i);
+      const bool shock = shockFlattening && (flags(k,j,i) == FlagShock::Shock);
+      if(isRegularGrid) {
+        const real dv = shock ? SL::MinModLim(dvp,dvm) : SL::PLMLim(dvp,dvm);
+        vl = v0 - HALF_F*dv;
+        vr = v0 + HALF_F*dv;
+      } else {
+        const int index = ioffset*i + joffset*j + koffset*k;
+
+        dvm *= wmArray(index);
+        dvp *= wpArray(index);
+        const real dv = shock ? SL::MinModLim(dvp,dvm)
+                              : SL::PLMLim(dvp,dvm,cpArray(index),cmArray(index));
+        vl = v0 - dmArray(index)*dv;
+        vr = v0 + dpArray(index)*dv;
+      }
+    } else if constexpr(order == 3) {
+      // 1D index along the chosen direction
+      const int index = ioffset*i + joffset*j + koffset*k;
+      const real v0 = Vc(n,k,j,i);
+      const real dvm = Vc(n,k,j,i)-Vc(n,k-koffset,j-joffset,i-ioffset);
+      const real dvp = Vc(n,k+koffset,j+joffset,i+ioffset) - Vc(n,k,j,i);
+
+      // Limo3 limiter
+      real dvl, dvr;
+      if(shockFlattening && flags(k,j,i) == FlagShock::Shock) {
+        // Force slope limiter to minmod
+        dvl = SL::MinModLim(dvp,dvm);
+        dvr = dvl;
+      } else {
+        dvl = dvm * SL::LimO3Lim(dvm, dvp, dx(index));
+        dvr = dvp * SL::LimO3Lim(dvp, dvm, dx(index));
+      }
+      vl = v0 - HALF_F*dvl;
+      vr = v0 + HALF_F*dvr;
+
+      // Check positivity: if a face element is negative, revert to minmod
+      bool positive = (nv==RHO);
+      if constexpr(Phys::pressure) positive = positive || (nv==PRS);
+      if(positive) {
+        if(vl <= 0.0) vl = v0 - HALF_F*SL::MinModLim(dvp,dvm);
+        if(vr <= 0.0) vr = v0 + HALF_F*SL::MinModLim(dvp,dvm);
+      }
+    } else if constexpr(order == 4) {
+      const real vm2 = Vc(n,k-2*koffset,j-2*joffset,i-2*ioffset);
+      const real vm1 = Vc(n,k-koffset,j-joffset,i-ioffset);
+      const real v0 = Vc(n,k,j,i);
+      const real vp1 = Vc(n,k+koffset,j+joffset,i+ioffset);
+      const real vp2 = Vc(n,k+2*koffset,j+2*joffset,i+2*ioffset);
+
+      SL::getPPMStates(vm2, vm1, v0, vp1, vp2, vl, vr);
+
+      // Check positivity: if a face element is negative, revert to vanleer
+      bool positive = (nv==RHO);
+      if constexpr(Phys::pressure) positive = positive || (nv==PRS);
+      if(positive) {
+        if(vl <= 0.0) vl = v0 - HALF_F*SL::PLMLim(vp1-v0,v0-vm1);
+        if(vr <= 0.0) vr = v0 + HALF_F*SL::PLMLim(vp1-v0,v0-vm1);
+      }
+    }
+  }
 
-          vR[nv] = Vc(nv,k,j,i) - HALF_F*dv;
-        } else {
-          /////////////////////////////////////
-          // Irregular Grid, PLM reconstruction
-          /////////////////////////////////////
-          const int index = ioffset*i + joffset*j + koffset*k;
-
-          real dvm = Vc(nv,k-koffset,j-joffset,i-ioffset)
-                    -Vc(nv,k-2*koffset,j-2*joffset,i-2*ioffset);
-          real dvp = Vc(nv,k,j,i)-Vc(nv,k-koffset,j-joffset,i-ioffset);
-
-          dvm *= wmArray(index-1);
-          dvp *= wpArray(index-1);
-          real cp = cpArray(index-1);
-          real cm = cmArray(index-1);
-
-          real dv;
-          if(shockFlattening) {
-            if(flags(k-koffset,j-joffset,i-ioffset) == FlagShock::Shock) {
-              // Force slope limiter to minmod
-              dv = SL::MinModLim(dvp,dvm);
-            } else {
-              dv = SL::PLMLim(dvp,dvm,cp,cm);
-            }
-          } else { // No shock flattening
-            dv = SL::PLMLim(dvp,dvm,cp,cm);
+  // Extrapolate the primitive variable nv of cell (k,j,i) to the right face of the cell
+  // (offset is the index of the first variable of the fluid in Vc, when Vc holds several fluids)
+  KOKKOS_FORCEINLINE_FUNCTION real GetRightFaceState(const int nv, const int k,
+                                                     const int j, const int i,
+                                                     const int offset = 0) const {
+    constexpr int ioffset = (dir==IDIR ? 1 : 0);
+    constexpr int joffset = (dir==JDIR ? 1 : 0);
+    constexpr int koffset = (dir==KDIR ? 1 : 0);
+    const int n = offset + nv;   // index of the variable in Vc
+
+    real vr;
+    if constexpr(order == 1) {
+      vr = Vc(n,k,j,i);
+    } else if constexpr(order == 2) {
+      real dvm = Vc(n,k,j,i)-Vc(n,k-koffset,j-joffset,i-ioffset);
+      real dvp = Vc(n,k+koffset,j+joffset,i+ioffset)-Vc(n,k,j,i);
+      if(isRegularGrid) {
+        /////////////////////////////////////
+        // Regular Grid, PLM reconstruction
+        /////////////////////////////////////
+        real dv;
+        if(shockFlattening) {
+          if(flags(k,j,i) == FlagShock::Shock) {
+            // Force slope limiter to minmod
+            dv = SL::MinModLim(dvp,dvm);
+          } else {
+            dv = SL::PLMLim(dvp,dvm);
           }
-
-          vL[nv] = Vc(nv,k-koffset,j-joffset,i-ioffset) + dpArray(index-1)*dv;
-
-          dvm = Vc(nv,k,j,i)-Vc(nv,k-koffset,j-joffset,i-ioffset);
-          dvp = Vc(nv,k+koffset,j+joffset,i+ioffset) - Vc(nv,k,j,i);
-          dvm *= wmArray(index);
-          dvp *= wpArray(index);
-          cp = cpArray(index);
-          cm = cmArray(index);
-
-          if(shockFlattening) {
-            if(flags(k,j,i) == FlagShock::Shock) {
-              dv = SL::MinModLim(dvp,dvm);
-            } else {
-              dv = SL::PLMLim(dvp,dvm,cp,cm);
-            }
-          } else { // No shock flattening
+        } else { // No shock flattening
+          dv = SL::PLMLim(dvp,dvm);
+        }
+
+        vr = Vc(n,k,j,i) + HALF_F*dv;
+      } else {
+        /////////////////////////////////////
+        // Irregular Grid, PLM reconstruction
+        /////////////////////////////////////
+        const int index = ioffset*i + joffset*j + koffset*k;
+
+        dvm *= wmArray(index);
+        dvp *= wpArray(index);
+        real cp = cpArray(index);
+        real cm = cmArray(index);
+
+        real dv;
+        if(shockFlattening) {
+          if(flags(k,j,i) == FlagShock::Shock) {
+            // Force slope limiter to minmod
+            dv = SL::MinModLim(dvp,dvm);
+          } else {
             dv = SL::PLMLim(dvp,dvm,cp,cm);
           }
-          vR[nv] = Vc(nv,k,j,i) - dmArray(index)*dv;
-        } // Regular grid
-
-      } else if constexpr(order == 3) {
-          // 1D index along the chosen direction
-          const int index = ioffset*i + joffset*j + koffset*k;
-          real dvm = Vc(nv,k-koffset,j-joffset,i-ioffset)
-                    -Vc(nv,k-2*koffset,j-2*joffset,i-2*ioffset);
-          real dvp = Vc(nv,k,j,i)-Vc(nv,k-koffset,j-joffset,i-ioffset);
-
-          // Limo3 limiter
-          real dv;
-          if(shockFlattening) {
-            if(flags(k-koffset,j-joffset,i-ioffset) == FlagShock::Shock) {
-              // Force slope limiter to minmod
-              dv = SL::MinModLim(dvp,dvm);
-            } else {
-              dv = dvp * SL::LimO3Lim(dvp, dvm, dx(index-1));
-            }
-          } else { // No shock flattening
-              dv = dvp * SL::LimO3Lim(dvp, dvm, dx(index-1));
-          }
+        } else { // No shock flattening
+          dv = SL::PLMLim(dvp,dvm,cp,cm);
+        }
+
+        vr = Vc(n,k,j,i) + dpArray(index)*dv;
+      } // Regular grid
+    } else if constexpr(order == 3) {
+      // 1D index along the chosen direction
+      const int index = ioffset*i + joffset*j + koffset*k;
+      real dvm = Vc(n,k,j,i)-Vc(n,k-koffset,j-joffset,i-ioffset);
+      real dvp = Vc(n,k+koffset,j+joffset,i+ioffset)-Vc(n,k,j,i);
+
+      // Limo3 limiter
+      real dv;
+      if(shockFlattening) {
+        if(flags(k,j,i) == FlagShock::Shock) {
+          // Force slope limiter to minmod
+          dv = SL::MinModLim(dvp,dvm);
+        } else {
+          dv = dvp * SL::LimO3Lim(dvp, dvm, dx(index));
+        }
+      } else { // No shock flattening
+          dv = dvp * SL::LimO3Lim(dvp, dvm, dx(index));
+      }
 
-          vL[nv] = Vc(nv,k-koffset,j-joffset,i-ioffset) + HALF_F*dv;
+      vr = Vc(n,k,j,i) + HALF_F*dv;
 
-          // Check positivity
-          if(nv==RHO) {
-            // If face element is negative, revert to minmod
-            if(vL[nv] <= 0.0) {
-              dv = SL::MinModLim(dvp,dvm);
-              vL[nv] = Vc(nv,k-koffset,j-joffset,i-ioffset) + HALF_F*dv;
-            }
-          }
-          if constexpr(Phys::pressure) {
-            if(nv==PRS) {
-              // If face element is negative, revert to minmod
-              if(vL[nv] <= 0.0) {
-                dv = SL::MinModLim(dvp,dvm);
-                vL[nv] = Vc(nv,k-koffset,j-joffset,i-ioffset) + HALF_F*dv;
-              }
-            }
+      // Check positivity
+      if(nv==RHO) {
+        // If face element is negative, revert to minmod
+        if(vr <= 0.0) {
+          dv = SL::MinModLim(dvp,dvm);
+          vr = Vc(n,k,j,i) + HALF_F*dv;
+        }
+      }
+      if constexpr(Phys::pressure) {
+        if(nv==PRS) {
+          // If face element is negative, revert to minmod
+          if(vr <= 0.0) {
+            dv = SL::MinModLim(dvp,dvm);
+            vr = Vc(n,k,j,i) + HALF_F*dv;
           }
-
-          dvm = dvp;
-          dvp = Vc(nv,k+koffset,j+joffset,i+ioffset) - Vc(nv,k,j,i);
-
-          // Limo3 limiter
-          if(shockFlattening) {
-            if(flags(k,j,i) == FlagShock::Shock) {
-              // Force slope limiter to minmod
-              dv = SL::MinModLim(dvp,dvm);
-            } else {
-              dv = dvm * SL::LimO3Lim(dvm, dvp, dx(index));
-            }
-          } else { // No shock flattening
-            dv = dvm * SL::LimO3Lim(dvm, dvp, dx(index));
+        }
+      }
+    } else if constexpr(order == 4) {
+      real vm2 = Vc(n,k-2*koffset,j-2*joffset,i-2*ioffset);
+      real vm1 = Vc(n,k-koffset,j-joffset,i-ioffset);
+      real v0 = Vc(n,k,j,i);
+      real vp1 = Vc(n,k+koffset,j+joffset,i+ioffset);
+      real vp2 = Vc(n,k+2*koffset,j+2*joffset,i+2*ioffset);
+
+      real vl;
+      SL::getPPMStates(vm2, vm1, v0, vp1, vp2, vl, vr);
+
+      // Check positivity
+      if(nv==RHO) {
+        // If face element is negative, revert to vanleer
+        if(vr <= 0.0) {
+          real dv = SL::PLMLim(vp1-v0,v0-vm1);
+          vr = v0+HALF_F*dv;
+        }
+      }
+      if constexpr(Phys::pressure) {
+        if(nv==PRS) {
+          // If face element is negative, revert to vanleer
+          if(vr <= 0.0) {
+            real dv = SL::PLMLim(vp1-v0,v0-vm1);
+            vr = v0+HALF_F*dv;
           }
+        }
+      }
+    }
+    return(vr);
+  }
 
-          vR[nv] = Vc(nv,k,j,i) - HALF_F*dv;
-
-          // Check positivity
-          if(nv==RHO) {
-            // If face element is negative, revert to vanleer
-            if(vR[nv] <= 0.0) {
-              dv = SL::MinModLim(dvp,dvm);
-              vR[nv] = Vc(nv,k,j,i) - HALF_F*dv;
-            }
-          }
-          if constexpr(Phys::pressure) {
-            if(nv==PRS) {
-              // If face element is negative, revert to vanleer
-              if(vR[nv] <= 0.0) {
-                dv = SL::MinModLim(dvp,dvm);
-                vR[nv] = Vc(nv,k,j,i) - HALF_F*dv;
-              }
-            }
-          }
-      } else if constexpr(order == 4) {
-          // Reconstruction in cell i-1
-          real vm2 = Vc(nv,k-3*koffset,j-3*joffset,i-3*ioffset);;
-          real vm1 = Vc(nv,k-2*koffset,j-2*joffset,i-2*ioffset);
-          real v0 = Vc(nv,k-koffset,j-joffset,i-ioffset);
-          real vp1 = Vc(nv,k,j,i);
-          real vp2 = Vc(nv,k+koffset,j+joffset,i+ioffset);
-
-          real vr,vl;
-          SL::getPPMStates(vm2, vm1, v0, vp1, vp2, vl, vr);
-          // vL= left side of current interface (i-1/2)= right side of cell i-1
-
-          // Check positivity
-          if(nv==RHO) {
-            // If face element is negative, revert to vanleer
-            if(vr <= 0.0) {
-              real dv = SL::PLMLim(vp1-v0,v0-vm1);
-              vr = v0+HALF_F*dv;
-            }
+  // Extrapolate the primitive variable nv of cell (k,j,i) to the left face of the cell
+  // (offset is the index of the first variable of the fluid in Vc, when Vc holds several fluids)
+  KOKKOS_FORCEINLINE_FUNCTION real GetLeftFaceState(const int nv, const int k,
+                                                    const int j, const int i,
+                                                    const int offset = 0) const {
+    constexpr int ioffset = (dir==IDIR ? 1 : 0);
+    constexpr int joffset = (dir==JDIR ? 1 : 0);
+    constexpr int koffset = (dir==KDIR ? 1 : 0);
+    const int n = offset + nv;   // index of the variable in Vc
+
+    real vl;
+    if constexpr(order == 1) {
+      vl = Vc(n,k,j,i);
+    } else if constexpr(order == 2) {
+      real dvm = Vc(n,k,j,i)-Vc(n,k-koffset,j-joffset,i-ioffset);
+      real dvp = Vc(n,k+koffset,j+joffset,i+ioffset) - Vc(n,k,j,i);
+      if(isRegularGrid) {
+        /////////////////////////////////////
+        // Regular Grid, PLM reconstruction
+        /////////////////////////////////////
+        real dv;
+        if(shockFlattening) {
+          if(flags(k,j,i) == FlagShock::Shock) {
+            dv = SL::MinModLim(dvp,dvm);
+          } else {
+            dv = SL::PLMLim(dvp,dvm);
           }
-          if constexpr(Phys::pressure) {
-            if(nv==PRS) {
-              // If face element is negative, revert to vanleer
-              if(vr <= 0.0) {
-                real dv = SL::PLMLim(vp1-v0,v0-vm1);
-                vr = v0+HALF_F*dv;
-              }
-            }
+        } else { // No shock flattening
+          dv = SL::PLMLim(dvp,dvm);
+        }
+
+        vl = Vc(n,k,j,i) - HALF_F*dv;
+      } else {
+        /////////////////////////////////////
+        // Irregular Grid, PLM reconstruction
+        /////////////////////////////////////
+        const int index = ioffset*i + joffset*j + koffset*k;
+
+        dvm *= wmArray(index);
+        dvp *= wpArray(index);
+        real cp = cpArray(index);
+        real cm = cmArray(index);
+
+        real dv;
+        if(shockFlattening) {
+          if(flags(k,j,i) == FlagShock::Shock) {
+            dv = SL::MinModLim(dvp,dvm);
+          } else {
+            dv = SL::PLMLim(dvp,dvm,cp,cm);
           }
+        } else { // No shock flattening
+          dv = SL::PLMLim(dvp,dvm,cp,cm);
+        }
+        vl = Vc(n,k,j,i) - dmArray(index)*dv;
+      } // Regular grid
+    } else if constexpr(order == 3) {
+      // 1D index along the chosen direction
+      const int index = ioffset*i + joffset*j + koffset*k;
+      real dvm = Vc(n,k,j,i)-Vc(n,k-koffset,j-joffset,i-ioffset);
+      real dvp = Vc(n,k+koffset,j+joffset,i+ioffset) - Vc(n,k,j,i);
+
+      // Limo3 limiter
+      real dv;
+      if(shockFlattening) {
+        if(flags(k,j,i) == FlagShock::Shock) {
+          // Force slope limiter to minmod
+          dv = SL::MinModLim(dvp,dvm);
+        } else {
+          dv = dvm * SL::LimO3Lim(dvm, dvp, dx(index));
+        }
+      } else { // No shock flattening
+        dv = dvm * SL::LimO3Lim(dvm, dvp, dx(index));
+      }
 
-          vL[nv] = vr;
-          // Reconstruction in cell i
-
-          vm2 = vm1;
-          vm1 = v0;
-          v0 = vp1;
-          vp1 = vp2;
-          vp2 = Vc(nv,k+2*koffset,j+2*joffset,i+2*ioffset);
-
-          SL::getPPMStates(vm2, vm1, v0, vp1, vp2, vl, vr);
+      vl = Vc(n,k,j,i) - HALF_F*dv;
 
-          // Check positivity
-          if(nv==RHO) {
-            // If face element is negative, revert to vanleer
-            if(vl <= 0.0) {
-              real dv = SL::PLMLim(vp1-v0,v0-vm1);
-              vl = v0-HALF_F*dv;
-            }
+      // Check positivity
+      if(nv==RHO) {
+        // If face element is negative, revert to vanleer
+        if(vl <= 0.0) {
+          dv = SL::MinModLim(dvp,dvm);
+          vl = Vc(n,k,j,i) - HALF_F*dv;
+        }
+      }
+      if constexpr(Phys::pressure) {
+        if(nv==PRS) {
+          // If face element is negative, revert to vanleer
+          if(vl <= 0.0) {
+            dv = SL::MinModLim(dvp,dvm);
+            vl = Vc(n,k,j,i) - HALF_F*dv;
           }
-          if constexpr(Phys::pressure) {
-            if(nv==PRS) {
-              // If face element is negative, revert to vanleer
-              if(vl <= 0.0) {
-                real dv = SL::PLMLim(vp1-v0,v0-vm1);
-                vl = v0-HALF_F*dv;
-              }
-            }
+        }
+      }
+    } else if constexpr(order == 4) {
+      real vm2 = Vc(n,k-2*koffset,j-2*joffset,i-2*ioffset);
+      real vm1 = Vc(n,k-koffset,j-joffset,i-ioffset);
+      real v0 = Vc(n,k,j,i);
+      real vp1 = Vc(n,k+koffset,j+joffset,i+ioffset);
+      real vp2 = Vc(n,k+2*koffset,j+2*joffset,i+2*ioffset);
+
+      real vr;
+      SL::getPPMStates(vm2, vm1, v0, vp1, vp2, vl, vr);
+
+      // Check positivity
+      if(nv==RHO) {
+        // If face element is negative, revert to vanleer
+        if(vl <= 0.0) {
+          real dv = SL::PLMLim(vp1-v0,v0-vm1);
+          vl = v0-HALF_F*dv;
+        }
+      }
+      if constexpr(Phys::pressure) {
+        if(nv==PRS) {
+          // If face element is negative, revert to vanleer
+          if(vl <= 0.0) {
+            real dv = SL::PLMLim(vp1-v0,v0-vm1);
+            vl = v0-HALF_F*dv;
           }
-
-          vR[nv] = vl;
+        }
       }
     }
+    return(vl);
   }
 
-  IdefixArray4D<real> Vc;
+  IdefixArray4D<realStore> Vc;
   IdefixArray1D<real> dx;
   IdefixArray3D<FlagShock> flags;
 
@@ -321,6 +477,11 @@ class ExtrapolateToFaces {
 
   bool isRegularGrid{true};
   bool shockFlattening{false};
+
+  // Face states cache (shared by all of the directions)
+  IdefixArray4D<real> cacheL;   // primitive variables on the left face of each cell
+  IdefixArray4D<real> cacheR;   // primitive variables on the right face of each cell
+  bool haveCache{false};
 };
 
 
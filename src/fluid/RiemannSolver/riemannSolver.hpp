@@ -8,6 +8,7 @@
 #ifndef FLUID_RIEMANNSOLVER_RIEMANNSOLVER_HPP_
 #define FLUID_RIEMANNSOLVER_RIEMANNSOLVER_HPP_
 
+#include <array>
 #include <string>
 #include <memory>
 
@@ -29,7 +30,7 @@ class RiemannSolver {
 
   RiemannSolver(Input &input, Fluid<Phys>* hydro);
 
-  template <int> void CalcFlux(IdefixArray4D<real> &);
+  template <int> void CalcFlux(IdefixArray4D<realStore> &);
 
   Solver GetSolver() {
     return(mySolver);
@@ -39,38 +40,41 @@ class RiemannSolver {
 
   // Riemann Solvers
   template<const int>
-    void HlldMHD(IdefixArray4D<real> &);
+    void HlldMHD(IdefixArray4D<realStore> &);
   template<const int>
-    void HllMHD(IdefixArray4D<real> &);
+    void HllMHD(IdefixArray4D<realStore> &);
   template<const int>
-    void RoeMHD(IdefixArray4D<real> &);
+    void RoeMHD(IdefixArray4D<realStore> &);
   template<const int>
-    void TvdlfMHD(IdefixArray4D<real> &);
+    void TvdlfMHD(IdefixArray4D<realStore> &);
 
   template<const int>
-    void HllcHD(IdefixArray4D<real> &);
+    void HllcHD(IdefixArray4D<realStore> &);
   template<const int>
-    void HllHD(IdefixArray4D<real> &);
+    void HllHD(IdefixArray4D<realStore> &);
   template<const int>
-    void RoeHD(IdefixArray4D<real> &);
+    void RoeHD(IdefixArray4D<realStore> &);
   template<const int>
-    void TvdlfHD(IdefixArray4D<real> &);
+    void TvdlfHD(IdefixArray4D<realStore> &);
 
   template<const int>
-    void HllDust(IdefixArray4D<real> &);
+    void HllDust(IdefixArray4D<realStore> &);
   // Get the right slope limiter
   template<int dir>
   ExtrapolateToFaces<Phys, dir>* GetExtrapolator();
 
   std::unique_ptr<ShockFlattening<Phys>> shockFlattening;
 
+  // Whether the face states are computed once per cell before the Riemann solvers
+  bool cacheFaceStates{false};
+
  private:
   template <typename P, int dir, PLMLimiter L, int O>
   friend class ExtrapolateToFaces;
 
-  IdefixArray4D<real> Vc;
+  IdefixArray4D<realStore> Vc;
   IdefixArray4D<real> Vs;
-  IdefixArray4D<real> Flux;
+  IdefixArray4D<realStore> Flux;
   IdefixArray3D<real> cMax;
   Fluid<Phys>* hydro;
   DataBlock *data;
@@ -83,6 +87,10 @@ class RiemannSolver {
   std::unique_ptr<ExtrapolateToFaces<Phys,KDIR>> slopeLimKDIR;
 
   bool haveShockFlattening;
+
+  // Face states cache, shared by all of the directions
+  IdefixArray4D<real> faceStateL;
+  IdefixArray4D<real> faceStateR;
 };
 
 #include "shockFlattening.hpp"
@@ -158,6 +166,17 @@ RiemannSolver<Phys>::RiemannSolver(Input &input, Fluid<Phys>* hydro) : Vc{hydro-
                               hydro,input.Get<real>(std::string(Phys::prefix),"shockFlattening",0));
   }
 
+  // Face states cache
+  if(input.CheckEntry(std::string(Phys::prefix),"cacheFaceStates")>=0) {
+    this->cacheFaceStates = input.Get<bool>(std::string(Phys::prefix),"cacheFaceStates",0);
+  }
+  if(cacheFaceStates && !data->haveBlocks) {
+    faceStateL = IdefixArray4D<real>("RiemannSolver_FaceStateL", Phys::nvar,
+                                     data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+    faceStateR = IdefixArray4D<real>("RiemannSolver_FaceStateR", Phys::nvar,
+                                     data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+  }
+
   // init slope limiters
   slopeLimIDIR = std::make_unique<ExtrapolateToFaces<Phys,IDIR>>(this);
   #if DIMENSIONS >= 2
@@ -206,6 +225,10 @@ void RiemannSolver<Phys>::ShowConfig() {
   if(haveShockFlattening) {
     idfx::cout << Phys::prefix << ": Shock Flattening ENABLED." << std::endl;
   }
+  if(cacheFaceStates) {
+    idfx::cout << Phys::prefix << ": Face states cache ENABLED (experimental, adds the traffic "
+               << "of two face state arrays per direction)." << std::endl;
+  }
 }
 
 template <typename Phys>
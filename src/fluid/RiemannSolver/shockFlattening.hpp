@@ -64,7 +64,7 @@ struct ShockFlattening_FindShockFunctor {
   //*****************************************************************
   real smoothing;
   IdefixArray3D<FlagShock> flags;
-  IdefixArray4D<real> Vc;
+  IdefixArray4D<realStore> Vc;
   #if GEOMETRY == CARTESIAN
     IdefixArray1D<real> dx1, dx2, dx3;
   #else
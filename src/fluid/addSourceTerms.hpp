@@ -47,8 +47,8 @@ struct Fluid_AddSourceTermsFunctor {
   //*****************************************************************
   // Functor Variables
   //*****************************************************************
-  IdefixArray4D<real> Uc;
-  IdefixArray4D<real> Vc;
+  IdefixArray4D<realStore> Uc;
+  IdefixArray4D<realStore> Vc;
   IdefixArray1D<real> x1;
   IdefixArray1D<real> x2;
   IdefixArray3D<real> csIsoArr;
@@ -268,7 +268,7 @@ void Axis::FixBx2sAxisGhostAverage(int side) {
 
 void Axis::EnforceAxisBoundary(int side) {
   idfx::pushRegion("Axis::EnforceAxisBoundary");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray1D<int> sVc = this->symmetryVc;
 
   int ibeg = 0;
@@ -443,7 +443,7 @@ void Axis::ExchangeMPI(int side) {
   int nx,ny,nz;
   auto bufferSend = this->bufferSend;
   IdefixArray1D<int> map = this->mapVars;
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
 
 // If MPI Persistent, start receiving even before the buffers are filled
@@ -79,7 +79,7 @@ class Axis {
   IdefixArray3D<real> ez;
   IdefixArray4D<real> J;
 
-  IdefixArray4D<real> Vc;
+  IdefixArray4D<realStore> Vc;
   IdefixArray4D<real> Vs;
 
   DataBlock *data;
@@ -13,6 +13,7 @@
 #include "idefix.hpp"
 #include "fluid_defs.hpp"
 #include "grid.hpp"
+#include "shearingBoxExchange.hpp"
 
 #ifdef WITH_MPI
 #include "mpi.hpp"
@@ -39,8 +40,13 @@ class Boundary {
  public:
   explicit Boundary(Fluid<Phys>*);
   void SetBoundaries(real);                         ///< Set the ghost zones in all directions
+  void StartBoundaries(real);     ///< Set the ghost zones, possibly leaving MPI exchanges in flight
+  void FinishBoundaries(real);    ///< Complete the ghost zones started by StartBoundaries
+  bool ExchangeReceived();        ///< Whether FinishBoundaries can proceed without waiting
+  bool CanOverlapMpi();           ///< Whether MPI exchanges can be overlapped with computation
   void EnforceBoundaryDir(real, int);             ///< write in the ghost zone in specific direction
-  void ReconstructVcField(IdefixArray4D<real> &);  ///< reconstruct cell-centered magnetic field
+  void EnforceInternalBoundaries(real);       ///< call the user-defined internal boundaries
+  void ReconstructVcField(IdefixArray4D<realStore> &); ///< reconstruct cell-centered magnetic field
   void ReconstructNormalField(int dir);           ///< reconstruct normal field using divB=0
 
   void EnforceFluxBoundaries(int,real);      ///< Apply boundary condition conditions to the fluxes
@@ -106,9 +112,18 @@ class Boundary {
                             const int &,
                             const BoundarySide &,
                             Function );
-  IdefixArray4D<real> sBArray;    ///< Array use by shearingbox boundary conditions
-
-  IdefixArray4D<real> Vc; ///< reference to cell-centered array that we should sync
+  // Shearing box boundary conditions
+  std::unique_ptr<ShearingBoxExchange> sbExchange; ///< gather the shifted rows along X2
+  IdefixArray4D<real> sbSlab;     ///< ghost cells of the X1 boundary (Vc, then Vs components)
+  IdefixArray4D<real> sbColumn;   ///< rows of the X2 column the ghost cells are shifted from
+
+  // Overlap of MPI exchanges with the computation of the active domain
+  bool overlapMpi{false};         ///< whether the overlap has been requested
+  bool haveExchangePending{false}; ///< whether StartBoundaries left MPI exchanges in flight
+  bool overlapStage{false};   ///< whether the exchanges of the current stage are overlapped (the
+                              ///< conversions of the fluid then skip the stale ghost zones)
+
+  IdefixArray4D<realStore> Vc; ///< reference to cell-centered array that we should sync
   IdefixArray4D<real> Vs; ///< reference to face-centered array that we should sync
   std::unique_ptr<Axis> axis; ///< Axis object, initialised if needed.
   bool haveAxis{false};
@@ -141,13 +156,19 @@ Boundary<Phys>::Boundary(Fluid<Phys>* fluid) {
 
 
   if(data->lbound[IDIR] == shearingbox || data->rbound[IDIR] == shearingbox) {
-    // using np_tot[...]+1 points to allow this buffer to represent
-    // fields that are defined on faces
-    sBArray = IdefixArray4D<real>("ShearingBoxArray",
-                                  nVar,
-                                  data->np_tot[KDIR]+1,
-                                  data->np_tot[JDIR]+1,
-                                  data->nghost[IDIR]);
+    // Cell-centered variables, and the face-centered field components along X2 and X3
+    int nSlab = nVar;
+    if constexpr(Phys::mhd) nSlab += DIMENSIONS-1;
+    sbSlab = IdefixArray4D<real>("ShearingBoxSlab", nSlab,
+                                 data->np_tot[KDIR],
+                                 data->np_tot[JDIR],
+                                 data->nghost[IDIR]);
+    // 2 more rows on each side for the slopes of the remap
+    sbColumn = IdefixArray4D<real>("ShearingBoxColumn", nSlab,
+                                   data->np_tot[KDIR],
+                                   data->np_tot[JDIR]+4,
+                                   data->nghost[IDIR]);
+    sbExchange = std::make_unique<ShearingBoxExchange>(data);
   }
 
   // Init MPI stack when needed
@@ -181,7 +202,10 @@ Boundary<Phys>::Boundary(Fluid<Phys>* fluid) {
     }
   }
 
-  mpi.Init(data->mygrid, mapVars, data->nghost.data(), data->np_int.data(), Phys::mhd);
+  // The ghost zones of a process split in blocks are exchanged by the blocks themselves
+  if(!data->haveBlocks) {
+    mpi.Init(data->mygrid, mapVars, data->nghost.data(), data->np_int.data(), Phys::mhd);
+  }
 
 #endif // MPI
   idfx::popRegion();
@@ -233,9 +257,7 @@ void Boundary<Phys>::EnforceFluxBoundaries(int dir,const real t) {
 }
 
 template<typename Phys>
-void Boundary<Phys>::SetBoundaries(real t) {
-  idfx::pushRegion("Boundary::SetBoundaries");
-  // set internal boundary conditions
+void Boundary<Phys>::EnforceInternalBoundaries(real t) {
   if(haveInternalBoundary) {
     idfx::pushRegion("Boundary::UserDefInternalBoundary");
     if(internalBoundaryFunc != NULL) {
@@ -245,6 +267,14 @@ void Boundary<Phys>::SetBoundaries(real t) {
     }
     idfx::popRegion();
   }
+}
+
+template<typename Phys>
+void Boundary<Phys>::SetBoundaries(real t) {
+  idfx::pushRegion("Boundary::SetBoundaries");
+  overlapStage = false;
+  // set internal boundary conditions
+  EnforceInternalBoundaries(t);
   for(int dir=0 ; dir < DIMENSIONS ; dir++ ) {
       // MPI Exchange data when needed
     #ifdef WITH_MPI
@@ -278,6 +308,87 @@ void Boundary<Phys>::SetBoundaries(real t) {
 }
 
 
+// Check whether the MPI exchanges can be overlapped with the computation, i.e. whether
+// the stage update only depends on the ghost cells through the Riemann fluxes along each
+// direction (and never on the corner ghost cells, which are not refreshed by Mpi::ExchangeAll).
+template<typename Phys>
+bool Boundary<Phys>::CanOverlapMpi() {
+  #ifdef WITH_MPI
+  if(idfx::psize < 2) return(false);
+  if(!Mpi::CanExchangeAll()) return(false);
+  if constexpr(Phys::mhd) {
+    return(false);
+  }
+  if(fluid->haveExplicitParabolicTerms || fluid->haveTracer) return(false);
+  if(fluid->rSolver->shockFlattening) return(false);
+  if(haveFluxBoundary || haveAxis) return(false);
+  if(data->haveFargo || data->haveGridCoarsening) return(false);
+  // The equation of state is refreshed before the ghost zones are complete
+  if constexpr(Phys::eos) {
+    #ifdef EOS_FILE
+      return(false);    // custom equations of state may read the flow when they are refreshed
+    #else
+      if(fluid->eos->RefreshReadsFlow()) return(false);
+    #endif
+  }
+  // The ghost zones of the static refinement levels are prolongated once they are complete
+  if(data->haveRefinement || data->mygrid->level > 0) return(false);
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(data->np_int[dir] < 2*data->nghost[dir]) return(false);
+  }
+  return(true);
+  #else
+  return(false);
+  #endif
+}
+
+// Start setting the ghost zones. When the overlap is enabled, the MPI exchanges are only
+// started, and FinishBoundaries should be called before the ghost zones are used. Otherwise,
+// this is equivalent to SetBoundaries.
+template<typename Phys>
+void Boundary<Phys>::StartBoundaries(real t) {
+  if(!(overlapMpi && CanOverlapMpi())) {
+    SetBoundaries(t);
+    return;
+  }
+  idfx::pushRegion("Boundary::StartBoundaries");
+  // set internal boundary conditions
+  EnforceInternalBoundaries(t);
+  #ifdef WITH_MPI
+  mpi.ExchangeAllBegin(this->Vc);
+  #endif
+  haveExchangePending = true;
+  overlapStage = true;
+  idfx::popRegion();
+}
+
+// Whether the MPI exchanges left in flight by StartBoundaries have been received
+template<typename Phys>
+bool Boundary<Phys>::ExchangeReceived() {
+  if(!haveExchangePending) return(true);
+  #ifdef WITH_MPI
+  return(mpi.ExchangeAllReceived());
+  #else
+  return(true);
+  #endif
+}
+
+// Complete the ghost zones started by StartBoundaries
+template<typename Phys>
+void Boundary<Phys>::FinishBoundaries(real t) {
+  if(!haveExchangePending) return;
+  idfx::pushRegion("Boundary::FinishBoundaries");
+  #ifdef WITH_MPI
+  mpi.ExchangeAllEnd(this->Vc);
+  #endif
+  haveExchangePending = false;
+  // Physical boundaries are enforced once all of the MPI ghost zones have been received
+  for(int dir=0 ; dir < DIMENSIONS ; dir++ ) {
+    EnforceBoundaryDir(t, dir);
+  }
+  idfx::popRegion();
+}
+
 // Enforce boundary conditions by writing into ghost zones
 template<typename Phys>
 void Boundary<Phys>::EnforceBoundaryDir(real t, int dir) {
@@ -382,7 +493,7 @@ void Boundary<Phys>::EnforceBoundaryDir(real t, int dir) {
 
 
 template<typename Phys>
-void Boundary<Phys>::ReconstructVcField(IdefixArray4D<real> &Vc) {
+void Boundary<Phys>::ReconstructVcField(IdefixArray4D<realStore> &Vc) {
   idfx::pushRegion("Boundary::ReconstructVcField");
 
   IdefixArray4D<real> Vs=this->Vs;
@@ -568,7 +679,7 @@ void Boundary<Phys>::EnrollInternalBoundary(InternalBoundaryFunc<Phys> myFunc) {
 template<typename Phys>
 void Boundary<Phys>::EnforcePeriodic(int dir, BoundarySide side ) {
   idfx::pushRegion("Boundary::EnforcePeriodic");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   int nxi = data->np_int[IDIR];
   int nxj = data->np_int[JDIR];
   int nxk = data->np_int[KDIR];
@@ -668,7 +779,7 @@ void Boundary<Phys>::EnforcePeriodic(int dir, BoundarySide side ) {
 template<typename Phys>
 void Boundary<Phys>::EnforceReflective(int dir, BoundarySide side ) {
   idfx::pushRegion("Boundary::EnforceReflective");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   const int nxi = data->np_int[IDIR];
   const int nxj = data->np_int[JDIR];
   const int nxk = data->np_int[KDIR];
@@ -731,7 +842,7 @@ void Boundary<Phys>::EnforceReflective(int dir, BoundarySide side ) {
 template<typename Phys>
 void Boundary<Phys>::EnforceOutflow(int dir, BoundarySide side ) {
   idfx::pushRegion("Boundary::EnforceOutflow");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   const int nxi = data->np_int[IDIR];
   const int nxj = data->np_int[JDIR];
   const int nxk = data->np_int[KDIR];
@@ -805,20 +916,19 @@ void Boundary<Phys>::EnforceShearingBox(real t, int dir, BoundarySide side) {
   idfx::pushRegion("Boundary::EnforceShearingBox");
   if(dir != IDIR)
     IDEFIX_ERROR("Shearing box boundaries can only be applied along the X1 direction");
-  if(data->mygrid->nproc[JDIR]>1)
-    IDEFIX_ERROR("Shearing box is not yet compatible with domain decomposition in X2");
 
   // First thing is to enforce periodicity (already performed by MPI)
   if(data->mygrid->nproc[dir] == 1) EnforcePeriodic(dir, side);
 
-  IdefixArray4D<real> scrh = sBArray;
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<real> slab = sbSlab;
+  IdefixArray4D<real> column = sbColumn;
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<real> Vs = this->Vs;
 
   const int nxi = data->np_int[IDIR];
-  const int nxj = data->np_int[JDIR];
-
   const int ighost = data->nghost[IDIR];
-  const int jghost = data->nghost[JDIR];
+  const int nVar = this->nVar;
+  const int nSlab = sbSlab.extent(0);
 
   // Where does the boundary starts along x1?
   const int istart = side*(ighost+nxi);
@@ -845,116 +955,43 @@ void Boundary<Phys>::EnforceShearingBox(real t, int dir, BoundarySide side) {
   // remainding shift
   const real eps = dL / dy - m;
 
+  // Store the ghost cells (which hold the periodic image of the other side of the box)
+  idefix_for("BoundaryShearingBoxStore",0,nSlab,
+                                        0,data->np_tot[KDIR],
+                                        0,data->np_tot[JDIR],
+                                        istart,istart+ighost,
+    KOKKOS_LAMBDA (int n, int k, int j, int i) {
+      if(n < nVar) {
+        slab(n,k,j,i-istart) = Vc(n,k,j,i);
+      } else {
+        // Face-centered field components along X2 and X3
+        slab(n,k,j,i-istart) = Vs(BX2s+n-nVar,k,j,i);
+      }
+    });
+
+  // Get the rows jo-2...jo+2 around the origin jo=j-m of each row j, which may belong to
+  // other processes when the domain is decomposed along X2
+  sbExchange->Gather(slab, m, column);
 
   // Now we need to perform the shift
-  BoundaryForAll("BoundaryShearingBox", dir, side,
-        KOKKOS_LAMBDA ( int n, int k, int j, int i) {
-          // jorigin
-          const int jo = jghost + ((j-m-jghost)%nxj+nxj)%nxj;
-          const int jop2 = jghost + ((jo+2-jghost)%nxj+nxj)%nxj;
-          const int jop1 = jghost + ((jo+1-jghost)%nxj+nxj)%nxj;
-          const int jom1 = jghost + ((jo-1-jghost)%nxj+nxj)%nxj;
-          const int jom2 = jghost + ((jo-2-jghost)%nxj+nxj)%nxj;
-
-          // Define Left and right fluxes
-          // Fluxes are defined from slope-limited interpolation
-          // Using Van-leer slope limiter (consistently with the main advection scheme)
-          real Fl,Fr;
-          real dqm, dqp, dq;
-
-          if(eps>=ZERO_F) {
-            // Compute Fl
-            dqm = Vc(n,k,jom1,i) - Vc(n,k,jom2,i);
-            dqp = Vc(n,k,jo,i) - Vc(n,k,jom1,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fl = Vc(n,k,jom1,i) + 0.5*dq*(1.0-eps);
-            //Compute Fr
-            dqm=dqp;
-            dqp = Vc(n,k,jop1,i) - Vc(n,k,jo,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fr = Vc(n,k,jo,i) + 0.5*dq*(1.0-eps);
-          } else {
-            //Compute Fl
-            dqm = Vc(n,k,jo,i) - Vc(n,k,jom1,i);
-            dqp = Vc(n,k,jop1,i) - Vc(n,k,jo,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fl = Vc(n,k,jo,i) - 0.5*dq*(1.0+eps);
-            // Compute Fr
-            dqm=dqp;
-            dqp = Vc(n,k,jop2,i) - Vc(n,k,jop1,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fr = Vc(n,k,jop1,i) - 0.5*dq*(1.0+eps);
-          }
-          scrh(n,k,j,i-istart) = Vc(n,k,jo,i) - eps*(Fr - Fl);
-        });
-  // Copy scrach back to our boundary
-  BoundaryForAll("BoundaryShearingBoxCopy", dir, side,
-        KOKKOS_LAMBDA ( int n, int k, int j, int i) {
-          Vc(n,k,j,i) = scrh(n,k,j,i-istart);
-          if(n==VX2) Vc(n,k,j,i) += sbVelocity;
-        });
+  idefix_for("BoundaryShearingBox",0,nSlab,
+                                   0,data->np_tot[KDIR],
+                                   0,data->np_tot[JDIR],
+                                   istart,istart+ighost,
+    KOKKOS_LAMBDA (int n, int k, int j, int i) {
+      real q[5];
+      for(int d = 0 ; d < 5 ; d++) {
+        q[d] = column(n,k,j+d,i-istart);
+      }
+      const real v = K_ShearingBoxShift(q, eps);
+      if(n < nVar) {
+        Vc(n,k,j,i) = v;
+        if(n==VX2) Vc(n,k,j,i) += sbVelocity;
+      } else {
+        Vs(BX2s+n-nVar,k,j,i) = v;
+      }
+    });
 
-  // Magnetised version of the same thing
-  if constexpr(Phys::mhd) {
-    IdefixArray4D<real> Vs = this->Vs;
-    #if DIMENSIONS >= 2
-      for(int component = BX2s ; component < DIMENSIONS ; component++) {
-        BoundaryFor("BoundaryShearingBoxBXs", dir, side,
-        KOKKOS_LAMBDA (int k, int j, int i) {
-          // jorigin
-          const int jo = jghost + ((j-m-jghost)%nxj+nxj)%nxj;
-          const int jop2 = jghost + ((jo+2-jghost)%nxj+nxj)%nxj;
-          const int jop1 = jghost + ((jo+1-jghost)%nxj+nxj)%nxj;
-          const int jom1 = jghost + ((jo-1-jghost)%nxj+nxj)%nxj;
-          const int jom2 = jghost + ((jo-2-jghost)%nxj+nxj)%nxj;
-
-          // Define Left and right fluxes
-          // Fluxes are defined from slope-limited interpolation
-          // Using Van-leer slope limiter (consistently with the main advection scheme)
-          real Fl,Fr;
-          real dqm, dqp, dq;
-
-          if(eps>=ZERO_F) {
-            // Compute Fl
-            dqm = Vs(component,k,jom1,i) - Vs(component,k,jom2,i);
-            dqp = Vs(component,k,jo,i) - Vs(component,k,jom1,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fl = Vs(component,k,jom1,i) + 0.5*dq*(1.0-eps);
-            //Compute Fr
-            dqm=dqp;
-            dqp = Vs(component,k,jop1,i) - Vs(component,k,jo,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fr = Vs(component,k,jo,i) + 0.5*dq*(1.0-eps);
-          } else {
-            //Compute Fl
-            dqm = Vs(component,k,jo,i) - Vs(component,k,jom1,i);
-            dqp = Vs(component,k,jop1,i) - Vs(component,k,jo,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fl = Vs(component,k,jo,i) - 0.5*dq*(1.0+eps);
-            // Compute Fr
-            dqm=dqp;
-            dqp = Vs(component,k,jop2,i) - Vs(component,k,jop1,i);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fr = Vs(component,k,jop1,i) - 0.5*dq*(1.0+eps);
-          }
-          scrh(0,k,j,i-istart) = Vs(component,k,jo,i) - eps*(Fr - Fl);
-        });
-        // Copy scratch back to our boundary
-        BoundaryFor("BoundaryShearingBoxCopyBXs", dir, side,
-              KOKKOS_LAMBDA ( int k, int j, int i) {
-                Vs(component,k,j,i) = scrh(0,k,j,i-istart);
-              });
-      }// loop on components
-    #endif// DIMENSIONS
-  } // MHD
   idfx::popRegion();
 }
 
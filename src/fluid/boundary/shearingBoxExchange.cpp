@@ -0,0 +1,164 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include "shearingBoxExchange.hpp"
+#include <algorithm>
+#include <vector>
+#include "dataBlock.hpp"
+
+ShearingBoxExchange::ShearingBoxExchange(DataBlock *datain) {
+  idfx::pushRegion("ShearingBoxExchange::ShearingBoxExchange");
+  this->data = datain;
+  #ifdef WITH_MPI
+    // The rank of a process in columnComm is its coordinate along X2
+    int remainDims[3] = {false, true, false};
+    MPI_SAFE_CALL(MPI_Cart_sub(data->mygrid->CartComm, remainDims, &columnComm));
+  #endif
+  idfx::popRegion();
+}
+
+std::vector<ShearingBoxExchange::Segment> ShearingBoxExchange::Segments(int p, int shift) const {
+  const std::vector<int> &slabs = data->mygrid->decomposition[JDIR];
+  const int ny = data->mygrid->np_int[JDIR];
+  const int jghost = data->nghost[JDIR];
+
+  // local rows of process p (ghost cells included), and the 2 rows on each side of them
+  const int nRows = slabs[p+1] - slabs[p] + 2*jghost + 4;
+  // global index of the origin of row 0
+  const int j0 = slabs[p] - jghost - shift - 2;
+
+  std::vector<Segment> segments;
+  for(int r = 0 ; r < nRows ; r++) {
+    const int jg = ((j0 + r) % ny + ny) % ny;
+    const int q = static_cast<int>(std::upper_bound(slabs.begin(), slabs.end(), jg)
+                                   - slabs.begin()) - 1;
+    const int srcRow = jg - slabs[q] + jghost;
+    if(!segments.empty() && segments.back().proc == q
+                         && segments.back().srcRow + segments.back().count == srcRow) {
+      segments.back().count++;
+    } else {
+      segments.push_back({q, r, 1, srcRow});
+    }
+  }
+  return(segments);
+}
+
+void ShearingBoxExchange::CopySegment(IdefixArray4D<real> src, IdefixArray4D<real> dst,
+                                      const Segment &s) {
+  const int row = s.row;
+  const int srcRow = s.srcRow;
+  const int nv = src.extent(0);
+  const int nk = src.extent(1);
+  const int ni = src.extent(3);
+  idefix_for("ShearingBoxExchange_Copy",0,nv,0,nk,0,s.count,0,ni,
+    KOKKOS_LAMBDA (int n, int k, int c, int i) {
+      dst(n,k,row+c,i) = src(n,k,srcRow+c,i);
+    });
+}
+
+void ShearingBoxExchange::Gather(IdefixArray4D<real> src, const int shift,
+                                 IdefixArray4D<real> dst) {
+  idfx::pushRegion("ShearingBoxExchange::Gather");
+  const int me = data->mygrid->xproc[JDIR];
+  const std::vector<Segment> mySegments = Segments(me, shift);
+
+  // Rows we own ourselves
+  for(const Segment &s : mySegments) {
+    if(s.proc == me) CopySegment(src, dst, s);
+  }
+
+  #ifdef WITH_MPI
+  const int nproc = data->mygrid->nproc[JDIR];
+  if(nproc > 1) {
+    const int nv = src.extent(0);
+    const int nk = src.extent(1);
+    const int ni = src.extent(3);
+    const size_t rowSize = static_cast<size_t>(nv)*nk*ni;
+
+    // Rows we need from (resp. we send to) each process of the column
+    std::vector<std::vector<Segment>> recvSegments(nproc);
+    std::vector<std::vector<Segment>> sendSegments(nproc);
+    std::vector<size_t> recvOffset(nproc+1, 0);
+    std::vector<size_t> sendOffset(nproc+1, 0);
+    for(const Segment &s : mySegments) {
+      if(s.proc != me) recvSegments[s.proc].push_back(s);
+    }
+    for(int p = 0 ; p < nproc ; p++) {
+      if(p != me) {
+        for(const Segment &s : Segments(p, shift)) {
+          if(s.proc == me) sendSegments[p].push_back(s);
+        }
+      }
+      size_t recvRows = 0;
+      size_t sendRows = 0;
+      for(const Segment &s : recvSegments[p]) recvRows += s.count;
+      for(const Segment &s : sendSegments[p]) sendRows += s.count;
+      recvOffset[p+1] = recvOffset[p] + recvRows*rowSize;
+      sendOffset[p+1] = sendOffset[p] + sendRows*rowSize;
+    }
+    if(bufferRecv.extent(0) < recvOffset[nproc]) {
+      bufferRecv = IdefixArray1D<real>("ShearingBoxExchange_Recv", recvOffset[nproc]);
+    }
+    if(bufferSend.extent(0) < sendOffset[nproc]) {
+      bufferSend = IdefixArray1D<real>("ShearingBoxExchange_Send", sendOffset[nproc]);
+    }
+    IdefixArray1D<real> bufRecv = bufferRecv;
+    IdefixArray1D<real> bufSend = bufferSend;
+
+    std::vector<MPI_Request> requests;
+    requests.reserve(2*nproc);
+    for(int p = 0 ; p < nproc ; p++) {
+      const int size = static_cast<int>(recvOffset[p+1]-recvOffset[p]);
+      if(size > 0) {
+        requests.emplace_back();
+        MPI_SAFE_CALL(MPI_Irecv(bufRecv.data()+recvOffset[p], size, realMPI, p, 1300,
+                                columnComm, &requests.back()));
+      }
+    }
+
+    // Pack the rows needed by the other processes
+    for(int p = 0 ; p < nproc ; p++) {
+      size_t offset = sendOffset[p];
+      for(const Segment &s : sendSegments[p]) {
+        const int count = s.count;
+        const int srcRow = s.srcRow;
+        idefix_for("ShearingBoxExchange_Pack",0,nv,0,nk,0,count,0,ni,
+          KOKKOS_LAMBDA (int n, int k, int c, int i) {
+            bufSend(offset + ((n*nk + k)*count + c)*ni + i) = src(n,k,srcRow+c,i);
+          });
+        offset += count*rowSize;
+      }
+    }
+    Kokkos::fence();
+
+    for(int p = 0 ; p < nproc ; p++) {
+      const int size = static_cast<int>(sendOffset[p+1]-sendOffset[p]);
+      if(size > 0) {
+        requests.emplace_back();
+        MPI_SAFE_CALL(MPI_Isend(bufSend.data()+sendOffset[p], size, realMPI, p, 1300,
+                                columnComm, &requests.back()));
+      }
+    }
+    MPI_SAFE_CALL(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+
+    // Unpack the rows we received
+    for(int p = 0 ; p < nproc ; p++) {
+      size_t offset = recvOffset[p];
+      for(const Segment &s : recvSegments[p]) {
+        const int count = s.count;
+        const int row = s.row;
+        idefix_for("ShearingBoxExchange_Unpack",0,nv,0,nk,0,count,0,ni,
+          KOKKOS_LAMBDA (int n, int k, int c, int i) {
+            dst(n,k,row+c,i) = bufRecv(offset + ((n*nk + k)*count + c)*ni + i);
+          });
+        offset += count*rowSize;
+      }
+    }
+  }
+  #endif
+  idfx::popRegion();
+}
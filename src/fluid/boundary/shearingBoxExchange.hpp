@@ -0,0 +1,92 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef FLUID_BOUNDARY_SHEARINGBOXEXCHANGE_HPP_
+#define FLUID_BOUNDARY_SHEARINGBOXEXCHANGE_HPP_
+
+#include <vector>
+#include "idefix.hpp"
+
+// Forward class declaration
+class DataBlock;
+
+// Value of a field at the origin cell q[2] shifted by eps cells along X2, q[0..4] being the
+// cells jo-2...jo+2. Fluxes are defined from slope-limited interpolation, using Van-leer slope
+// limiter (consistently with the main advection scheme)
+KOKKOS_INLINE_FUNCTION real K_ShearingBoxShift(const real q[5], const real eps) {
+  real Fl,Fr;
+  real dqm, dqp, dq;
+
+  if(eps>=ZERO_F) {
+    // Compute Fl
+    dqm = q[1] - q[0];
+    dqp = q[2] - q[1];
+    dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
+
+    Fl = q[1] + 0.5*dq*(1.0-eps);
+    //Compute Fr
+    dqm=dqp;
+    dqp = q[3] - q[2];
+    dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
+
+    Fr = q[2] + 0.5*dq*(1.0-eps);
+  } else {
+    //Compute Fl
+    dqm = q[2] - q[1];
+    dqp = q[3] - q[2];
+    dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
+
+    Fl = q[2] - 0.5*dq*(1.0+eps);
+    // Compute Fr
+    dqm=dqp;
+    dqp = q[4] - q[3];
+    dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
+
+    Fr = q[3] - 0.5*dq*(1.0+eps);
+  }
+  return(q[2] - eps*(Fr - Fl));
+}
+
+// Gather the rows of a shearing-box boundary from the processes of the same X2 column of the
+// domain decomposition.
+// Each process of the column holds a slab src(n,k,j,i) of the ghost cells of one X1 boundary,
+// j being the local index along X2 (ghost cells included). Given the shift of the boundary
+// (in # of cells), Gather fills dst(n,k,r,i) with the rows jo-2...jo+2 required by the
+// remap of each local row j, where jo = j-shift is the origin of the row: row r of dst holds
+// the global row (j0 + r) mod ny, j0 being the global index of the first local row, minus
+// shift, minus 2. The origin of row j is then dst(n,k,j+2,i) whatever the decomposition.
+// Only the processes owning some of the required rows are involved in the exchange.
+class ShearingBoxExchange {
+ public:
+  explicit ShearingBoxExchange(DataBlock *);
+
+  void Gather(IdefixArray4D<real> src, const int shift, IdefixArray4D<real> dst);
+
+ private:
+  // Contiguous rows of dst coming from the same process
+  struct Segment {
+    int proc;     // process of the X2 column owning the rows
+    int row;      // first row in dst
+    int count;    // # of rows
+    int srcRow;   // first row in src of the owning process
+  };
+
+  // Rows needed by the process at position p of the column
+  std::vector<Segment> Segments(int p, int shift) const;
+
+  void CopySegment(IdefixArray4D<real>, IdefixArray4D<real>, const Segment &);
+
+  DataBlock *data;
+
+  #ifdef WITH_MPI
+  MPI_Comm columnComm;          // processes sharing our X1 and X3 coordinates
+  IdefixArray1D<real> bufferSend;
+  IdefixArray1D<real> bufferRecv;
+  #endif
+};
+
+#endif // FLUID_BOUNDARY_SHEARINGBOXEXCHANGE_HPP_
@@ -65,7 +65,7 @@ void BragThermalDiffusion::EnrollBragThermalDiffusivity(BragDiffusivityFunc myFu
 }
 
 void BragThermalDiffusion::AddBragDiffusiveFlux(int dir, const real t,
-                                                const IdefixArray4D<real> &Flux) {
+                                                const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("BragThermalDiffusion::AddBragDiffusiveFlux");
   switch(limiter) {
     case PLMLimiter::VanLeer:
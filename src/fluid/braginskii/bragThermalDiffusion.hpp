@@ -30,10 +30,10 @@ class BragThermalDiffusion {
 
   void ShowConfig(); // display configuration
 
-  void AddBragDiffusiveFlux(int, const real, const IdefixArray4D<real> &);
+  void AddBragDiffusiveFlux(int, const real, const IdefixArray4D<realStore> &);
 
   template<const PLMLimiter>
-  void AddBragDiffusiveFluxLim(int, const real, const IdefixArray4D<real> &);
+  void AddBragDiffusiveFluxLim(int, const real, const IdefixArray4D<realStore> &);
 
   // Enroll user-defined thermal conductivity
   void EnrollBragThermalDiffusivity(BragDiffusivityFunc);
@@ -63,7 +63,7 @@ class BragThermalDiffusion {
   bool haveMinmod{false};
 
   // helper array
-  IdefixArray4D<real> &Vc;
+  IdefixArray4D<realStore> &Vc;
   IdefixArray4D<real> &Vs;
   IdefixArray3D<real> &dMax;
 
@@ -245,10 +245,10 @@ BragThermalDiffusion::BragThermalDiffusion(Input &input, Grid &grid, Fluid<Phys>
 // (this avoids an extra array)
 template <PLMLimiter limTemplate>
 void BragThermalDiffusion::AddBragDiffusiveFluxLim(int dir, const real t,
-                                                const IdefixArray4D<real> &Flux) {
+                                                const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("BragThermalDiffusion::AddBragDiffusiveFluxLim");
 
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
   IdefixArray3D<real> dMax = this->dMax;
   EquationOfState eos = *(this->eos);
@@ -87,7 +87,8 @@ void BragViscosity::EnrollBragViscousDiffusivity(DiffusivityFunc myFunc) {
 // (this avoids an extra array)
 // Associated source terms, present in non-cartesian geometry are also computed
 // and stored in this->viscSrc for later use (in calcRhs).
-void BragViscosity::AddBragViscousFlux(int dir, const real t, const IdefixArray4D<real> &Flux) {
+void BragViscosity::AddBragViscousFlux(int dir, const real t,
+                                       const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("BragViscosity::AddBragViscousFlux");
   switch(limiter) {
     case PLMLimiter::VanLeer:
@@ -25,10 +25,10 @@ class BragViscosity {
   template <typename Phys>
   BragViscosity(Input &, Grid &, Fluid<Phys> *);
   void ShowConfig();                    // print configuration
-  void AddBragViscousFlux(int, const real, const IdefixArray4D<real> &);
+  void AddBragViscousFlux(int, const real, const IdefixArray4D<realStore> &);
 
   template <const PLMLimiter>
-  void AddBragViscousFluxLim(int, const real, const IdefixArray4D<real> &);
+  void AddBragViscousFluxLim(int, const real, const IdefixArray4D<realStore> &);
 
   // Enroll user-defined viscous diffusivity
   void EnrollBragViscousDiffusivity(DiffusivityFunc);
@@ -55,7 +55,7 @@ class BragViscosity {
   bool haveMonotizedCentral{false};
   bool haveVanLeer{false};
 
-  IdefixArray4D<real> &Vc;
+  IdefixArray4D<realStore> &Vc;
   IdefixArray4D<real> &Vs;
   IdefixArray3D<real> &dMax;
 
@@ -110,7 +110,8 @@ BragViscosity::BragViscosity(Input &input, Grid &grid, Fluid<Phys> *hydroin):
                    "in the .ini file");
   }
 
-  InitArrays();
+  // (the fluids of a process split in blocks are not evolved, see Fluid)
+  if(!data->haveBlocks) InitArrays();
 
   idfx::popRegion();
 }
@@ -169,9 +170,10 @@ BragViscosity::BragViscosity(Input &input, Grid &grid, Fluid<Phys> *hydroin):
 // Associated source terms, present in non-cartesian geometry are also computed
 // and stored in this->bragViscSrc for later use (in calcRhs).
 template <PLMLimiter limTemplate>
-void BragViscosity::AddBragViscousFluxLim(int dir, const real t, const IdefixArray4D<real> &Flux) {
+void BragViscosity::AddBragViscousFluxLim(int dir, const real t,
+                                          const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("BragViscosity::AddBragViscousFlux");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
   IdefixArray4D<real> bragViscSrc = this->bragViscSrc;
   IdefixArray3D<real> dMax = this->dMax;
@@ -0,0 +1,279 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef FLUID_CALCFUSEDRIGHTHANDSIDE_HPP_
+#define FLUID_CALCFUSEDRIGHTHANDSIDE_HPP_
+
+#include "fluid.hpp"
+#include "dataBlock.hpp"
+#include "gravity.hpp"
+#include "riemannSolver.hpp"
+
+// Evolve the conservative variables of each cell with the flux divergence of all of the
+// directions in a single kernel. The Riemann fluxes are computed on the fly at both faces of
+// the cell, so that FluxRiemann is never written to nor read back from memory. Each face
+// flux is therefore computed twice, which is favourable on bandwidth-bound architectures.
+// The arithmetic is identical to LoopDir, so that both paths give the same results.
+template<typename Phys, template<typename, int> class FluxFunctor>
+struct Fluid_CalcFusedRHSFunctor {
+  //*****************************************************************
+  // Functor constructor
+  //*****************************************************************
+  Fluid_CalcFusedRHSFunctor(Fluid<Phys> *hydro, real dt):
+        fluxX1(*hydro->rSolver->template GetExtrapolator<IDIR>(), *hydro->eos)
+    #if DIMENSIONS >= 2
+      , fluxX2(*hydro->rSolver->template GetExtrapolator<JDIR>(), *hydro->eos)
+    #endif
+    #if DIMENSIONS == 3
+      , fluxX3(*hydro->rSolver->template GetExtrapolator<KDIR>(), *hydro->eos)
+    #endif
+    {
+    Uc   = hydro->Uc;
+    Vc   = hydro->Vc;
+    dV   = hydro->data->dV;
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      A[dir] = hydro->data->A[dir];
+      dx[dir] = hydro->data->dx[dir];
+    }
+    invDt = hydro->InvDt;
+    this->dt = dt;
+
+    if(hydro->data->haveGravity) {
+      // Gravitational potential
+      phiP = hydro->data->gravity->phiP;
+      needPotential = hydro->data->gravity->havePotential;
+
+      // BodyForce
+      bodyForce = hydro->data->gravity->bodyForceVector;
+      needBodyForce = hydro->data->gravity->haveBodyForce;
+    }
+  }
+
+  //*****************************************************************
+  // Functor Variables
+  //*****************************************************************
+  FluxFunctor<Phys,IDIR> fluxX1;
+  #if DIMENSIONS >= 2
+  FluxFunctor<Phys,JDIR> fluxX2;
+  #endif
+  #if DIMENSIONS == 3
+  FluxFunctor<Phys,KDIR> fluxX3;
+  #endif
+
+  IdefixArray4D<realStore> Uc;
+  IdefixArray4D<realStore> Vc;
+  IdefixArray3D<real> dV;
+  IdefixArray3D<real> A[3];
+  IdefixArray1D<real> dx[3];
+  IdefixArray3D<real> invDt;
+
+  // Gravitational potential
+  IdefixArray3D<real> phiP;
+  bool needPotential{false};
+
+  // BodyForce
+  IdefixArray4D<real> bodyForce;
+  bool needBodyForce{false};
+
+  // timestep
+  real dt;
+
+  //*****************************************************************
+  // Contribution of direction dir to the evolution of the cell
+  //*****************************************************************
+  template<int dir>
+  KOKKOS_INLINE_FUNCTION void AddDirection(const int k, const int j, const int i,
+                                           const real dtdV,
+                                           const real fluxL[], const real cmaxL,
+                                           const real fluxR[], const real cmaxR,
+                                           real u[], real &invDtCell) const {
+    constexpr int ioffset = (dir==IDIR) ? 1 : 0;
+    constexpr int joffset = (dir==JDIR) ? 1 : 0;
+    constexpr int koffset = (dir==KDIR) ? 1 : 0;
+
+    // Fluxes through the cell faces (as corrected in Fluid_CorrectFluxFunctor)
+    const real AL = A[dir](k,j,i);
+    const real AR = A[dir](k+koffset,j+joffset,i+ioffset);
+
+    real rhs[Phys::nvar];
+    #pragma unroll
+    for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+      rhs[nv] = -  dtdV*(fluxR[nv]*AR - fluxL[nv]*AL);
+    }
+
+    // elmentary length for gradient computations
+    const int ig = ioffset*i + joffset*j + koffset*k;
+    const real dl = dx[dir](ig);
+
+    // Potential terms
+    if(needPotential) {
+      real dphi;
+      if constexpr (dir==IDIR) {
+        dphi = - 1.0/12.0 * (
+                      - phiP(k,j,i+2) + 8.0 * phiP(k,j,i+1)
+                      - 8.0*phiP(k,j,i-1) + phiP(k,j,i-2));
+      }
+      if constexpr (dir==JDIR) {
+        dphi = - 1.0/12.0 * (
+                      - phiP(k,j+2,i) + 8.0 * phiP(k,j+1,i)
+                      - 8.0*phiP(k,j-1,i) + phiP(k,j-2,i));
+      }
+      if constexpr (dir==KDIR) {
+        dphi = - 1.0/12.0 * (
+                      - phiP(k+2,j,i) + 8.0 * phiP(k+1,j,i)
+                      - 8.0*phiP(k-1,j,i) + phiP(k-2,j,i));
+      }
+      rhs[MX1+dir] += dt * Vc(RHO,k,j,i) * dphi /dl;
+
+      if constexpr(Phys::pressure) {
+        rhs[ENG] += HALF_F * dtdV  * (fluxL[RHO]*AL + fluxR[RHO]*AR) * dphi;
+      }
+    }
+
+    // Body force
+    if(needBodyForce) {
+      rhs[MX1+dir] += dt * Vc(RHO,k,j,i) * bodyForce(dir,k,j,i);
+      if constexpr(Phys::pressure) {
+        rhs[ENG] += HALF_F * dtdV * dl * (fluxL[RHO]*AL + fluxR[RHO]*AR) * bodyForce(dir,k,j,i);
+      }
+
+      // Particular cases if we do not sweep all of the components
+      #if DIMENSIONS == 1 && COMPONENTS > 1
+        EXPAND(                                                           ,
+                  rhs[MX2] += dt * Vc(RHO,k,j,i) * bodyForce(JDIR,k,j,i);   ,
+                  rhs[MX3] += dt * Vc(RHO,k,j,i) * bodyForce(KDIR,k,j,i);    )
+        if constexpr(Phys::pressure) {
+          rhs[ENG] += dt * (EXPAND( ZERO_F                                              ,
+                                    + Vc(RHO,k,j,i) * Vc(VX2,k,j,i) * bodyForce(JDIR,k,j,i)   ,
+                                    + Vc(RHO,k,j,i) * Vc(VX3,k,j,i) * bodyForce(KDIR,k,j,i) ));
+        }
+      #endif
+      #if DIMENSIONS == 2 && COMPONENTS == 3
+        // Only add this term once!
+        if constexpr (dir==JDIR) {
+          rhs[MX3] += dt * Vc(RHO,k,j,i) * bodyForce(KDIR,k,j,i);
+          if constexpr(Phys::pressure) {
+            rhs[ENG] += dt * Vc(RHO,k,j,i) * Vc(VX3,k,j,i) * bodyForce(KDIR,k,j,i);
+          }
+        }
+      #endif
+    }
+
+    // Compute dt from max signal speed
+    invDtCell = invDtCell + HALF_F*(cmaxR + cmaxL) / (dl);
+
+    #pragma unroll
+    for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+      u[nv] = u[nv] + rhs[nv];
+    }
+  }
+
+  //*****************************************************************
+  // Functor Operator
+  //*****************************************************************
+  KOKKOS_INLINE_FUNCTION void operator() (const int k, const int j,  const int i) const {
+    const real dtdV = dt / dV(k,j,i);
+
+    real u[Phys::nvar];
+    #pragma unroll
+    for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+      u[nv] = Uc(nv,k,j,i);
+    }
+    real invDtCell = invDt(k,j,i);
+
+    real fluxL[Phys::nvar];
+    real fluxR[Phys::nvar];
+    real cmaxL, cmaxR;
+
+    fluxX1(k, j, i, fluxL, cmaxL);
+    fluxX1(k, j, i+1, fluxR, cmaxR);
+    AddDirection<IDIR>(k, j, i, dtdV, fluxL, cmaxL, fluxR, cmaxR, u, invDtCell);
+
+    #if DIMENSIONS >= 2
+    fluxX2(k, j, i, fluxL, cmaxL);
+    fluxX2(k, j+1, i, fluxR, cmaxR);
+    AddDirection<JDIR>(k, j, i, dtdV, fluxL, cmaxL, fluxR, cmaxR, u, invDtCell);
+    #endif
+
+    #if DIMENSIONS == 3
+    fluxX3(k, j, i, fluxL, cmaxL);
+    fluxX3(k+1, j, i, fluxR, cmaxR);
+    AddDirection<KDIR>(k, j, i, dtdV, fluxL, cmaxL, fluxR, cmaxR, u, invDtCell);
+    #endif
+
+    #pragma unroll
+    for(int nv = 0 ; nv < Phys::nvar ; nv++) {
+      Uc(nv,k,j,i) = u[nv];
+    }
+    invDt(k,j,i) = invDtCell;
+  }
+};
+
+// Check whether the fused update can replace the per-direction sweeps of LoopDir.
+// This is only implemented for cartesian HD fluids solved with TVDLF, HLL or HLLC,
+// without parabolic terms, tracers, flux boundaries, fargo, grid coarsening or face states cache.
+template<typename Phys>
+bool Fluid<Phys>::CanUseFusedUpdate() {
+  if constexpr(Phys::mhd || Phys::dust) {
+    return(false);
+  } else {
+    #if GEOMETRY != CARTESIAN
+      return(false);
+    #else
+      if(haveExplicitParabolicTerms || haveTracer) return(false);
+      if(boundary->haveFluxBoundary) return(false);
+      if(data->haveFargo || data->haveGridCoarsening) return(false);
+      // (the fluxes are not stored by the fused update)
+      if(!fluxRegisters.empty()) return(false);
+      if(rSolver->cacheFaceStates) return(false);
+      const auto solver = rSolver->GetSolver();
+      return(solver == RiemannSolver<Phys>::TVDLF
+          || solver == RiemannSolver<Phys>::HLL
+          || solver == RiemannSolver<Phys>::HLLC);
+    #endif
+  }
+}
+
+template<typename Phys>
+template<template<typename, int> class FluxFunctor>
+void Fluid<Phys>::LaunchFusedRightHandSide(real dt) {
+  auto calcRHS = Fluid_CalcFusedRHSFunctor<Phys,FluxFunctor>(this,dt);
+  idefix_for("CalcFusedRightHandSide",
+             updateBeg[KDIR],updateEnd[KDIR],
+             updateBeg[JDIR],updateEnd[JDIR],
+             updateBeg[IDIR],updateEnd[IDIR],
+              calcRHS);
+}
+
+// Compute the right handside in all of the directions with a single fused kernel
+template<typename Phys>
+void Fluid<Phys>::CalcFusedRightHandSide(real t, real dt) {
+  idfx::pushRegion("Fluid::CalcFusedRightHandSide");
+  if constexpr(Phys::mhd || Phys::dust) {
+    IDEFIX_ERROR("The fused update is only available for HD fluids");
+  } else {
+    // enable shock flattening
+    if(rSolver->shockFlattening) rSolver->shockFlattening->FindShock();
+
+    switch(rSolver->GetSolver()) {
+      case RiemannSolver<Phys>::TVDLF:
+        LaunchFusedRightHandSide<TvdlfHD_FluxFunctor>(dt);
+        break;
+      case RiemannSolver<Phys>::HLL:
+        LaunchFusedRightHandSide<HllHD_FluxFunctor>(dt);
+        break;
+      case RiemannSolver<Phys>::HLLC:
+        LaunchFusedRightHandSide<HllcHD_FluxFunctor>(dt);
+        break;
+      default:
+        IDEFIX_ERROR("The fused update is not available for this Riemann solver");
+    }
+  }
+  idfx::popRegion();
+}
+
+#endif // FLUID_CALCFUSEDRIGHTHANDSIDE_HPP_
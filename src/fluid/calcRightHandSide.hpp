@@ -52,9 +52,9 @@ struct Fluid_CorrectFluxFunctor {
   //*****************************************************************
   // Functor Variables
   //*****************************************************************
-  IdefixArray4D<real> Uc;
-  IdefixArray4D<real> Vc;
-  IdefixArray4D<real> Flux;
+  IdefixArray4D<realStore> Uc;
+  IdefixArray4D<realStore> Vc;
+  IdefixArray4D<realStore> Flux;
   IdefixArray3D<real> A;
   IdefixArray3D<real> dV;
   IdefixArray1D<real> x1m;
@@ -270,9 +270,9 @@ struct Fluid_CalcRHSFunctor {
   //*****************************************************************
   // Functor Variables
   //*****************************************************************
-  IdefixArray4D<real> Uc;
-  IdefixArray4D<real> Vc;
-  IdefixArray4D<real> Flux;
+  IdefixArray4D<realStore> Uc;
+  IdefixArray4D<realStore> Vc;
+  IdefixArray4D<realStore> Flux;
   IdefixArray3D<real> A;
   IdefixArray3D<real> dV;
   IdefixArray1D<real> x1m;
@@ -566,23 +566,26 @@ void Fluid<Phys>::CalcRightHandSide(real t, real dt) {
   const int joffset = (dir==JDIR) ? 1 : 0;
   const int koffset = (dir==KDIR) ? 1 : 0;
   idefix_for("Correct Flux",
-             data->beg[KDIR],data->end[KDIR]+koffset,
-             data->beg[JDIR],data->end[JDIR]+joffset,
-             data->beg[IDIR],data->end[IDIR]+ioffset,
+             updateBeg[KDIR],updateEnd[KDIR]+koffset,
+             updateBeg[JDIR],updateEnd[JDIR]+joffset,
+             updateBeg[IDIR],updateEnd[IDIR]+ioffset,
               fluxCorrection);
 
 
   // If user has requested specific flux functions for the boundaries, here they come
   if(boundary->haveFluxBoundary) boundary->EnforceFluxBoundaries(dir,t);
 
+  // Keep track of the fluxes through the edges of the static refinement levels
+  for(auto &reg : fluxRegisters) reg->template StoreFlux<dir>(dt);
+
   auto calcRHS = Fluid_CalcRHSFunctor<Phys,dir>(this,dt);
   /////////////////////////////////////////////////////////////////////////////
   // Final conserved quantity budget from fluxes divergence
   /////////////////////////////////////////////////////////////////////////////
   idefix_for("CalcRightHandSide",
-             data->beg[KDIR],data->end[KDIR],
-             data->beg[JDIR],data->end[JDIR],
-             data->beg[IDIR],data->end[IDIR],
+             updateBeg[KDIR],updateEnd[KDIR],
+             updateBeg[JDIR],updateEnd[JDIR],
+             updateBeg[IDIR],updateEnd[IDIR],
               calcRHS);
 
 
@@ -60,7 +60,7 @@ real Fluid<Phys>::CheckDivB() {
 
 #ifdef WITH_MPI
   if(idfx::psize>1) {
-    MPI_Allreduce(MPI_IN_PLACE, &divB, 1, realMPI, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &divB, 1, realMPI, MPI_MAX, data->mygrid->CartComm);
   }
 #endif
 
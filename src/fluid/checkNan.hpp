@@ -20,7 +20,7 @@ int Fluid<Phys>::CheckNan()  {
   int nanVc=0;
 
   idfx::pushRegion("Fluid::CheckNan");
-  IdefixArray4D<real> Vc=this->Vc;
+  IdefixArray4D<realStore> Vc=this->Vc;
 
   idefix_reduce("checkNanVc",
     0, Phys::nvar,
@@ -48,7 +48,7 @@ int Fluid<Phys>::CheckNan()  {
 
   int nanTot = nanVc+nanVs;
   #ifdef WITH_MPI
-    MPI_Allreduce(MPI_IN_PLACE, &nanTot,1,MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &nanTot,1,MPI_INT, MPI_SUM, data->mygrid->CartComm);
   #endif
   if(nanTot>0) {
     idfx::cout << "Fluid<" << prefix << ">: Nans were found in the current calculation"
@@ -67,7 +67,7 @@ int Fluid<Phys>::CheckNan()  {
 
       DataBlockHost dataHost(*data);
 
-      IdefixHostArray4D<real> VcHost = Kokkos::create_mirror_view(this->Vc);
+      IdefixHostArray4D<realStore> VcHost = Kokkos::create_mirror_view(this->Vc);
       Kokkos::deep_copy(VcHost,Vc);
 
       int nerrormax=10;
@@ -128,4 +128,22 @@ int Fluid<Phys>::CheckNan()  {
   return(nanTot);
 }
 
+// Count the Nans of the active cells as a side effect of the kernels which already read every
+// cell, instead of a dedicated reduction over the whole grid. The face-centred field Vs is not
+// tracked: a Nan there only shows up once it has reached the cell-centred variables.
+template<typename Phys>
+void Fluid<Phys>::EnableNanTracking() {
+  this->nanTracking = true;
+  this->nanCount = IdefixArray1D<int>(prefix+"_NanCount",1);
+}
+
+// Number of Nans found in the current datablock since the tracking was enabled
+template<typename Phys>
+int Fluid<Phys>::GetTrackedNans() {
+  if(!nanTracking) return(0);
+  IdefixArray1D<int>::HostMirror nanCountHost = Kokkos::create_mirror_view(nanCount);
+  Kokkos::deep_copy(nanCountHost, nanCount);
+  return(nanCountHost(0));
+}
+
 #endif // FLUID_CHECKNAN_HPP_
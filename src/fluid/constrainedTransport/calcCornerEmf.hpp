@@ -59,7 +59,8 @@ void ConstrainedTransport<Phys>::CalcArithmeticAverage() {
 
   #if MHD == YES && DIMENSIONS >= 2
 
-  idefix_for("CalcArithmeticAverage",
+  // Stencil along j and k: the planes k-1 are reused by the tiled loop
+  idefix_for_tiled("CalcArithmeticAverage",
             data->beg[KDIR],data->end[KDIR]+KOFFSET,
             data->beg[JDIR],data->end[JDIR]+JOFFSET,
             data->beg[IDIR],data->end[IDIR]+IOFFSET,
@@ -84,7 +85,7 @@ void ConstrainedTransport<Phys>::CalcArithmeticAverage() {
 template<typename Phys>
 void ConstrainedTransport<Phys>::CalcCellCenteredEMF() {
   idfx::pushRegion("ConstrainedTransport::CalcCellCenteredEMF");
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
     // cell-centered EMFs
   IdefixArray3D<real> Ex1 = this->Ex1;
   IdefixArray3D<real> Ex2 = this->Ex2;
@@ -23,7 +23,7 @@ void ConstrainedTransport<Phys>::CalcNonidealEMF(real t) {
   IdefixArray3D<real> ez = this->ez;
   IdefixArray4D<real> J = hydro->J;
   IdefixArray4D<real> Vs = hydro->Vs;
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
 
   // These arrays have been previously computed in calcParabolicFlux
   IdefixArray3D<real> etaArr = hydro->etaOhmic;
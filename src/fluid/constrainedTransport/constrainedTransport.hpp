@@ -8,9 +8,11 @@
 #ifndef FLUID_CONSTRAINEDTRANSPORT_CONSTRAINEDTRANSPORT_HPP_
 #define FLUID_CONSTRAINEDTRANSPORT_CONSTRAINEDTRANSPORT_HPP_
 
+#include <memory>
 #include "idefix.hpp"
 #include "input.hpp"
 #include "riemannSolver.hpp"
+#include "shearingBoxExchange.hpp"
 
 // Forward declarations
 #include "physics.hpp"
@@ -70,6 +72,8 @@ class ConstrainedTransport {
   IdefixArray2D<real>     sbEyL;
   IdefixArray2D<real>     sbEyR;
   IdefixArray2D<real>     sbEyRL;
+  IdefixArray4D<real>     sbColumn;   // rows of the X2 column Ey is shifted from
+  std::unique_ptr<ShearingBoxExchange> sbExchange;
 
   // Range of existence
 
@@ -186,6 +190,9 @@ ConstrainedTransport<Phys>::ConstrainedTransport(Input &input, Fluid<Phys> *hydr
     sbEyL = IdefixArray2D<real>("EMF_sbEyL", data->np_tot[KDIR], data->np_tot[JDIR]);
     sbEyR = IdefixArray2D<real>("EMF_sbEyR", data->np_tot[KDIR], data->np_tot[JDIR]);
     sbEyRL = IdefixArray2D<real>("EMF_sbEyRL", data->np_tot[KDIR], data->np_tot[JDIR]);
+    sbColumn = IdefixArray4D<real>("EMF_sbColumn", 1, data->np_tot[KDIR],
+                                   data->np_tot[JDIR]+4, 1);
+    sbExchange = std::make_unique<ShearingBoxExchange>(data);
   }
 
   D_EXPAND( ez = IdefixArray3D<real>("EMF_ez",
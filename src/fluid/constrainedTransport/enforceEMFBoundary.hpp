@@ -137,7 +137,8 @@ void ConstrainedTransport<Phys>::SymmetrizeEMFShearingBox() {
                             });
     }
 
-    // todo: exchange sbEyR and sbEyL when domain-decomposed along y
+    // Exchange sbEyR and sbEyL with the other side of the box (the shift along y, which may
+    // involve other processes of the X2 column, is done by ExtrapolateEMFShearingBox)
     #ifdef WITH_MPI
       if(data->mygrid->nproc[IDIR]>1) {
         int procLeft, procRight;
@@ -192,12 +193,6 @@ template<typename Phys>
 void ConstrainedTransport<Phys>::ExtrapolateEMFShearingBox(BoundarySide side,
                                                    IdefixArray2D<real> Ein,
                                                    IdefixArray2D<real> Eout) {
-  const int nxi = data->np_int[IDIR];
-  const int nxj = data->np_int[JDIR];
-
-  const int ighost = data->nghost[IDIR];
-  const int jghost = data->nghost[JDIR];
-
   // Shear rate
   const real S  = hydro->sbS;
 
@@ -220,51 +215,21 @@ void ConstrainedTransport<Phys>::ExtrapolateEMFShearingBox(BoundarySide side,
   // remainding shift
   const real eps = dL / dy - m;
 
+  // Get the rows jo-2...jo+2 around the origin jo=j-m of each row j, which may belong to
+  // other processes when the domain is decomposed along X2
+  IdefixArray4D<real> slab(Ein.data(), 1, data->np_tot[KDIR], data->np_tot[JDIR], 1);
+  IdefixArray4D<real> column = sbColumn;
+  sbExchange->Gather(slab, m, column);
+
   // New we need to perform the shift
   idefix_for("BoundaryShearingBoxEMF", 0, data->np_tot[KDIR],
                                        0, data->np_tot[JDIR],
         KOKKOS_LAMBDA (int k, int j) {
-          // jorigin
-          const int jo = jghost + ((j-m-jghost)%nxj+nxj)%nxj;
-          const int jop2 = jghost + ((jo+2-jghost)%nxj+nxj)%nxj;
-          const int jop1 = jghost + ((jo+1-jghost)%nxj+nxj)%nxj;
-          const int jom1 = jghost + ((jo-1-jghost)%nxj+nxj)%nxj;
-          const int jom2 = jghost + ((jo-2-jghost)%nxj+nxj)%nxj;
-
-          // Define Left and right fluxes
-          // Fluxes are defined from slope-limited interpolation
-          // Using Van-leer slope limiter (consistently with the main advection scheme)
-          real Fl,Fr;
-          real dqm, dqp, dq;
-
-          if(eps>=ZERO_F) {
-            // Compute Fl
-            dqm = Ein(k,jom1) - Ein(k,jom2);
-            dqp = Ein(k,jo) - Ein(k,jom1);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fl = Ein(k,jom1) + 0.5*dq*(1.0-eps);
-            //Compute Fr
-            dqm=dqp;
-            dqp = Ein(k,jop1) - Ein(k,jo);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fr = Ein(k,jo) + 0.5*dq*(1.0-eps);
-          } else {
-            //Compute Fl
-            dqm = Ein(k,jo) - Ein(k,jom1);
-            dqp = Ein(k,jop1) - Ein(k,jo);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fl = Ein(k,jo) - 0.5*dq*(1.0+eps);
-            // Compute Fr
-            dqm=dqp;
-            dqp = Ein(k,jop2) - Ein(k,jop1);
-            dq = (dqp*dqm > ZERO_F ? TWO_F*dqp*dqm/(dqp + dqm) : ZERO_F);
-
-            Fr = Ein(k,jop1) - 0.5*dq*(1.0+eps);
+          real q[5];
+          for(int d = 0 ; d < 5 ; d++) {
+            q[d] = column(0,k,j+d,0);
           }
-          Eout(k,j) = Ein(k,jo) - eps*(Fr - Fl);
+          Eout(k,j) = K_ShearingBoxShift(q, eps);
         });
 }
 #endif // FLUID_CONSTRAINEDTRANSPORT_ENFORCEEMFBOUNDARY_HPP_
@@ -106,8 +106,8 @@ template<typename Phys>
 void Fluid<Phys>::ConvertConsToPrim() {
   idfx::pushRegion("Fluid::ConvertConsToPrim");
 
-  IdefixArray4D<real> Vc = this->Vc;
-  IdefixArray4D<real> Uc = this->Uc;
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
   EquationOfState eos;
   if constexpr(Phys::eos) {
     eos = *(this->eos.get());
@@ -120,10 +120,22 @@ void Fluid<Phys>::ConvertConsToPrim() {
     boundary->ReconstructVcField(Uc);
   }
 
+  const bool nanTracking = this->nanTracking;
+  IdefixArray1D<int> nanCount = this->nanCount;
+  const int ibeg = data->beg[IDIR];
+  const int iend = data->end[IDIR];
+  const int jbeg = data->beg[JDIR];
+  const int jend = data->end[JDIR];
+  const int kbeg = data->beg[KDIR];
+  const int kend = data->end[KDIR];
+
+  // When the MPI exchanges are overlapped with the update, Uc is only valid in the active
+  // domain: the ghost zones of Vc, completed during the update, are kept
+  const bool active = boundary->overlapStage;
   idefix_for("ConsToPrim",
-             0,data->np_tot[KDIR],
-             0,data->np_tot[JDIR],
-             0,data->np_tot[IDIR],
+             active ? kbeg : 0, active ? kend : data->np_tot[KDIR],
+             active ? jbeg : 0, active ? jend : data->np_tot[JDIR],
+             active ? ibeg : 0, active ? iend : data->np_tot[IDIR],
     KOKKOS_LAMBDA (int k, int j, int i) {
       real U[Phys::nvar];
       real V[Phys::nvar];
@@ -135,9 +147,15 @@ void Fluid<Phys>::ConvertConsToPrim() {
 
       K_ConsToPrim<Phys>(V,U,&eos);
 
+      bool nan = false;
 #pragma unroll
       for(int nv = 0 ; nv<Phys::nvar; nv++) {
         Vc(nv,k,j,i) = V[nv];
+        nan = nan || std::isnan(V[nv]);
+      }
+      // Only the active cells are checked, as in CheckNan
+      if(nanTracking && nan && i>=ibeg && i<iend && j>=jbeg && j<jend && k>=kbeg && k<kend) {
+        Kokkos::atomic_increment(&nanCount(0));
       }
   });
 
@@ -153,17 +171,19 @@ template<typename Phys>
 void Fluid<Phys>::ConvertPrimToCons() {
   idfx::pushRegion("Fluid::ConvertPrimToCons");
 
-  IdefixArray4D<real> Vc = this->Vc;
-  IdefixArray4D<real> Uc = this->Uc;
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
   EquationOfState eos;
   if constexpr(Phys::eos) {
     eos = *(this->eos.get());
   }
 
+  // The ghost zones of Vc are still being exchanged when the overlap is enabled
+  const bool active = boundary->overlapStage;
   idefix_for("ConvertPrimToCons",
-             0,data->np_tot[KDIR],
-             0,data->np_tot[JDIR],
-             0,data->np_tot[IDIR],
+             active ? data->beg[KDIR] : 0, active ? data->end[KDIR] : data->np_tot[KDIR],
+             active ? data->beg[JDIR] : 0, active ? data->end[JDIR] : data->np_tot[JDIR],
+             active ? data->beg[IDIR] : 0, active ? data->end[IDIR] : data->np_tot[IDIR],
     KOKKOS_LAMBDA (int k, int j, int i) {
       real U[Phys::nvar];
       real V[Phys::nvar];
@@ -188,4 +208,132 @@ void Fluid<Phys>::ConvertPrimToCons() {
   idfx::popRegion();
 }
 
+// Streamlined stages of the time integrator: the conversions are only done in the active cells
+// (the ghost cells of Vc are set by the boundary conditions, and those of Uc are never used),
+// and they are fused with the copy of the initial state and with the combination of the stages.
+
+// Convert primitive to conservative variables, and store a copy of Uc in Uc0 when the latter
+// is allocated (initial state of multi-stage integrators)
+template<typename Phys>
+void Fluid<Phys>::ConvertPrimToConsAndStore(IdefixArray4D<realStore> Uc0) {
+  idfx::pushRegion("Fluid::ConvertPrimToConsAndStore");
+
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
+  EquationOfState eos;
+  if constexpr(Phys::eos) {
+    eos = *(this->eos.get());
+  }
+
+  // Passive tracers are converted first, so that they can be stored along with the other variables
+  if(haveTracer) {
+    tracer->ConvertPrimToCons();
+  }
+
+  const bool store = Uc0.is_allocated();
+  const int nvarTot = Uc.extent(0);
+
+  idefix_for("PrimToConsAndStore",
+             data->beg[KDIR],data->end[KDIR],
+             data->beg[JDIR],data->end[JDIR],
+             data->beg[IDIR],data->end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      real U[Phys::nvar];
+      real V[Phys::nvar];
+
+#pragma unroll
+      for(int nv = 0 ; nv < Phys::nvar; nv++) {
+        V[nv] = Vc(nv,k,j,i);
+      }
+
+      K_PrimToCons<Phys>(U,V,&eos);
+
+#pragma unroll
+      for(int nv = 0 ; nv<Phys::nvar; nv++) {
+        Uc(nv,k,j,i) = U[nv];
+        if(store) Uc0(nv,k,j,i) = U[nv];
+      }
+      if(store) {
+        for(int nv = Phys::nvar ; nv < nvarTot ; nv++) {
+          Uc0(nv,k,j,i) = Uc(nv,k,j,i);
+        }
+      }
+  });
+
+  idfx::popRegion();
+}
+
+// Combine the current conservative variables with those of the initial state,
+// Uc = wc*Uc + w0*Uc0 (when Uc0 is allocated), and convert the result into primitive variables
+template<typename Phys>
+void Fluid<Phys>::AddAndConvertConsToPrim(const real wc, const real w0,
+                                          IdefixArray4D<realStore> Uc0) {
+  idfx::pushRegion("Fluid::AddAndConvertConsToPrim");
+
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
+  EquationOfState eos;
+  if constexpr(Phys::eos) {
+    eos = *(this->eos.get());
+  }
+
+  if constexpr(Phys::mhd) {
+    // The cell-centered field is rebuilt from the face-centered field, which has already been
+    // combined with its initial state
+    #ifdef EVOLVE_VECTOR_POTENTIAL
+      emf->ComputeMagFieldFromA(Ve,Vs);
+    #endif
+    boundary->ReconstructVcField(Uc);
+  }
+
+  const bool add = Uc0.is_allocated();
+  const bool nanTracking = this->nanTracking;
+  IdefixArray1D<int> nanCount = this->nanCount;
+  const int nvarTot = Uc.extent(0);
+
+  idefix_for("AddAndConsToPrim",
+             data->beg[KDIR],data->end[KDIR],
+             data->beg[JDIR],data->end[JDIR],
+             data->beg[IDIR],data->end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      real U[Phys::nvar];
+      real V[Phys::nvar];
+
+#pragma unroll
+      for(int nv = 0 ; nv < Phys::nvar; nv++) {
+        // Only the field components along the dimensions are rebuilt from Vs: the other ones
+        // (2.5D and 1.5D setups) are combined here like the other variables
+        if(add && !(Phys::mhd && nv >= BX1 && nv < BX1+DIMENSIONS)) {
+          // Rounded to the storage precision, as done by StateContainer::AddAndStore
+          const realStore u = wc * Uc(nv,k,j,i) + w0 * Uc0(nv,k,j,i);
+          Uc(nv,k,j,i) = u;
+          U[nv] = u;
+        } else {
+          U[nv] = Uc(nv,k,j,i);
+        }
+      }
+      if(add) {
+        for(int nv = Phys::nvar ; nv < nvarTot ; nv++) {
+          Uc(nv,k,j,i) = wc * Uc(nv,k,j,i) + w0 * Uc0(nv,k,j,i);
+        }
+      }
+
+      K_ConsToPrim<Phys>(V,U,&eos);
+
+      bool nan = false;
+#pragma unroll
+      for(int nv = 0 ; nv<Phys::nvar; nv++) {
+        Vc(nv,k,j,i) = V[nv];
+        nan = nan || std::isnan(V[nv]);
+      }
+      if(nanTracking && nan) Kokkos::atomic_increment(&nanCount(0));
+  });
+
+  if(haveTracer) {
+    tracer->ConvertConsToPrim();
+  }
+
+  idfx::popRegion();
+}
+
 #endif //FLUID_CONVERTCONSTOPRIM_HPP_
@@ -25,13 +25,20 @@ class GammaDrag {
   void RefreshUserDrag(DataBlock *);
 
   KOKKOS_INLINE_FUNCTION real GetGamma(const int k, const int j, const int i) const {
-    real gamma;  // The drag coefficient
+    if(type == Type::Userdef) return(gammai(k,j,i));
+    return(GetGamma(dragCoeff, k, j, i));
+  }
+
+  // Drag coefficient of a specie with drag parameter coeff (not for user-defined drag laws)
+  KOKKOS_INLINE_FUNCTION real GetGamma(const real coeff,
+                                       const int k, const int j, const int i) const {
+    real gamma{0};  // The drag coefficient
     if(type ==  Type::Gamma) {
-      gamma = dragCoeff;
+      gamma = coeff;
 
     } else if(type == Type::Tau) {
       // In this case, the coefficient is the stopping time (assumed constant)
-      gamma = 1/(dragCoeff*VcGas(RHO,k,j,i));
+      gamma = 1/(coeff*VcGas(RHO,k,j,i));
     } else if(type == Type::Size) {
       real cs;
       // Assume a fixed size, hence for both Epstein or Stokes, gamma~1/rho_g/cs
@@ -42,9 +49,7 @@ class GammaDrag {
       #else
         cs = eos.GetWaveSpeed(k,j,i);
       #endif
-      gamma = cs/dragCoeff;
-    } else if(type == Type::Userdef) {
-      gamma = gammai(k,j,i);
+      gamma = cs/coeff;
     }
     return gamma;
   }
@@ -53,7 +58,7 @@ class GammaDrag {
   real dragCoeff;
   EquationOfState eos;
   IdefixArray3D<real> gammai;
-  IdefixArray4D<real> VcGas;
+  IdefixArray4D<realStore> VcGas;
 
   int instanceNumber;
   UserDefDragFunc userDrag{NULL};
@@ -77,11 +82,12 @@ class Drag {
 
   void EnrollUserDrag(UserDefDragFunc);   // User defined drag function enrollment
   bool IsImplicit() const { return implicit; }  // Check if the drag is implicit
+  bool HasFeedback() const { return feedback; }  // Check if the gas feels the drag
 
-  IdefixArray4D<real> UcDust;  // Dust conservative quantities
-  IdefixArray4D<real> UcGas;  // Gas conservative quantities
-  IdefixArray4D<real> VcDust;  // Gas primitive quantities
-  IdefixArray4D<real> VcGas;  // Gas primitive quantities
+  IdefixArray4D<realStore> UcDust;  // Dust conservative quantities
+  IdefixArray4D<realStore> UcGas;  // Gas conservative quantities
+  IdefixArray4D<realStore> VcDust;  // Gas primitive quantities
+  IdefixArray4D<realStore> VcGas;  // Gas primitive quantities
   IdefixArray3D<real> InvDt;  // The InvDt of current dust specie
   IdefixArray3D<real> implicitFactor; // The prefactor used by the implicit timestepping
 
@@ -29,6 +29,7 @@ class EquationOfState {
   // So we add default values to 0 here so that GetGamma can be called without any argument
   KOKKOS_INLINE_FUNCTION real GetGamma(real P = 0.0, real rho = 0.0) const {return gamma;}
   void Refresh(DataBlock &, real) {}  // Refresh the eos (recompute coefficients and tables)
+  bool RefreshReadsFlow() const { return(false); }  // Whether Refresh may read the flow
 
   KOKKOS_INLINE_FUNCTION
   real GetWaveSpeed(int k, int j, int i) const {
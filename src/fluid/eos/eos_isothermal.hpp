@@ -67,6 +67,12 @@ class EquationOfState {
     idfx::popRegion();
   }
 
+  // Whether Refresh may read the flow (user-defined sound speeds can depend on it, ghost zones
+  // included)
+  bool RefreshReadsFlow() const {
+    return(haveIsoSoundSpeed == UserDefFunction);
+  }
+
   KOKKOS_INLINE_FUNCTION real GetWaveSpeed(const int k, const int j, const int i) const {
     if(haveIsoSoundSpeed == UserDefFunction) {
       return isoSoundSpeedArray(k,j,i);
@@ -34,6 +34,65 @@ void Fluid<Phys>::LoopDir(const real t, const real dt) {
     if constexpr (dir+1 < DIMENSIONS) LoopDir<dir+1>(t, dt);
 }
 
+// Update the cells of the current update region
+template<typename Phys>
+void Fluid<Phys>::LoopAllDirs(const real t, const real dt) {
+  if(fusedUpdate && CanUseFusedUpdate()) {
+    CalcFusedRightHandSide(t,dt);
+  } else {
+    LoopDir<IDIR>(t,dt);
+  }
+}
+
+// Loop on all of the directions while the MPI exchanges started by Boundary::StartBoundaries
+// are in flight. The cells which are at least nghost cells away from the domain edges do not
+// depend on the ghost zones, so they are updated first. The ghost zones are then completed,
+// and the remaining slabs along each edge are updated. Each cell is updated exactly once.
+template<typename Phys>
+void Fluid<Phys>::LoopDirOverlapMpi(const real t, const real dt) {
+  idfx::pushRegion("Fluid::LoopDirOverlapMpi");
+  bool haveInner = true;
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    const int ng = (dir < DIMENSIONS) ? data->nghost[dir] : 0;
+    updateBeg[dir] = data->beg[dir] + ng;
+    updateEnd[dir] = data->end[dir] - ng;
+    if(updateEnd[dir] <= updateBeg[dir]) haveInner = false;
+  }
+  if(haveInner) LoopAllDirs(t,dt);
+
+  boundary->FinishBoundaries(t);
+
+  // Slabs along the edges of direction dir, excluding the slabs of the previous directions
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    const int ng = data->nghost[dir];
+    for(BoundarySide side : {left, right}) {
+      for(int d = 0 ; d < 3 ; d++) {
+        const int ngd = (d < DIMENSIONS) ? data->nghost[d] : 0;
+        if(d < dir) {
+          updateBeg[d] = data->beg[d] + ngd;
+          updateEnd[d] = data->end[d] - ngd;
+        } else {
+          updateBeg[d] = data->beg[d];
+          updateEnd[d] = data->end[d];
+        }
+      }
+      if(side == left) {
+        updateEnd[dir] = data->beg[dir] + ng;
+      } else {
+        updateBeg[dir] = data->end[dir] - ng;
+      }
+      LoopAllDirs(t,dt);
+    }
+  }
+
+  // Back to the full active domain
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    updateBeg[dir] = data->beg[dir];
+    updateEnd[dir] = data->end[dir];
+  }
+  idfx::popRegion();
+}
+
 
 
 // Evolve one step forward in time of hydro
@@ -55,7 +114,11 @@ void Fluid<Phys>::EvolveStage(const real t, const real dt) {
   }
 
   // Loop on all of the directions
-  LoopDir<IDIR>(t,dt);
+  if(boundary->haveExchangePending) {
+    LoopDirOverlapMpi(t,dt);
+  } else {
+    LoopAllDirs(t,dt);
+  }
 
   // Step 4: add source terms to the conserved variables (curvature, rotation, etc)
   if(haveSourceTerms) AddSourceTerms(t, dt);
@@ -75,6 +138,7 @@ void Fluid<Phys>::EvolveStage(const real t, const real dt) {
         emf->CalcNonidealEMF(t);
       }
       emf->EnforceEMFBoundary();
+      for(auto &reg : fluxRegisters) reg->StoreEMF(dt);
       #ifdef EVOLVE_VECTOR_POTENTIAL
         emf->EvolveVectorPotential(dt, Ve);
         emf->ComputeMagFieldFromA(Ve, Vs);
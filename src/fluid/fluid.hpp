@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <array>
 
 #include "idefix.hpp"
 #include "grid.hpp"
@@ -42,6 +43,9 @@ class RiemannSolver;
 template<typename Phys>
 class ShockFlattening;
 
+template<typename Phys>
+class FluxRegister;
+
 class Viscosity;
 class ThermalDiffusion;
 class BragViscosity;
@@ -56,19 +60,25 @@ class Fluid {
   Fluid( Grid &, Input&, DataBlock *, int n = 0);
   void ConvertConsToPrim();
   void ConvertPrimToCons();
+  void ConvertPrimToConsAndStore(IdefixArray4D<realStore>);
+  void AddAndConvertConsToPrim(const real, const real, IdefixArray4D<realStore>);
   template <int> void CalcParabolicFlux(const real);
   template <int> void AddNonIdealMHDFlux(const real);
   template <int> void CalcRightHandSide(real, real );
+  void CalcFusedRightHandSide(real, real );
+  bool CanUseFusedUpdate();
   void CalcCurrent();
   void AddSourceTerms(real, real );
-  void CoarsenFlow(IdefixArray4D<real>&);
+  void CoarsenFlow(IdefixArray4D<realStore>&);
   void CoarsenMagField(IdefixArray4D<real>&);
   real CheckDivB();
   void EvolveStage(const real, const real);
   void ResetStage();
   void ShowConfig();
-  IdefixArray4D<real> GetFlux() {return this->FluxRiemann;}
+  IdefixArray4D<realStore> GetFlux() {return this->FluxRiemann;}
   int CheckNan();
+  void EnableNanTracking();
+  int GetTrackedNans();
 
   // Our boundary conditions
   std::unique_ptr<Boundary<Phys>> boundary;
@@ -79,6 +89,9 @@ class Fluid {
   // Source terms
   bool haveSourceTerms{false};
 
+  // Whether the fused update (all of the directions in a single kernel) has been requested
+  bool fusedUpdate{false};
+
   // Parabolic terms
   bool haveExplicitParabolicTerms{false};
   bool haveRKLParabolicTerms{false};
@@ -139,6 +152,9 @@ class Fluid {
   bool haveTracer{false};
   int nTracer{0};
 
+  // Registers of the fluxes through the edges of the static refinement levels
+  std::vector<std::unique_ptr<FluxRegister<Phys>>> fluxRegisters;
+
 
   // Enroll user-defined boundary conditions (proxies for boundary class functions)
   template <typename T>
@@ -164,10 +180,11 @@ class Fluid {
 
 
   // Arrays required by the Hydro object
-  IdefixArray4D<real> Vc;      // Main cell-centered primitive variables index
+  // (cell-centered arrays are stored in single precision with MIXED_PRECISION, see real_types.hpp)
+  IdefixArray4D<realStore> Vc; // Main cell-centered primitive variables index
   IdefixArray4D<real> Vs;      // Main face-centered varariables
   IdefixArray4D<real> Ve;      // Main edge-centered varariables (only when EVOLVE_VECTOR_POTENTIAL)
-  IdefixArray4D<real> Uc;      // Main cell-centered conservative variables
+  IdefixArray4D<realStore> Uc; // Main cell-centered conservative variables
   IdefixArray4D<real> J;       // Electrical current
                                // (only defined when non-ideal MHD effects are enabled)
 
@@ -182,7 +199,11 @@ class Fluid {
   // Required by time integrator
   IdefixArray3D<real> InvDt;
 
-  IdefixArray4D<real> FluxRiemann;
+  // Nan tracking: the Nans are counted by ConvertConsToPrim and by the timestep reduction
+  bool nanTracking{false};
+  IdefixArray1D<int> nanCount;
+
+  IdefixArray4D<realStore> FluxRiemann;
   IdefixArray3D<real> dMax;    // Maximum diffusion speed
 
   std::unique_ptr<RiemannSolver<Phys>> rSolver;
@@ -215,6 +236,9 @@ class Fluid {
   template <typename P, int dir>
   friend struct Fluid_CalcRHSFunctor;
 
+  template <typename P, template<typename, int> class F>
+  friend struct Fluid_CalcFusedRHSFunctor;
+
   template<typename P>
   friend struct ShockFlattening_FindShockFunctor;
 
@@ -236,6 +260,11 @@ class Fluid {
 
   IdefixArray3D<real> cMax;    // Maximum propagation speed
 
+  // Sub-domain on which the fluxes and right hand side are computed. This is the full active
+  // domain, except when MPI exchanges are overlapped with the computation.
+  std::array<int,3> updateBeg;
+  std::array<int,3> updateEnd;
+
   // Nonideal effect diffusion coefficient (only allocated when needed)
   IdefixArray3D<real> etaOhmic;
   IdefixArray3D<real> xHall;
@@ -244,6 +273,15 @@ class Fluid {
   // Loop on dimensions
   template <int dir>
   void LoopDir(const real, const real);
+
+  // Loop on dimensions, overlapping MPI exchanges with the computation of inner cells
+  void LoopDirOverlapMpi(const real, const real);
+
+  // Update the cells of the current update region, either with LoopDir or with the fused update
+  void LoopAllDirs(const real, const real);
+
+  template <template<typename, int> class>
+  void LaunchFusedRightHandSide(real);
 };
 
 #include "physics.hpp"
@@ -258,6 +296,7 @@ class Fluid {
 #include "drag.hpp"
 #include "checkNan.hpp"
 #include "tracer.hpp"
+#include "fluxRegister.hpp"
 
 
 template<typename Phys>
@@ -526,21 +565,44 @@ Fluid<Phys>::Fluid(Grid &grid, Input &input, DataBlock *datain, int n) {
   /////////////////////////////////////////
 
   // We now allocate the fields required by the hydro solver
-  Vc = IdefixArray4D<real>(prefix+"_Vc", Phys::nvar+nTracer,
-                           data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  Uc = IdefixArray4D<real>(prefix+"_Uc", Phys::nvar+nTracer,
-                           data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-
-  data->states["current"].PushArray(Uc, State::center, prefix+"_Uc");
-
-  InvDt = IdefixArray3D<real>(prefix+"_InvDt",
-                              data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  cMax = IdefixArray3D<real>(prefix+"_cMax",
-                              data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  dMax = IdefixArray3D<real>(prefix+"_dMax",
-                              data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  FluxRiemann =  IdefixArray4D<real>(prefix+"_FluxRiemann", Phys::nvar+nTracer,
+  // When the domain of the process is split in blocks, each block evolves its own fluids: the
+  // fluids of the process only hold the primitive variables, which are scattered to the blocks
+  // after the initial conditions and gathered from them for the outputs.
+  const bool primitivesOnly = data->haveBlocks;
+  if(Phys::dust && data->haveFusedDust) {
+    // The fields of the dust species are views of the species-indexed arrays of the fused
+    // dust engine (whose Uc is already part of the current state)
+    if(haveTracer) {
+      IDEFIX_ERROR("Passive tracers are not compatible with fused dust species");
+    }
+    FusedDust *fused = data->fusedDust.get();
+    Vc = fused->SpecieVariables(fused->Vc, n);
+    Uc = fused->SpecieVariables(fused->Uc, n);
+    InvDt = fused->SpecieField(fused->InvDt, n);
+    cMax = fused->SpecieField(fused->cMax, n);
+    FluxRiemann = fused->SpecieVariables(fused->Flux, n);
+  } else if(primitivesOnly) {
+    Vc = IdefixArray4D<realStore>(prefix+"_Vc", Phys::nvar+nTracer,
+                             data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+  } else {
+    Vc = IdefixArray4D<realStore>(prefix+"_Vc", Phys::nvar+nTracer,
+                             data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+    Uc = IdefixArray4D<realStore>(prefix+"_Uc", Phys::nvar+nTracer,
+                             data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+
+    data->states["current"].PushArray(Uc, State::center, prefix+"_Uc");
+
+    InvDt = IdefixArray3D<real>(prefix+"_InvDt",
+                                data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+    cMax = IdefixArray3D<real>(prefix+"_cMax",
+                                data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+    FluxRiemann =  IdefixArray4D<realStore>(prefix+"_FluxRiemann", Phys::nvar+nTracer,
                                      data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+  }
+  if(!primitivesOnly) {
+    dMax = IdefixArray3D<real>(prefix+"_dMax",
+                                data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
+  }
 
   if constexpr(Phys::mhd) {
     Vs = IdefixArray4D<real>(prefix+"_Vs", DIMENSIONS,
@@ -716,6 +778,24 @@ Fluid<Phys>::Fluid(Grid &grid, Input &input, DataBlock *datain, int n) {
   boundary = std::make_unique<Boundary<Phys>>(this);
   this->haveAxis = data->haveAxis;
 
+  // By default, the whole active domain is updated at once
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    updateBeg[dir] = data->beg[dir];
+    updateEnd[dir] = data->end[dir];
+  }
+
+  // Overlap MPI exchanges with the computation of the inner cells (shared by all the fluids)
+  if(prefix.compare("Hydro") == 0) {
+    boundary->overlapMpi = input.GetOrSet<bool>("Hydro","mpiOverlap",0,false);
+  } else {
+    boundary->overlapMpi = data->hydro->boundary->overlapMpi;
+  }
+
+  // Compute the flux divergence of all of the directions in a single kernel
+  if(input.CheckEntry(std::string(Phys::prefix),"fusedUpdate")>=0) {
+    this->fusedUpdate = input.Get<bool>(std::string(Phys::prefix),"fusedUpdate",0);
+  }
+
   if(haveRKLParabolicTerms) {
     this->rkl = std::make_unique<RKLegendre<Phys>>(input,this);
   }
@@ -757,6 +837,7 @@ Fluid<Phys>::Fluid(Grid &grid, Input &input, DataBlock *datain, int n) {
 
 #include "addSourceTerms.hpp"
 #include "calcRightHandSide.hpp"
+#include "calcFusedRightHandSide.hpp"
 #include "enroll.hpp"
 #include "calcCurrent.hpp"
 #include "coarsenFlow.hpp"
@@ -0,0 +1,242 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef FLUID_FLUXREGISTER_HPP_
+#define FLUID_FLUXREGISTER_HPP_
+
+#include <array>
+#include <string>
+#include "idefix.hpp"
+
+// Forward class declaration
+template <typename Phys> class Fluid;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+/// Time-integrated fluxes and EMFs of a fluid through the sides of a box of cells, used by the
+/// static mesh refinement to correct the coarse level so that it is consistent with the fine
+/// level (reflux). The box is counted in cells of the coarse level: each of its cells is made of
+/// ratio[dir] cells of the fluid along each direction (1 on the coarse level, 2 along the
+/// refined dimensions on the fine level).
+/// The registers are pushed in the current state of the DataBlock, so that the time integrator
+/// combines them like the conservative variables: once a step is done, they hold the fluxes
+/// actually applied to the cells during that step, whatever the number of stages.
+//////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename Phys>
+class FluxRegister {
+ public:
+  FluxRegister(Fluid<Phys> *, const std::array<int,3> &base, const std::array<int,3> &size,
+               const std::array<int,3> &ratio, const std::array<std::array<bool,2>,3> &sides,
+               const std::string &name);
+
+  void Reset();                                 ///< Set all of the registers to zero
+  template <int dir> void StoreFlux(const real);  ///< Add dt*the fluxes of the sides along dir
+  void StoreEMF(const real);                    ///< Add dt*the EMFs of the edges of the sides
+
+  std::array<int,3> base;     ///< local index of the first cell of the box in the fluid arrays
+  std::array<int,3> size;     ///< size of the box (in coarse cells)
+  std::array<int,3> ratio;    ///< number of cells of the fluid per coarse cell
+  std::array<std::array<bool,2>,3> sides;   ///< whether each side of the box is registered
+
+  /// Fluxes through the sides normal to each direction, indexed by (var,k,j,i), where the index
+  /// along that direction is the side (0 for left, 1 for right)
+  std::array<IdefixArray4D<real>,3> flux;
+  /// EMFs along each direction, on the edges of the box (only the edges which lie on one of the
+  /// registered sides are filled). Only defined for the components evolved by CT.
+  std::array<IdefixArray4D<real>,3> emf;
+
+ private:
+  static bool IsLineFlux(int dir, int nv);
+  void StoreEMFComponent(int, IdefixArray3D<real>, const real);
+
+  IdefixArray2D<real> weight;   // (dir, var) weight of each sub-face in the coarse face
+  Fluid<Phys> *fluid;
+};
+
+#include "fluid.hpp"
+#include "dataBlock.hpp"
+
+template <typename Phys>
+FluxRegister<Phys>::FluxRegister(Fluid<Phys> *fluid, const std::array<int,3> &base,
+                                 const std::array<int,3> &size, const std::array<int,3> &ratio,
+                                 const std::array<std::array<bool,2>,3> &sides,
+                                 const std::string &name) {
+  idfx::pushRegion("FluxRegister::FluxRegister");
+  this->fluid = fluid;
+  this->base = base;
+  this->size = size;
+  this->ratio = ratio;
+  this->sides = sides;
+  DataBlock *data = fluid->data;
+  const int nvar = fluid->Uc.extent(0);
+
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    std::array<int,3> n = size;
+    n[dir] = 2;
+    flux[dir] = IdefixArray4D<real>(name+"_X"+std::to_string(dir+1), nvar,
+                                    n[KDIR], n[JDIR], n[IDIR]);
+    data->states["current"].PushArray(flux[dir], State::face, name+"_X"+std::to_string(dir+1));
+  }
+
+  // Sub-faces of the fluxes which are not multiplied by the area of the faces are averaged
+  weight = IdefixArray2D<real>(name+"_weight", 3, nvar);
+  IdefixArray2D<real>::HostMirror weightHost = Kokkos::create_mirror_view(weight);
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    int nsub = 1;
+    for(int d = 0 ; d < 3 ; d++) {
+      if(d != dir) nsub *= ratio[d];
+    }
+    for(int nv = 0 ; nv < nvar ; nv++) {
+      weightHost(dir,nv) = IsLineFlux(dir, nv) ? ONE_F/nsub : ONE_F;
+    }
+  }
+  Kokkos::deep_copy(weight, weightHost);
+
+  if constexpr(Phys::mhd) {
+    #if DIMENSIONS >= 2
+      for(int c = 0 ; c < 3 ; c++) {
+        if(DIMENSIONS == 2 && c != KDIR) continue;
+        std::array<int,3> n = size;
+        for(int d = 0 ; d < DIMENSIONS ; d++) {
+          if(d != c) n[d]++;
+        }
+        emf[c] = IdefixArray4D<real>(name+"_E"+std::to_string(c+1), 1,
+                                     n[KDIR], n[JDIR], n[IDIR]);
+        data->states["current"].PushArray(emf[c], State::edge, name+"_E"+std::to_string(c+1));
+      }
+    #endif
+  }
+  Reset();
+  idfx::popRegion();
+}
+
+// Variables whose flux is not multiplied by the area of the face in Fluid_CorrectFluxFunctor
+template <typename Phys>
+bool FluxRegister<Phys>::IsLineFlux(int dir, int nv) {
+  if constexpr(Phys::mhd) {
+    #if (GEOMETRY == POLAR && COMPONENTS >= 2) || (GEOMETRY == CYLINDRICAL && COMPONENTS == 3)
+      if(dir == IDIR && nv == iBPHI) return(true);
+    #elif GEOMETRY == SPHERICAL
+      #if COMPONENTS >= 2
+        if(dir == IDIR && nv == iBTH) return(true);
+      #endif
+      #if COMPONENTS == 3
+        if((dir == IDIR || dir == JDIR) && nv == iBPHI) return(true);
+      #endif
+    #endif
+  }
+  return(false);
+}
+
+template <typename Phys>
+void FluxRegister<Phys>::Reset() {
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    Kokkos::deep_copy(flux[dir], ZERO_F);
+  }
+  for(int c = 0 ; c < 3 ; c++) {
+    if(emf[c].is_allocated()) Kokkos::deep_copy(emf[c], ZERO_F);
+  }
+}
+
+template <typename Phys>
+template <int dir>
+void FluxRegister<Phys>::StoreFlux(const real dt) {
+  idfx::pushRegion("FluxRegister::StoreFlux");
+  IdefixArray4D<realStore> Flux = fluid->FluxRiemann;
+  IdefixArray4D<real> reg = flux[dir];
+  IdefixArray2D<real> weight = this->weight;
+
+  const bool haveLeft = sides[dir][0];
+  const bool haveRight = sides[dir][1];
+  // Faces of the fluid on the left and right sides
+  const int faceLeft = base[dir];
+  const int faceRight = base[dir] + ratio[dir]*size[dir];
+  const int beg[3] = {base[IDIR], base[JDIR], base[KDIR]};
+  int nsub[3] = {ratio[IDIR], ratio[JDIR], ratio[KDIR]};
+  nsub[dir] = 1;
+
+  idefix_for("FluxRegister::StoreFlux",
+             0, reg.extent(0),
+             0, reg.extent(1),
+             0, reg.extent(2),
+             0, reg.extent(3),
+    KOKKOS_LAMBDA (int n, int k, int j, int i) {
+      int f[3] = {beg[IDIR] + nsub[IDIR]*i, beg[JDIR] + nsub[JDIR]*j, beg[KDIR] + nsub[KDIR]*k};
+      const int side = (dir == IDIR) ? i : ((dir == JDIR) ? j : k);
+      if(side == 0) {
+        if(!haveLeft) return;
+        f[dir] = faceLeft;
+      } else {
+        if(!haveRight) return;
+        f[dir] = faceRight;
+      }
+      real sum = ZERO_F;
+      for(int dk = 0 ; dk < nsub[KDIR] ; dk++) {
+        for(int dj = 0 ; dj < nsub[JDIR] ; dj++) {
+          for(int di = 0 ; di < nsub[IDIR] ; di++) {
+            sum += Flux(n, f[KDIR]+dk, f[JDIR]+dj, f[IDIR]+di);
+          }
+        }
+      }
+      reg(n,k,j,i) += dt*weight(dir,n)*sum;
+    });
+  idfx::popRegion();
+}
+
+template <typename Phys>
+void FluxRegister<Phys>::StoreEMF(const real dt) {
+  if constexpr(Phys::mhd) {
+    idfx::pushRegion("FluxRegister::StoreEMF");
+    #if DIMENSIONS == 3
+      StoreEMFComponent(IDIR, fluid->emf->ex, dt);
+      StoreEMFComponent(JDIR, fluid->emf->ey, dt);
+    #endif
+    #if DIMENSIONS >= 2
+      StoreEMFComponent(KDIR, fluid->emf->ez, dt);
+    #endif
+    idfx::popRegion();
+  }
+}
+
+// A coarse edge is made of ratio[c] edges of the fluid along its direction c, whose EMFs are
+// averaged
+template <typename Phys>
+void FluxRegister<Phys>::StoreEMFComponent(int c, IdefixArray3D<real> E, const real dt) {
+  IdefixArray4D<real> reg = emf[c];
+  int beg[3], r[3], n[3];
+  // Registered sides of the directions normal to the edges
+  bool side[3][2];
+  for(int d = 0 ; d < 3 ; d++) {
+    beg[d] = base[d];
+    r[d] = ratio[d];
+    n[d] = size[d];
+    for(int s = 0 ; s < 2 ; s++) side[d][s] = (d != c) && (d < DIMENSIONS) && sides[d][s];
+  }
+  const int nc = ratio[c];
+
+  idefix_for("FluxRegister::StoreEMF",
+             0, reg.extent(1),
+             0, reg.extent(2),
+             0, reg.extent(3),
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      const int e[3] = {i, j, k};
+      bool onSide = false;
+      for(int d = 0 ; d < 3 ; d++) {
+        if((e[d] == 0 && side[d][0]) || (e[d] == n[d] && side[d][1])) onSide = true;
+      }
+      if(!onSide) return;
+      int f[3];
+      for(int d = 0 ; d < 3 ; d++) f[d] = beg[d] + r[d]*e[d];
+      real sum = ZERO_F;
+      for(int a = 0 ; a < nc ; a++) {
+        sum += E(f[KDIR], f[JDIR], f[IDIR]);
+        f[c]++;
+      }
+      reg(0,k,j,i) += dt*sum/nc;
+    });
+}
+
+#endif // FLUID_FLUXREGISTER_HPP_
@@ -0,0 +1,438 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include "fusedDust.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+#include "dataBlock.hpp"
+#include "fluid.hpp"
+
+FusedDust::FusedDust(Input &input, DataBlock *datain) {
+  idfx::pushRegion("FusedDust::FusedDust");
+  this->data = datain;
+  this->nSpecies = input.Get<int>("Dust","nSpecies",0);
+  this->nvar = DustPhysics::nvar;
+
+  if(nSpecies < 1) {
+    IDEFIX_ERROR("[Dust]:fused requires at least one dust specie");
+  }
+
+  const int nk = data->np_tot[KDIR];
+  const int nj = data->np_tot[JDIR];
+  const int ni = data->np_tot[IDIR];
+
+  Vc = IdefixArray4D<realStore>("FusedDust_Vc", nSpecies*nvar, nk, nj, ni);
+  Uc = IdefixArray4D<realStore>("FusedDust_Uc", nSpecies*nvar, nk, nj, ni);
+  Flux = IdefixArray4D<realStore>("FusedDust_Flux", nSpecies*nvar, nk, nj, ni);
+  cMax = IdefixArray4D<real>("FusedDust_cMax", nSpecies, nk, nj, ni);
+  InvDt = IdefixArray4D<real>("FusedDust_InvDt", nSpecies, nk, nj, ni);
+
+  // The conservative variables of all of the species are integrated as a single array
+  data->states["current"].PushArray(Uc, State::center, "FusedDust_Uc");
+
+  idfx::popRegion();
+}
+
+IdefixArray4D<realStore> FusedDust::SpecieVariables(IdefixArray4D<realStore> &array,
+                                                    int n) const {
+  return(Kokkos::subview(array, std::make_pair(n*nvar, (n+1)*nvar),
+                         Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL()));
+}
+
+IdefixArray3D<real> FusedDust::SpecieField(IdefixArray4D<real> &array, int n) const {
+  return(Kokkos::subview(array, n, Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL()));
+}
+
+void FusedDust::Link() {
+  idfx::pushRegion("FusedDust::Link");
+  auto &dust = data->dust;
+  for(int s = 0 ; s < nSpecies ; s++) {
+    if(dust[s]->rSolver->shockFlattening) {
+      IDEFIX_ERROR("Shock flattening is not compatible with fused dust species");
+    }
+    if(dust[s]->rSolver->cacheFaceStates) {
+      IDEFIX_ERROR("cacheFaceStates is not compatible with fused dust species");
+    }
+  }
+
+  // All of the species share the same drag law, only the drag parameter differs
+  haveDrag = dust[0]->haveDrag;
+  if(haveDrag) {
+    implicitDrag = dust[0]->drag->IsImplicit();
+    feedback = dust[0]->drag->HasFeedback();
+
+    dragCoeff = IdefixArray1D<real>("FusedDust_dragCoeff", nSpecies);
+    IdefixArray1D<real>::HostMirror dragCoeffHost = Kokkos::create_mirror_view(dragCoeff);
+    for(int s = 0 ; s < nSpecies ; s++) {
+      dragCoeffHost(s) = dust[s]->drag->gammaDrag.dragCoeff;
+    }
+    Kokkos::deep_copy(dragCoeff, dragCoeffHost);
+
+    if(dust[0]->drag->gammaDrag.type == GammaDrag::Type::Userdef) {
+      // The user-defined drag function of each specie fills its slice of gammai
+      gammai = IdefixArray4D<real>("FusedDust_gammai", nSpecies, data->np_tot[KDIR],
+                                   data->np_tot[JDIR], data->np_tot[IDIR]);
+      for(int s = 0 ; s < nSpecies ; s++) {
+        dust[s]->drag->gammaDrag.gammai = SpecieField(gammai, s);
+      }
+    }
+  }
+
+  #ifdef WITH_MPI
+    std::vector<int> vars;
+    for(int n = 0 ; n < nSpecies*nvar ; n++) {
+      vars.push_back(n);
+    }
+    mpi.Init(data->mygrid, vars, data->nghost.data(), data->np_int.data());
+  #endif
+
+  idfx::popRegion();
+}
+
+void FusedDust::ConvertConsToPrim() {
+  idfx::pushRegion("FusedDust::ConvertConsToPrim");
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
+  const int nvar = this->nvar;
+  const bool nanTracking = this->nanTracking;
+  IdefixArray1D<int> nanCount = this->nanCount;
+  const int ibeg = data->beg[IDIR];
+  const int iend = data->end[IDIR];
+  const int jbeg = data->beg[JDIR];
+  const int jend = data->end[JDIR];
+  const int kbeg = data->beg[KDIR];
+  const int kend = data->end[KDIR];
+
+  idefix_for("FusedDust_ConsToPrim",
+             0,nSpecies,
+             0,data->np_tot[KDIR],
+             0,data->np_tot[JDIR],
+             0,data->np_tot[IDIR],
+    KOKKOS_LAMBDA (int s, int k, int j, int i) {
+      real U[DustPhysics::nvar];
+      real V[DustPhysics::nvar];
+      const int offset = s*nvar;
+
+#pragma unroll
+      for(int nv = 0 ; nv < DustPhysics::nvar; nv++) {
+        U[nv] = Uc(offset+nv,k,j,i);
+      }
+
+      K_ConsToPrim<DustPhysics>(V,U,NULL);
+
+      bool nan = false;
+#pragma unroll
+      for(int nv = 0 ; nv < DustPhysics::nvar; nv++) {
+        Vc(offset+nv,k,j,i) = V[nv];
+        nan = nan || std::isnan(V[nv]);
+      }
+      if(nanTracking && nan && i>=ibeg && i<iend && j>=jbeg && j<jend && k>=kbeg && k<kend) {
+        Kokkos::atomic_increment(&nanCount(0));
+      }
+  });
+  idfx::popRegion();
+}
+
+void FusedDust::ConvertPrimToCons() {
+  idfx::pushRegion("FusedDust::ConvertPrimToCons");
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
+  const int nvar = this->nvar;
+
+  idefix_for("FusedDust_PrimToCons",
+             0,nSpecies,
+             0,data->np_tot[KDIR],
+             0,data->np_tot[JDIR],
+             0,data->np_tot[IDIR],
+    KOKKOS_LAMBDA (int s, int k, int j, int i) {
+      real U[DustPhysics::nvar];
+      real V[DustPhysics::nvar];
+      const int offset = s*nvar;
+
+#pragma unroll
+      for(int nv = 0 ; nv < DustPhysics::nvar; nv++) {
+        V[nv] = Vc(offset+nv,k,j,i);
+      }
+
+      K_PrimToCons<DustPhysics>(U,V,NULL);
+
+#pragma unroll
+      for(int nv = 0 ; nv < DustPhysics::nvar; nv++) {
+        Uc(offset+nv,k,j,i) = U[nv];
+      }
+  });
+  idfx::popRegion();
+}
+
+void FusedDust::ResetStage() {
+  idfx::pushRegion("FusedDust::ResetStage");
+  IdefixArray4D<real> InvDt = this->InvDt;
+
+  idefix_for("FusedDust_ResetStage",0,nSpecies,
+             0,data->np_tot[KDIR],0,data->np_tot[JDIR],0,data->np_tot[IDIR],
+    KOKKOS_LAMBDA (int s, int k, int j, int i) {
+      InvDt(s,k,j,i) = ZERO_F;
+  });
+  idfx::popRegion();
+}
+
+void FusedDust::SetBoundaries(real t) {
+  idfx::pushRegion("FusedDust::SetBoundaries");
+  auto &dust = data->dust;
+  for(int s = 0 ; s < nSpecies ; s++) {
+    dust[s]->boundary->EnforceInternalBoundaries(t);
+  }
+  for(int dir=0 ; dir < DIMENSIONS ; dir++ ) {
+    // A single MPI exchange for all of the species
+    #ifdef WITH_MPI
+    if(data->mygrid->nproc[dir]>1) {
+      switch(dir) {
+        case 0:
+          mpi.ExchangeX1(this->Vc);
+          break;
+        case 1:
+          mpi.ExchangeX2(this->Vc);
+          break;
+        case 2:
+          mpi.ExchangeX3(this->Vc);
+          break;
+      }
+    }
+    #endif
+    for(int s = 0 ; s < nSpecies ; s++) {
+      dust[s]->boundary->EnforceBoundaryDir(t, dir);
+    }
+  }
+  idfx::popRegion();
+}
+
+// Compute the Riemann fluxes of all of the species in direction dir
+template <int dir>
+void FusedDust::CalcFlux() {
+  idfx::pushRegion("FusedDust::CalcFlux");
+  constexpr int ioffset = (dir==IDIR) ? 1 : 0;
+  constexpr int joffset = (dir==JDIR) ? 1 : 0;
+  constexpr int koffset = (dir==KDIR) ? 1 : 0;
+
+  IdefixArray4D<realStore> Flux = this->Flux;
+  IdefixArray4D<real> cMax = this->cMax;
+  const int nvar = this->nvar;
+
+  // The reconstruction only depends on the grid, so that the extrapolator of the first specie
+  // can be used for all of the species
+  ExtrapolateToFaces<DustPhysics,dir> extrapol =
+                                    *data->dust[0]->rSolver->template GetExtrapolator<dir>();
+  extrapol.Vc = this->Vc;
+
+  idefix_for_tiled<dir>("FusedDust_HLL_Kernel",
+                        0,nSpecies,
+                        data->beg[KDIR],data->end[KDIR]+koffset,
+                        data->beg[JDIR],data->end[JDIR]+joffset,
+                        data->beg[IDIR],data->end[IDIR]+ioffset,
+    KOKKOS_LAMBDA (int s, int k, int j, int i) {
+      real vL[DustPhysics::nvar];
+      real vR[DustPhysics::nvar];
+      real flux[DustPhysics::nvar];
+      const int offset = s*nvar;
+
+      for(int nv = 0 ; nv < DustPhysics::nvar ; nv++) {
+        // vL= left side of current interface (i-1/2)= right side of cell i-1
+        vL[nv] = extrapol.GetRightFaceState(nv,k-koffset,j-joffset,i-ioffset,offset);
+        // vR= right side of current interface (i-1/2)= left side of cell i
+        vR[nv] = extrapol.GetLeftFaceState(nv,k,j,i,offset);
+      }
+
+      real cmax = K_HllDust<DustPhysics,dir>(vL, vR, flux);
+
+#pragma unroll
+      for(int nv = 0 ; nv < DustPhysics::nvar; nv++) {
+        Flux(offset+nv,k,j,i) = flux[nv];
+      }
+      cMax(s,k,j,i) = cmax;
+  });
+  idfx::popRegion();
+}
+
+template <int dir>
+void FusedDust::LoopDir(const real t, const real dt) {
+  CalcFlux<dir>();
+  // The fluxes are then applied by each specie, in its own slice of the fused arrays
+  for(auto &fluid : data->dust) {
+    if(fluid->haveExplicitParabolicTerms) fluid->template CalcParabolicFlux<dir>(t);
+    fluid->template CalcRightHandSide<dir>(t,dt);
+  }
+  // Recursive: do next dimension
+  if constexpr (dir+1 < DIMENSIONS) LoopDir<dir+1>(t, dt);
+}
+
+// Evolve one step forward in time all of the dust species
+void FusedDust::EvolveStage(const real t, const real dt) {
+  idfx::pushRegion("FusedDust::EvolveStage");
+  LoopDir<IDIR>(t,dt);
+
+  for(auto &fluid : data->dust) {
+    if(fluid->haveSourceTerms) fluid->AddSourceTerms(t, dt);
+  }
+
+  if(haveDrag && !implicitDrag) AddDragForce(dt);
+  idfx::popRegion();
+}
+
+void FusedDust::RefreshUserDrag() {
+  if(gammai.is_allocated()) {
+    for(auto &fluid : data->dust) {
+      fluid->drag->gammaDrag.RefreshUserDrag(data);
+    }
+  }
+}
+
+// Explicit drag force of all of the species, see Drag::AddDragForce
+void FusedDust::AddDragForce(const real dt) {
+  idfx::pushRegion("FusedDust::AddDragForce");
+  IdefixArray4D<realStore> UcGas = data->hydro->Uc;
+  IdefixArray4D<realStore> VcGas = data->hydro->Vc;
+  IdefixArray4D<realStore> UcDust = this->Uc;
+  IdefixArray4D<realStore> VcDust = this->Vc;
+  IdefixArray4D<real> InvDt = this->InvDt;
+  IdefixArray1D<real> coeff = this->dragCoeff;
+  IdefixArray4D<real> gammai = this->gammai;
+  const bool userDrag = gammai.is_allocated();
+  const bool feedback = this->feedback;
+  const int nSpecies = this->nSpecies;
+  const int nvar = this->nvar;
+
+  auto gammaDrag = data->dust[0]->drag->gammaDrag;
+  RefreshUserDrag();
+
+  // Compute a drag force fd = - gamma*rhod*rhog*(vd-vg) for each specie
+  idefix_for("FusedDust_DragForce",0,data->np_tot[KDIR],0,data->np_tot[JDIR],
+                                   0,data->np_tot[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      for(int s = 0 ; s < nSpecies ; s++) {
+        const int offset = s*nvar;
+        // The drag coefficient
+        const real gamma = userDrag ? gammai(s,k,j,i) : gammaDrag.GetGamma(coeff(s),k,j,i);
+
+        real dp = dt * gamma * VcDust(offset+RHO,k,j,i) * VcGas(RHO,k,j,i);
+        for(int n = MX1 ; n < MX1+COMPONENTS ; n++) {
+          real dv = VcDust(offset+n,k,j,i) - VcGas(n,k,j,i);
+          UcDust(offset+n,k,j,i) -= dp*dv;
+          if(feedback) {
+            UcGas(n,k,j,i) += dp*dv;
+            #if HAVE_ENERGY == 1
+              // We add back the energy dissipated for the dust which is not accounted for
+              // (since there is no energy equation for dust grains)
+              UcGas(ENG,k,j,i) += dp*dv*VcDust(offset+n,k,j,i);
+            #endif
+          } // feedback
+        }
+        // Cfl constraint
+        real idt = gamma*VcGas(RHO,k,j,i);
+        if(feedback) idt += gamma*VcDust(offset+RHO,k,j,i);
+        InvDt(s,k,j,i) += idt;
+      }
+    });
+  idfx::popRegion();
+}
+
+// Implicit drag of all of the species, see Drag::AddImplicitBackReaction,
+// Drag::NormalizeImplicitBackReaction and Drag::AddImplicitFluidMomentum
+void FusedDust::AddImplicitDrag(const real dt) {
+  idfx::pushRegion("FusedDust::AddImplicitDrag");
+  IdefixArray4D<realStore> UcGas = data->hydro->Uc;
+  IdefixArray4D<realStore> UcDust = this->Uc;
+  IdefixArray4D<realStore> VcDust = this->Vc;
+  IdefixArray1D<real> coeff = this->dragCoeff;
+  IdefixArray4D<real> gammai = this->gammai;
+  const bool userDrag = gammai.is_allocated();
+  const bool feedback = this->feedback;
+  const int nSpecies = this->nSpecies;
+  const int nvar = this->nvar;
+
+  auto gammaDrag = data->dust[0]->drag->gammaDrag;
+  RefreshUserDrag();
+
+  idefix_for("FusedDust_ImplicitDrag",0,data->np_tot[KDIR],0,data->np_tot[JDIR],
+                                      0,data->np_tot[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      if(feedback) {
+        // Back reaction on the gas
+        real preFactor = 0;
+        for(int s = 0 ; s < nSpecies ; s++) {
+          const int offset = s*nvar;
+          const real gamma = userDrag ? gammai(s,k,j,i) : gammaDrag.GetGamma(coeff(s),k,j,i);
+
+          preFactor += UcDust(offset+RHO,k,j,i)*gamma*dt/(1+UcGas(RHO,k,j,i)*gamma*dt);
+          for(int n = MX1 ; n < MX1+COMPONENTS ; n++) {
+            UcGas(n,k,j,i) +=  dt * gamma * UcGas(RHO,k,j,i) * UcDust(offset+n,k,j,i) /
+                                                                (1 + UcGas(RHO,k,j,i)*dt*gamma);
+          }
+        }
+        for(int n = MX1 ; n < MX1+COMPONENTS ; n++) {
+          UcGas(n,k,j,i) /= 1+preFactor;
+        }
+      }
+      // Dust momentum
+      for(int s = 0 ; s < nSpecies ; s++) {
+        const int offset = s*nvar;
+        const real gamma = userDrag ? gammai(s,k,j,i) : gammaDrag.GetGamma(coeff(s),k,j,i);
+
+        for(int n = MX1 ; n < MX1+COMPONENTS ; n++) {
+          real oldUc = UcDust(offset+n,k,j,i);
+          UcDust(offset+n,k,j,i) = (oldUc + dt * gamma * UcDust(offset+RHO,k,j,i)
+                                                       * UcGas(n,k,j,i)) /
+                                   (1 + UcGas(RHO,k,j,i)*dt*gamma);
+
+          #if HAVE_ENERGY == 1
+            real dp = UcDust(offset+n,k,j,i) - oldUc;
+            // We add back the energy dissipated for the dust which is not accounted for
+            if(feedback) UcGas(ENG,k,j,i) -= dp*VcDust(offset+n,k,j,i);
+          #endif
+        }
+      }
+    });
+  idfx::popRegion();
+}
+
+real FusedDust::ComputeTimestep() {
+  IdefixArray4D<real> InvDt = this->InvDt;
+  const int nSpecies = this->nSpecies;
+  const bool nanTracking = this->nanTracking;
+  IdefixArray1D<int> nanCount = this->nanCount;
+  real dt;
+  idefix_reduce("FusedDust_Timestep_reduction",
+          data->beg[KDIR], data->end[KDIR],
+          data->beg[JDIR], data->end[JDIR],
+          data->beg[IDIR], data->end[IDIR],
+          KOKKOS_LAMBDA (int k, int j, int i, real &dtmin) {
+                  for(int s = 0 ; s < nSpecies ; s++) {
+                    if(nanTracking && std::isnan(InvDt(s,k,j,i))) {
+                      Kokkos::atomic_increment(&nanCount(0));
+                    }
+                    dtmin=FMIN(ONE_F/InvDt(s,k,j,i),dtmin);
+                  }
+              },
+          Kokkos::Min<real>(dt));
+  return(dt);
+}
+
+void FusedDust::EnableNanTracking() {
+  this->nanTracking = true;
+  this->nanCount = IdefixArray1D<int>("FusedDust_NanCount",1);
+}
+
+int FusedDust::GetTrackedNans() {
+  if(!nanTracking) return(0);
+  IdefixArray1D<int>::HostMirror nanCountHost = Kokkos::create_mirror_view(nanCount);
+  Kokkos::deep_copy(nanCountHost, nanCount);
+  return(nanCountHost(0));
+}
+
+void FusedDust::ShowConfig() {
+  idfx::cout << "FusedDust: evolving the " << nSpecies << " dust species at once." << std::endl;
+}
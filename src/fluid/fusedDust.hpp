@@ -0,0 +1,78 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef FLUID_FUSEDDUST_HPP_
+#define FLUID_FUSEDDUST_HPP_
+
+#include "idefix.hpp"
+#include "input.hpp"
+#ifdef WITH_MPI
+#include "mpi.hpp"
+#endif
+
+// forward class declaration
+class DataBlock;
+
+// Evolve all of the dust species at once.
+// The variables of the species are stored in species-indexed arrays, where the variable nv of
+// the specie s is found at index s*nvar+nv. The arrays of each dust Fluid are views of these
+// arrays, so that each specie can still be used on its own (outputs, restart dumps, user
+// functions, source terms). The Riemann fluxes, the drag force, the Fargo shift and the MPI
+// exchange of the ghost zones are then computed for all of the species by a single kernel
+// (or a single message), instead of one per specie.
+class FusedDust {
+ public:
+  FusedDust(Input &, DataBlock *);
+  void Link();                          // Connect the dust species once they have been created
+
+  // Views of the variables (resp. the scalar field) of specie n in a species-indexed array
+  IdefixArray4D<realStore> SpecieVariables(IdefixArray4D<realStore> &, int) const;
+  IdefixArray3D<real> SpecieField(IdefixArray4D<real> &, int) const;
+
+  void ConvertConsToPrim();
+  void ConvertPrimToCons();
+  void ResetStage();
+  void SetBoundaries(real);
+  void EvolveStage(const real, const real);
+  void AddImplicitDrag(const real);     // Implicit drag of all of the species
+  real ComputeTimestep();
+  void ShowConfig();
+  void EnableNanTracking();             // Count the Nans in ConsToPrim and ComputeTimestep
+  int GetTrackedNans();
+
+  int nSpecies;
+  int nvar;                     // # of variables of each specie
+
+  IdefixArray4D<realStore> Vc;   // Primitive variables of all of the species
+  IdefixArray4D<realStore> Uc;   // Conservative variables of all of the species
+  IdefixArray4D<realStore> Flux; // Riemann fluxes of all of the species
+  IdefixArray4D<real> cMax;     // Maximum propagation speed of each specie
+  IdefixArray4D<real> InvDt;    // Inverse of the timestep of each specie
+
+  bool nanTracking{false};
+  IdefixArray1D<int> nanCount;  // # of Nans found in the active cells of all of the species
+
+ private:
+  template <int dir> void LoopDir(const real, const real);
+  template <int dir> void CalcFlux();
+  void AddDragForce(const real);
+  void RefreshUserDrag();
+
+  DataBlock *data;
+
+  bool haveDrag{false};
+  bool implicitDrag{false};
+  bool feedback{false};
+  IdefixArray1D<real> dragCoeff;  // Drag parameter of each specie
+  IdefixArray4D<real> gammai;     // User-defined drag coefficient of each specie (userdef only)
+
+  #ifdef WITH_MPI
+  Mpi mpi;                      // Exchange the ghost zones of all of the species at once
+  #endif
+};
+
+#endif // FLUID_FUSEDDUST_HPP_
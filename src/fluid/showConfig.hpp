@@ -161,6 +161,23 @@ void Fluid<Phys>::ShowConfig() {
   if(haveAxis) {
     boundary->axis->ShowConfig();
   }
+  if(fusedUpdate) {
+    if(CanUseFusedUpdate()) {
+      idfx::cout << Phys::prefix << ": fused update of all directions ENABLED." << std::endl;
+    } else {
+      idfx::cout << Phys::prefix << ": fused update is not compatible with this "
+                 << "configuration, falling back to per-direction sweeps." << std::endl;
+    }
+  }
+  if(boundary->overlapMpi) {
+    if(boundary->CanOverlapMpi()) {
+      idfx::cout << Phys::prefix << ": MPI exchanges overlapped with computation ENABLED."
+                 << std::endl;
+    } else {
+      idfx::cout << Phys::prefix << ": MPI exchanges overlap is not compatible with this "
+                 << "configuration, falling back to blocking exchanges." << std::endl;
+    }
+  }
   if(haveDrag) {
     drag->ShowConfig();
   }
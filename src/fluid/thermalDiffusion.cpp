@@ -51,9 +51,10 @@ void ThermalDiffusion::EnrollThermalDiffusivity(DiffusivityFunc myFunc) {
 // (this avoids an extra array)
 // Associated source terms, present in non-cartesian geometry are also computed
 // and stored in this->viscSrc for later use (in calcRhs).
-void ThermalDiffusion::AddDiffusiveFlux(int dir, const real t, const IdefixArray4D<real> &Flux) {
+void ThermalDiffusion::AddDiffusiveFlux(int dir, const real t,
+                                        const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("ThermalDiffusion::AddDiffusiveFlux");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray3D<real> dMax = this->dMax;
   IdefixArray3D<real> kappaArr = this->kappaArr;
   IdefixArray1D<real> dx = this->data->dx[dir];
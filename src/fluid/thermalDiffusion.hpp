@@ -29,7 +29,7 @@ class ThermalDiffusion {
 
   void ShowConfig(); // display configuration
 
-  void AddDiffusiveFlux(int, const real, const IdefixArray4D<real> &);
+  void AddDiffusiveFlux(int, const real, const IdefixArray4D<realStore> &);
 
   // Enroll user-defined viscous diffusivity
   void EnrollThermalDiffusivity(DiffusivityFunc);
@@ -49,7 +49,7 @@ class ThermalDiffusion {
   DiffusivityFunc diffusivityFunc;
 
   // helper array
-  IdefixArray4D<real> &Vc;
+  IdefixArray4D<realStore> &Vc;
   IdefixArray3D<real> &dMax;
 
   // constant diffusion coefficient (when needed)
@@ -22,12 +22,12 @@ class Tracer {
   template <typename Phys> Tracer(Fluid<Phys> *, int n);
   void ConvertConsToPrim();
   void ConvertPrimToCons();
-  template <int, typename> void CalcFlux(IdefixArray4D<real> &);
-  template <int, typename> void CalcRightHandSide(IdefixArray4D<real> &, real, real);
+  template <int, typename> void CalcFlux(IdefixArray4D<realStore> &);
+  template <int, typename> void CalcRightHandSide(IdefixArray4D<realStore> &, real, real);
 
  private:
-  IdefixArray4D<real> Vc;  // Vector of primitive variables for the passive tracer
-  IdefixArray4D<real> Uc;  // Vector of conservative variables for the passive tracer
+  IdefixArray4D<realStore> Vc;  // Vector of primitive variables for the passive tracer
+  IdefixArray4D<realStore> Uc;  // Vector of conservative variables for the passive tracer
 
   std::string prefix;
 
@@ -55,11 +55,11 @@ Tracer::Tracer(Fluid<Phys> *fluid, int n) {
 
 // Compute the upwinded flux
 template <int dir, typename Phys>
-void Tracer::CalcFlux(IdefixArray4D<real> &Flux) {
+void Tracer::CalcFlux(IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("Tracer::CalcFlux");
 
-  IdefixArray4D<real> Vc = this->Vc;
-  IdefixArray4D<real> Uc = this->Uc;
+  IdefixArray4D<realStore> Vc = this->Vc;
+  IdefixArray4D<realStore> Uc = this->Uc;
   IdefixArray3D<real> A    = data->A[dir];
 
   constexpr int ioffset = (dir==IDIR ? 1 : 0);
@@ -100,10 +100,10 @@ void Tracer::CalcFlux(IdefixArray4D<real> &Flux) {
 }
 
 template <int dir, typename Phys>
-void Tracer::CalcRightHandSide(IdefixArray4D<real> &Flux, real t, real dt) {
+void Tracer::CalcRightHandSide(IdefixArray4D<realStore> &Flux, real t, real dt) {
   idfx::pushRegion("Tracer::ComputeRHS");
 
-  IdefixArray4D<real> Uc = this->Uc;
+  IdefixArray4D<realStore> Uc = this->Uc;
   IdefixArray3D<real> dV  = data->dV;
 
   constexpr int ioffset = (dir==IDIR ? 1 : 0);
@@ -97,9 +97,9 @@ void Viscosity::EnrollViscousDiffusivity(ViscousDiffusivityFunc myFunc) {
 // (this avoids an extra array)
 // Associated source terms, present in non-cartesian geometry are also computed
 // and stored in this->viscSrc for later use (in calcRhs).
-void Viscosity::AddViscousFlux(int dir, const real t, const IdefixArray4D<real> &Flux) {
+void Viscosity::AddViscousFlux(int dir, const real t, const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("Viscosity::AddViscousFlux");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> viscSrc = this->viscSrc;
   IdefixArray3D<real> dMax = this->dMax;
   IdefixArray3D<real> eta1Arr = this->eta1Arr;
@@ -29,7 +29,7 @@ class Viscosity {
   template <typename Phys>
   Viscosity(Input &, Grid &, Fluid<Phys> *);
   void ShowConfig();                    // print configuration
-  void AddViscousFlux(int, const real, const IdefixArray4D<real> &);
+  void AddViscousFlux(int, const real, const IdefixArray4D<realStore> &);
 
   // Enroll user-defined viscous diffusivity
   void EnrollViscousDiffusivity(ViscousDiffusivityFunc);
@@ -52,7 +52,7 @@ class Viscosity {
 
   ViscousDiffusivityFunc viscousDiffusivityFunc;
 
-  IdefixArray4D<real> &Vc;
+  IdefixArray4D<realStore> &Vc;
   IdefixArray3D<real> &dMax;
 
   // constant diffusion coefficient (when needed)
@@ -90,7 +90,8 @@ Viscosity::Viscosity(Input &input, Grid &grid, Fluid<Phys> *hydroin):
                      "Can only be constant or userdef.");
   }
 
-  InitArrays();
+  // (the fluids of a process split in blocks are not evolved, see Fluid)
+  if(!data->haveBlocks) InitArrays();
 
   idfx::popRegion();
 }
@@ -5,6 +5,8 @@
 // Licensed under CeCILL 2.1 License, see COPYING for more information
 // ***********************************************************************************
 
+#include <unistd.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -24,10 +26,15 @@ int psize;
 double mpiCallsTimer = 0.0;
 
 bool warningsAreErrors{false};
+bool mpiThreadMultiple{false};
+bool profileKernels{false};
+std::array<int,3> loopTile = {0, 0, 0};
+int64_t loopTileCache{0};
 
 IdefixOutStream cout;
 IdefixErrStream cerr;
 Profiler prof;
+LoopTuner loopTuner;
 LoopPattern defaultLoopPattern;
 
 #ifdef DEBUG
@@ -54,6 +61,12 @@ int initialize() {
     defaultLoopPattern = LoopPattern::TPX;    // On cpus, works best (generally)
   #endif
 
+  // Size of the L2 cache, which the tiles of the tiled loops fit in
+  #ifdef _SC_LEVEL2_CACHE_SIZE
+    loopTileCache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  #endif
+  if(loopTileCache <= 0) loopTileCache = 1 << 20;
+
   #ifdef WITH_MPI
     Mpi::CheckConfig();
   #endif
@@ -92,6 +105,49 @@ void popRegion() {
 #endif
 }
 
+void SetKernelWork(int64_t iterations, size_t captureSize) {
+  prof.SetKernelWork(iterations, captureSize);
+}
+
+// Tile of a tiled loop over a block of the given size (i,j,k), swept along sweepDir, each cell
+// using bytesPerCell bytes of each of the nouter slices of the loop. Half of the cache holds the
+// stencil of the loop: the planes normal to sweepDir it reads. The rows along i are kept whole
+// as long as they fit, and the tiles are shrunk until there are enough of them for all the
+// threads. The tiles of a thread are stacked along sweepDir (see idefix_for_tiled).
+std::array<int,3> LoopTile(const std::array<int,3> &size, int sweepDir, int64_t bytesPerCell,
+                           int nouter) {
+  constexpr int stencil = 2*((ORDER >= 4) ? 3 : 2) + 1;
+  constexpr int vlen = KOKKOS_VECTOR_LENGTH;
+  const int other = (sweepDir == KDIR) ? JDIR : KDIR;
+  const int64_t cells = std::max<int64_t>(1, loopTileCache / (2*std::max<int64_t>(1,bytesPerCell)));
+  const int64_t plane = std::max<int64_t>(1, cells / stencil);
+
+  std::array<int,3> tile;
+  tile[IDIR] = size[IDIR];
+  if(tile[IDIR] > plane) tile[IDIR] = std::max<int64_t>(vlen, plane / vlen * vlen);
+  tile[other] = std::clamp<int64_t>(plane / tile[IDIR], 1, std::max(size[other], 1));
+  tile[sweepDir] = std::clamp<int64_t>(cells / (tile[IDIR]*tile[other]), 1,
+                                       std::max(size[sweepDir], 1));
+
+  // Enough stacks of tiles for all of the threads
+  const int threads = Kokkos::DefaultExecutionSpace().concurrency();
+  auto stacks = [&]() {
+    return(static_cast<int64_t>(nouter) * ((size[IDIR] + tile[IDIR] - 1) / tile[IDIR])
+                                        * ((size[other] + tile[other] - 1) / tile[other]));
+  };
+  while(stacks() < threads && tile[other] > 1) tile[other] = (tile[other] + 1) / 2;
+  while(stacks() < threads && tile[IDIR] >= 2*vlen) {
+    tile[IDIR] = (tile[IDIR] / 2 + vlen - 1) / vlen * vlen;
+  }
+
+  // Tiles given on the command line (-tile)
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    if(loopTile[dir] > 0) tile[dir] = loopTile[dir];
+    tile[dir] = std::max(1, std::min(tile[dir], size[dir]));
+  }
+  return(tile);
+}
+
 // Init the iostream with defined rank
 void IdefixOutStream::init(int rank) {
   if(rank==0)
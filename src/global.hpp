@@ -7,6 +7,7 @@
 
 #ifndef GLOBAL_HPP_
 #define GLOBAL_HPP_
+#include <array>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -20,18 +21,32 @@ void safeExit(int );       // Exit the code
 class IdefixOutStream;
 class IdefixErrStream;
 class Profiler;
+class LoopTuner;
 
 extern int prank;                       //< parallel rank
 extern int psize;
 extern IdefixOutStream cout;              //< custom cout for idefix
 extern IdefixErrStream cerr;              //< custom cerr for idefix
 extern Profiler prof;                   //< profiler (for memory & performance usage)
+extern LoopTuner loopTuner;             //< autotuner of the loop patterns (see loop.hpp)
 extern double mpiCallsTimer;            //< time significant MPI calls
 extern LoopPattern defaultLoopPattern;  //< default loop patterns (for idefix_for loops)
 extern bool warningsAreErrors;    //< whether warnings should be considered as errors
+extern bool mpiThreadMultiple;    //< whether MPI may be called by several threads at once
+extern bool profileKernels;       //< whether kernels are profiled (-kernels or -trace)
+extern std::array<int,3> loopTile;  //< tile of the tiled loops (0: given by the cache model)
+extern int64_t loopTileCache;       //< cache size (in bytes) the tiles of the tiled loops fit in
 
 void pushRegion(const std::string&);
 void popRegion();
+void SetKernelWork(int64_t, size_t);  //< work of the next kernel, for the kernel profiler
+std::array<int,3> LoopTile(const std::array<int,3> &, int, int64_t, int);  //< tile of a tiled loop
+
+// Declare the # of iterations of the next kernel to the kernel profiler
+template<typename Function>
+inline void KernelWork(const int64_t iterations) {
+  if(profileKernels) SetKernelWork(iterations, sizeof(Function));
+}
 
 template<typename T>
 IdefixArray1D<T> ConvertVectorToIdefixArray(std::vector<T> &inputVector) {
@@ -151,7 +151,7 @@ void Gravity::ComputeGravity(int stepNumber) {
     }
     if(haveSelfGravityPotential) {
       // Solving Poisson for the current gas density distribution
-      if(stepNumber % selfGravity.skipSelfGravity == 0) selfGravity.SolvePoisson();
+      if(selfGravity.NeedSolve(stepNumber)) selfGravity.SolvePoisson();
 
       // Adding gas self-gravity contribution to global gravity potential
       selfGravity.AddSelfGravityPotential(phiP);
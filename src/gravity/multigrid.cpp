@@ -0,0 +1,888 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "multigrid.hpp"
+#include "dataBlock.hpp"
+
+// Weighted sum of the neighbours of cell (k,j,i), and sum of the weights
+KOKKOS_INLINE_FUNCTION void NeighbourSum(const IdefixArray4D<real> &coef,
+                                         const IdefixArray3D<real> &x,
+                                         const int k, const int j, const int i,
+                                         real &sum, real &csum) {
+  real cm = coef(0,k,j,i);
+  real cp = coef(1,k,j,i);
+  sum = cm*x(k,j,i-1) + cp*x(k,j,i+1);
+  csum = cm + cp;
+  #if DIMENSIONS > 1
+    cm = coef(2,k,j,i);
+    cp = coef(3,k,j,i);
+    sum += cm*x(k,j-1,i) + cp*x(k,j+1,i);
+    csum += cm + cp;
+    #if DIMENSIONS > 2
+      cm = coef(4,k,j,i);
+      cp = coef(5,k,j,i);
+      sum += cm*x(k-1,j,i) + cp*x(k+1,j,i);
+      csum += cm + cp;
+    #endif
+  #endif
+}
+
+// View a 3D array as a single variable 4D array (for MPI exchanges and transfers)
+static IdefixArray4D<real> AsArray4D(IdefixArray3D<real> arr) {
+  if(arr.data() == nullptr) return(IdefixArray4D<real>());
+  return(IdefixArray4D<real>(arr.data(), 1, arr.extent(0), arr.extent(1), arr.extent(2)));
+}
+
+Multigrid::Multigrid(Input &input, Laplacian &op, real error, int maxiter,
+                     std::array<int,3> ntot, std::array<int,3> beg, std::array<int,3> end) :
+                     IterativeSolver<Laplacian>(op, error, maxiter, ntot, beg, end) {
+  idfx::pushRegion("Multigrid::Multigrid");
+
+  if(op.havePreconditioner) {
+    IDEFIX_ERROR("Multigrid:: cannot be used with a diagonally preconditioned Laplacian");
+  }
+
+  std::string cycle = input.GetOrSet<std::string>("SelfGravity","mgCycle",0,"V");
+  if(cycle.compare("V") == 0) {
+    cycleType = Vcycle;
+  } else if(cycle.compare("W") == 0) {
+    cycleType = Wcycle;
+  } else {
+    std::stringstream msg;
+    msg << "Multigrid:: Unknown cycle \"" << cycle << "\". Use \"V\" or \"W\".";
+    IDEFIX_ERROR(msg);
+  }
+
+  std::string smoother = input.GetOrSet<std::string>("SelfGravity","mgSmoother",0,"redblack");
+  if(smoother.compare("redblack") == 0) {
+    smootherType = redBlack;
+  } else if(smoother.compare("jacobi") == 0) {
+    smootherType = jacobi;
+  } else {
+    std::stringstream msg;
+    msg << "Multigrid:: Unknown smoother \"" << smoother << "\". "
+        << "Use \"redblack\" or \"jacobi\".";
+    IDEFIX_ERROR(msg);
+  }
+
+  nPreSmooth = input.GetOrSet<int>("SelfGravity","mgSmoothSteps",0,2);
+  nPostSmooth = input.GetOrSet<int>("SelfGravity","mgSmoothSteps",1,nPreSmooth);
+  maxLevels = input.GetOrSet<int>("SelfGravity","mgMaxLevels",0,16);
+  agglomerationSize = input.GetOrSet<int>("SelfGravity","mgAgglomeration",0,512);
+
+  if(nPreSmooth < 0 || nPostSmooth < 0 || nPreSmooth+nPostSmooth == 0) {
+    IDEFIX_ERROR("Multigrid:: mgSmoothSteps should be positive and not both zero");
+  }
+  if(maxLevels < 1) {
+    IDEFIX_ERROR("Multigrid:: mgMaxLevels should be a strictly positive integer");
+  }
+
+  // Optimal damping of the Jacobi smoother for the 2*DIMENSIONS+1 points stencil
+  jacobiWeight = 2.0*DIMENSIONS/(2.0*DIMENSIONS+1.0);
+
+  InitFinestLevel();
+  while(MakeCoarseLevel()) {}
+
+  idfx::popRegion();
+}
+
+void Multigrid::AllocateLevel(Level &lev) {
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    lev.np_tot[dir] = lev.np_int[dir] + 2*lev.nghost[dir];
+    lev.beg[dir] = lev.nghost[dir];
+    lev.end[dir] = lev.nghost[dir] + lev.np_int[dir];
+  }
+  if(lev.active) {
+    lev.coef = IdefixArray4D<real>("MG_Coef", 2*DIMENSIONS, lev.np_tot[KDIR],
+                                                           lev.np_tot[JDIR],
+                                                           lev.np_tot[IDIR]);
+    lev.vol = IdefixArray3D<real>("MG_Volume", lev.np_tot[KDIR],
+                                               lev.np_tot[JDIR],
+                                               lev.np_tot[IDIR]);
+    lev.x = IdefixArray3D<real>("MG_Solution", lev.np_tot[KDIR],
+                                               lev.np_tot[JDIR],
+                                               lev.np_tot[IDIR]);
+    lev.rhs = IdefixArray3D<real>("MG_Rhs", lev.np_tot[KDIR],
+                                            lev.np_tot[JDIR],
+                                            lev.np_tot[IDIR]);
+    lev.res = IdefixArray3D<real>("MG_Residual", lev.np_tot[KDIR],
+                                                 lev.np_tot[JDIR],
+                                                 lev.np_tot[IDIR]);
+  }
+  #ifdef WITH_MPI
+  if(!lev.gathered && idfx::psize > 1) {
+    std::vector<int> mapVars;
+    mapVars.push_back(0);
+    lev.mpi = std::make_unique<Mpi>();
+    lev.mpi->Init(linearOperator.data->mygrid, mapVars, lev.nghost.data(), lev.np_int.data());
+  }
+  #endif
+}
+
+void Multigrid::InitFinestLevel() {
+  idfx::pushRegion("Multigrid::InitFinestLevel");
+  Laplacian &op = this->linearOperator;
+  Level lev;
+  lev.np_int = op.np_int;
+  lev.nghost = op.nghost;
+  lev.lbound = op.lbound;
+  lev.rbound = op.rbound;
+  lev.offset = {0, 0, 0};
+  lev.coarsened = {false, false, false};
+  globalLbound = op.lbound;
+  globalRbound = op.rbound;
+  AllocateLevel(lev);
+
+  #ifdef WITH_MPI
+    Grid *grid = op.data->mygrid;
+    // Offset of this process in the global (Laplacian) grid, which may be extended by the
+    // origin boundary condition.
+    std::array<int,6> mine;
+    std::vector<int> info(6*idfx::psize);
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      mine[dir] = grid->xproc[dir];
+      mine[3+dir] = lev.np_int[dir];
+    }
+    MPI_SAFE_CALL(MPI_Allgather(mine.data(), 6, MPI_INT, info.data(), 6, MPI_INT,
+                                MPI_COMM_WORLD));
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      for(int r = 0 ; r < idfx::psize ; r++) {
+        bool sameLine = true;
+        for(int d = 0 ; d < 3 ; d++) {
+          if(d != dir && info[6*r+d] != mine[d]) sameLine = false;
+        }
+        if(sameLine && info[6*r+dir] < mine[dir]) lev.offset[dir] += info[6*r+3+dir];
+      }
+    }
+
+    // Physical boundaries of the whole domain, known by the processes at the domain edges
+    std::array<int,6> bound;
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      bound[dir] = (grid->xproc[dir] == 0) ? op.lbound[dir] : -1;
+      bound[3+dir] = (grid->xproc[dir] == grid->nproc[dir]-1) ? op.rbound[dir] : -1;
+    }
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, bound.data(), 6, MPI_INT, MPI_MAX,
+                                MPI_COMM_WORLD));
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      globalLbound[dir] = static_cast<Laplacian::LaplacianBoundaryType>(bound[dir]);
+      globalRbound[dir] = static_cast<Laplacian::LaplacianBoundaryType>(bound[3+dir]);
+    }
+  #endif
+
+  // Copy the Laplacian coefficients and volumes
+  IdefixArray4D<real> coef = lev.coef;
+  IdefixArray3D<real> vol = lev.vol;
+  IdefixArray3D<real> dV = op.dV;
+  IdefixArray4D<real> Lx1 = op.Lx1;
+  IdefixArray4D<real> Lx2 = op.Lx2;
+  IdefixArray4D<real> Lx3 = op.Lx3;
+
+  idefix_for("MG_InitCoef", lev.beg[KDIR], lev.end[KDIR],
+                            lev.beg[JDIR], lev.end[JDIR],
+                            lev.beg[IDIR], lev.end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      vol(k,j,i) = dV(k,j,i);
+      coef(0,k,j,i) = Lx1(0,k,j,i);
+      coef(1,k,j,i) = Lx1(1,k,j,i);
+      #if DIMENSIONS > 1
+        coef(2,k,j,i) = Lx2(0,k,j,i);
+        coef(3,k,j,i) = Lx2(1,k,j,i);
+        #if DIMENSIONS > 2
+          coef(4,k,j,i) = Lx3(0,k,j,i);
+          coef(5,k,j,i) = Lx3(1,k,j,i);
+        #endif
+      #endif
+    });
+
+  levels.push_back(std::move(lev));
+  idfx::popRegion();
+}
+
+bool Multigrid::MakeCoarseLevel() {
+  Level &fine = levels.back();
+  if(!fine.active) return(false);
+  if(static_cast<int>(levels.size()) >= maxLevels) return(false);
+
+  // Directions which can be coarsened by a factor 2
+  std::array<int,3> canCoarsen = {0, 0, 0};
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    int factor = 2;
+    // The axis boundary condition needs an even number of cells in phi
+    if(dir == KDIR && linearOperator.isTwoPi) factor = 4;
+    if(fine.np_int[dir] % factor == 0 && fine.np_int[dir] >= 4) canCoarsen[dir] = 1;
+  }
+
+  #ifdef WITH_MPI
+  if(!fine.gathered && idfx::psize > 1) {
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, canCoarsen.data(), 3, MPI_INT, MPI_MIN,
+                                MPI_COMM_WORLD));
+    int64_t localSize = static_cast<int64_t>(fine.np_int[IDIR])*fine.np_int[JDIR]
+                                                                *fine.np_int[KDIR];
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, &localSize, 1, MPI_INT64_T, MPI_MAX,
+                                MPI_COMM_WORLD));
+    // Agglomerate the coarse grid when it becomes too small (or cannot be coarsened anymore)
+    if(localSize <= agglomerationSize
+       || canCoarsen[IDIR]+canCoarsen[JDIR]+canCoarsen[KDIR] == 0) {
+      Level gathered = MakeGatheredLevel(levels.back());
+      levels.push_back(std::move(gathered));
+      return(true);
+    }
+  }
+  #endif
+  if(canCoarsen[IDIR]+canCoarsen[JDIR]+canCoarsen[KDIR] == 0) return(false);
+
+  Level coarse;
+  coarse.gathered = fine.gathered;
+  coarse.active = fine.active;
+  coarse.lbound = fine.lbound;
+  coarse.rbound = fine.rbound;
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    coarse.coarsened[dir] = (canCoarsen[dir] == 1);
+    coarse.np_int[dir] = coarse.coarsened[dir] ? fine.np_int[dir]/2 : fine.np_int[dir];
+    coarse.offset[dir] = coarse.coarsened[dir] ? fine.offset[dir]/2 : fine.offset[dir];
+    coarse.nghost[dir] = (dir < DIMENSIONS) ? 1 : 0;
+  }
+  AllocateLevel(coarse);
+
+  // Coarse operator: face conductances (coef*vol) are summed over the fine faces, and halved
+  // in the coarsened directions where the distance between cell centres doubles.
+  IdefixArray4D<real> cf = fine.coef;
+  IdefixArray3D<real> vf = fine.vol;
+  IdefixArray4D<real> cc = coarse.coef;
+  IdefixArray3D<real> vc = coarse.vol;
+  const int fib = fine.beg[IDIR];
+  const int fjb = fine.beg[JDIR];
+  const int fkb = fine.beg[KDIR];
+  const int cib = coarse.beg[IDIR];
+  const int cjb = coarse.beg[JDIR];
+  const int ckb = coarse.beg[KDIR];
+  const int ri = coarse.coarsened[IDIR] ? 2 : 1;
+  const int rj = coarse.coarsened[JDIR] ? 2 : 1;
+  const int rk = coarse.coarsened[KDIR] ? 2 : 1;
+
+  idefix_for("MG_CoarsenOperator", coarse.beg[KDIR], coarse.end[KDIR],
+                                   coarse.beg[JDIR], coarse.end[JDIR],
+                                   coarse.beg[IDIR], coarse.end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      const int i0 = fib + (i-cib)*ri;
+      const int j0 = fjb + (j-cjb)*rj;
+      const int k0 = fkb + (k-ckb)*rk;
+      real v = 0;
+      real g[2*DIMENSIONS];
+      for(int n = 0 ; n < 2*DIMENSIONS ; n++) g[n] = 0;
+
+      for(int kk = 0 ; kk < rk ; kk++) {
+        for(int jj = 0 ; jj < rj ; jj++) {
+          for(int ii = 0 ; ii < ri ; ii++) {
+            const int kf = k0+kk;
+            const int jf = j0+jj;
+            const int iff = i0+ii;
+            const real dv = vf(kf,jf,iff);
+            v += dv;
+            if(ii == 0) g[0] += cf(0,kf,jf,iff)*dv;
+            if(ii == ri-1) g[1] += cf(1,kf,jf,iff)*dv;
+            #if DIMENSIONS > 1
+              if(jj == 0) g[2] += cf(2,kf,jf,iff)*dv;
+              if(jj == rj-1) g[3] += cf(3,kf,jf,iff)*dv;
+              #if DIMENSIONS > 2
+                if(kk == 0) g[4] += cf(4,kf,jf,iff)*dv;
+                if(kk == rk-1) g[5] += cf(5,kf,jf,iff)*dv;
+              #endif
+            #endif
+          }
+        }
+      }
+      vc(k,j,i) = v;
+      cc(0,k,j,i) = g[0]/(ri*v);
+      cc(1,k,j,i) = g[1]/(ri*v);
+      #if DIMENSIONS > 1
+        cc(2,k,j,i) = g[2]/(rj*v);
+        cc(3,k,j,i) = g[3]/(rj*v);
+        #if DIMENSIONS > 2
+          cc(4,k,j,i) = g[4]/(rk*v);
+          cc(5,k,j,i) = g[5]/(rk*v);
+        #endif
+      #endif
+    });
+
+  levels.push_back(std::move(coarse));
+  return(true);
+}
+
+#ifdef WITH_MPI
+Multigrid::Level Multigrid::MakeGatheredLevel(Level &fine) {
+  idfx::pushRegion("Multigrid::MakeGatheredLevel");
+  Level lev;
+  lev.gathered = true;
+  lev.active = (idfx::prank == 0);
+  lev.lbound = globalLbound;
+  lev.rbound = globalRbound;
+  lev.offset = {0, 0, 0};
+  lev.coarsened = {false, false, false};
+
+  // Position of each process in the global grid
+  std::array<int,6> mine;
+  std::vector<int> info(6*idfx::psize);
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    mine[dir] = fine.offset[dir];
+    mine[3+dir] = fine.np_int[dir];
+  }
+  MPI_SAFE_CALL(MPI_Allgather(mine.data(), 6, MPI_INT, info.data(), 6, MPI_INT,
+                              MPI_COMM_WORLD));
+
+  lev.np_int = {0, 0, 0};
+  lev.blocks.resize(idfx::psize);
+  lev.counts.resize(idfx::psize);
+  lev.displs.resize(idfx::psize);
+  int displ = 0;
+  for(int r = 0 ; r < idfx::psize ; r++) {
+    for(int n = 0 ; n < 6 ; n++) lev.blocks[r][n] = info[6*r+n];
+    for(int dir = 0 ; dir < 3 ; dir++) {
+      lev.np_int[dir] = std::max(lev.np_int[dir], info[6*r+dir]+info[6*r+3+dir]);
+    }
+    lev.counts[r] = info[6*r+3]*info[6*r+4]*info[6*r+5];
+    lev.displs[r] = displ;
+    displ += lev.counts[r];
+  }
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    lev.nghost[dir] = (dir < DIMENSIONS) ? 1 : 0;
+  }
+  AllocateLevel(lev);
+
+  // Transfer the operator
+  GatherToRoot(fine, fine.coef, lev, lev.coef);
+  GatherToRoot(fine, AsArray4D(fine.vol), lev, AsArray4D(lev.vol));
+
+  idfx::popRegion();
+  return(lev);
+}
+
+// Gather the active cells of a distributed level into a level agglomerated on process #0
+void Multigrid::GatherToRoot(Level &from, IdefixArray4D<real> in,
+                             Level &to, IdefixArray4D<real> out) {
+  idfx::pushRegion("Multigrid::GatherToRoot");
+  const int nvar = in.extent(0);
+  IdefixArray4D<real>::HostMirror inH = Kokkos::create_mirror_view(in);
+  Kokkos::deep_copy(inH, in);
+
+  std::vector<real> sendBuf(nvar*from.np_int[IDIR]*from.np_int[JDIR]*from.np_int[KDIR]);
+  int idx = 0;
+  for(int n = 0 ; n < nvar ; n++) {
+    for(int k = from.beg[KDIR] ; k < from.end[KDIR] ; k++) {
+      for(int j = from.beg[JDIR] ; j < from.end[JDIR] ; j++) {
+        for(int i = from.beg[IDIR] ; i < from.end[IDIR] ; i++) {
+          sendBuf[idx++] = inH(n,k,j,i);
+        }
+      }
+    }
+  }
+
+  std::vector<int> counts(idfx::psize);
+  std::vector<int> displs(idfx::psize);
+  for(int r = 0 ; r < idfx::psize ; r++) {
+    counts[r] = nvar*to.counts[r];
+    displs[r] = nvar*to.displs[r];
+  }
+  std::vector<real> recvBuf;
+  if(idfx::prank == 0) recvBuf.resize(displs.back()+counts.back());
+
+  MPI_SAFE_CALL(MPI_Gatherv(sendBuf.data(), static_cast<int>(sendBuf.size()), realMPI,
+                            recvBuf.data(), counts.data(), displs.data(), realMPI,
+                            0, MPI_COMM_WORLD));
+
+  if(idfx::prank == 0) {
+    IdefixArray4D<real>::HostMirror outH = Kokkos::create_mirror_view(out);
+    for(int r = 0 ; r < idfx::psize ; r++) {
+      const std::array<int,6> &b = to.blocks[r];
+      idx = displs[r];
+      for(int n = 0 ; n < nvar ; n++) {
+        for(int k = 0 ; k < b[3+KDIR] ; k++) {
+          for(int j = 0 ; j < b[3+JDIR] ; j++) {
+            for(int i = 0 ; i < b[3+IDIR] ; i++) {
+              outH(n, to.beg[KDIR]+b[KDIR]+k,
+                      to.beg[JDIR]+b[JDIR]+j,
+                      to.beg[IDIR]+b[IDIR]+i) = recvBuf[idx++];
+            }
+          }
+        }
+      }
+    }
+    Kokkos::deep_copy(out, outH);
+  }
+  idfx::popRegion();
+}
+
+// Scatter the active cells of a level agglomerated on process #0 to a distributed level
+void Multigrid::ScatterFromRoot(Level &from, IdefixArray4D<real> in,
+                                Level &to, IdefixArray4D<real> out) {
+  idfx::pushRegion("Multigrid::ScatterFromRoot");
+  const int nvar = out.extent(0);
+  std::vector<int> counts(idfx::psize);
+  std::vector<int> displs(idfx::psize);
+  for(int r = 0 ; r < idfx::psize ; r++) {
+    counts[r] = nvar*from.counts[r];
+    displs[r] = nvar*from.displs[r];
+  }
+
+  std::vector<real> sendBuf;
+  if(idfx::prank == 0) {
+    sendBuf.resize(displs.back()+counts.back());
+    IdefixArray4D<real>::HostMirror inH = Kokkos::create_mirror_view(in);
+    Kokkos::deep_copy(inH, in);
+    for(int r = 0 ; r < idfx::psize ; r++) {
+      const std::array<int,6> &b = from.blocks[r];
+      int idx = displs[r];
+      for(int n = 0 ; n < nvar ; n++) {
+        for(int k = 0 ; k < b[3+KDIR] ; k++) {
+          for(int j = 0 ; j < b[3+JDIR] ; j++) {
+            for(int i = 0 ; i < b[3+IDIR] ; i++) {
+              sendBuf[idx++] = inH(n, from.beg[KDIR]+b[KDIR]+k,
+                                      from.beg[JDIR]+b[JDIR]+j,
+                                      from.beg[IDIR]+b[IDIR]+i);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<real> recvBuf(nvar*to.np_int[IDIR]*to.np_int[JDIR]*to.np_int[KDIR]);
+  MPI_SAFE_CALL(MPI_Scatterv(sendBuf.data(), counts.data(), displs.data(), realMPI,
+                             recvBuf.data(), static_cast<int>(recvBuf.size()), realMPI,
+                             0, MPI_COMM_WORLD));
+
+  IdefixArray4D<real>::HostMirror outH = Kokkos::create_mirror_view(out);
+  int idx = 0;
+  for(int n = 0 ; n < nvar ; n++) {
+    for(int k = to.beg[KDIR] ; k < to.end[KDIR] ; k++) {
+      for(int j = to.beg[JDIR] ; j < to.end[JDIR] ; j++) {
+        for(int i = to.beg[IDIR] ; i < to.end[IDIR] ; i++) {
+          outH(n,k,j,i) = recvBuf[idx++];
+        }
+      }
+    }
+  }
+  Kokkos::deep_copy(out, outH);
+  idfx::popRegion();
+}
+#endif
+
+void Multigrid::EnforceBoundary(int l, int dir, BoundarySide side,
+                                Laplacian::LaplacianBoundaryType type,
+                                IdefixArray3D<real> &arr) {
+  Level &lev = levels[l];
+  IdefixArray3D<real> localVar = arr;
+
+  // Number of active cells
+  const int nxi = lev.np_int[IDIR];
+  const int nxj = lev.np_int[JDIR];
+  const int nxk = lev.np_int[KDIR];
+
+  // Number of ghost cells
+  const int ighost = lev.nghost[IDIR];
+  const int jghost = lev.nghost[JDIR];
+  const int kghost = lev.nghost[KDIR];
+
+  // Boundaries of the loop
+  const int ibeg = (dir == IDIR) ? side*(ighost+nxi) : 0;
+  const int iend = (dir == IDIR) ? ighost + side*(ighost+nxi) : lev.np_tot[IDIR];
+  const int jbeg = (dir == JDIR) ? side*(jghost+nxj) : 0;
+  const int jend = (dir == JDIR) ? jghost + side*(jghost+nxj) : lev.np_tot[JDIR];
+  const int kbeg = (dir == KDIR) ? side*(kghost+nxk) : 0;
+  const int kend = (dir == KDIR) ? kghost + side*(kghost+nxk) : lev.np_tot[KDIR];
+
+  switch(type) {
+    case Laplacian::internalgrav:
+      // Boundary enforced by MPI exchanges
+      break;
+
+    case Laplacian::periodic: {
+      #ifdef WITH_MPI
+      // Periodicity already enforced by MPI calls
+      if(!lev.gathered && linearOperator.data->mygrid->nproc[dir] > 1) break;
+      #endif
+      idefix_for("MG_BoundaryPeriodic", kbeg, kend, jbeg, jend, ibeg, iend,
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          const int iref = (dir==IDIR) ? ighost + (i+ighost*(nxi-1))%nxi : i;
+          const int jref = (dir==JDIR) ? jghost + (j+jghost*(nxj-1))%nxj : j;
+          const int kref = (dir==KDIR) ? kghost + (k+kghost*(nxk-1))%nxk : k;
+          localVar(k,j,i) = localVar(kref,jref,iref);
+        });
+      break;
+    }
+
+    // Corrections vanish on boundaries where the potential is prescribed
+    case Laplacian::nullpot:
+    case Laplacian::userdef: {
+      idefix_for("MG_BoundaryNullPot", kbeg, kend, jbeg, jend, ibeg, iend,
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          localVar(k,j,i) = 0.0;
+        });
+      break;
+    }
+
+    // The origin boundary condition is approximated by a null gradient on coarse levels
+    case Laplacian::nullgrad:
+    case Laplacian::origin: {
+      idefix_for("MG_BoundaryNullGrad", kbeg, kend, jbeg, jend, ibeg, iend,
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          const int iref = (dir==IDIR) ? ighost + side*(nxi-1) : i;
+          const int jref = (dir==JDIR) ? jghost + side*(nxj-1) : j;
+          const int kref = (dir==KDIR) ? kghost + side*(nxk-1) : k;
+          localVar(k,j,i) = localVar(kref,jref,iref);
+        });
+      break;
+    }
+
+    case Laplacian::axis: {
+      const int jref = (side == left) ? lev.beg[JDIR] : lev.end[JDIR]-1;
+      const int offset = (side == left) ? -1 : 1;
+      if(linearOperator.isTwoPi) {
+        idefix_for("MG_BoundaryAxis", kbeg, kend, jbeg, jend, ibeg, iend,
+          KOKKOS_LAMBDA (int k, int j, int i) {
+            const int kcomp = kghost + (( k - kghost + nxk/2) % nxk);
+            localVar(k,j,i) = localVar(kcomp, 2*jref-j+offset, i);
+          });
+      } else {
+        idefix_for("MG_BoundaryAxis", kbeg, kend, jbeg, jend, ibeg, iend,
+          KOKKOS_LAMBDA (int k, int j, int i) {
+            localVar(k,j,i) = localVar(k, 2*jref-j+offset, i);
+          });
+      }
+      break;
+    }
+
+    default:
+      IDEFIX_ERROR("Multigrid:: Boundary condition type is not yet implemented");
+  }
+}
+
+void Multigrid::SetBoundaries(int l, IdefixArray3D<real> &arr) {
+  idfx::pushRegion("Multigrid::SetBoundaries");
+  Level &lev = levels[l];
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    #ifdef WITH_MPI
+    if(!lev.gathered && linearOperator.data->mygrid->nproc[dir] > 1) {
+      IdefixArray4D<real> arr4D = AsArray4D(arr);
+      switch(dir) {
+        case 0:
+          lev.mpi->ExchangeX1(arr4D);
+          break;
+        case 1:
+          lev.mpi->ExchangeX2(arr4D);
+          break;
+        case 2:
+          lev.mpi->ExchangeX3(arr4D);
+          break;
+      }
+    }
+    #endif
+    EnforceBoundary(l, dir, left, lev.lbound[dir], arr);
+    EnforceBoundary(l, dir, right, lev.rbound[dir], arr);
+  }
+  idfx::popRegion();
+}
+
+void Multigrid::Smooth(int l, int nsweeps, bool reverse) {
+  idfx::pushRegion("Multigrid::Smooth");
+  Level &lev = levels[l];
+  IdefixArray3D<real> x = lev.x;
+  IdefixArray3D<real> rhs = lev.rhs;
+  IdefixArray3D<real> work = lev.res;
+  IdefixArray4D<real> coef = lev.coef;
+
+  // Shift from local to global indices, used to colour the cells consistently across processes
+  const int oi = lev.offset[IDIR] - lev.beg[IDIR];
+  const int oj = lev.offset[JDIR] - lev.beg[JDIR];
+  const int ok = lev.offset[KDIR] - lev.beg[KDIR];
+  const real w = jacobiWeight;
+
+  for(int n = 0 ; n < nsweeps ; n++) {
+    if(smootherType == jacobi) {
+      SetBoundaries(l, x);
+      idefix_for("MG_Jacobi", lev.beg[KDIR], lev.end[KDIR],
+                              lev.beg[JDIR], lev.end[JDIR],
+                              lev.beg[IDIR], lev.end[IDIR],
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          real sum, csum;
+          NeighbourSum(coef, x, k, j, i, sum, csum);
+          work(k,j,i) = (sum - rhs(k,j,i))/csum;
+        });
+      idefix_for("MG_JacobiUpdate", lev.beg[KDIR], lev.end[KDIR],
+                                    lev.beg[JDIR], lev.end[JDIR],
+                                    lev.beg[IDIR], lev.end[IDIR],
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          x(k,j,i) += w*(work(k,j,i) - x(k,j,i));
+        });
+    } else {
+      // Post-smoothing sweeps colours in reverse order, so that the cycle remains symmetric
+      for(int c = 0 ; c < 2 ; c++) {
+        const int color = reverse ? 1-c : c;
+        SetBoundaries(l, x);
+        idefix_for("MG_RedBlack", lev.beg[KDIR], lev.end[KDIR],
+                                  lev.beg[JDIR], lev.end[JDIR],
+                                  lev.beg[IDIR], lev.end[IDIR],
+          KOKKOS_LAMBDA (int k, int j, int i) {
+            if((i+oi + j+oj + k+ok) % 2 == color) {
+              real sum, csum;
+              NeighbourSum(coef, x, k, j, i, sum, csum);
+              x(k,j,i) = (sum - rhs(k,j,i))/csum;
+            }
+          });
+      }
+    }
+  }
+  idfx::popRegion();
+}
+
+void Multigrid::ComputeResidual(int l) {
+  idfx::pushRegion("Multigrid::ComputeResidual");
+  Level &lev = levels[l];
+  IdefixArray3D<real> x = lev.x;
+  IdefixArray3D<real> rhs = lev.rhs;
+  IdefixArray3D<real> res = lev.res;
+  IdefixArray4D<real> coef = lev.coef;
+
+  SetBoundaries(l, x);
+  idefix_for("MG_Residual", lev.beg[KDIR], lev.end[KDIR],
+                            lev.beg[JDIR], lev.end[JDIR],
+                            lev.beg[IDIR], lev.end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      real sum, csum;
+      NeighbourSum(coef, x, k, j, i, sum, csum);
+      res(k,j,i) = rhs(k,j,i) - (sum - csum*x(k,j,i));
+    });
+  idfx::popRegion();
+}
+
+// Volume-weighted average of the residual of level l into the rhs of level l+1
+void Multigrid::Restrict(int l) {
+  idfx::pushRegion("Multigrid::Restrict");
+  Level &fine = levels[l];
+  Level &coarse = levels[l+1];
+  IdefixArray3D<real> res = fine.res;
+  IdefixArray3D<real> vf = fine.vol;
+  IdefixArray3D<real> rhs = coarse.rhs;
+  IdefixArray3D<real> vc = coarse.vol;
+  const int fib = fine.beg[IDIR];
+  const int fjb = fine.beg[JDIR];
+  const int fkb = fine.beg[KDIR];
+  const int cib = coarse.beg[IDIR];
+  const int cjb = coarse.beg[JDIR];
+  const int ckb = coarse.beg[KDIR];
+  const int ri = coarse.coarsened[IDIR] ? 2 : 1;
+  const int rj = coarse.coarsened[JDIR] ? 2 : 1;
+  const int rk = coarse.coarsened[KDIR] ? 2 : 1;
+
+  idefix_for("MG_Restrict", coarse.beg[KDIR], coarse.end[KDIR],
+                            coarse.beg[JDIR], coarse.end[JDIR],
+                            coarse.beg[IDIR], coarse.end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      const int i0 = fib + (i-cib)*ri;
+      const int j0 = fjb + (j-cjb)*rj;
+      const int k0 = fkb + (k-ckb)*rk;
+      real sum = 0;
+      for(int kk = 0 ; kk < rk ; kk++) {
+        for(int jj = 0 ; jj < rj ; jj++) {
+          for(int ii = 0 ; ii < ri ; ii++) {
+            sum += vf(k0+kk,j0+jj,i0+ii)*res(k0+kk,j0+jj,i0+ii);
+          }
+        }
+      }
+      rhs(k,j,i) = sum/vc(k,j,i);
+    });
+  idfx::popRegion();
+}
+
+// Add the (multi)linear interpolation of the solution of level l+1 to the solution of level l
+void Multigrid::Prolong(int l) {
+  idfx::pushRegion("Multigrid::Prolong");
+  Level &fine = levels[l];
+  Level &coarse = levels[l+1];
+  IdefixArray3D<real> x = fine.x;
+  IdefixArray3D<real> xc = coarse.x;
+  const int fib = fine.beg[IDIR];
+  const int fjb = fine.beg[JDIR];
+  const int fkb = fine.beg[KDIR];
+  const int cib = coarse.beg[IDIR];
+  const int cjb = coarse.beg[JDIR];
+  const int ckb = coarse.beg[KDIR];
+  const int ri = coarse.coarsened[IDIR] ? 2 : 1;
+  const int rj = coarse.coarsened[JDIR] ? 2 : 1;
+  const int rk = coarse.coarsened[KDIR] ? 2 : 1;
+
+  SetBoundaries(l+1, xc);
+
+  idefix_for("MG_Prolong", fine.beg[KDIR], fine.end[KDIR],
+                           fine.beg[JDIR], fine.end[JDIR],
+                           fine.beg[IDIR], fine.end[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      const int di = i-fib;
+      const int dj = j-fjb;
+      const int dk = k-fkb;
+      const int ic = cib + di/ri;
+      const int jc = cjb + dj/rj;
+      const int kc = ckb + dk/rk;
+      // Neighbouring coarse cell and its weight in each direction
+      const int si = (ri == 1) ? 0 : ((di % 2 == 0) ? -1 : 1);
+      const int sj = (rj == 1) ? 0 : ((dj % 2 == 0) ? -1 : 1);
+      const int sk = (rk == 1) ? 0 : ((dk % 2 == 0) ? -1 : 1);
+      const real wi = (ri == 1) ? 0.0 : 0.25;
+      const real wj = (rj == 1) ? 0.0 : 0.25;
+      const real wk = (rk == 1) ? 0.0 : 0.25;
+
+      real v = 0;
+      for(int c3 = 0 ; c3 < 2 ; c3++) {
+        for(int c2 = 0 ; c2 < 2 ; c2++) {
+          for(int c1 = 0 ; c1 < 2 ; c1++) {
+            const real wc = (c1 ? wi : 1.0-wi)*(c2 ? wj : 1.0-wj)*(c3 ? wk : 1.0-wk);
+            if(wc > 0) v += wc*xc(kc+c3*sk, jc+c2*sj, ic+c1*si);
+          }
+        }
+      }
+      x(k,j,i) += v;
+    });
+  idfx::popRegion();
+}
+
+void Multigrid::Cycle(int l) {
+  Level &lev = levels[l];
+  if(l == static_cast<int>(levels.size())-1) {
+    Smooth(l, nCoarseSweeps, false);
+    return;
+  }
+  Level &next = levels[l+1];
+
+  Smooth(l, nPreSmooth, false);
+  ComputeResidual(l);
+
+  // Reset the coarse correction
+  if(next.active) {
+    IdefixArray3D<real> xc = next.x;
+    idefix_for("MG_ResetCorrection", 0, next.np_tot[KDIR],
+                                     0, next.np_tot[JDIR],
+                                     0, next.np_tot[IDIR],
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        xc(k,j,i) = 0.0;
+      });
+  }
+
+  if(next.gathered && !lev.gathered) {
+    #ifdef WITH_MPI
+    // Agglomerated coarse problem, solved by process #0 while the others wait
+    GatherToRoot(lev, AsArray4D(lev.res), next, AsArray4D(next.rhs));
+    if(next.active) Cycle(l+1);
+    ScatterFromRoot(next, AsArray4D(next.x), lev, AsArray4D(lev.res));
+
+    IdefixArray3D<real> x = lev.x;
+    IdefixArray3D<real> corr = lev.res;
+    idefix_for("MG_AddCorrection", lev.beg[KDIR], lev.end[KDIR],
+                                   lev.beg[JDIR], lev.end[JDIR],
+                                   lev.beg[IDIR], lev.end[IDIR],
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        x(k,j,i) += corr(k,j,i);
+      });
+    #endif
+  } else {
+    Restrict(l);
+    const int ncycles = (cycleType == Wcycle) ? 2 : 1;
+    for(int n = 0 ; n < ncycles ; n++) {
+      Cycle(l+1);
+    }
+    Prolong(l);
+  }
+
+  Smooth(l, nPostSmooth, true);
+}
+
+void Multigrid::ApplyCycle(IdefixArray3D<real> &r) {
+  idfx::pushRegion("Multigrid::ApplyCycle");
+  Level &fine = levels[0];
+  IdefixArray3D<real> x = fine.x;
+  IdefixArray3D<real> rhs = fine.rhs;
+  idefix_for("MG_InitCycle", 0, fine.np_tot[KDIR],
+                             0, fine.np_tot[JDIR],
+                             0, fine.np_tot[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      x(k,j,i) = 0.0;
+      rhs(k,j,i) = r(k,j,i);
+    });
+  Cycle(0);
+  idfx::popRegion();
+}
+
+void Multigrid::ApplyPreconditioner(IdefixArray3D<real> &in, IdefixArray3D<real> &out) {
+  ApplyCycle(in);
+  Kokkos::deep_copy(out, levels[0].x);
+}
+
+int Multigrid::Solve(IdefixArray3D<real> &guess, IdefixArray3D<real> &rhs) {
+  idfx::pushRegion("Multigrid::Solve");
+  this->solution = guess;
+  this->rhs = rhs;
+
+  // Re-initialise convStatus
+  this->convStatus = false;
+
+  this->SetRes();
+  this->TestErrorL2();
+
+  IdefixArray3D<real> x = this->solution;
+  IdefixArray3D<real> corr = levels[0].x;
+
+  int n = 0;
+  while(this->convStatus != true && n < this->maxiter) {
+    // Correct the solution with a cycle applied to the current residual
+    ApplyCycle(this->res);
+    idefix_for("MG_Correct", this->beg[KDIR], this->end[KDIR],
+                             this->beg[JDIR], this->end[JDIR],
+                             this->beg[IDIR], this->end[IDIR],
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        x(k,j,i) += corr(k,j,i);
+      });
+    this->SetRes();
+    this->TestErrorL2();
+    n++;
+  }
+
+  if(n == this->maxiter) {
+    idfx::cout << "Multigrid:: Reached max iter." << std::endl;
+    IDEFIX_WARNING("Multigrid:: Failed to converge before reaching max iter.");
+  }
+
+  idfx::popRegion();
+  return(n);
+}
+
+void Multigrid::ShowConfig() {
+  idfx::pushRegion("Multigrid::ShowConfig");
+  if(!this->isPreconditioner) {
+    idfx::cout << "Multigrid: TargetError: " << this->targetError << std::endl;
+    idfx::cout << "Multigrid: Maximum iterations: " << this->maxiter << std::endl;
+  }
+  idfx::cout << "Multigrid: " << (cycleType == Vcycle ? "V" : "W") << "-cycles with "
+             << nPreSmooth << "+" << nPostSmooth << " "
+             << (smootherType == jacobi ? "weighted Jacobi" : "red-black Gauss-Seidel")
+             << " smoothing steps." << std::endl;
+  idfx::cout << "Multigrid: " << levels.size() << " levels (cells per process):";
+  for(size_t l = 0 ; l < levels.size() ; l++) {
+    idfx::cout << " " << levels[l].np_int[IDIR];
+    for(int dir = 1 ; dir < DIMENSIONS ; dir++) idfx::cout << "x" << levels[l].np_int[dir];
+    if(levels[l].gathered && (l == 0 || !levels[l-1].gathered)) {
+      idfx::cout << " (agglomerated)";
+    }
+  }
+  idfx::cout << std::endl;
+  idfx::popRegion();
+}
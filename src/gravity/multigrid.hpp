@@ -0,0 +1,106 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef GRAVITY_MULTIGRID_HPP_
+#define GRAVITY_MULTIGRID_HPP_
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "idefix.hpp"
+#include "input.hpp"
+#include "iterativesolver.hpp"
+#include "laplacian.hpp"
+#ifdef WITH_MPI
+#include "mpi.hpp"
+#endif
+
+// Geometric multigrid solver for the self-gravity Laplacian.
+// It can either be used as a standalone solver (each iteration is a multigrid cycle applied
+// to the current residual) or as a preconditioner of the Cg and Bicgstab solvers.
+// The coarse operators are built from the face conductances A/(h dl) and cell volumes of the
+// fine operator, so that they follow the geometry (cartesian, polar or spherical) of the
+// Laplacian. Coarse levels solve for a correction, hence they use the homogeneous version of
+// the Laplacian boundary conditions.
+class Multigrid : public IterativeSolver<Laplacian> {
+ public:
+  enum CycleType {Vcycle, Wcycle};
+  enum SmootherType {jacobi, redBlack};
+
+  Multigrid(Input &, Laplacian &op, real error, int maxIter,
+            std::array<int,3> ntot, std::array<int,3> beg, std::array<int,3> end);
+
+  int Solve(IdefixArray3D<real> &guess, IdefixArray3D<real> &rhs);
+  void ApplyPreconditioner(IdefixArray3D<real> &in, IdefixArray3D<real> &out);
+  void ShowConfig();
+
+  // Internal functions (left public for Lambda capture)
+  void InitFinestLevel();
+  bool MakeCoarseLevel();
+  void ApplyCycle(IdefixArray3D<real> &);  // one cycle on the finest level from a zero guess
+  void Cycle(int);
+  void Smooth(int, int, bool);
+  void ComputeResidual(int);
+  void Restrict(int);
+  void Prolong(int);
+  void SetBoundaries(int, IdefixArray3D<real> &);
+  void EnforceBoundary(int, int, BoundarySide, Laplacian::LaplacianBoundaryType,
+                       IdefixArray3D<real> &);
+
+ private:
+  struct Level {
+    std::array<int,3> np_int;
+    std::array<int,3> np_tot;
+    std::array<int,3> nghost;
+    std::array<int,3> beg;
+    std::array<int,3> end;
+    std::array<int,3> offset;       // global index of the first active cell of this process
+    std::array<bool,3> coarsened;   // whether this level is coarser than the previous one
+    bool gathered{false};           // whether this level is agglomerated on process #0
+    bool active{true};              // whether this process holds the level
+
+    std::array<Laplacian::LaplacianBoundaryType,3> lbound;
+    std::array<Laplacian::LaplacianBoundaryType,3> rbound;
+
+    IdefixArray4D<real> coef;       // coefficients of the left/right neighbours in each dir
+    IdefixArray3D<real> vol;        // cell volumes
+    IdefixArray3D<real> x;          // current solution
+    IdefixArray3D<real> rhs;        // right hand side
+    IdefixArray3D<real> res;        // residual
+
+    #ifdef WITH_MPI
+    std::unique_ptr<Mpi> mpi;       // halo exchanges of distributed levels
+    std::vector<std::array<int,6>> blocks;  // offset and size of each process (gathered levels)
+    std::vector<int> counts;        // # of active cells of each process (gathered levels)
+    std::vector<int> displs;        // displacement of each process (gathered levels)
+    #endif
+  };
+
+  void AllocateLevel(Level &);
+  #ifdef WITH_MPI
+  Level MakeGatheredLevel(Level &);
+  void GatherToRoot(Level &, IdefixArray4D<real>, Level &, IdefixArray4D<real>);
+  void ScatterFromRoot(Level &, IdefixArray4D<real>, Level &, IdefixArray4D<real>);
+  #endif
+
+  std::vector<Level> levels;
+
+  CycleType cycleType{Vcycle};
+  SmootherType smootherType{redBlack};
+  int nPreSmooth{2};
+  int nPostSmooth{2};
+  int nCoarseSweeps{32};        // # of smoothing sweeps on the coarsest level
+  int maxLevels;
+  int agglomerationSize;        // # of cells per process below which levels are agglomerated
+  real jacobiWeight;
+
+  // Physical boundary conditions of the whole domain (used by agglomerated levels)
+  std::array<Laplacian::LaplacianBoundaryType,3> globalLbound;
+  std::array<Laplacian::LaplacianBoundaryType,3> globalRbound;
+};
+
+#endif // GRAVITY_MULTIGRID_HPP_
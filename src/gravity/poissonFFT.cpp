@@ -0,0 +1,361 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "poissonFFT.hpp"
+#include "dataBlock.hpp"
+
+// Position of cell (k,j,i) in the send buffer of direction dir: the cells are grouped by the
+// process which owns their line, then by line and finally by position along the line.
+KOKKOS_INLINE_FUNCTION int SendPosition(const int dir, const int k, const int j, const int i,
+                                        const int ni, const int nj, const int n,
+                                        const int nlines, const int nproc,
+                                        const IdefixArray1D<int> &lineStart,
+                                        const IdefixArray1D<int> &displ) {
+  int line, m;
+  if(dir == IDIR) {
+    line = k*nj + j;
+    m = i;
+  } else if(dir == JDIR) {
+    line = k*ni + i;
+    m = j;
+  } else {
+    line = j*ni + i;
+    m = k;
+  }
+  const int p = static_cast<int>(((static_cast<int64_t>(line)+1)*nproc - 1)/nlines);
+  return(displ(p) + ((line - lineStart(p))*n + m)*2);
+}
+
+// Position of point g of (owned) line l in the receive buffer of a direction
+KOKKOS_INLINE_FUNCTION int RecvPosition(const int l, const int g,
+                                        const IdefixArray1D<int> &slabStart,
+                                        const IdefixArray1D<int> &displ) {
+  int q = 0;
+  while(g >= slabStart(q+1)) q++;
+  const int nq = slabStart(q+1) - slabStart(q);
+  return(displ(q) + (l*nq + g - slabStart(q))*2);
+}
+
+static IdefixArray1D<int> ToDevice(const std::vector<int> &vec, std::string name) {
+  IdefixArray1D<int> arr(name, vec.size());
+  IdefixArray1D<int>::HostMirror arrHost = Kokkos::create_mirror_view(arr);
+  for(size_t n = 0 ; n < vec.size() ; n++) arrHost(n) = vec[n];
+  Kokkos::deep_copy(arr, arrHost);
+  return(arr);
+}
+
+PoissonFFT::PoissonFFT(Laplacian &op, real error, int maxiter,
+                       std::array<int,3> ntot, std::array<int,3> beg, std::array<int,3> end) :
+                       IterativeSolver<Laplacian>(op, error, maxiter, ntot, beg, end) {
+  idfx::pushRegion("PoissonFFT::PoissonFFT");
+
+  #if GEOMETRY != CARTESIAN
+    IDEFIX_ERROR("PoissonFFT:: the FFT solver requires a cartesian geometry");
+  #endif
+  if(!op.isPeriodic) {
+    IDEFIX_ERROR("PoissonFFT:: the FFT solver requires periodic boundaries in all directions");
+  }
+  if(op.havePreconditioner) {
+    IDEFIX_ERROR("PoissonFFT:: cannot be used with a diagonally preconditioned Laplacian");
+  }
+
+  Grid *grid = op.data->mygrid;
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    nlocal[dir] = op.np_int[dir];
+    nglob[dir] = grid->np_int[dir];
+    offset[dir] = grid->decomposition[dir][grid->xproc[dir]];
+    dx[dir] = 1.0;
+    nproc[dir] = 1;
+    nlines[dir] = 0;
+    nlinesMine[dir] = 0;
+    linesAliasBuf[dir] = false;
+  }
+
+  // Check that the grid is uniform
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    IdefixArray1D<real>::HostMirror dxHost = Kokkos::create_mirror_view(op.dx[dir]);
+    Kokkos::deep_copy(dxHost, op.dx[dir]);
+    real dxMin = dxHost(op.beg[dir]);
+    real dxMax = dxMin;
+    for(int i = op.beg[dir] ; i < op.end[dir] ; i++) {
+      dxMin = std::fmin(dxMin, dxHost(i));
+      dxMax = std::fmax(dxMax, dxHost(i));
+    }
+    #ifdef WITH_MPI
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, &dxMin, 1, realMPI, MPI_MIN, MPI_COMM_WORLD));
+    MPI_SAFE_CALL(MPI_Allreduce(MPI_IN_PLACE, &dxMax, 1, realMPI, MPI_MAX, MPI_COMM_WORLD));
+    #endif
+    if(dxMax - dxMin > 1e-5*dxMax) {
+      IDEFIX_ERROR("PoissonFFT:: the FFT solver requires a uniform grid");
+    }
+    dx[dir] = dxMin;
+  }
+
+  field = IdefixArray4D<real>("FFT_Field", 2, nlocal[KDIR], nlocal[JDIR], nlocal[IDIR]);
+
+  // Redistribution of the lines of each direction
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    #ifdef WITH_MPI
+      int remainDims[3] = {false, false, false};
+      remainDims[dir] = true;
+      MPI_Cart_sub(grid->CartComm, remainDims, &lineComm[dir]);
+      MPI_Comm_size(lineComm[dir], &nproc[dir]);
+    #endif
+    const int P = nproc[dir];
+    // The rank of a process in lineComm is its coordinate along dir
+    const int me = grid->xproc[dir];
+
+    nlines[dir] = nlocal[IDIR]*nlocal[JDIR]*nlocal[KDIR]/nlocal[dir];
+
+    std::vector<int> lineStartHost(P+1);
+    std::vector<int> slabStartHost(P+1);
+    for(int p = 0 ; p <= P ; p++) {
+      lineStartHost[p] = static_cast<int>(static_cast<int64_t>(p)*nlines[dir]/P);
+      slabStartHost[p] = grid->decomposition[dir][p];
+    }
+    nlinesMine[dir] = lineStartHost[me+1] - lineStartHost[me];
+
+    std::vector<int> sCount(P), sDispl(P), rCount(P), rDispl(P);
+    int sendSize = 0;
+    int recvSize = 0;
+    for(int p = 0 ; p < P ; p++) {
+      sCount[p] = (lineStartHost[p+1] - lineStartHost[p])*nlocal[dir]*2;
+      rCount[p] = nlinesMine[dir]*(slabStartHost[p+1] - slabStartHost[p])*2;
+      sDispl[p] = sendSize;
+      rDispl[p] = recvSize;
+      sendSize += sCount[p];
+      recvSize += rCount[p];
+    }
+
+    lineStart[dir] = ToDevice(lineStartHost, "FFT_LineStart");
+    slabStart[dir] = ToDevice(slabStartHost, "FFT_SlabStart");
+    sendDispl[dir] = ToDevice(sDispl, "FFT_SendDispl");
+    recvDispl[dir] = ToDevice(rDispl, "FFT_RecvDispl");
+
+    sendBuf[dir] = IdefixArray1D<real>("FFT_SendBuffer", sendSize);
+    if(P == 1) {
+      // The send buffer already holds complete lines
+      recvBuf[dir] = sendBuf[dir];
+      lines[dir] = IdefixArray3D<real>(sendBuf[dir].data(), nlinesMine[dir], nglob[dir], 2);
+      linesAliasBuf[dir] = true;
+    } else {
+      recvBuf[dir] = IdefixArray1D<real>("FFT_RecvBuffer", recvSize);
+      lines[dir] = IdefixArray3D<real>("FFT_Lines", nlinesMine[dir], nglob[dir], 2);
+    }
+
+    #ifdef WITH_MPI
+      sendCount[dir] = sCount;
+      sendDisplHost[dir] = sDispl;
+      recvCount[dir] = rCount;
+      recvDisplHost[dir] = rDispl;
+    #endif
+
+    fft.emplace_back(nglob[dir]);
+  }
+
+  idfx::popRegion();
+}
+
+void PoissonFFT::PackLines(int dir) {
+  idfx::pushRegion("PoissonFFT::PackLines");
+  IdefixArray4D<real> field = this->field;
+  IdefixArray1D<real> buf = this->sendBuf[dir];
+  IdefixArray1D<int> lineStart = this->lineStart[dir];
+  IdefixArray1D<int> displ = this->sendDispl[dir];
+  const int ni = nlocal[IDIR];
+  const int nj = nlocal[JDIR];
+  const int n = nlocal[dir];
+  const int nl = nlines[dir];
+  const int P = nproc[dir];
+
+  idefix_for("FFT_Pack", 0, nlocal[KDIR], 0, nlocal[JDIR], 0, nlocal[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      const int pos = SendPosition(dir, k, j, i, ni, nj, n, nl, P, lineStart, displ);
+      buf(pos) = field(0,k,j,i);
+      buf(pos+1) = field(1,k,j,i);
+    });
+  idfx::popRegion();
+}
+
+void PoissonFFT::UnpackLines(int dir) {
+  idfx::pushRegion("PoissonFFT::UnpackLines");
+  IdefixArray4D<real> field = this->field;
+  IdefixArray1D<real> buf = this->sendBuf[dir];
+  IdefixArray1D<int> lineStart = this->lineStart[dir];
+  IdefixArray1D<int> displ = this->sendDispl[dir];
+  const int ni = nlocal[IDIR];
+  const int nj = nlocal[JDIR];
+  const int n = nlocal[dir];
+  const int nl = nlines[dir];
+  const int P = nproc[dir];
+
+  idefix_for("FFT_Unpack", 0, nlocal[KDIR], 0, nlocal[JDIR], 0, nlocal[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      const int pos = SendPosition(dir, k, j, i, ni, nj, n, nl, P, lineStart, displ);
+      field(0,k,j,i) = buf(pos);
+      field(1,k,j,i) = buf(pos+1);
+    });
+  idfx::popRegion();
+}
+
+void PoissonFFT::ScatterLines(int dir) {
+  idfx::pushRegion("PoissonFFT::ScatterLines");
+  IdefixArray1D<real> buf = this->recvBuf[dir];
+  IdefixArray3D<real> lines = this->lines[dir];
+  IdefixArray1D<int> slabStart = this->slabStart[dir];
+  IdefixArray1D<int> displ = this->recvDispl[dir];
+
+  idefix_for("FFT_ScatterLines", 0, nlinesMine[dir], 0, nglob[dir],
+    KOKKOS_LAMBDA (int l, int g) {
+      const int pos = RecvPosition(l, g, slabStart, displ);
+      lines(l,g,0) = buf(pos);
+      lines(l,g,1) = buf(pos+1);
+    });
+  idfx::popRegion();
+}
+
+void PoissonFFT::GatherLines(int dir) {
+  idfx::pushRegion("PoissonFFT::GatherLines");
+  IdefixArray1D<real> buf = this->recvBuf[dir];
+  IdefixArray3D<real> lines = this->lines[dir];
+  IdefixArray1D<int> slabStart = this->slabStart[dir];
+  IdefixArray1D<int> displ = this->recvDispl[dir];
+
+  idefix_for("FFT_GatherLines", 0, nlinesMine[dir], 0, nglob[dir],
+    KOKKOS_LAMBDA (int l, int g) {
+      const int pos = RecvPosition(l, g, slabStart, displ);
+      buf(pos) = lines(l,g,0);
+      buf(pos+1) = lines(l,g,1);
+    });
+  idfx::popRegion();
+}
+
+void PoissonFFT::Transform(int dir, int sign) {
+  idfx::pushRegion("PoissonFFT::Transform");
+  PackLines(dir);
+  #ifdef WITH_MPI
+  if(!linesAliasBuf[dir]) {
+    Kokkos::fence();
+    MPI_SAFE_CALL(MPI_Alltoallv(sendBuf[dir].data(), sendCount[dir].data(),
+                                sendDisplHost[dir].data(), realMPI,
+                                recvBuf[dir].data(), recvCount[dir].data(),
+                                recvDisplHost[dir].data(), realMPI, lineComm[dir]));
+    ScatterLines(dir);
+  }
+  #endif
+
+  fft[dir].Transform(lines[dir], nlinesMine[dir], sign);
+
+  #ifdef WITH_MPI
+  if(!linesAliasBuf[dir]) {
+    GatherLines(dir);
+    Kokkos::fence();
+    MPI_SAFE_CALL(MPI_Alltoallv(recvBuf[dir].data(), recvCount[dir].data(),
+                                recvDisplHost[dir].data(), realMPI,
+                                sendBuf[dir].data(), sendCount[dir].data(),
+                                sendDisplHost[dir].data(), realMPI, lineComm[dir]));
+  }
+  #endif
+  UnpackLines(dir);
+  idfx::popRegion();
+}
+
+void PoissonFFT::DivideByEigenvalues() {
+  idfx::pushRegion("PoissonFFT::DivideByEigenvalues");
+  IdefixArray4D<real> field = this->field;
+  const int ioffset = offset[IDIR];
+  const int joffset = offset[JDIR];
+  const int koffset = offset[KDIR];
+  // Eigenvalues of the second order Laplacian: -4 sin^2(pi g/N)/dx^2 in each direction
+  const real phi1 = M_PI/nglob[IDIR];
+  const real phi2 = M_PI/nglob[JDIR];
+  const real phi3 = M_PI/nglob[KDIR];
+  const real c1 = FOUR_F/(dx[IDIR]*dx[IDIR]);
+  const real c2 = FOUR_F/(dx[JDIR]*dx[JDIR]);
+  const real c3 = FOUR_F/(dx[KDIR]*dx[KDIR]);
+
+  idefix_for("FFT_DivideByEigenvalues", 0, nlocal[KDIR], 0, nlocal[JDIR], 0, nlocal[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      real s = sin(phi1*(i+ioffset));
+      real lambda = -c1*s*s;
+      #if DIMENSIONS > 1
+        s = sin(phi2*(j+joffset));
+        lambda -= c2*s*s;
+        #if DIMENSIONS > 2
+          s = sin(phi3*(k+koffset));
+          lambda -= c3*s*s;
+        #endif
+      #endif
+      // The mean of the potential is set to zero
+      const real inv = (i+ioffset == 0 && j+joffset == 0 && k+koffset == 0) ?
+                          ZERO_F : ONE_F/lambda;
+      field(0,k,j,i) *= inv;
+      field(1,k,j,i) *= inv;
+    });
+  idfx::popRegion();
+}
+
+int PoissonFFT::Solve(IdefixArray3D<real> &guess, IdefixArray3D<real> &rhs) {
+  idfx::pushRegion("PoissonFFT::Solve");
+  this->solution = guess;
+  this->rhs = rhs;
+
+  // Re-initialise convStatus
+  this->convStatus = false;
+
+  IdefixArray4D<real> field = this->field;
+  const int ib = this->beg[IDIR];
+  const int jb = this->beg[JDIR];
+  const int kb = this->beg[KDIR];
+
+  idefix_for("FFT_LoadRhs", 0, nlocal[KDIR], 0, nlocal[JDIR], 0, nlocal[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      field(0,k,j,i) = rhs(k+kb,j+jb,i+ib);
+      field(1,k,j,i) = ZERO_F;
+    });
+
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) Transform(dir, -1);
+  DivideByEigenvalues();
+  for(int dir = DIMENSIONS-1 ; dir >= 0 ; dir--) Transform(dir, 1);
+
+  // The backward transforms are not normalised
+  const real norm = ONE_F/(static_cast<real>(nglob[IDIR])*nglob[JDIR]*nglob[KDIR]);
+  IdefixArray3D<real> x = this->solution;
+  idefix_for("FFT_StoreSolution", 0, nlocal[KDIR], 0, nlocal[JDIR], 0, nlocal[IDIR],
+    KOKKOS_LAMBDA (int k, int j, int i) {
+      x(k+kb,j+jb,i+ib) = field(0,k,j,i)*norm;
+    });
+
+  // The residual is only computed to monitor the accuracy of the solution
+  this->SetRes();
+  this->TestErrorL2();
+  if(!this->convStatus) {
+    IDEFIX_WARNING("PoissonFFT:: the residual of the FFT solution is above targetError.");
+  }
+
+  idfx::popRegion();
+  return(1);
+}
+
+void PoissonFFT::ShowConfig() {
+  idfx::pushRegion("PoissonFFT::ShowConfig");
+  idfx::cout << "PoissonFFT: Direct solver on a " << nglob[IDIR];
+  for(int dir = 1 ; dir < DIMENSIONS ; dir++) idfx::cout << "x" << nglob[dir];
+  idfx::cout << " grid." << std::endl;
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    const bool isPow2 = (nglob[dir] & (nglob[dir]-1)) == 0;
+    idfx::cout << "PoissonFFT: X" << dir+1 << " transforms with "
+               << (isPow2 ? "radix-2" : "Bluestein") << " algorithm, lines distributed over "
+               << nproc[dir] << " process(es)." << std::endl;
+  }
+  idfx::popRegion();
+}
@@ -0,0 +1,73 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef GRAVITY_POISSONFFT_HPP_
+#define GRAVITY_POISSONFFT_HPP_
+
+#include <array>
+#include <vector>
+#include "idefix.hpp"
+#include "iterativesolver.hpp"
+#include "laplacian.hpp"
+#include "fft.hpp"
+
+// Direct solver of the Poisson equation for fully periodic, uniform cartesian grids.
+// The right hand side is Fourier transformed in each direction, divided by the eigenvalues of
+// the discrete (second order) Laplacian, and transformed back, so that the solution is exact
+// to round-off errors in a single "iteration".
+// In each direction, the lines of the domain are redistributed among the processes sharing
+// the same line of the MPI decomposition (a sub-communicator of Grid::CartComm), so that each
+// process transforms complete lines, and the data are then sent back to their original block.
+class PoissonFFT : public IterativeSolver<Laplacian> {
+ public:
+  PoissonFFT(Laplacian &op, real error, int maxIter,
+             std::array<int,3> ntot, std::array<int,3> beg, std::array<int,3> end);
+
+  int Solve(IdefixArray3D<real> &guess, IdefixArray3D<real> &rhs);
+  void ShowConfig();
+
+  // Internal functions (left public for Lambda capture)
+  void Transform(int, int);           // Transform the field in a given direction
+  void PackLines(int);                // Pack the field in the send buffer
+  void UnpackLines(int);              // Unpack the field from the send buffer
+  void ScatterLines(int);             // Receive buffer -> complete lines
+  void GatherLines(int);              // Complete lines -> receive buffer
+  void DivideByEigenvalues();
+
+ private:
+  IdefixArray4D<real> field;          // complex field (re/im, k, j, i) on the active cells
+
+  std::array<int,3> nlocal;           // # of active cells of this process
+  std::array<int,3> nglob;            // # of active cells of the whole domain
+  std::array<int,3> offset;           // global index of the first active cell of this process
+  std::array<real,3> dx;              // (uniform) cell size
+
+  // Redistribution of the lines of each direction
+  std::array<int,3> nproc;            // # of processes sharing a line
+  std::array<int,3> nlines;           // # of local (partial) lines
+  std::array<int,3> nlinesMine;       // # of complete lines transformed by this process
+  std::array<IdefixArray1D<int>,3> lineStart;  // first line owned by each process
+  std::array<IdefixArray1D<int>,3> slabStart;  // first cell of each process along the line
+  std::array<IdefixArray1D<int>,3> sendDispl;  // displacement in the send buffer
+  std::array<IdefixArray1D<int>,3> recvDispl;  // displacement in the receive buffer
+  std::array<IdefixArray1D<real>,3> sendBuf;
+  std::array<IdefixArray1D<real>,3> recvBuf;
+  std::array<IdefixArray3D<real>,3> lines;     // complete lines (line, position, re/im)
+  std::array<bool,3> linesAliasBuf;            // whether lines are a view of recvBuf
+
+  #ifdef WITH_MPI
+  std::array<MPI_Comm,3> lineComm;
+  std::array<std::vector<int>,3> sendCount;
+  std::array<std::vector<int>,3> sendDisplHost;
+  std::array<std::vector<int>,3> recvCount;
+  std::array<std::vector<int>,3> recvDisplHost;
+  #endif
+
+  std::vector<Fft> fft;
+};
+
+#endif // GRAVITY_POISSONFFT_HPP_
@@ -5,6 +5,8 @@
 // Licensed under CeCILL 2.1 License, see COPYING for more information
 // ***********************************************************************************
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,6 +43,22 @@ void SelfGravity::Init(Input &input, DataBlock *datain) {
     IDEFIX_ERROR("[SelfGravity]:skip should be a strictly positive integer");
   }
 
+  // Adaptive skip, bounded by skipMax cycles, enabled when a tolerance is provided
+  if(input.CheckEntry("SelfGravity","skipTolerance") >= 0) {
+    this->adaptiveSkip = true;
+    this->skipTolerance = input.Get<real>("SelfGravity","skipTolerance",0);
+    this->skipMax = input.GetOrSet<int>("SelfGravity","skipMax",0,100);
+    if(skipTolerance <= 0) {
+      IDEFIX_ERROR("[SelfGravity]:skipTolerance should be strictly positive");
+    }
+    if(skipMax < skipSelfGravity) {
+      IDEFIX_ERROR("[SelfGravity]:skipMax should be larger than skip");
+    }
+  }
+
+  // Extrapolation of the initial guess from the previous potentials
+  this->extrapolateGuess = input.GetOrSet<bool>("SelfGravity","extrapolate",0,false);
+
   // Get the gravity-related boundary conditions
   for (int dir = 0 ; dir < 3 ; dir++) {
     this->lbound[dir] = Laplacian::LaplacianBoundaryType::undefined;
@@ -126,6 +144,14 @@ void SelfGravity::Init(Input &input, DataBlock *datain) {
       solver = MINRES;
     } else if(strSolver.compare("PMINRES")==0) {
       solver = PMINRES;
+    } else if(strSolver.compare("MG")==0) {
+      solver = MG;
+    } else if(strSolver.compare("MGCG")==0) {
+      solver = MGCG;
+    } else if(strSolver.compare("MGBICGSTAB")==0) {
+      solver = MGBICGSTAB;
+    } else if(strSolver.compare("FFT")==0) {
+      solver = FFT;
     } else {
       try {
         // Try to use the old solver definition with integer (deprecated)
@@ -136,7 +162,8 @@ void SelfGravity::Init(Input &input, DataBlock *datain) {
       } catch(const std::exception& e) {
         std::stringstream msg;
         msg << "SelfGravity: Unknown solver \"" << strSolver << "\"."
-            << "Use \"Jacobi\", \"BICGSTAB\" or \"PBICGSTAB\"."
+            << "Use \"Jacobi\", \"BICGSTAB\", \"PBICGSTAB\", \"CG\", \"PCG\", \"MINRES\", "
+            << "\"PMINRES\", \"MG\", \"MGCG\", \"MGBICGSTAB\" or \"FFT\"."
             << std::endl;
         IDEFIX_ERROR(msg);
       }
@@ -162,6 +189,24 @@ void SelfGravity::Init(Input &input, DataBlock *datain) {
   } else if(solver == CG || solver == PCG) {
     iterativeSolver = new Cg<Laplacian>(*laplacian.get(), targetError, maxiter,
                                         laplacian->np_tot, laplacian->beg, laplacian->end);
+  } else if(solver == MG) {
+    iterativeSolver = new Multigrid(input, *laplacian.get(), targetError, maxiter,
+                                    laplacian->np_tot, laplacian->beg, laplacian->end);
+  } else if(solver == MGCG || solver == MGBICGSTAB) {
+    // The multigrid is only used for its cycles when preconditioning
+    multigrid = std::make_unique<Multigrid>(input, *laplacian.get(), targetError, maxiter,
+                                            laplacian->np_tot, laplacian->beg, laplacian->end);
+    if(solver == MGCG) {
+      iterativeSolver = new Cg<Laplacian>(*laplacian.get(), targetError, maxiter,
+                                          laplacian->np_tot, laplacian->beg, laplacian->end);
+    } else {
+      iterativeSolver = new Bicgstab<Laplacian>(*laplacian.get(), targetError, maxiter,
+                                              laplacian->np_tot, laplacian->beg, laplacian->end);
+    }
+    iterativeSolver->SetPreconditioner(multigrid.get());
+  } else if(solver == FFT) {
+    iterativeSolver = new PoissonFFT(*laplacian.get(), targetError, maxiter,
+                                     laplacian->np_tot, laplacian->beg, laplacian->end);
   } else if(solver == MINRES || solver == PMINRES) {
     iterativeSolver = new Minres<Laplacian>(*laplacian.get(),
                                   targetError, maxiter,
@@ -189,6 +234,16 @@ void SelfGravity::Init(Input &input, DataBlock *datain) {
   this->potential = IdefixArray3D<real> ("Potential", this->np_tot[KDIR],
                                                       this->np_tot[JDIR],
                                                       this->np_tot[IDIR]);
+  if(extrapolateGuess) {
+    this->previousPotential = IdefixArray3D<real> ("PreviousPotential", this->np_tot[KDIR],
+                                                                        this->np_tot[JDIR],
+                                                                        this->np_tot[IDIR]);
+  }
+  if(adaptiveSkip) {
+    this->previousDensity = IdefixArray3D<real> ("PreviousDensity", this->np_tot[KDIR],
+                                                                    this->np_tot[JDIR],
+                                                                    this->np_tot[IDIR]);
+  }
 
 
   idfx::popRegion();
@@ -220,6 +275,18 @@ void SelfGravity::ShowConfig() {
     case PMINRES:
       idfx::cout << "preconditionned MinRes";
       break;
+    case MG:
+      idfx::cout << "geometric multigrid";
+      break;
+    case MGCG:
+      idfx::cout << "multigrid preconditionned CG";
+      break;
+    case MGBICGSTAB:
+      idfx::cout << "multigrid preconditionned BICGSTAB";
+      break;
+    case FFT:
+      idfx::cout << "direct FFT";
+      break;
     default:
       IDEFIX_ERROR("SelfGravity:: Unknown solver");
   }
@@ -238,11 +305,20 @@ void SelfGravity::ShowConfig() {
                << " additional radial points." << std::endl;
   }
 
-  if(this->skipSelfGravity>1) {
+  if(this->adaptiveSkip) {
+    idfx::cout << "SelfGravity: self-gravity field will be updated every " << skipSelfGravity
+               << " to " << skipMax << " cycles, with a relative density change tolerance of "
+               << skipTolerance << "." << std::endl;
+  } else if(this->skipSelfGravity>1) {
     idfx::cout << "SelfGravity: self-gravity field will be updated every " << skipSelfGravity
                << " cycles." << std::endl;
   }
+  if(this->extrapolateGuess) {
+    idfx::cout << "SelfGravity: initial guess extrapolated from the previous two potentials."
+               << std::endl;
+  }
   iterativeSolver->ShowConfig();
+  if(multigrid) multigrid->ShowConfig();
 }
 
 
@@ -252,7 +328,7 @@ void SelfGravity::InitSolver() {
 
   // Loading needed attributes
   IdefixArray3D<real> density = this->density;
-  IdefixArray4D<real> Vc = data->hydro->Vc;
+  IdefixArray4D<realStore> Vc = data->hydro->Vc;
 
   // Initialise the density field
   // todo: check bounds
@@ -270,7 +346,7 @@ void SelfGravity::InitSolver() {
   // Make sure that dust mass contributes to the self-gravitating field
   if(data->haveDust) {
     for(int i = 0 ; i < data->dust.size() ; i++) {
-      IdefixArray4D<real> VcDust = data->dust[i]->Vc;
+      IdefixArray4D<realStore> VcDust = data->dust[i]->Vc;
       idefix_for("InitDustDensity", data->beg[KDIR], data->end[KDIR],
                                     data->beg[JDIR], data->end[JDIR],
                                     data->beg[IDIR], data->end[IDIR],
@@ -280,6 +356,12 @@ void SelfGravity::InitSolver() {
     }
   }
 
+  // Measure the change of density since the last solve (first solve of each cycle only)
+  if(adaptiveSkip && haveNewSolveStep) {
+    UpdateSkip();
+    haveNewSolveStep = false;
+  }
+
   // Deal with the mean issue for periodic density distribution
   if(this->isPeriodic == true) {
     SubstractMeanDensity();  // Remove density mean
@@ -378,6 +460,100 @@ void SelfGravity::EnrollUserDefBoundary(Laplacian::UserDefBoundaryFunc myFunc) {
 
 
 
+bool SelfGravity::NeedSolve(int stepNumber) {
+  if(!adaptiveSkip) return(stepNumber % skipSelfGravity == 0);
+
+  // The decision is taken at the first stage of each cycle, and kept for the other stages
+  if(stepNumber != lastDecisionStep) {
+    lastDecisionStep = stepNumber;
+    solveThisCycle = (lastSolveStep < 0 || stepNumber - lastSolveStep >= skipSelfGravity);
+    if(solveThisCycle) {
+      solveStep = stepNumber;
+      haveNewSolveStep = true;
+    }
+  }
+  return(solveThisCycle);
+}
+
+void SelfGravity::UpdateSkip() {
+  idfx::pushRegion("SelfGravity::UpdateSkip");
+  IdefixArray3D<real> density = this->density;
+  IdefixArray3D<real> previousDensity = this->previousDensity;
+  IdefixArray3D<real> dV = laplacian->dV;
+  int ioffset = laplacian->loffset[IDIR];
+  int joffset = laplacian->loffset[JDIR];
+  int koffset = laplacian->loffset[KDIR];
+
+  if(lastSolveStep >= 0 && solveStep > lastSolveStep) {
+    // Relative L2 norm of the density change
+    MyVector changeVector;
+    idefix_reduce("DensityChange",
+                  data->beg[KDIR], data->end[KDIR],
+                  data->beg[JDIR], data->end[JDIR],
+                  data->beg[IDIR], data->end[IDIR],
+                  KOKKOS_LAMBDA (int k, int j, int i, MyVector &localVector) {
+                    const real rho = density(k+koffset, j+joffset, i+ioffset);
+                    const real rho0 = previousDensity(k+koffset, j+joffset, i+ioffset);
+                    const real vol = dV(k+koffset, j+joffset, i+ioffset);
+                    localVector.v[0] += (rho - rho0) * (rho - rho0) * vol;
+                    localVector.v[1] += rho0 * rho0 * vol;
+                  },
+                  Kokkos::Sum<MyVector>(changeVector));
+    #ifdef WITH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &changeVector.v, 2, realMPI, MPI_SUM, MPI_COMM_WORLD);
+    #endif
+
+    if(changeVector.v[1] > 0) {
+      // Assume a linear evolution of the density to pick the next interval, which can at most
+      // double from one solve to the next
+      const real change = std::sqrt(changeVector.v[0] / changeVector.v[1]);
+      const real rate = change / (solveStep - lastSolveStep);
+      int skip = skipMax;
+      if(rate*skipMax > skipTolerance) skip = static_cast<int>(skipTolerance/rate);
+      skipSelfGravity = std::max(1, std::min(skip, 2*skipSelfGravity));
+    } else {
+      // The density of the last solve vanished, so that its relative change is undefined:
+      // solve at the next step
+      skipSelfGravity = 1;
+    }
+  }
+
+  Kokkos::deep_copy(previousDensity, density);
+  lastSolveStep = solveStep;
+  idfx::popRegion();
+}
+
+void SelfGravity::ExtrapolateGuess() {
+  idfx::pushRegion("SelfGravity::ExtrapolateGuess");
+  const real t = data->t;
+
+  // Only shift the history when the time has changed (e.g. not between two solves at the
+  // same stage time)
+  if(nPotentials > 0 && t != tLastSolve) {
+    IdefixArray3D<real> potential = this->potential;
+    IdefixArray3D<real> previousPotential = this->previousPotential;
+    real w = 0;
+    if(nPotentials > 1) {
+      // Linear extrapolation, limited to twice the interval between the previous solves
+      w = (t - tLastSolve) / (tLastSolve - tPreviousSolve);
+      w = std::max<real>(-2.0, std::min<real>(2.0, w));
+    }
+    idefix_for("ExtrapolatePotential", 0, this->np_tot[KDIR],
+                                       0, this->np_tot[JDIR],
+                                       0, this->np_tot[IDIR],
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        const real phi = potential(k,j,i);
+        potential(k,j,i) = phi + w*(phi - previousPotential(k,j,i));
+        previousPotential(k,j,i) = phi;
+      });
+    tPreviousSolve = tLastSolve;
+    nPotentials = 2;
+  }
+  tLastSolve = t;
+  if(nPotentials == 0) nPotentials = 1;
+  idfx::popRegion();
+}
+
 void SelfGravity::SolvePoisson() {
   idfx::pushRegion("SelfGravity::SolvePoisson");
 
@@ -387,6 +563,8 @@ void SelfGravity::SolvePoisson() {
 
   InitSolver(); // (Re)initialise the solver
 
+  if(extrapolateGuess) ExtrapolateGuess();
+
   this->nsteps = iterativeSolver->Solve(potential, density);
   if (this->nsteps<0) {
     idfx::cout << "SelfGravity:: BICGSTAB failed, resetting potential" << std::endl;
@@ -408,6 +586,7 @@ void SelfGravity::SolvePoisson() {
       KOKKOS_LAMBDA (int k, int j, int i) {
         potential(k, j, i) = ZERO_F;
       });
+    nPotentials = 0;
 
     // Try again !
     this->nsteps = iterativeSolver->Solve(this->potential, density);
@@ -17,6 +17,8 @@
 #include "fluid_defs.hpp"
 #include "iterativesolver.hpp"
 #include "laplacian.hpp"
+#include "multigrid.hpp"
+#include "poissonFFT.hpp"
 
 #ifdef WITH_MPI
 #include "mpi.hpp"
@@ -27,14 +29,18 @@ class DataBlock;
 
 class SelfGravity {
  public:
-  enum GravitySolver {JACOBI, BICGSTAB, PBICGSTAB, PCG, CG, PMINRES, MINRES};
+  enum GravitySolver {JACOBI, BICGSTAB, PBICGSTAB, PCG, CG, PMINRES, MINRES,
+                      MG, MGCG, MGBICGSTAB, FFT};
 
   void Init(Input &, DataBlock *);  // Initialisation of the class attributes
   void ShowConfig();                // display current configuration
   void InitSolver(); // (Re)initialisation of the solver for a given density distribution
 
   void SubstractMeanDensity();  // Compute and substract the average input density
+  void ExtrapolateGuess();      // Extrapolate the initial guess from the previous potentials
+  void UpdateSkip();            // Update the adaptive skip from the change of density
 
+  bool NeedSolve(int);  // Whether Poisson equation should be solved at a given cycle
   void SolvePoisson(); // Solve Poisson equation
   void AddSelfGravityPotential(IdefixArray3D<real> &);
 
@@ -45,13 +51,26 @@ class SelfGravity {
   // The linear operator involved in Poisson equation
   std::unique_ptr<Laplacian> laplacian;
 
+  // Multigrid preconditioner of the Krylov solvers (MGCG and MGBICGSTAB)
+  std::unique_ptr<Multigrid> multigrid;
+
   real currentError{0};       // last error of the iterative solver
   int nsteps{0};              // # of steps of the latest iteration
   double elapsedTime;        // time spent solving self gravity
 
   // Whether we should skip self-gravity computation every n steps
+  // (current interval when the skip is adaptive)
   int skipSelfGravity{1};
 
+  // Adaptive skip: the interval is chosen so that the relative L2 change of the density
+  // between two solves is close to skipTolerance
+  bool adaptiveSkip{false};
+  real skipTolerance{0};
+  int skipMax{1};
+
+  // Temporal extrapolation of the initial guess from the last two potentials
+  bool extrapolateGuess{false};
+
  private:
   DataBlock *data;  // My parent data object
   IdefixArray3D<real> potential;  // Gravitational potential
@@ -64,6 +83,20 @@ class SelfGravity {
   std::array<Laplacian::LaplacianBoundaryType,3> lbound;  // Boundary condition to the left
   std::array<Laplacian::LaplacianBoundaryType,3> rbound;  // Boundary condition to the right
 
+  // Potential and times of the previous solves (extrapolated guess)
+  IdefixArray3D<real> previousPotential;
+  real tLastSolve{0};
+  real tPreviousSolve{0};
+  int nPotentials{0};             // # of valid potentials in the history (up to 2)
+
+  // Density of the last solve (adaptive skip)
+  IdefixArray3D<real> previousDensity;
+  int lastSolveStep{-1};          // cycle of the last solve
+  int lastDecisionStep{-1};       // last cycle for which NeedSolve took a decision
+  int solveStep{-1};              // cycle of the current solve
+  bool solveThisCycle{false};     // whether Poisson equation is solved during this cycle
+  bool haveNewSolveStep{false};   // whether the next solve is the first of its cycle
+
   bool isPeriodic;
   bool havePreconditioner{false};
   GravitySolver solver; // The solver  used to solve Poisson
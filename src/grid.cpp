@@ -5,11 +5,14 @@
 // Licensed under CeCILL 2.1 License, see COPYING for more information
 // ***********************************************************************************
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "idefix.hpp"
 #include "gridHost.hpp"
 #include "grid.hpp"
+#include "dump.hpp"
 
 Grid::Grid(SubGrid * subgrid) {
   idfx::pushRegion("Grid::Grid(SubGrid)");
@@ -35,6 +38,9 @@ Grid::Grid(SubGrid * subgrid) {
 
   nproc = subgrid->parentGrid->nproc;
   xproc = subgrid->parentGrid->xproc;
+  decomposition = subgrid->parentGrid->decomposition;
+  loadBalance = subgrid->parentGrid->loadBalance;
+  loadProfile = subgrid->parentGrid->loadProfile;
 
   // Now slice if along the chosen direction
   SliceMe(subgrid);
@@ -42,6 +48,129 @@ Grid::Grid(SubGrid * subgrid) {
   idfx::popRegion();
 }
 
+// Grid of a static refinement level: the cells [patchBeg,patchEnd) of the parent grid are split
+// in two along each dimension. The refined grid is decomposed on the procs of the parent grid
+// which hold a part of the patch, following the parent decomposition, so that each proc refines
+// its own part of the patch.
+Grid::Grid(Grid *parent, const std::array<int,3> &patchBeg, const std::array<int,3> &patchEnd) {
+  idfx::pushRegion("Grid::Grid(Grid)");
+  level = parent->level+1;
+  isRegularCartesian = parent->isRegularCartesian;
+  haveLocalDomain = true;
+
+  GridHost parentHost(*parent);
+  parentHost.SyncFromDevice();
+
+  int period[3] = {0, 0, 0};
+  std::array<int,3> firstProc = {0, 0, 0};
+
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    nghost[dir] = parent->nghost[dir];
+    if(dir < DIMENSIONS) {
+      np_int[dir] = 2*(patchEnd[dir]-patchBeg[dir]);
+    } else {
+      np_int[dir] = 1;
+    }
+    np_tot[dir] = np_int[dir] + 2*nghost[dir];
+
+    // The edges of the patch located on the edges of the parent domain inherit its boundary
+    // conditions. The other ones are refinement edges, where the ghost cells are prolongated
+    // from the parent grid.
+    lbound[dir] = (patchBeg[dir] == 0) ? parent->lbound[dir] : internal;
+    rbound[dir] = (patchEnd[dir] == parent->np_int[dir]) ? parent->rbound[dir] : internal;
+    if(dir < DIMENSIONS && rbound[dir] == periodic) period[dir] = 1;
+
+    xbeg[dir] = parentHost.xl[dir](patchBeg[dir]+parent->nghost[dir]);
+    xend[dir] = parentHost.xr[dir](patchEnd[dir]-1+parent->nghost[dir]);
+
+    // Procs of the parent grid which hold a part of the patch
+    const std::vector<int> &slabs = parent->decomposition[dir];
+    decomposition[dir].clear();
+    firstProc[dir] = -1;
+    for(int p = 0 ; p < parent->nproc[dir] ; p++) {
+      const int lo = std::max(slabs[p], patchBeg[dir]);
+      const int hi = std::min(slabs[p+1], patchEnd[dir]);
+      if(lo >= hi) continue;
+      if(firstProc[dir] < 0) firstProc[dir] = p;
+      decomposition[dir].push_back((dir < DIMENSIONS) ? 2*(lo-patchBeg[dir]) : 0);
+    }
+    nproc[dir] = decomposition[dir].size();
+    decomposition[dir].push_back(np_int[dir]);
+    xproc[dir] = parent->xproc[dir] - firstProc[dir];
+    if(xproc[dir] < 0 || xproc[dir] >= nproc[dir]) haveLocalDomain = false;
+
+    loadProfile[dir].assign(np_int[dir], 0.0);
+
+    // Each slab is split in two along the refined dimensions
+    x[dir] = IdefixArray1D<real>("Grid_x",np_tot[dir]);
+    xr[dir] = IdefixArray1D<real>("Grid_xr",np_tot[dir]);
+    xl[dir] = IdefixArray1D<real>("Grid_xl",np_tot[dir]);
+    dx[dir] = IdefixArray1D<real>("Grid_dx",np_tot[dir]);
+    auto xH = Kokkos::create_mirror_view(x[dir]);
+    auto xrH = Kokkos::create_mirror_view(xr[dir]);
+    auto xlH = Kokkos::create_mirror_view(xl[dir]);
+    auto dxH = Kokkos::create_mirror_view(dx[dir]);
+    for(int i = 0 ; i < np_tot[dir] ; i++) {
+      if(dir >= DIMENSIONS) {
+        xH(i) = parentHost.x[dir](i);
+        xrH(i) = parentHost.xr[dir](i);
+        xlH(i) = parentHost.xl[dir](i);
+        dxH(i) = parentHost.dx[dir](i);
+        continue;
+      }
+      // Parent cell of the refined cell (ghost cells included): g is the index of the refined
+      // cell from the patch edge, shifted by 2*nghost so that it is never negative
+      const int g = i + nghost[dir];
+      const int ip = patchBeg[dir] + g/2 - nghost[dir] + parent->nghost[dir];
+      const real xmid = HALF_F*(parentHost.xl[dir](ip) + parentHost.xr[dir](ip));
+      if(g%2 == 0) {
+        xlH(i) = parentHost.xl[dir](ip);
+        xrH(i) = xmid;
+      } else {
+        xlH(i) = xmid;
+        xrH(i) = parentHost.xr[dir](ip);
+      }
+      xH(i) = HALF_F*(xlH(i) + xrH(i));
+      dxH(i) = xrH(i) - xlH(i);
+    }
+    Kokkos::deep_copy(x[dir], xH);
+    Kokkos::deep_copy(xr[dir], xrH);
+    Kokkos::deep_copy(xl[dir], xlH);
+    Kokkos::deep_copy(dx[dir], dxH);
+  }
+
+  // Refined grids are never split in blocks nor coarsened
+  nblocks = 1;
+  blockDir = parent->blockDir;
+  haveGridCoarsening = GridCoarsening::disabled;
+  coarseningDirection = {false, false, false};
+  loadBalance = LoadBalance::uniform;
+
+#ifdef WITH_MPI
+  // The procs which hold a part of the patch get their own cartesian communicator. Since the
+  // parent communicator is not reordered and the procs are kept in the same order, their
+  // coordinates are those of the parent grid, shifted by the first proc of the patch.
+  int parentRank;
+  MPI_Comm_rank(parent->CartComm, &parentRank);
+  MPI_Comm levelComm;
+  MPI_SAFE_CALL(MPI_Comm_split(parent->CartComm, haveLocalDomain ? 0 : MPI_UNDEFINED,
+                               parentRank, &levelComm));
+  if(haveLocalDomain) {
+    MPI_SAFE_CALL(MPI_Cart_create(levelComm, 3, nproc.data(), period, 0, &CartComm));
+    MPI_Comm_free(&levelComm);
+  } else {
+    CartComm = MPI_COMM_NULL;
+  }
+#endif
+
+  if(haveLocalDomain) {
+    const int n = decomposition[blockDir][xproc[blockDir]+1]
+                  - decomposition[blockDir][xproc[blockDir]];
+    blockDecomposition = {0, n};
+  }
+  idfx::popRegion();
+}
+
 Grid::Grid(Input &input) {
   idfx::pushRegion("Grid::Grid(Input)");
 
@@ -148,6 +277,14 @@ Grid::Grid(Input &input) {
   for(int i=0 ; i < 3; i++) {
     nproc[i] = 1;
     xproc[i] = 0;
+    decomposition[i] = {0, np_int[i]};
+    loadProfile[i].assign(np_int[i], 0.0);
+  }
+
+  // Over-decomposition of the domain of each proc in several blocks
+  nblocks = input.GetOrSet<int>("Grid","blocks",0,1);
+  if(nblocks < 1) {
+    IDEFIX_ERROR("The number of blocks per process should be at least 1");
   }
 
 #ifdef WITH_MPI
@@ -160,32 +297,15 @@ Grid::Grid(Input &input) {
 
   // Check that number of procs > 1
   if(idfx::psize>1) {
-    int ngridtot=1;
-    for(int dir=0 ; dir < DIMENSIONS; dir++) {
-      ngridtot *= np_int[dir];
-    }
-    // Check that the total grid dimension is effectively divisible by number of procs
-    if(ngridtot % idfx::psize)
-      IDEFIX_ERROR("Total grid size must be a multiple of the number of mpi process");
     // Check that dec option has been passed
     if(input.CheckEntry("CommandLine","dec")  != DIMENSIONS) {
-      // No command line decomposition, make auto-decomposition if possible
-      // (only when nproc and dimensions are powers of 2, and in 1D)
+      // No command line decomposition, make auto-decomposition
       if(DIMENSIONS == 1) {
         nproc[0] = idfx::psize;
-      } else {
-        if(!isPow2(idfx::psize))
-          IDEFIX_ERROR(
-            "Automatic domain decomposition requires the number of processes to be a power of 2. "
-            "Alternatively, set a manual decomposition with -dec"
-          );
-        for(int dir = 0; dir < 3; dir++) {
-          if(!isPow2(np_int[dir]))
-            IDEFIX_ERROR(
-              "Automatic domain decomposition requires nx1, nx2 and nx3 to be powers of 2. "
-              "Alternatively, set a manual decomposition with -dec"
-            );
+        if(nblocks > 1) {
+          IDEFIX_ERROR("Blocks cannot be used with several processes in 1D");
         }
+      } else {
         makeDomainDecomposition();
       }
     } else {
@@ -193,9 +313,6 @@ Grid::Grid(Input &input) {
       int ntot=1;
       for(int dir=0 ; dir < DIMENSIONS; dir++) {
         nproc[dir] = input.Get<int>("CommandLine","dec",dir);
-        // Check that the dimension is effectively divisible by number of procs along each direction
-        if(np_int[dir] % nproc[dir])
-          IDEFIX_ERROR("Grid size must be a multiple of the domain decomposition");
         // Count the total number of procs we'll need for the specified domain decomposition
         ntot = ntot * nproc[dir];
       }
@@ -210,6 +327,56 @@ Grid::Grid(Input &input) {
         msg << ").";
         IDEFIX_ERROR(msg);
       }
+      if(nblocks > 1 && nproc[blockDir] > 1) {
+        IDEFIX_ERROR("Blocks are split along X"+std::to_string(blockDir+1)
+                     +", which cannot be decomposed between processes");
+      }
+    }
+
+    // Load balancing of the decomposition
+    if(input.CheckEntry("Grid","loadBalance")>=0) {
+      std::string balanceType = input.Get<std::string>("Grid","loadBalance",0);
+      if(balanceType.compare("uniform")==0) {
+        loadBalance = LoadBalance::uniform;
+      } else if(balanceType.compare("cost")==0) {
+        loadBalance = LoadBalance::cost;
+      } else if(balanceType.compare("measured")==0) {
+        loadBalance = LoadBalance::measured;
+      } else {
+        std::stringstream msg;
+        msg << "Load balancing can only be uniform, cost or measured. I got: " << balanceType;
+        IDEFIX_ERROR(msg);
+      }
+    }
+    if(loadBalance == LoadBalance::measured) {
+      if(!input.restartRequested) {
+        IDEFIX_WARNING("Measured load balancing requires a restart. "
+                       "Falling back to a uniform decomposition.");
+        loadBalance = LoadBalance::uniform;
+      } else if(!Dump::ReadLoadProfile(input, loadProfile)) {
+        IDEFIX_WARNING("Cannot find a measured load profile in the restart dump. "
+                       "Falling back to a uniform decomposition.");
+        loadBalance = LoadBalance::uniform;
+        for(int dir = 0 ; dir < 3 ; dir++) {
+          loadProfile[dir].assign(np_int[dir], 0.0);
+        }
+      }
+    }
+
+    for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+      std::vector<double> cost;
+      if(loadBalance == LoadBalance::cost) cost = makeCostModel(input, dir);
+      if(loadBalance == LoadBalance::measured) cost = loadProfile[dir];
+      if(haveAxis && dir == KDIR && nproc[KDIR] > 1) {
+        // The axis boundary exchanges data with the proc located at phi+pi,
+        // hence the decomposition along X3 should be uniform
+        if(np_int[KDIR] % nproc[KDIR]) {
+          IDEFIX_ERROR("Axis boundaries require the X3 grid size to be a multiple of "
+                       "the number of processes along X3");
+        }
+        cost.clear();
+      }
+      makeSlabs(dir, cost);
     }
   }
 
@@ -265,31 +432,51 @@ Grid::Grid(Input &input) {
 
     this->haveGridCoarsening = GridCoarsening::enabled;
   }
-  idfx::popRegion();
-}
 
-bool Grid::isPow2(int n) {
-  return( (n & (n-1)) == 0);
+  // Uniform split of the slab of the current proc in blocks
+  {
+    const int n = decomposition[blockDir][xproc[blockDir]+1]
+                  - decomposition[blockDir][xproc[blockDir]];
+    if(n < nblocks*nghost[blockDir]) {
+      IDEFIX_ERROR("Blocks should have at least as many points as ghost cells along X"
+                   +std::to_string(blockDir+1));
+    }
+    blockDecomposition.assign(nblocks+1, 0);
+    for(int b = 0 ; b <= nblocks ; b++) {
+      blockDecomposition[b] = static_cast<int>((static_cast<int64_t>(b)*n)/nblocks);
+    }
+  }
+  idfx::popRegion();
 }
 
-// Produce a domain decomposition in nProc assuming psize and np_int[] are powers of 2
+// Produce a domain decomposition of psize processes. psize is split in its prime factors, which
+// are successively assigned (largest first) to the direction with the most points per process.
 void Grid::makeDomainDecomposition() {
-  // initialize the routine
-  int nleft=idfx::psize;
-  int nlocal[3];
+  // Prime factors of the number of processes
+  std::vector<int> factors;
+  int nleft = idfx::psize;
+  for(int f = 2 ; f*f <= nleft ; f++) {
+    while(nleft % f == 0) {
+      factors.push_back(f);
+      nleft = nleft/f;
+    }
+  }
+  if(nleft>1) factors.push_back(nleft);
+  std::sort(factors.rbegin(), factors.rend());
+
+  double nlocal[3];
   for(int dir = 0; dir < 3; dir++) {
     nproc[dir] = 1;
     nlocal[dir] = np_int[dir];
   }
+  // The blocks of each process are split along blockDir, which is kept whole
+  if(nblocks > 1) nlocal[blockDir] = 0;
 
-  // Loop
-  while(nleft>1) {
+  for(int factor : factors) {
     // Find the direction where there is a maximum of point
-    int dirmax;
-    int nmax=1;
-    int ndir=2;
-
-    for(int dir = ndir; dir >= 0; dir--) {
+    int dirmax = 0;
+    double nmax = 1;
+    for(int dir = 2; dir >= 0; dir--) {
       // We do this loop backward so that we divide the domain first in the last dimension
       // (better for cache optimisation)
       if(nlocal[dir]>nmax ) {
@@ -298,15 +485,112 @@ void Grid::makeDomainDecomposition() {
       }
     }
     // At this point, we have nmax points in direction dirmax,
-    // which is the direction we're going to divide by 2
-    if(nmax==1)
+    // which is the direction we're going to divide by factor
+    if(nmax < factor)
       IDEFIX_ERROR("Your domain size is too small to be decomposed "
                    "on this number of MPI processes");
-    nlocal[dirmax]=nlocal[dirmax]/2;
-    nproc[dirmax]=nproc[dirmax]*2;
-    nleft=nleft/2;
+    nlocal[dirmax]=nlocal[dirmax]/factor;
+    nproc[dirmax]=nproc[dirmax]*factor;
+  }
+}
+
+// Split direction dir into nproc[dir] slabs having the same total cost. When no cost is given,
+// the slabs have the same number of points (up to one point when np_int is not a multiple of
+// nproc).
+void Grid::makeSlabs(int dir, const std::vector<double> &cost) {
+  const int n = np_int[dir];
+  const int np = nproc[dir];
+  // Each slab should at least fill the ghost zones of its neighbours
+  const int minSize = std::max(nghost[dir],1);
+
+  if(n < np*minSize) {
+    std::stringstream msg;
+    msg << "Your domain size in X" << dir+1 << " (" << n << " points) is too small "
+        << "to be decomposed on " << np << " MPI processes.";
+    IDEFIX_ERROR(msg);
+  }
+
+  decomposition[dir].assign(np+1, 0);
+  decomposition[dir][np] = n;
+
+  double costTot = 0;
+  for(double c : cost) costTot += c;
+
+  if(static_cast<int>(cost.size()) != n || costTot <= 0) {
+    // Uniform decomposition
+    for(int p = 1 ; p < np ; p++) {
+      decomposition[dir][p] = static_cast<int>((static_cast<int64_t>(p)*n)/np);
+    }
+    return;
+  }
+
+  // Weighted decomposition: proc p starts at the first cell for which the cumulated cost
+  // (measured at cell centers) exceeds p/np of the total cost
+  double cumul = 0;
+  int i = 0;
+  for(int p = 1 ; p < np ; p++) {
+    const double target = costTot*p/np;
+    while(i < n && cumul + 0.5*cost[i] < target) {
+      cumul += cost[i];
+      i++;
+    }
+    int start = std::max(i, decomposition[dir][p-1] + minSize);
+    start = std::min(start, n - (np-p)*minSize);
+    decomposition[dir][p] = start;
+  }
+}
+
+// Cost model: relative cost per cell of each grid patch, given by the X1/2/3-cost entries
+std::vector<double> Grid::makeCostModel(Input &input, int dir) {
+  std::vector<double> cost(np_int[dir], 1.0);
+
+  std::string label = std::string("X")+std::to_string(dir+1)+std::string("-grid");
+  std::string costLabel = std::string("X")+std::to_string(dir+1)+std::string("-cost");
+
+  int numCost = input.CheckEntry("Grid",costLabel);
+  if(numCost < 0) return(cost);
+
+  int numPatch = input.Get<int>("Grid",label,0);
+  if(numCost != numPatch) {
+    std::stringstream msg;
+    msg << costLabel << " should have one entry for each of the " << numPatch
+        << " patches of " << label << ".";
+    IDEFIX_ERROR(msg);
+  }
+
+  int start = 0;
+  for(int patch = 0; patch < numPatch ; patch++) {
+    int patchSize = input.Get<int>("Grid",label,2+3*patch);
+    double patchCost = input.Get<double>("Grid",costLabel,patch);
+    if(patchCost <= 0) {
+      IDEFIX_ERROR(costLabel+" should only contain positive values");
+    }
+    for(int i = start ; i < start+patchSize ; i++) {
+      cost[i] = patchCost;
+    }
+    start += patchSize;
   }
+  return(cost);
 }
+
+void Grid::AddMeasuredLoad(const std::vector<double> &computeTime) {
+  #ifdef WITH_MPI
+    // The compute time of each proc is evenly spread on the cells of its slab
+    // NB: ranks in CartComm are those of MPI_COMM_WORLD since it is created without reordering
+    for(int rank = 0 ; rank < static_cast<int>(computeTime.size()) ; rank++) {
+      int coords[3];
+      MPI_Cart_coords(CartComm, rank, 3, coords);
+      for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+        const int start = decomposition[dir][coords[dir]];
+        const int end = decomposition[dir][coords[dir]+1];
+        for(int i = start ; i < end ; i++) {
+          loadProfile[dir][i] += computeTime[rank]/(end-start);
+        }
+      }
+    }
+  #endif
+}
+
 /*
 Grid& Grid::operator=(const Grid& grid) {
     for(int dir = 0 ; dir < 3 ; dir++) {
@@ -397,6 +681,23 @@ void Grid::ShowConfig() {
       idfx::cout << " " << nproc[dir] << " ";
     }
     idfx::cout << ")" << std::endl;
+    if(loadBalance == LoadBalance::cost) {
+      idfx::cout << "Grid: decomposition balanced with the cost model." << std::endl;
+    } else if(loadBalance == LoadBalance::measured) {
+      idfx::cout << "Grid: decomposition balanced with the measured load." << std::endl;
+    }
+    for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+      int nmin = np_int[dir];
+      int nmax = 0;
+      for(int p = 0 ; p < nproc[dir] ; p++) {
+        nmin = std::min(nmin, decomposition[dir][p+1]-decomposition[dir][p]);
+        nmax = std::max(nmax, decomposition[dir][p+1]-decomposition[dir][p]);
+      }
+      if(nmin != nmax) {
+        idfx::cout << "Grid: uneven slabs in X" << dir+1 << " with " << nmin << " to " << nmax
+                   << " points per process." << std::endl;
+      }
+    }
     idfx::cout << "Grid: Current MPI proc coordinates (";
 
     for(int dir = 0; dir < 3; dir++) {
@@ -405,6 +706,10 @@ void Grid::ShowConfig() {
     }
     idfx::cout << ")" << std::endl;
   #endif
+  if(nblocks > 1) {
+    idfx::cout << "Grid: domain of each process split in " << nblocks << " blocks along X"
+               << blockDir+1 << "." << std::endl;
+  }
   if(haveGridCoarsening) {
     if(haveGridCoarsening == GridCoarsening::enabled ) {
       idfx::cout << "Grid: static grid coarsening enabled in direction(s) ";
@@ -464,4 +769,6 @@ void Grid::SliceMe(SubGrid *subgrid) {
     nproc[dir] = 1;
     xproc[dir] = 0;
   #endif
+  this->decomposition[dir] = {0, 1};
+  this->loadProfile[dir].assign(1, 0.0);
 }
@@ -49,6 +49,31 @@ class Grid {
   std::array<int,3> nproc;           ///</< Total number of procs in each direction
   std::array<int,3> xproc;           ///</< Coordinates of current proc in the array of procs
 
+  /// First active cell (starting from 0) of each proc in each direction. Each array has
+  /// nproc+1 elements, the last one being np_int, so that the slabs can have uneven sizes.
+  std::array<std::vector<int>,3> decomposition;
+
+  /// Type of load balancing used to define the size of each slab of the decomposition
+  enum class LoadBalance {uniform, cost, measured};
+  LoadBalance loadBalance{LoadBalance::uniform};
+
+  /// Measured computing time of each slice of active cells in each direction, summed over
+  /// the procs. It is stored in restart dumps, so that the decomposition can follow it.
+  std::array<std::vector<double>,3> loadProfile;
+
+  /// Over-decomposition: number of blocks of the domain of each proc, which are split along
+  /// blockDir (never decomposed between procs in that case)
+  int nblocks{1};
+  int blockDir{DIMENSIONS-1};
+  /// First active cell of each block in the slab of the proc along blockDir (nblocks+1 elements)
+  std::vector<int> blockDecomposition;
+
+  /// Static refinement: level of this grid (0 for the base grid), and whether the current proc
+  /// holds a part of it (the grid of a refinement level only spans the procs of its parent grid
+  /// which intersect its region)
+  int level{0};
+  bool haveLocalDomain{true};
+
   #ifdef WITH_MPI
   MPI_Comm CartComm;                ///< Cartesian communicator for the planned domain decomposition
   MPI_Comm AxisComm;                ///< Cartesian communicator to exchange data accross the axis
@@ -58,17 +83,22 @@ class Grid {
   // Constructor
   explicit Grid(Input &);
   explicit Grid(SubGrid *);
+  /// Refinement of the cells [patchBeg,patchEnd) (active cells, counted from 0) of a parent grid
+  Grid(Grid *, const std::array<int,3> &patchBeg, const std::array<int,3> &patchEnd);
 
   void ShowConfig();
 
   void SliceMe(SubGrid *);       ///< Slice this grid according to the subgrid (internal function)
 
+  /// Add the compute time measured on each proc to the load profile (only used by rank 0)
+  void AddMeasuredLoad(const std::vector<double> &);
+
   Grid() = default;
 
  private:
-  // Check if number is a power of 2
-  bool isPow2(int);
   void makeDomainDecomposition();
+  void makeSlabs(int, const std::vector<double> &);
+  std::vector<double> makeCostModel(Input &, int);
 };
 
 /**
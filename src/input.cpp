@@ -169,6 +169,8 @@ void Input::ParseCommandLine(int argc, char **argv) {
       inputParameters["CommandLine"]["maxCycles"].push_back(std::to_string(maxCycles));
     } else if(std::string(argv[i]) == "-force_init") {
       this->forceInitRequested = true;
+    } else if(std::string(argv[i]) == "-remap") {
+      this->remapRequested = true;
     } else if(std::string(argv[i]) == "-nowrite") {
       this->forceNoWrite = true;
       enableLogs = false;
@@ -176,6 +178,35 @@ void Input::ParseCommandLine(int argc, char **argv) {
       enableLogs = false;
     } else if(std::string(argv[i]) == "-profile") {
       idfx::prof.EnablePerformanceProfiling();
+    } else if(std::string(argv[i]) == "-kernels") {
+      idfx::prof.EnableKernelProfiling(false);
+    } else if(std::string(argv[i]) == "-trace") {
+      idfx::prof.EnableKernelProfiling(true);
+    } else if(std::string(argv[i]) == "-autotune") {
+      if((i+1)>= argc || std::isdigit(argv[i+1][0]) == 0) {
+        IDEFIX_ERROR("-autotune requires an additional integer parameter");
+      }
+      idfx::loopTuner.callsPerCandidate = std::stoi(std::string(argv[++i]));
+      inputParameters["CommandLine"]["autotune"].push_back(argv[i]);
+    } else if(std::string(argv[i]) == "-autotune_file") {
+      if((++i) >= argc) IDEFIX_ERROR(
+                      "You must specify -autotune_file filename where filename is a tuning file.");
+      idfx::loopTuner.fileName = std::string(argv[i]);
+      inputParameters["CommandLine"]["autotune_file"].push_back(argv[i]);
+    } else if(std::string(argv[i]) == "-tile") {
+      // Tile of the tiled loops along each direction
+      for(int dir = 0 ; dir < 3 ; dir++) {
+        if((++i) >= argc || std::isdigit(argv[i][0]) == 0) {
+          IDEFIX_ERROR("You must specify -tile ni nj nk (0 to use the cache model)");
+        }
+        idfx::loopTile[dir] = std::stoi(std::string(argv[i]));
+        inputParameters["CommandLine"]["tile"].push_back(argv[i]);
+      }
+    } else if(std::string(argv[i]) == "-bench") {
+      if((++i) >= argc) IDEFIX_ERROR(
+                      "You must specify -bench filename where filename is the benchmark report.");
+      this->benchFile = std::string(argv[i]);
+      inputParameters["CommandLine"]["bench"].push_back(benchFile);
     } else if(std::string(argv[i]) == "-Werror") {
       idfx::warningsAreErrors = true;
     } else if(std::string(argv[i]) == "-version" || std::string(argv[i]) == "-v") {
@@ -232,8 +263,11 @@ void Input::ShowConfig() {
   idfx::cout << "-----------------------------------------------------------------------------"
              << std::endl;
 
-  #ifdef SINGLE_PRECISION
+  #if defined(SINGLE_PRECISION)
     idfx::cout << "Input: Compiled with SINGLE PRECISION arithmetic." << std::endl;
+  #elif defined(MIXED_PRECISION)
+    idfx::cout << "Input: Compiled with MIXED PRECISION (single precision storage, "
+               << "double precision arithmetic)." << std::endl;
   #else
     idfx::cout << "Input: Compiled with DOUBLE PRECISION arithmetic." << std::endl;
   #endif
@@ -400,12 +434,36 @@ void Input::PrintOptions() {
   idfx::cout << " -force_init" << std::endl;
   idfx::cout << "         Call initial conditions before reading dump file ";
   idfx::cout << "(this has no effect if -restart is not also passed)" << std::endl;
+  idfx::cout << " -remap" << std::endl;
+  idfx::cout << "         Remap the restart dump onto the current grid when their resolutions "
+             << "differ." << std::endl;
   idfx::cout << " -nowrite" << std::endl;
   idfx::cout << "         Do not generate any output file." << std::endl;
   idfx::cout << " -nolog" << std::endl;
   idfx::cout << "         Do not write any log file." << std::endl;
   idfx::cout << " -profile" << std::endl;
   idfx::cout << "         Enable on-the-fly performance profiling." << std::endl;
+  idfx::cout << " -kernels" << std::endl;
+  idfx::cout << "         Time each kernel and show a report of the kernels at the end of the run."
+             << std::endl;
+  idfx::cout << " -trace" << std::endl;
+  idfx::cout << "         Same as -kernels, and write the timeline of the kernels of each process"
+             << std::endl;
+  idfx::cout << "         in idefix.trace.<rank>.json." << std::endl;
+  idfx::cout << " -autotune n" << std::endl;
+  idfx::cout << "         Time the first n calls of each loop with each candidate loop pattern "
+             << "(default 2," << std::endl;
+  idfx::cout << "         requires Idefix_LOOP_PATTERN=Autotune)." << std::endl;
+  idfx::cout << " -autotune_file xxx" << std::endl;
+  idfx::cout << "         Read the loop patterns from the file xxx when it matches the build and "
+             << "the grid," << std::endl;
+  idfx::cout << "         and write the tuned patterns in xxx at the end of the run." << std::endl;
+  idfx::cout << " -tile ni nj nk" << std::endl;
+  idfx::cout << "         Size of the tiles of the cache-blocked loops (0 for the size given by "
+             << "the cache model)." << std::endl;
+  idfx::cout << " -bench xxx" << std::endl;
+  idfx::cout << "         Write a performance report in the json file xxx at the end of the run."
+             << std::endl;
   idfx::cout << " -Werror" << std::endl;
   idfx::cout << "         Consider warnings as errors." << std::endl;
   idfx::cout << " -v/-version" << std::endl;
@@ -58,6 +58,7 @@ class Input {
   bool restartRequested{false};       //< Should we restart?
   int  restartFileNumber;             //< if yes, from which file?
   bool forceInitRequested{false};     // call DataBlock::InitFlow even on restarts ?
+  bool remapRequested{false};         // remap restart dumps written on a different grid ?
 
   static bool abortRequested;         //< Did we receive an abort signal (USR2) from the system?
 
@@ -65,6 +66,8 @@ class Input {
 
   bool forceNoWrite{false};           //< explicitely disable all writes to disk
 
+  std::string benchFile{""};          //< json performance report written at the end of the run
+
  private:
   std::string inputFileName;
   IdefixInputContainer  inputParameters;
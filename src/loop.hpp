@@ -12,9 +12,13 @@
 #ifndef LOOP_HPP_
 #define LOOP_HPP_
 
+#include <algorithm>
+#include <array>
 #include <string>
+#include <type_traits>
 #include "idefix.hpp"
 #include "global.hpp"
+#include "loopTuner.hpp"
 
 #define KOKKOS_VECTOR_LENGTH  8
 
@@ -49,8 +53,8 @@ typedef Kokkos::TeamPolicy<>::member_type  member_type;
   constexpr LoopPattern defaultLoop = LoopPattern::TPX;
 #elif defined(LOOP_PATTERN_TPTTRTVR)
   constexpr LoopPattern defaultLoop = LoopPattern::TPTTRTVR;
-#else // no loop strategy has been defined
-  // Default loops
+#else // no loop strategy has been defined (or the pattern is autotuned)
+  // Default loops (the reference of the autotuner)
   #if defined(KOKKOS_ENABLE_OPENMP)
     constexpr LoopPattern defaultLoop = LoopPattern::TPTTRTVR;
   #elif defined(KOKKOS_ENABLE_CUDA)
@@ -74,6 +78,43 @@ typedef Kokkos::TeamPolicy<>::member_type  member_type;
   #endif
 #endif
 
+// Whether the pattern of each loop is chosen at runtime by idfx::loopTuner
+#ifdef LOOP_PATTERN_AUTOTUNE
+  constexpr bool autotuneLoops = true;
+#else
+  constexpr bool autotuneLoops = false;
+#endif
+
+// Whether the loops run on the host, and can therefore use SIMD loops. Host-accessible memory
+// (e.g. Cuda UVM) is not enough: the kernels still run on the device.
+constexpr bool simdLoopAvailable =
+    std::is_same<Kokkos::DefaultExecutionSpace, Kokkos::DefaultHostExecutionSpace>::value;
+
+// Whether idefix_for_tiled uses the cache-blocked pattern, or is a plain idefix_for
+#ifdef WITH_TILED_LOOPS
+  constexpr bool tiledLoops = simdLoopAvailable;
+#else
+  constexpr bool tiledLoops = false;
+#endif
+
+// Configuration of the loops which are not autotuned
+constexpr idfx::LoopConfig defaultLoopConfig = {defaultLoop, KOKKOS_VECTOR_LENGTH, 0};
+
+// Team policy of a team kernel. An explicit team size is only used when the kernel can be
+// launched with it.
+template <typename Kernel>
+inline team_policy MakeTeamPolicy(const int league, const idfx::LoopConfig &config,
+                                  const Kernel &kernel) {
+  if(config.teamSize > 0) {
+    const int teamSizeMax = team_policy(league, 1, config.vectorLength)
+                              .team_size_max(kernel, Kokkos::ParallelForTag());
+    if(config.teamSize <= teamSizeMax) {
+      return(team_policy(league, config.teamSize, config.vectorLength));
+    }
+  }
+  return(team_policy(league, Kokkos::AUTO, config.vectorLength));
+}
+
 
 
 // 1D loop
@@ -81,6 +122,7 @@ template <typename Function>
 inline void idefix_for(const std::string & NAME,
                        const int & IB, const int & IE,
                        Function function) {
+  idfx::KernelWork<Function>(static_cast<int64_t>(IE-IB));
   #ifdef DEBUG
   idfx::pushRegion("idefix_for("+NAME+")");
   #endif
@@ -98,17 +140,15 @@ inline void idefix_for(const std::string & NAME,
 }
 
 
-// 2D loop
-template <typename Function>
-inline void idefix_for(const std::string & NAME,
-                       const int & JB, const int & JE,
-                       const int & IB, const int & IE,
-                       Function function) {
-  #ifdef DEBUG
-  idfx::pushRegion("idefix_for("+NAME+")");
-  #endif
+// 2D loop with a given pattern
+template <LoopPattern pattern, typename Function>
+inline void idefix_for_pattern(const std::string & NAME,
+                               const idfx::LoopConfig & config,
+                               const int & JB, const int & JE,
+                               const int & IB, const int & IE,
+                               Function function) {
   // Kokkos 1D Range
-  if constexpr(defaultLoop == LoopPattern::RANGE) {
+  if constexpr(pattern == LoopPattern::RANGE) {
     const int NJ = JE - JB;
     const int NI = IE - IB;
     const int NJNI = NJ * NI;
@@ -122,25 +162,25 @@ inline void idefix_for(const std::string & NAME,
     });
 
     // MDRange loops
-  } else if constexpr(defaultLoop == LoopPattern::MDRANGE) {
+  } else if constexpr(pattern == LoopPattern::MDRANGE) {
     Kokkos::parallel_for(NAME,
       Kokkos::MDRangePolicy<Kokkos::Rank<2, Kokkos::Iterate::Right, Kokkos::Iterate::Right>>
         ({JB,IB},{JE,IE}), function);
 
     // TeamPolicies with single inner loops
-  } else if constexpr(defaultLoop == LoopPattern::TPX || defaultLoop == LoopPattern::TPTTRTVR ) {
+  } else if constexpr(pattern == LoopPattern::TPX || pattern == LoopPattern::TPTTRTVR ) {
     const int NJ = JE - JB;
-    Kokkos::parallel_for(NAME, team_policy (NJ, Kokkos::AUTO,KOKKOS_VECTOR_LENGTH),
-      KOKKOS_LAMBDA (member_type team_member) {
-        const int j = team_member.league_rank() + JB;
-        Kokkos::parallel_for(TPINNERLOOP<>(team_member,IB,IE),
-                             [&] (const int i) {
-                               function(j,i);
-                            });
-    });
+    auto kernel = KOKKOS_LAMBDA (member_type team_member) {
+      const int j = team_member.league_rank() + JB;
+      Kokkos::parallel_for(TPINNERLOOP<>(team_member,IB,IE),
+                           [&] (const int i) {
+                             function(j,i);
+                          });
+    };
+    Kokkos::parallel_for(NAME, MakeTeamPolicy(NJ, config, kernel), kernel);
 
     // SIMD FOR loops
-  } else if constexpr(defaultLoop == LoopPattern::SIMDFOR) {
+  } else if constexpr(pattern == LoopPattern::SIMDFOR) {
     for (auto j = JB; j < JE; j++)
 #pragma omp simd
       for (auto i = IB; i < IE; i++)
@@ -148,25 +188,20 @@ inline void idefix_for(const std::string & NAME,
   } else {
     throw std::runtime_error("Unknown/undefined LoopPattern used.");
   }
-  #ifdef DEBUG
-  Kokkos::fence();
-  idfx::popRegion();
-  #endif
 }
 
 
-// 3D loop
-template <typename Function>
-inline void idefix_for(const std::string & NAME,
-                       const int & KB, const int & KE,
-                       const int & JB, const int & JE,
-                       const int & IB, const int & IE,
-                       Function function) {
-  #ifdef DEBUG
-  idfx::pushRegion("idefix_for("+NAME+")");
-  #endif
+
+// 3D loop with a given pattern
+template <LoopPattern pattern, typename Function>
+inline void idefix_for_pattern(const std::string & NAME,
+                               const idfx::LoopConfig & config,
+                               const int & KB, const int & KE,
+                               const int & JB, const int & JE,
+                               const int & IB, const int & IE,
+                               Function function) {
   // Kokkos 1D Range
-  if constexpr(defaultLoop == LoopPattern::RANGE) {
+  if constexpr(pattern == LoopPattern::RANGE) {
     const int NK = KE - KB;
     const int NJ = JE - JB;
     const int NI = IE - IB;
@@ -184,47 +219,45 @@ inline void idefix_for(const std::string & NAME,
     });
 
   // MDRange loops
-  } else if constexpr(defaultLoop == LoopPattern::MDRANGE) {
+  } else if constexpr(pattern == LoopPattern::MDRANGE) {
     Kokkos::parallel_for(NAME,
       Kokkos::MDRangePolicy<Kokkos::Rank<3, Kokkos::Iterate::Right, Kokkos::Iterate::Right>>
         ({KB,JB,IB},{KE,JE,IE}), function);
 
   // TeamPolicy with single inner loops
-  } else if constexpr(defaultLoop == LoopPattern::TPX) {
+  } else if constexpr(pattern == LoopPattern::TPX) {
     const int NK = KE - KB;
     const int NJ = JE - JB;
     const int NKNJ = NK * NJ;
-    Kokkos::parallel_for(NAME,
-      team_policy (NKNJ, Kokkos::AUTO,KOKKOS_VECTOR_LENGTH),
-      KOKKOS_LAMBDA (member_type team_member) {
-        const int k = team_member.league_rank() / NJ + KB;
-        const int j = team_member.league_rank() % NJ + JB;
-        Kokkos::parallel_for(TPINNERLOOP<>(team_member,IB,IE),
-          [&] (const int i) {
-            function(k,j,i);
-        });
+    auto kernel = KOKKOS_LAMBDA (member_type team_member) {
+      const int k = team_member.league_rank() / NJ + KB;
+      const int j = team_member.league_rank() % NJ + JB;
+      Kokkos::parallel_for(TPINNERLOOP<>(team_member,IB,IE),
+        [&] (const int i) {
+          function(k,j,i);
       });
+    };
+    Kokkos::parallel_for(NAME, MakeTeamPolicy(NKNJ, config, kernel), kernel);
 
   // TeamPolicy with nested TeamThreadRange and ThreadVectorRange
-  } else if constexpr(defaultLoop == LoopPattern::TPTTRTVR) {
+  } else if constexpr(pattern == LoopPattern::TPTTRTVR) {
     const int NK = KE - KB;
-    Kokkos::parallel_for(NAME,
-      team_policy (NK, Kokkos::AUTO,KOKKOS_VECTOR_LENGTH),
-      KOKKOS_LAMBDA (member_type team_member) {
-        const int k = team_member.league_rank() + KB;
-        Kokkos::parallel_for(
-          Kokkos::TeamThreadRange<>(team_member,JB,JE),
-          [&] (const int j) {
-            Kokkos::parallel_for(
-              Kokkos::ThreadVectorRange<>(team_member,IB,IE),
-              [&] (const int i) {
-                function(k,j,i);
-              });
-          });
-      });
+    auto kernel = KOKKOS_LAMBDA (member_type team_member) {
+      const int k = team_member.league_rank() + KB;
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange<>(team_member,JB,JE),
+        [&] (const int j) {
+          Kokkos::parallel_for(
+            Kokkos::ThreadVectorRange<>(team_member,IB,IE),
+            [&] (const int i) {
+              function(k,j,i);
+            });
+        });
+    };
+    Kokkos::parallel_for(NAME, MakeTeamPolicy(NK, config, kernel), kernel);
 
   // SIMD FOR loops
-  } else if constexpr(defaultLoop == LoopPattern::SIMDFOR) {
+  } else if constexpr(pattern == LoopPattern::SIMDFOR) {
     for (auto k = KB; k < KE; k++)
       for (auto j = JB; j < JE; j++)
 #pragma omp simd
@@ -233,25 +266,20 @@ inline void idefix_for(const std::string & NAME,
   } else {
     throw std::runtime_error("Unknown/undefined LoopPattern used.");
   }
-  #ifdef DEBUG
-  Kokkos::fence();
-  idfx::popRegion();
-  #endif
 }
 
-// 4D loop
-template <typename Function>
-inline void idefix_for(const std::string & NAME,
-                       const int NB, const int NE,
-                       const int KB, const int KE,
-                       const int JB, const int JE,
-                       const int IB, const int IE,
-                       Function function) {
-  #ifdef DEBUG
-  idfx::pushRegion("idefix_for("+NAME+")");
-  #endif
+
+// 4D loop with a given pattern
+template <LoopPattern pattern, typename Function>
+inline void idefix_for_pattern(const std::string & NAME,
+                               const idfx::LoopConfig & config,
+                               const int NB, const int NE,
+                               const int KB, const int KE,
+                               const int JB, const int JE,
+                               const int IB, const int IE,
+                               Function function) {
   // Kokkos 1D Range
-  if constexpr(defaultLoop == LoopPattern::RANGE) {
+  if constexpr(pattern == LoopPattern::RANGE) {
     const int NN = (NE) - (NB);
     const int NK = (KE) - (KB);
     const int NJ = (JE) - (JB);
@@ -273,56 +301,54 @@ inline void idefix_for(const std::string & NAME,
     });
 
   // MDRange loops
-  } else if constexpr(defaultLoop == LoopPattern::MDRANGE) {
+  } else if constexpr(pattern == LoopPattern::MDRANGE) {
     Kokkos::parallel_for(NAME,
       Kokkos::MDRangePolicy<Kokkos::Rank<4,Kokkos::Iterate::Right, Kokkos::Iterate::Right>>
         ({NB,KB,JB,IB},{NE,KE,JE,IE}), function);
 
   // TeamPolicy loops
-  } else if constexpr(defaultLoop == LoopPattern::TPX) {
+  } else if constexpr(pattern == LoopPattern::TPX) {
     const int NN = NE - NB;
     const int NK = KE - KB;
     const int NJ = JE - JB;
     const int NKNJ = NK * NJ;
     const int NNNKNJ = NN * NK * NJ;
-    Kokkos::parallel_for(NAME,
-      team_policy (NNNKNJ, Kokkos::AUTO,KOKKOS_VECTOR_LENGTH),
-      KOKKOS_LAMBDA (member_type team_member) {
-        int n = team_member.league_rank() / NKNJ;
-        int k = (team_member.league_rank() - n*NKNJ) / NJ;
-        int j = team_member.league_rank() - n*NKNJ - k*NJ + JB;
-        n += NB;
-        k += KB;
-        Kokkos::parallel_for(
-          TPINNERLOOP<>(team_member,IB,IE),
-          [&] (const int i) {
-            function(n,k,j,i);
-          });
-      });
+    auto kernel = KOKKOS_LAMBDA (member_type team_member) {
+      int n = team_member.league_rank() / NKNJ;
+      int k = (team_member.league_rank() - n*NKNJ) / NJ;
+      int j = team_member.league_rank() - n*NKNJ - k*NJ + JB;
+      n += NB;
+      k += KB;
+      Kokkos::parallel_for(
+        TPINNERLOOP<>(team_member,IB,IE),
+        [&] (const int i) {
+          function(n,k,j,i);
+        });
+    };
+    Kokkos::parallel_for(NAME, MakeTeamPolicy(NNNKNJ, config, kernel), kernel);
 
   // TeamPolicy with nested TeamThreadRange and ThreadVectorRange
-  } else if constexpr(defaultLoop == LoopPattern::TPTTRTVR) {
+  } else if constexpr(pattern == LoopPattern::TPTTRTVR) {
     const int NN = NE - NB;
     const int NK = KE - KB;
     const int NNNK = NN * NK;
-    Kokkos::parallel_for(NAME,
-      team_policy (NNNK, Kokkos::AUTO,KOKKOS_VECTOR_LENGTH),
-      KOKKOS_LAMBDA (member_type team_member) {
-        int n = team_member.league_rank() / NK + NB;
-        int k = team_member.league_rank() % NK + KB;
-        Kokkos::parallel_for(
-          Kokkos::TeamThreadRange<>(team_member,JB,JE),
-          [&] (const int j) {
-            Kokkos::parallel_for(
-              Kokkos::ThreadVectorRange<>(team_member,IB,IE),
-              [&] (const int i) {
-                function(n,k,j,i);
-              });
-          });
-      });
+    auto kernel = KOKKOS_LAMBDA (member_type team_member) {
+      int n = team_member.league_rank() / NK + NB;
+      int k = team_member.league_rank() % NK + KB;
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange<>(team_member,JB,JE),
+        [&] (const int j) {
+          Kokkos::parallel_for(
+            Kokkos::ThreadVectorRange<>(team_member,IB,IE),
+            [&] (const int i) {
+              function(n,k,j,i);
+            });
+        });
+    };
+    Kokkos::parallel_for(NAME, MakeTeamPolicy(NNNK, config, kernel), kernel);
 
   // SIMD FOR loops
-  } else if constexpr(defaultLoop == LoopPattern::SIMDFOR) {
+  } else if constexpr(pattern == LoopPattern::SIMDFOR) {
     for (auto n = NB; n < NE; n++)
       for (auto k = KB; k < KE; k++)
         for (auto j = JB; j < JE; j++)
@@ -332,10 +358,229 @@ inline void idefix_for(const std::string & NAME,
   } else {
     throw std::runtime_error("Unknown/undefined LoopPattern used.");
   }
+}
+
+
+// Loop whose pattern is chosen by the autotuner (the bounds being those of idefix_for)
+template <typename Function, typename... Bounds>
+inline void idefix_for_tuned(const std::string & NAME, const int64_t iterations,
+                             Function function, Bounds... bounds) {
+  const idfx::LoopConfig &config = idfx::loopTuner.Begin(NAME, sizeof...(Bounds)/2);
+  switch(config.pattern) {
+    case LoopPattern::RANGE:
+      idefix_for_pattern<LoopPattern::RANGE>(NAME, config, bounds..., function);
+      break;
+    case LoopPattern::MDRANGE:
+      idefix_for_pattern<LoopPattern::MDRANGE>(NAME, config, bounds..., function);
+      break;
+    case LoopPattern::TPX:
+      idefix_for_pattern<LoopPattern::TPX>(NAME, config, bounds..., function);
+      break;
+    case LoopPattern::TPTTRTVR:
+      idefix_for_pattern<LoopPattern::TPTTRTVR>(NAME, config, bounds..., function);
+      break;
+    case LoopPattern::SIMDFOR:
+      if constexpr(simdLoopAvailable) {
+        idefix_for_pattern<LoopPattern::SIMDFOR>(NAME, config, bounds..., function);
+        break;
+      }
+      [[fallthrough]];
+    default:
+      throw std::runtime_error("Unknown/undefined LoopPattern used.");
+  }
+  idfx::loopTuner.End(iterations);
+}
+
+// 2D loop
+template <typename Function>
+inline void idefix_for(const std::string & NAME,
+                       const int & JB, const int & JE,
+                       const int & IB, const int & IE,
+                       Function function) {
+  const int64_t iterations = static_cast<int64_t>(JE-JB)*(IE-IB);
+  idfx::KernelWork<Function>(iterations);
+  #ifdef DEBUG
+  idfx::pushRegion("idefix_for("+NAME+")");
+  #endif
+  if constexpr(autotuneLoops) {
+    idefix_for_tuned(NAME, iterations, function, JB, JE, IB, IE);
+  } else {
+    idefix_for_pattern<defaultLoop>(NAME, defaultLoopConfig, JB, JE, IB, IE, function);
+  }
+  #ifdef DEBUG
+  Kokkos::fence();
+  idfx::popRegion();
+  #endif
+}
+
+// 3D loop
+template <typename Function>
+inline void idefix_for(const std::string & NAME,
+                       const int & KB, const int & KE,
+                       const int & JB, const int & JE,
+                       const int & IB, const int & IE,
+                       Function function) {
+  const int64_t iterations = static_cast<int64_t>(KE-KB)*(JE-JB)*(IE-IB);
+  idfx::KernelWork<Function>(iterations);
+  #ifdef DEBUG
+  idfx::pushRegion("idefix_for("+NAME+")");
+  #endif
+  if constexpr(autotuneLoops) {
+    idefix_for_tuned(NAME, iterations, function, KB, KE, JB, JE, IB, IE);
+  } else {
+    idefix_for_pattern<defaultLoop>(NAME, defaultLoopConfig, KB, KE, JB, JE, IB, IE, function);
+  }
   #ifdef DEBUG
   Kokkos::fence();
   idfx::popRegion();
   #endif
 }
 
+// 4D loop
+template <typename Function>
+inline void idefix_for(const std::string & NAME,
+                       const int NB, const int NE,
+                       const int KB, const int KE,
+                       const int JB, const int JE,
+                       const int IB, const int IE,
+                       Function function) {
+  const int64_t iterations = static_cast<int64_t>(NE-NB)*(KE-KB)*(JE-JB)*(IE-IB);
+  idfx::KernelWork<Function>(iterations);
+  #ifdef DEBUG
+  idfx::pushRegion("idefix_for("+NAME+")");
+  #endif
+  if constexpr(autotuneLoops) {
+    idefix_for_tuned(NAME, iterations, function, NB, NE, KB, KE, JB, JE, IB, IE);
+  } else {
+    idefix_for_pattern<defaultLoop>(NAME, defaultLoopConfig, NB, NE, KB, KE, JB, JE, IB, IE,
+                                    function);
+  }
+  #ifdef DEBUG
+  Kokkos::fence();
+  idfx::popRegion();
+  #endif
+}
+
+
+// Cache-blocked loop on host backends: the block [NB,NE)x[KB,KE)x[JB,JE)x[IB,IE) is split in 3D
+// tiles sized to fit in the L2 cache (see idfx::LoopTile), each team (of a single thread)
+// processing a tile with its rows along i vectorized. The tiles are ordered with the sweep
+// direction varying fastest, and each thread gets a whole stack of tiles along that direction,
+// so that the planes read by a stencil along sweepDir are still in cache for the next tile.
+template <typename Function>
+inline void idefix_for_tiles(const std::string & NAME, const int sweepDir,
+                             const int64_t bytesPerCell,
+                             const int NB, const int NE,
+                             const int KB, const int KE,
+                             const int JB, const int JE,
+                             const int IB, const int IE,
+                             Function function) {
+  const int NN = NE - NB;
+  const std::array<int,3> tile = idfx::LoopTile({IE-IB, JE-JB, KE-KB}, sweepDir, bytesPerCell,
+                                                NN);
+  const int TI = tile[IDIR];
+  const int TJ = tile[JDIR];
+  const int TK = tile[KDIR];
+  // # of tiles along each direction, and order of the directions (fastest first)
+  const int nti = (IE - IB + TI - 1) / TI;
+  const int ntj = (JE - JB + TJ - 1) / TJ;
+  const int ntk = (KE - KB + TK - 1) / TK;
+  const int ntiles = nti * ntj * ntk;
+  if(NN <= 0 || ntiles <= 0) return;
+  const int ntile[3] = {nti, ntj, ntk};
+  const int first = sweepDir;
+  const int second = (sweepDir == KDIR) ? JDIR : KDIR;
+  const int third = 3 - first - second;
+  const int nfirst = ntile[first];
+  const int nsecond = ntile[second];
+
+  auto kernel = KOKKOS_LAMBDA (member_type team_member) {
+    int r = team_member.league_rank();
+    const int n = r / ntiles + NB;
+    r = r % ntiles;
+    int t[3];
+    t[first] = r % nfirst;
+    r = r / nfirst;
+    t[second] = r % nsecond;
+    t[third] = r / nsecond;
+    const int i0 = IB + t[IDIR]*TI;
+    const int j0 = JB + t[JDIR]*TJ;
+    const int k0 = KB + t[KDIR]*TK;
+    const int i1 = (i0 + TI < IE) ? i0 + TI : IE;
+    const int nj = ((j0 + TJ < JE) ? j0 + TJ : JE) - j0;
+    const int nk = ((k0 + TK < KE) ? k0 + TK : KE) - k0;
+    Kokkos::parallel_for(
+      Kokkos::TeamThreadRange<>(team_member, nk*nj),
+      [&] (const int kj) {
+        const int k = k0 + kj / nj;
+        const int j = j0 + kj % nj;
+        Kokkos::parallel_for(
+          Kokkos::ThreadVectorRange<>(team_member, i0, i1),
+          [&] (const int i) {
+            function(n,k,j,i);
+          });
+      });
+  };
+  Kokkos::parallel_for(NAME,
+                       team_policy(NN*ntiles, 1, KOKKOS_VECTOR_LENGTH).set_chunk_size(nfirst),
+                       kernel);
+}
+
+// Bytes moved per iteration by a kernel, assuming its capture is made of arrays of reals
+template <typename Function>
+constexpr int64_t KernelBytesPerCell() {
+  return(std::max<int64_t>(1, sizeof(Function)/sizeof(IdefixArray3D<real>)) * sizeof(real));
+}
+
+// 3D loop using the cache-blocked pattern, for stencil kernels reading neighbours along
+// sweepDir (JDIR or KDIR). It falls back to idefix_for for stencils along i, which are already
+// streamed by the default patterns, on device backends, and unless Idefix_TILED_LOOPS is on.
+template <int sweepDir = KDIR, typename Function>
+inline void idefix_for_tiled(const std::string & NAME,
+                             const int & KB, const int & KE,
+                             const int & JB, const int & JE,
+                             const int & IB, const int & IE,
+                             Function function) {
+  if constexpr(!tiledLoops || sweepDir == IDIR) {
+    idefix_for(NAME, KB, KE, JB, JE, IB, IE, function);
+  } else {
+    idfx::KernelWork<Function>(static_cast<int64_t>(KE-KB)*(JE-JB)*(IE-IB));
+    #ifdef DEBUG
+    idfx::pushRegion("idefix_for_tiled("+NAME+")");
+    #endif
+    idefix_for_tiles(NAME, sweepDir, KernelBytesPerCell<Function>(), 0, 1, KB, KE, JB, JE, IB, IE,
+      KOKKOS_LAMBDA (const int, const int k, const int j, const int i) {
+        function(k,j,i);
+      });
+    #ifdef DEBUG
+    Kokkos::fence();
+    idfx::popRegion();
+    #endif
+  }
+}
+
+// 4D loop using the cache-blocked pattern, the tiles of each n being processed in turn
+template <int sweepDir = KDIR, typename Function>
+inline void idefix_for_tiled(const std::string & NAME,
+                             const int NB, const int NE,
+                             const int KB, const int KE,
+                             const int JB, const int JE,
+                             const int IB, const int IE,
+                             Function function) {
+  if constexpr(!tiledLoops || sweepDir == IDIR) {
+    idefix_for(NAME, NB, NE, KB, KE, JB, JE, IB, IE, function);
+  } else {
+    idfx::KernelWork<Function>(static_cast<int64_t>(NE-NB)*(KE-KB)*(JE-JB)*(IE-IB));
+    #ifdef DEBUG
+    idfx::pushRegion("idefix_for_tiled("+NAME+")");
+    #endif
+    idefix_for_tiles(NAME, sweepDir, KernelBytesPerCell<Function>(), NB, NE, KB, KE, JB, JE,
+                     IB, IE, function);
+    #ifdef DEBUG
+    Kokkos::fence();
+    idfx::popRegion();
+    #endif
+  }
+}
+
 #endif // LOOP_HPP_
@@ -0,0 +1,215 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "idefix.hpp"
+#include "loopTuner.hpp"
+
+idfx::LoopTuner::LoopTuner() {
+  reference = defaultLoopConfig;
+}
+
+void idfx::LoopTuner::Init(const std::array<int,3> &gridSize) {
+  if constexpr(!autotuneLoops) {
+    if(!fileName.empty()) {
+      IDEFIX_WARNING("The tuning file is ignored: Idefix was not built with "
+                     "Idefix_LOOP_PATTERN=Autotune");
+    }
+    return;
+  }
+  idfx::pushRegion("LoopTuner::Init");
+  candidates.clear();
+  candidates.push_back({LoopPattern::RANGE, 1, 0});
+  candidates.push_back({LoopPattern::MDRANGE, 1, 0});
+
+  // Team policies: vector lengths, and threads per team on accelerators (0 is Kokkos::AUTO)
+  std::vector<int> vectorLengths;
+  for(int vl : {1, 4, 8, 16, 32}) {
+    if(vl <= team_policy::vector_length_max()) vectorLengths.push_back(vl);
+  }
+  std::vector<int> teamThreads = {0};
+  #if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP) || defined(KOKKOS_ENABLE_SYCL)
+    teamThreads.push_back(128);
+    teamThreads.push_back(256);
+  #endif
+  for(LoopPattern pattern : {LoopPattern::TPX, LoopPattern::TPTTRTVR}) {
+    for(int vl : vectorLengths) {
+      for(int threads : teamThreads) {
+        if(threads > 0 && threads < vl) continue;
+        candidates.push_back({pattern, vl, threads/vl});
+      }
+    }
+  }
+  // Serial loops are only worth a try when there is a single host thread
+  if(simdLoopAvailable && Kokkos::DefaultExecutionSpace().concurrency() == 1) {
+    candidates.push_back({LoopPattern::SIMDFOR, 1, 0});
+  }
+
+  // The winners only hold for a given build, number of processes and grid size
+  std::stringstream ss;
+  ss << "Idefix " << IDEFIX_VERSION << " Kokkos " << KOKKOS_VERSION
+     << " " << Kokkos::DefaultExecutionSpace::name()
+     << " x" << Kokkos::DefaultExecutionSpace().concurrency()
+     << " dim " << DIMENSIONS << " geometry " << GEOMETRY << " mhd " << (MHD == YES)
+     << " real " << sizeof(real) << " procs " << idfx::psize
+     << " grid " << gridSize[IDIR] << "x" << gridSize[JDIR] << "x" << gridSize[KDIR];
+  key = ss.str();
+
+  if(!fileName.empty()) Load();
+  idfx::popRegion();
+}
+
+void idfx::LoopTuner::Load() {
+  std::ifstream file(fileName);
+  if(!file.good()) return;
+  std::string line;
+  std::getline(file, line);
+  if(line != "# " + key) {
+    IDEFIX_WARNING("The tuning file " + fileName + " was written by another build or for "
+                   "another grid size. The loops are tuned again.");
+    return;
+  }
+  int nloaded = 0;
+  while(std::getline(file, line)) {
+    std::stringstream entry(line);
+    int rank;
+    std::string pattern;
+    LoopConfig config;
+    std::string name;
+    if(!(entry >> rank >> pattern >> config.vectorLength >> config.teamSize)) continue;
+    std::getline(entry >> std::ws, name);
+    // Only the configurations which are candidates on this machine are used
+    bool valid = false;
+    for(auto &candidate : candidates) {
+      if(PatternName(candidate.pattern) == pattern && candidate.vectorLength == config.vectorLength
+         && candidate.teamSize == config.teamSize) {
+        config.pattern = candidate.pattern;
+        valid = true;
+      }
+    }
+    if(!valid || rank < 1 || rank > 4) continue;
+    TunedLoop &loop = loops[name][rank-1];
+    loop.config = config;
+    loop.tuned = true;
+    loop.fromFile = true;
+    nloaded++;
+  }
+  idfx::cout << "LoopTuner: read the patterns of " << nloaded << " loops from " << fileName
+             << "." << std::endl;
+}
+
+void idfx::LoopTuner::Start(TunedLoop &loop) {
+  if(callsPerCandidate <= 0) {
+    loop.config = reference;
+    loop.tuned = true;
+    return;
+  }
+  loop.time.assign(candidates.size(), std::numeric_limits<double>::max());
+  loop.candidate = 0;
+  loop.calls = 0;
+  loop.config = candidates[0];
+}
+
+void idfx::LoopTuner::Record(TunedLoop &loop, double time) {
+  loop.time[loop.candidate] = std::min(loop.time[loop.candidate], time);
+  if(++loop.calls < callsPerCandidate) return;
+  loop.calls = 0;
+  loop.candidate++;
+  if(loop.candidate < candidates.size()) {
+    loop.config = candidates[loop.candidate];
+  } else {
+    const int winner = std::min_element(loop.time.begin(), loop.time.end()) - loop.time.begin();
+    loop.config = candidates[winner];
+    loop.tuned = true;
+  }
+}
+
+std::string idfx::LoopTuner::PatternName(LoopPattern pattern) {
+  // Same names as the values of Idefix_LOOP_PATTERN
+  switch(pattern) {
+    case LoopPattern::SIMDFOR:  return("SIMD");
+    case LoopPattern::RANGE:    return("Range");
+    case LoopPattern::MDRANGE:  return("MDRange");
+    case LoopPattern::TPX:      return("TeamPolicy");
+    case LoopPattern::TPTTRTVR: return("TeamPolicyInnerVector");
+    default:                    return("Undefined");
+  }
+}
+
+std::string idfx::LoopTuner::Name(const LoopConfig &config) {
+  std::string name = PatternName(config.pattern);
+  if(config.pattern == LoopPattern::TPX || config.pattern == LoopPattern::TPTTRTVR) {
+    name += "(vector " + std::to_string(config.vectorLength) + ", team "
+            + (config.teamSize > 0 ? std::to_string(config.teamSize) : "auto") + ")";
+  }
+  return(name);
+}
+
+void idfx::LoopTuner::Finalize() {
+  if(candidates.empty()) return;
+  // Sorted by name
+  std::map<std::string, std::array<TunedLoop,4>*> sorted;
+  for(auto &loop : loops) sorted[loop.first] = &loop.second;
+
+  int ntuning = 0;
+  idfx::cout << "LoopTuner: patterns of the loops (speedup with respect to "
+             << Name(reference) << "):" << std::endl;
+  for(auto &entry : sorted) {
+    for(int rank = 0 ; rank < 4 ; rank++) {
+      const TunedLoop &loop = (*entry.second)[rank];
+      if(!loop.tuned) {
+        if(!loop.time.empty()) ntuning++;
+        continue;
+      }
+      idfx::cout << "  " << std::left << std::setw(48) << entry.first << " " << rank+1 << "D  "
+                 << std::setw(36) << Name(loop.config) << std::right;
+      if(loop.fromFile) {
+        idfx::cout << " (tuning file)";
+      } else if(!loop.time.empty()) {
+        const double best = *std::min_element(loop.time.begin(), loop.time.end());
+        for(int c = 0 ; c < candidates.size() ; c++) {
+          const LoopConfig &cand = candidates[c];
+          if(cand.pattern == reference.pattern && cand.teamSize == reference.teamSize
+             && (cand.vectorLength == reference.vectorLength
+                 || (cand.pattern != LoopPattern::TPX && cand.pattern != LoopPattern::TPTTRTVR))) {
+            idfx::cout << " x" << std::fixed << std::setprecision(2) << loop.time[c]/best;
+            break;
+          }
+        }
+      }
+      idfx::cout << std::endl;
+    }
+  }
+  if(ntuning > 0) {
+    idfx::cout << "LoopTuner: " << ntuning << " loops were still being tuned at the end of the run."
+               << std::endl;
+  }
+
+  // Each process uses its own winners, the file holds those of the first process
+  if(!fileName.empty() && idfx::prank == 0) {
+    std::ofstream file(fileName);
+    file << "# " << key << std::endl;
+    for(auto &entry : sorted) {
+      for(int rank = 0 ; rank < 4 ; rank++) {
+        const TunedLoop &loop = (*entry.second)[rank];
+        if(!loop.tuned) continue;
+        file << rank+1 << " " << PatternName(loop.config.pattern) << " "
+             << loop.config.vectorLength << " " << loop.config.teamSize << " "
+             << entry.first << std::endl;
+      }
+    }
+    idfx::cout << "LoopTuner: patterns written in " << fileName << "." << std::endl;
+  }
+}
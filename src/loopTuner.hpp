@@ -0,0 +1,82 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef LOOPTUNER_HPP_
+#define LOOPTUNER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace idfx {
+
+// Execution parameters of an idefix_for loop
+struct LoopConfig {
+  LoopPattern pattern;
+  int vectorLength;           // vector length of the team policies
+  int teamSize;               // team size of the team policies (0 for Kokkos::AUTO)
+};
+
+// Tuning state of the loops of a given name and rank
+struct TunedLoop {
+  int candidate{0};           // candidate being timed
+  int calls{0};               // # of calls timed with the current candidate
+  bool tuned{false};          // whether config is the final configuration of the loop
+  bool fromFile{false};       // whether config was read from the tuning file
+  LoopConfig config;          // configuration used by the next call
+  std::vector<double> time;   // best time per iteration of each candidate
+};
+
+// Runtime autotuner of the idefix_for loops (enabled with Idefix_LOOP_PATTERN=Autotune). The
+// first calls of each loop (identified by its name and rank) are timed with each candidate
+// pattern and team/vector size, and the fastest candidate is used for the rest of the run.
+class LoopTuner {
+ public:
+  LoopTuner();
+  void Init(const std::array<int,3> &);   // candidates and tuning file of the given grid size
+  void Finalize();                        // show the winners and write the tuning file
+
+  // Configuration of the next call of a loop, and timing of that call
+  inline const LoopConfig &Begin(const std::string &name, int rank) {
+    current = &loops[name][rank-1];
+    if(current->tuned) return(current->config);
+    // Loops launched before Init (or in builds without autotuning) use the default pattern
+    if(candidates.empty()) return(reference);
+    if(current->time.empty()) Start(*current);
+    Kokkos::fence();
+    timer.reset();
+    return(current->config);
+  }
+  inline void End(int64_t iterations) {
+    if(current->tuned || candidates.empty()) return;
+    Kokkos::fence();
+    Record(*current, timer.seconds()/std::max<int64_t>(1, iterations));
+  }
+
+  int callsPerCandidate{2};   // # of calls timed with each candidate
+  std::string fileName;       // tuning file (none if empty)
+
+ private:
+  void Start(TunedLoop &);
+  void Record(TunedLoop &, double);
+  void Load();
+  static std::string Name(const LoopConfig &);
+  static std::string PatternName(LoopPattern);
+
+  std::vector<LoopConfig> candidates;
+  LoopConfig reference;                   // configuration of the default loop pattern
+  std::string key;                        // build and grid size of the tuning file
+  std::unordered_map<std::string, std::array<TunedLoop,4>> loops;
+  TunedLoop *current{nullptr};
+  Kokkos::Timer timer;
+};
+
+}// namespace idfx
+
+#endif // LOOPTUNER_HPP_
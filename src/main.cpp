@@ -24,6 +24,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <Kokkos_Core.hpp>
 
@@ -63,7 +66,13 @@ int main( int argc, char* argv[] ) {
   if(initKokkosBeforeMPI)  Kokkos::initialize( argc, argv );
 
 #ifdef WITH_MPI
-  MPI_Init(&argc,&argv);
+  #ifdef WITH_ASYNC_DUMPS
+    // Asynchronous dumps are written by a separate thread
+    int mpiThreadLevel;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpiThreadLevel);
+  #else
+    MPI_Init(&argc,&argv);
+  #endif
 #endif
 
   if(!initKokkosBeforeMPI) Kokkos::initialize( argc, argv );
@@ -71,6 +80,9 @@ int main( int argc, char* argv[] ) {
 
   {
     idfx::initialize();
+    #if defined(WITH_MPI) && defined(WITH_ASYNC_DUMPS)
+      idfx::mpiThreadMultiple = (mpiThreadLevel >= MPI_THREAD_MULTIPLE);
+    #endif
     ///////////////////////////////
     // Initialization
     ///////////////////////////////
@@ -81,6 +93,7 @@ int main( int argc, char* argv[] ) {
 
     // Allocate the grid on device
     Grid grid(input);
+    idfx::loopTuner.Init(grid.np_int);
     // Allocate the grid image on host
     GridHost gridHost(grid);
 
@@ -95,6 +108,23 @@ int main( int argc, char* argv[] ) {
       Pydefix pydefix(input);
     #endif
     Output output(input, data);
+    // The user boundaries and source terms of each block are enrolled by its own Setup (created
+    // first, so that the Setup of the process has the last word on any global state)
+    std::vector<std::unique_ptr<Setup>> blockSetups;
+    if(data.haveBlocks) {
+      for(auto &block : data.scheduler->blocks) {
+        blockSetups.push_back(std::make_unique<Setup>(input, grid, *block, output));
+      }
+    }
+    // Same for each refinement level. The fine levels only exist on the procs they span, so that
+    // their Setup is only constructed there: it should not make any collective call on
+    // MPI_COMM_WORLD, but on the communicator of the grid of its level (grid.CartComm)
+    std::vector<std::pair<std::unique_ptr<Setup>, DataBlock*>> levelSetups;
+    for(StaticRefinement *ref = data.refinement.get() ; ref != nullptr && ref->fine ;
+        ref = ref->fine->refinement.get()) {
+      levelSetups.emplace_back(std::make_unique<Setup>(input, *ref->grid, *ref->fine, output),
+                               ref->fine.get());
+    }
     Setup mysetup(input, grid, data, output);
 
     idfx::cout << "Main: initialisation finished." << std::endl;
@@ -124,6 +154,10 @@ int main( int argc, char* argv[] ) {
     ///////////////////////////////
     // Are we restarting?
     if(input.restartRequested) {
+      if(data.haveRefinement) {
+        IDEFIX_ERROR("Restarts are not supported with the static mesh refinement: "
+                     "the refined levels are not written in the dump files.");
+      }
       if(input.forceInitRequested) {
         #ifdef WITH_PYTHON
           if(pydefix.haveInitflow) {
@@ -148,6 +182,7 @@ int main( int argc, char* argv[] ) {
         idfx::cout << "Main: restart aborted." << std::endl;
         input.restartRequested = false;
       } else {
+        if(data.haveBlocks) data.scheduler->Scatter();
         data.SetBoundaries();
       }
     }
@@ -167,6 +202,13 @@ int main( int argc, char* argv[] ) {
       #endif
       idfx::popRegion();
       data.DeriveVectorPotential();   // This does something only when evolveVectorPotential is on
+      for(auto &level : levelSetups) {
+        idfx::pushRegion("Setup::Initflow");
+        level.first->InitFlow(*level.second);
+        idfx::popRegion();
+      }
+      if(data.haveRefinement) data.refinement->InitializeLevels();
+      if(data.haveBlocks) data.scheduler->Scatter();
       data.SetBoundaries();
       data.Validate();
       output.CheckForWrites(data);
@@ -229,7 +271,8 @@ int main( int argc, char* argv[] ) {
     n_minutes = divres.quot;
     n_seconds = divres.rem;
 
-    double perfs = timer.seconds() / grid.np_int[IDIR] / grid.np_int[JDIR]
+    double runTime = timer.seconds();
+    double perfs = runTime / grid.np_int[IDIR] / grid.np_int[JDIR]
                             / grid.np_int[KDIR] / Tint.GetNCycles() * idfx::psize;
 
     idfx::cout << "Main: Reached t=" << data.t << std::endl;
@@ -278,6 +321,10 @@ int main( int argc, char* argv[] ) {
               << "% of total run time." << std::endl;
     // Show profiler output
     idfx::prof.Show();
+    idfx::loopTuner.Finalize();
+    if(!input.benchFile.empty()) {
+      idfx::prof.WriteReport(input.benchFile, 1/perfs, runTime, Tint.GetNCycles());
+    }
   }
 
   if(returnCode<0) {
@@ -28,9 +28,172 @@
 // init the number of instances
 int Mpi::nInstances = 0;
 
-// MPI Routines exchange
-void Mpi::ExchangeAll() {
-  IDEFIX_ERROR("Not Implemented");
+///
+/// Start the exchange of the cell-centered variables in all of the directions at once.
+/// Contrary to ExchangeX1...X3, the directions are not treated one after the other, so the
+/// ghost cells located in the corners of the domain are not refreshed: this is only suitable
+/// for algorithms which do not read corner ghost cells. The messages are left in flight, and
+/// ExchangeAllEnd should be called before the ghost cells are used.
+///
+template<typename T>
+void Mpi::ExchangeAllBegin(IdefixArray4D<T> Vc) {
+  idfx::pushRegion("Mpi::ExchangeAllBegin");
+#ifndef MPI_PERSISTENT
+  IDEFIX_ERROR("Mpi::ExchangeAllBegin requires persistent MPI communications");
+#else
+  if(haveVs) {
+    IDEFIX_ERROR("Mpi::ExchangeAllBegin cannot be used with face-centered variables");
+  }
+  if(exchangeAllPending) {
+    IDEFIX_ERROR("Mpi::ExchangeAllBegin called while a previous exchange is still pending");
+  }
+  Buffer *bufferSend[3] = {BufferSendX1, BufferSendX2, BufferSendX3};
+  MPI_Request *sendRequest[3] = {sendRequestX1, sendRequestX2, sendRequestX3};
+  MPI_Request *recvRequest[3] = {recvRequestX1, recvRequestX2, recvRequestX3};
+  IdefixArray1D<int> map = this->mapVars;
+
+  // Start receiving even before the buffers are filled
+  myTimer -= MPI_Wtime();
+  double tStart = MPI_Wtime();
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(mygrid->nproc[dir] > 1) {
+      MPI_SAFE_CALL(MPI_Startall(2, recvRequest[dir]));
+    }
+  }
+  idfx::mpiCallsTimer += MPI_Wtime() - tStart;
+  myTimer += MPI_Wtime();
+
+  // Load the buffers with data
+  std::pair<int,int> range[3];
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(mygrid->nproc[dir] > 1) {
+      for(BoundarySide side : {left, right}) {
+        Buffer buffer = bufferSend[dir][side == left ? faceLeft : faceRight];
+        buffer.ResetPointer();
+        GetExchangeRange(dir, side, false, range);
+        buffer.Pack(Vc, map, range[IDIR], range[JDIR], range[KDIR]);
+      }
+    }
+  }
+
+  // Wait for completion before sending out everything
+  Kokkos::fence();
+  myTimer -= MPI_Wtime();
+  tStart = MPI_Wtime();
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(mygrid->nproc[dir] > 1) {
+      MPI_SAFE_CALL(MPI_Startall(2, sendRequest[dir]));
+    }
+  }
+  idfx::mpiCallsTimer += MPI_Wtime() - tStart;
+  myTimer += MPI_Wtime();
+
+  exchangeAllPending = true;
+#endif
+  idfx::popRegion();
+}
+
+///
+/// Complete the exchanges started by ExchangeAllBegin, and fill the ghost cells with
+/// the received data.
+///
+template<typename T>
+void Mpi::ExchangeAllEnd(IdefixArray4D<T> Vc) {
+  idfx::pushRegion("Mpi::ExchangeAllEnd");
+#ifdef MPI_PERSISTENT
+  if(!exchangeAllPending) {
+    IDEFIX_ERROR("Mpi::ExchangeAllEnd called without a prior call to Mpi::ExchangeAllBegin");
+  }
+  Buffer *bufferRecv[3] = {BufferRecvX1, BufferRecvX2, BufferRecvX3};
+  MPI_Request *sendRequest[3] = {sendRequestX1, sendRequestX2, sendRequestX3};
+  MPI_Request *recvRequest[3] = {recvRequestX1, recvRequestX2, recvRequestX3};
+  const int bufferSize[3] = {bufferSizeX1, bufferSizeX2, bufferSizeX3};
+  IdefixArray1D<int> map = this->mapVars;
+
+  MPI_Status sendStatus[2];
+  MPI_Status recvStatus[2];
+  std::pair<int,int> range[3];
+
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(mygrid->nproc[dir] > 1) {
+      // Wait for buffers to be received
+      myTimer -= MPI_Wtime();
+      double tStart = MPI_Wtime();
+      MPI_Waitall(2, recvRequest[dir], recvStatus);
+      idfx::mpiCallsTimer += MPI_Wtime() - tStart;
+      myTimer += MPI_Wtime();
+
+      // Unpack
+      for(BoundarySide side : {left, right}) {
+        Buffer buffer = bufferRecv[dir][side == left ? faceLeft : faceRight];
+        buffer.ResetPointer();
+        GetExchangeRange(dir, side, true, range);
+        buffer.Unpack(Vc, map, range[IDIR], range[JDIR], range[KDIR]);
+      }
+      bytesSentOrReceived += 4*bufferSize[dir]*sizeof(real);
+    }
+  }
+
+  // Wait for the sends if they have not yet completed
+  myTimer -= MPI_Wtime();
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(mygrid->nproc[dir] > 1) {
+      MPI_Waitall(2, sendRequest[dir], sendStatus);
+    }
+  }
+  myTimer += MPI_Wtime();
+
+  exchangeAllPending = false;
+#endif
+  idfx::popRegion();
+}
+
+///
+/// Test (without blocking) whether all of the messages started by ExchangeAllBegin have been
+/// received, so that ExchangeAllEnd would not wait for them. Returns true when no exchange is
+/// pending.
+///
+bool Mpi::ExchangeAllReceived() {
+  bool received = true;
+#ifdef MPI_PERSISTENT
+  if(!exchangeAllPending) return(received);
+  MPI_Request *recvRequest[3] = {recvRequestX1, recvRequestX2, recvRequestX3};
+  double tStart = MPI_Wtime();
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(mygrid->nproc[dir] > 1) {
+      int flag;
+      MPI_SAFE_CALL(MPI_Testall(2, recvRequest[dir], &flag, MPI_STATUSES_IGNORE));
+      if(!flag) {
+        received = false;
+        break;
+      }
+    }
+  }
+  idfx::mpiCallsTimer += MPI_Wtime() - tStart;
+#endif
+  return(received);
+}
+
+// Compute the range of the cell-centered region involved in an exchange in direction dir.
+// When isGhost is true, the range is the ghost region which is received, otherwise the active
+// region which is sent. The ranges are identical to the ones used by ExchangeX1...X3, so that
+// the same buffers and persistent requests can be used.
+void Mpi::GetExchangeRange(int dir, BoundarySide side, bool isGhost,
+                           std::pair<int,int> range[3]) {
+  for(int d = 0 ; d < 3 ; d++) {
+    if(d < dir) {
+      // Directions treated before dir include their ghost zones
+      range[d] = std::make_pair(0, ntot[d]);
+    } else if(d > dir) {
+      range[d] = std::make_pair(beg[d], end[d]);
+    } else if(side == left) {
+      range[d] = isGhost ? std::make_pair(0, nghost[d])
+                         : std::make_pair(beg[d], beg[d]+nghost[d]);
+    } else {
+      range[d] = isGhost ? std::make_pair(end[d], end[d]+nghost[d])
+                         : std::make_pair(end[d]-nghost[d], end[d]);
+    }
+  }
 }
 
 ///
@@ -53,6 +216,11 @@ void Mpi::Init(Grid *grid, std::vector<int> inputMap,
   nInstances++;
   thisInstance=nInstances;
 
+  // Each instance exchanges its messages on its own communicator, so that their tags do not
+  // depend on the number of instances. The instances are created in the same order on all of
+  // the processes of the grid, which pairs their communicators.
+  MPI_SAFE_CALL(MPI_Comm_dup(grid->CartComm, &comm));
+
   // Transfer the vector of indices as an IdefixArray on the target
 
   // Allocate mapVars on target and copy it from the input argument list
@@ -140,64 +308,64 @@ void Mpi::Init(Grid *grid, std::vector<int> inputMap,
 
   // X1-dir exchanges
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,0,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,0,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Send_init(BufferSendX1[faceRight].data(), bufferSizeX1, realMPI, procSend,
-                thisInstance*1000, mygrid->CartComm, &sendRequestX1[faceRight]));
+                0, comm, &sendRequestX1[faceRight]));
 
   MPI_SAFE_CALL(MPI_Recv_init(BufferRecvX1[faceLeft].data(), bufferSizeX1, realMPI, procRecv,
-                thisInstance*1000, mygrid->CartComm, &recvRequestX1[faceLeft]));
+                0, comm, &recvRequestX1[faceLeft]));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,0,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,0,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Send_init(BufferSendX1[faceLeft].data(), bufferSizeX1, realMPI, procSend,
-                thisInstance*1000+1,mygrid->CartComm, &sendRequestX1[faceLeft]));
+                1, comm, &sendRequestX1[faceLeft]));
 
   MPI_SAFE_CALL(MPI_Recv_init(BufferRecvX1[faceRight].data(), bufferSizeX1, realMPI, procRecv,
-                thisInstance*1000+1,mygrid->CartComm, &recvRequestX1[faceRight]));
+                1, comm, &recvRequestX1[faceRight]));
 
   #if DIMENSIONS >= 2
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,1,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,1,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Send_init(BufferSendX2[faceRight].data(), bufferSizeX2, realMPI, procSend,
-                thisInstance*1000+10, mygrid->CartComm, &sendRequestX2[faceRight]));
+                10, comm, &sendRequestX2[faceRight]));
 
   MPI_SAFE_CALL(MPI_Recv_init(BufferRecvX2[faceLeft].data(), bufferSizeX2, realMPI, procRecv,
-                thisInstance*1000+10, mygrid->CartComm, &recvRequestX2[faceLeft]));
+                10, comm, &recvRequestX2[faceLeft]));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,1,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,1,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Send_init(BufferSendX2[faceLeft].data(), bufferSizeX2, realMPI, procSend,
-                thisInstance*1000+11, mygrid->CartComm, &sendRequestX2[faceLeft]));
+                11, comm, &sendRequestX2[faceLeft]));
 
   MPI_SAFE_CALL(MPI_Recv_init(BufferRecvX2[faceRight].data(), bufferSizeX2, realMPI, procRecv,
-                thisInstance*1000+11, mygrid->CartComm, &recvRequestX2[faceRight]));
+                11, comm, &recvRequestX2[faceRight]));
   #endif
 
   #if DIMENSIONS == 3
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,2,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,2,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Send_init(BufferSendX3[faceRight].data(), bufferSizeX3, realMPI, procSend,
-                thisInstance*1000+20, mygrid->CartComm, &sendRequestX3[faceRight]));
+                20, comm, &sendRequestX3[faceRight]));
 
   MPI_SAFE_CALL(MPI_Recv_init(BufferRecvX3[faceLeft].data(), bufferSizeX3, realMPI, procRecv,
-                thisInstance*1000+20, mygrid->CartComm, &recvRequestX3[faceLeft]));
+                20, comm, &recvRequestX3[faceLeft]));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,2,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,2,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Send_init(BufferSendX3[faceLeft].data(), bufferSizeX3, realMPI, procSend,
-                thisInstance*1000+21, mygrid->CartComm, &sendRequestX3[faceLeft]));
+                21, comm, &sendRequestX3[faceLeft]));
 
   MPI_SAFE_CALL(MPI_Recv_init(BufferRecvX3[faceRight].data(), bufferSizeX3, realMPI, procRecv,
-                thisInstance*1000+21, mygrid->CartComm, &recvRequestX3[faceRight]));
+                21, comm, &recvRequestX3[faceRight]));
   #endif
 
 #endif // MPI_Persistent
@@ -231,6 +399,7 @@ Mpi::~Mpi() {
       #endif
       }
     #endif
+    MPI_Comm_free(&comm);
     if(thisInstance==1) {
       idfx::cout << "Mpi(" << thisInstance << "): measured throughput is "
                 << bytesSentOrReceived/myTimer/1024.0/1024.0 << " MB/s" << std::endl;
@@ -244,7 +413,8 @@ Mpi::~Mpi() {
   idfx::popRegion();
 }
 
-void Mpi::ExchangeX1(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
+template<typename T>
+void Mpi::ExchangeX1(IdefixArray4D<T> Vc, IdefixArray4D<real> Vs) {
   idfx::pushRegion("Mpi::ExchangeX1");
 
   // Load  the buffers with data
@@ -342,23 +512,23 @@ void Mpi::ExchangeX1(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
   MPI_Request recvRequest[2];
 
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,0,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,0,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Isend(BufferSendX1[faceRight].data(), bufferSizeX1, realMPI, procSend, 100,
-                mygrid->CartComm, &sendRequest[0]));
+                comm, &sendRequest[0]));
 
   MPI_SAFE_CALL(MPI_Irecv(BufferRecvX1[faceLeft].data(), bufferSizeX1, realMPI, procRecv, 100,
-                mygrid->CartComm, &recvRequest[0]));
+                comm, &recvRequest[0]));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,0,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,0,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Isend(BufferSendX1[faceLeft].data(), bufferSizeX1, realMPI, procSend, 101,
-                mygrid->CartComm, &sendRequest[1]));
+                comm, &sendRequest[1]));
 
   MPI_SAFE_CALL(MPI_Irecv(BufferRecvX1[faceRight].data(), bufferSizeX1, realMPI, procRecv, 101,
-                mygrid->CartComm, &recvRequest[1]));
+                comm, &recvRequest[1]));
 
   // Wait for recv to complete (we don't care about the sends)
   MPI_Waitall(2, recvRequest, recvStatus);
@@ -367,19 +537,19 @@ void Mpi::ExchangeX1(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
   MPI_Status status;
   // Send to the right
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,0,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,0,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Sendrecv(BufferSendX1[faceRight].data(), bufferSizeX1, realMPI, procSend, 100,
                 BufferRecvX1[faceLeft].data(), bufferSizeX1, realMPI, procRecv, 100,
-                mygrid->CartComm, &status));
+                comm, &status));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,0,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,0,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Sendrecv(BufferSendX1[faceLeft].data(), bufferSizeX1, realMPI, procSend, 101,
                 BufferRecvX1[faceRight].data(), bufferSizeX1, realMPI, procRecv, 101,
-                mygrid->CartComm, &status));
+                comm, &status));
   #endif
 #endif
   myTimer += MPI_Wtime();
@@ -446,7 +616,8 @@ myTimer -= MPI_Wtime();
 }
 
 
-void Mpi::ExchangeX2(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
+template<typename T>
+void Mpi::ExchangeX2(IdefixArray4D<T> Vc, IdefixArray4D<real> Vs) {
   idfx::pushRegion("Mpi::ExchangeX2");
 
   // Load  the buffers with data
@@ -540,23 +711,23 @@ void Mpi::ExchangeX2(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
   MPI_Request recvRequest[2];
 
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,1,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,1,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Isend(BufferSendX2[faceRight].data(), bufferSizeX2, realMPI, procSend, 100,
-                mygrid->CartComm, &sendRequest[0]));
+                comm, &sendRequest[0]));
 
   MPI_SAFE_CALL(MPI_Irecv(BufferRecvX2[faceLeft].data(), bufferSizeX2, realMPI, procRecv, 100,
-                mygrid->CartComm, &recvRequest[0]));
+                comm, &recvRequest[0]));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,1,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,1,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Isend(BufferSendX2[faceLeft].data(), bufferSizeX2, realMPI, procSend, 101,
-                mygrid->CartComm, &sendRequest[1]));
+                comm, &sendRequest[1]));
 
   MPI_SAFE_CALL(MPI_Irecv(BufferRecvX2[faceRight].data(), bufferSizeX2, realMPI, procRecv, 101,
-                mygrid->CartComm, &recvRequest[1]));
+                comm, &recvRequest[1]));
 
   // Wait for recv to complete (we don't care about the sends)
   MPI_Waitall(2, recvRequest, recvStatus);
@@ -564,20 +735,20 @@ void Mpi::ExchangeX2(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
   #else
   MPI_Status status;
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,1,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,1,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Sendrecv(BufferSendX2[faceRight].data(), bufferSizeX2, realMPI, procSend, 200,
                 BufferRecvX2[faceLeft].data(), bufferSizeX2, realMPI, procRecv, 200,
-                mygrid->CartComm, &status));
+                comm, &status));
 
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,1,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,1,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Sendrecv(BufferSendX2[faceLeft].data(), bufferSizeX2, realMPI, procSend, 201,
                 BufferRecvX2[faceRight].data(), bufferSizeX2, realMPI, procRecv, 201,
-                mygrid->CartComm, &status));
+                comm, &status));
   #endif
 #endif
   myTimer += MPI_Wtime();
@@ -643,7 +814,8 @@ void Mpi::ExchangeX2(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
 }
 
 
-void Mpi::ExchangeX3(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
+template<typename T>
+void Mpi::ExchangeX3(IdefixArray4D<T> Vc, IdefixArray4D<real> Vs) {
   idfx::pushRegion("Mpi::ExchangeX3");
 
 
@@ -741,23 +913,23 @@ void Mpi::ExchangeX3(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
   MPI_Request recvRequest[2];
 
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,2,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,2,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Isend(BufferSendX3[faceRight].data(), bufferSizeX3, realMPI, procSend, 100,
-                mygrid->CartComm, &sendRequest[0]));
+                comm, &sendRequest[0]));
 
   MPI_SAFE_CALL(MPI_Irecv(BufferRecvX3[faceLeft].data(), bufferSizeX3, realMPI, procRecv, 100,
-                mygrid->CartComm, &recvRequest[0]));
+                comm, &recvRequest[0]));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,2,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,2,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Isend(BufferSendX3[faceLeft].data(), bufferSizeX3, realMPI, procSend, 101,
-                mygrid->CartComm, &sendRequest[1]));
+                comm, &sendRequest[1]));
 
   MPI_SAFE_CALL(MPI_Irecv(BufferRecvX3[faceRight].data(), bufferSizeX3, realMPI, procRecv, 101,
-                mygrid->CartComm, &recvRequest[1]));
+                comm, &recvRequest[1]));
 
   // Wait for recv to complete (we don't care about the sends)
   MPI_Waitall(2, recvRequest, recvStatus);
@@ -765,19 +937,19 @@ void Mpi::ExchangeX3(IdefixArray4D<real> Vc, IdefixArray4D<real> Vs) {
   #else
   MPI_Status status;
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,2,1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,2,1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Sendrecv(BufferSendX3[faceRight].data(), bufferSizeX3, realMPI, procSend, 300,
                 BufferRecvX3[faceLeft].data(), bufferSizeX3, realMPI, procRecv, 300,
-                mygrid->CartComm, &status));
+                comm, &status));
 
   // Send to the left
   // We receive from procRecv, and we send to procSend
-  MPI_SAFE_CALL(MPI_Cart_shift(mygrid->CartComm,2,-1,&procRecv,&procSend ));
+  MPI_SAFE_CALL(MPI_Cart_shift(comm,2,-1,&procRecv,&procSend ));
 
   MPI_SAFE_CALL(MPI_Sendrecv(BufferSendX3[faceLeft].data(), bufferSizeX3, realMPI, procSend, 301,
                 BufferRecvX3[faceRight].data(), bufferSizeX3, realMPI, procRecv, 301,
-                mygrid->CartComm, &status));
+                comm, &status));
   #endif
 #endif
   myTimer += MPI_Wtime();
@@ -961,6 +1133,14 @@ void Mpi::SigErrorHandler(int nSignum, siginfo_t* si, void* vcontext) {
 // This routine check that all of the processes are synced.
 // Returns true if this is the case, false otherwise
 
+bool Mpi::CanExchangeAll() {
+#ifdef MPI_PERSISTENT
+  return(true);
+#else
+  return(false);
+#endif
+}
+
 bool Mpi::CheckSync(real timeout) {
   // If no parallelism, then we're in sync!
   if(idfx::psize == 1) return(true);
@@ -990,3 +1170,17 @@ bool Mpi::CheckSync(real timeout) {
 
   return(true);
 }
+
+// Exchanges of real arrays, and of the realStore arrays of the fluids in mixed precision
+template void Mpi::ExchangeAllBegin(IdefixArray4D<real>);
+template void Mpi::ExchangeAllEnd(IdefixArray4D<real>);
+template void Mpi::ExchangeX1(IdefixArray4D<real>, IdefixArray4D<real>);
+template void Mpi::ExchangeX2(IdefixArray4D<real>, IdefixArray4D<real>);
+template void Mpi::ExchangeX3(IdefixArray4D<real>, IdefixArray4D<real>);
+#ifdef MIXED_PRECISION
+template void Mpi::ExchangeAllBegin(IdefixArray4D<realStore>);
+template void Mpi::ExchangeAllEnd(IdefixArray4D<realStore>);
+template void Mpi::ExchangeX1(IdefixArray4D<realStore>, IdefixArray4D<real>);
+template void Mpi::ExchangeX2(IdefixArray4D<realStore>, IdefixArray4D<real>);
+template void Mpi::ExchangeX3(IdefixArray4D<realStore>, IdefixArray4D<real>);
+#endif
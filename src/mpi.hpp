@@ -78,7 +78,8 @@ class Buffer {
     this->pointer += ninjnk;
   }
 
-  void Pack(IdefixArray4D<real>& in,
+  template<typename T>
+  void Pack(IdefixArray4D<T>& in,
        IdefixArray1D<int>& map,
        std::pair<int,int> ib,
        std::pair<int,int> jb,
@@ -149,7 +150,8 @@ class Buffer {
     this->pointer += ninjnk;
   }
 
-  void Unpack(IdefixArray4D<real>& out,
+  template<typename T>
+  void Unpack(IdefixArray4D<T>& out,
        IdefixArray1D<int>& map,
        std::pair<int,int> ib,
        std::pair<int,int> jb,
@@ -185,14 +187,24 @@ class Mpi {
  public:
   Mpi() = default;
   // MPI Exchange functions
-  void ExchangeAll();   ///< Exchange boundary elements in all directions (todo)
-  void ExchangeX1(IdefixArray4D<real> inputVc,
+  // (the cell-centered arrays are either real or realStore arrays, see mpi.cpp)
+  template<typename T>
+  void ExchangeAllBegin(IdefixArray4D<T> inputVc);
+                                      ///< Start exchanging cell-centered elements in all directions
+  template<typename T>
+  void ExchangeAllEnd(IdefixArray4D<T> inputVc);
+                                      ///< Complete the exchanges started by ExchangeAllBegin
+  bool ExchangeAllReceived();         ///< Whether the messages of ExchangeAllBegin have arrived
+  template<typename T>
+  void ExchangeX1(IdefixArray4D<T> inputVc,
                   IdefixArray4D<real> inputVs = IdefixArray4D<real>());
                                       ///< Exchange boundary elements in the X1 direction
-  void ExchangeX2(IdefixArray4D<real> inputVc,
+  template<typename T>
+  void ExchangeX2(IdefixArray4D<T> inputVc,
                 IdefixArray4D<real> inputVs = IdefixArray4D<real>());
                                     ///< Exchange boundary elements in the X2 direction
-  void ExchangeX3(IdefixArray4D<real> inputVc,
+  template<typename T>
+  void ExchangeX3(IdefixArray4D<T> inputVc,
                 IdefixArray4D<real> inputVs = IdefixArray4D<real>());
                                       ///< Exchange boundary elements in the X3 direction
 
@@ -206,6 +218,9 @@ class Mpi {
   // Check that MPI processes are synced
   static bool CheckSync(real);
 
+  // Whether ExchangeAllBegin is available (it requires persistent communications)
+  static bool CanExchangeAll();
+
 
   // Destructor
   ~Mpi();
@@ -218,6 +233,7 @@ class Mpi {
 
   static int nInstances;     // total number of mpi instances in the code
   int thisInstance;          // unique number of the current instance
+  MPI_Comm comm;             // communicator of the exchanges of this instance
   int nReferences;           // # of references to this instance
   bool isInitialized{false};
 
@@ -247,6 +263,11 @@ class Mpi {
   int bufferSizeX3;
 
   bool haveVs{false};
+  bool exchangeAllPending{false};  //< whether ExchangeAllBegin has been called without ExchangeAllEnd
+
+  // Ranges of the cell-centered region sent (or received) in direction dir by ExchangeAll
+  void GetExchangeRange(int dir, BoundarySide side, bool isGhost,
+                        std::pair<int,int> range[3]);
 
   // Requests for MPI persistent communications
   MPI_Request sendRequestX1[2];
@@ -17,9 +17,16 @@
   #error "Missing the <filesystem> header."
 #endif
 #include <iomanip>
+#include <map>
+#include <memory>
 #include <string>
 #include <cstdio>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
 #include "dump.hpp"
+#include "dumpRemap.hpp"
 #include "version.hpp"
 #include "dataBlockHost.hpp"
 #include "gridHost.hpp"
@@ -31,6 +38,57 @@
 #define  FILENAMESIZE   256
 #define  HEADERSIZE 128
 
+// The write routines also run on the writer thread of the asynchronous dumps, which should not
+// stop the code by itself: their errors are thrown on this thread, and reported by the main
+// thread when it waits for the write (Dump::Fence)
+namespace {
+thread_local bool inWriterThread = false;
+
+void WriteError(const std::string &msg) {
+  if(inWriterThread) throw std::runtime_error(msg);
+  IDEFIX_ERROR(msg);
+}
+} // namespace
+
+#ifdef WITH_MPI
+#define WRITE_SAFE_CALL(cmd) {                                        \
+  int mpiErrNo = (cmd);                                               \
+  if (MPI_SUCCESS != mpiErrNo) {                                      \
+    char msg[MPI_MAX_ERROR_STRING];                                   \
+    int len;                                                          \
+    MPI_Error_string(mpiErrNo, msg, &len);                            \
+    WriteError("MPI failed with error code :"+std::to_string(mpiErrNo)  \
+               +" "+std::string(msg));                                \
+  }                                                                   \
+}
+#endif
+
+DumpRecord::DumpRecord(std::string name, DataType type, int size, const void *in):
+            name{name}, type{type} {
+  size_t elemSize = sizeof(int);
+  if(type == DoubleType) elemSize = sizeof(double);
+  if(type == SingleType) elemSize = sizeof(float);
+  if(type == BoolType) elemSize = sizeof(bool);
+  dim[0] = size;
+  serialData.resize(size*elemSize);
+  std::memcpy(serialData.data(), in, size*elemSize);
+}
+
+DumpRecord::DumpRecord(std::string name, int nx[3], int nxtot[3],
+                       IdfxDataDescriptor *descriptor):
+            name{name}, distributed{true}, descriptor{descriptor} {
+  #ifndef SINGLE_PRECISION
+  type = DoubleType;
+  #else
+  type = SingleType;
+  #endif
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    dim[dir] = nx[dir];
+    gdim[dir] = nxtot[dir];
+  }
+  distributedData.resize(static_cast<size_t>(nx[IDIR])*nx[JDIR]*nx[KDIR]);
+}
+
 // Register a variable to be dumped (and read)
 
 void Dump::RegisterVariable(IdefixArray3D<real>& in,
@@ -63,6 +121,16 @@ void  Dump::RegisterVariable(IdefixHostArray4D<real>& in,
     dumpFieldMap.emplace(name, DumpField(in, varnum, loc, dir));
 }
 
+#ifdef MIXED_PRECISION
+void  Dump::RegisterVariable(IdefixArray4D<realStore>& in,
+                        std::string name,
+                        int varnum,
+                        int dir,
+                        DumpField::ArrayLocation loc) {
+    dumpFieldMap.emplace(name, DumpField(in, varnum, loc, dir));
+}
+#endif
+
 
 
 void Dump::CreateMPIDataType(GridBox gb, bool read) {
@@ -194,6 +262,16 @@ void Dump::Init(DataBlock *datain) {
   this->scrch = new real[nmax];
 
   #ifdef WITH_MPI
+    // Dumps use their own communicator, so that they can be written by the writer thread
+    // (duplicated from the grid communicator, which only spans a part of the processes on the
+    // static refinement levels)
+    MPI_SAFE_CALL(MPI_Comm_dup(data->mygrid->CartComm, &ioComm));
+    if(asyncWrite && !idfx::mpiThreadMultiple) {
+      IDEFIX_WARNING("Asynchronous dumps require an MPI library supporting "
+                     "MPI_THREAD_MULTIPLE. Falling back to synchronous dumps.");
+      asyncWrite = false;
+    }
+
     Grid *grid = data->mygrid;
     GridBox gb;
     for(int dir = 0; dir < 3 ; dir++) {
@@ -211,6 +289,13 @@ void Dump::Init(DataBlock *datain) {
   this->RegisterVariable(&geometry, "geometry");
   this->RegisterVariable(periodicity, "periodicity", 3);
 
+  // Load profile of the grid, used to balance the decomposition when restarting
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    std::vector<double> &profile = data->mygrid->loadProfile[dir];
+    this->RegisterVariable(profile.data(), "loadProfileX"+std::to_string(dir+1),
+                           static_cast<int>(profile.size()));
+  }
+
   idfx::popRegion();
 }
 
@@ -225,6 +310,15 @@ Dump::Dump(Input &input, DataBlock *datain) {
   } else {
     outputDirectory = "./";
   }
+  asyncWrite = input.GetOrSet<bool>("Output","dmp_async",0,false);
+  #ifndef WITH_ASYNC_DUMPS
+    if(asyncWrite) {
+      IDEFIX_WARNING("Asynchronous dumps require Idefix_ASYNC_DUMPS to be enabled when "
+                     "configuring. Falling back to synchronous dumps.");
+      asyncWrite = false;
+    }
+  #endif
+  remapRequested = input.remapRequested;
   Init(datain);
 }
 
@@ -237,21 +331,26 @@ Dump::Dump(DataBlock *datain) {
 }
 
 Dump::~Dump() {
+  // Make sure that the last dump is complete before the code exits
+  Fence();
   delete scrch;
+  #ifdef WITH_MPI
+    MPI_Comm_free(&ioComm);
+  #endif
 }
 
 void Dump::WriteString(IdfxFileHandler fileHdl, char *str, int size) {
   #ifdef WITH_MPI
     MPI_Status status;
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, this->offset,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, this->offset,
                                     MPI_BYTE, MPI_CHAR, "native", MPI_INFO_NULL ));
     if(idfx::prank==0) {
-      MPI_SAFE_CALL(MPI_File_write(fileHdl, str, size, MPI_CHAR, &status));
+      WRITE_SAFE_CALL(MPI_File_write(fileHdl, str, size, MPI_CHAR, &status));
     }
     offset=offset+size;
   #else
     if(fwrite (str, sizeof(char), size, fileHdl) != size) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
   #endif
 }
@@ -276,26 +375,26 @@ void Dump::WriteSerial(IdfxFileHandler fileHdl, int ndim, int *dim,
     MPI_Datatype MpiType;
 
     // Write data type
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                     MPI_CHAR, "native", MPI_INFO_NULL ));
     if(idfx::prank==0) {
-      MPI_SAFE_CALL(MPI_File_write(fileHdl, &type, 1, MPI_INT, &status));
+      WRITE_SAFE_CALL(MPI_File_write(fileHdl, &type, 1, MPI_INT, &status));
     }
     offset=offset+sizeof(int);
 
     // Write dimensions
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                     MPI_CHAR, "native", MPI_INFO_NULL ));
     if(idfx::prank==0) {
-      MPI_SAFE_CALL(MPI_File_write(fileHdl, &ndim, 1, MPI_INT, &status));
+      WRITE_SAFE_CALL(MPI_File_write(fileHdl, &ndim, 1, MPI_INT, &status));
     }
     offset=offset+sizeof(int);
 
     for(int n = 0 ; n < ndim ; n++) {
-      MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+      WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                       MPI_CHAR, "native", MPI_INFO_NULL ));
       if(idfx::prank==0) {
-        MPI_SAFE_CALL(MPI_File_write(fileHdl, dim+n, 1, MPI_INT, &status));
+        WRITE_SAFE_CALL(MPI_File_write(fileHdl, dim+n, 1, MPI_INT, &status));
       }
       offset=offset+sizeof(int);
       ntot = ntot * dim[n];
@@ -305,11 +404,11 @@ void Dump::WriteSerial(IdfxFileHandler fileHdl, int ndim, int *dim,
     if(type == DoubleType) MpiType=MPI_DOUBLE;
     if(type == SingleType) MpiType=MPI_FLOAT;
     if(type == IntegerType) MpiType=MPI_INT;
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                     MPI_CHAR, "native", MPI_INFO_NULL ));
 
     if(idfx::prank==0) {
-      MPI_SAFE_CALL(MPI_File_write(fileHdl, data, ntot, MpiType, &status));
+      WRITE_SAFE_CALL(MPI_File_write(fileHdl, data, ntot, MpiType, &status));
     }
     // increment offset accordingly
     offset += ntot*size;
@@ -317,21 +416,21 @@ void Dump::WriteSerial(IdfxFileHandler fileHdl, int ndim, int *dim,
   #else
     // Write type of data
     if(fwrite(&type, sizeof(int), 1, fileHdl) != 1) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
     // Write dimensions of array
     if(fwrite(&ndim, sizeof(int), 1, fileHdl) != 1) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
     for(int n = 0 ; n < ndim ; n++) {
       if(fwrite(dim+n, sizeof(int), 1, fileHdl) != 1) {
-        IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+        WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
       }
       ntot = ntot * dim[n];
     }
     // Write raw data
     if(fwrite(data, size, ntot, fileHdl) != ntot) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
   #endif
 }
@@ -357,26 +456,26 @@ void Dump::WriteDistributed(IdfxFileHandler fileHdl, int ndim, int *dim, int *gd
     int64_t nglob = 1;
 
     // Write data type
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                     MPI_CHAR, "native", MPI_INFO_NULL ));
     if(idfx::prank==0) {
-      MPI_SAFE_CALL(MPI_File_write(fileHdl, &type, 1, MPI_INT, &status));
+      WRITE_SAFE_CALL(MPI_File_write(fileHdl, &type, 1, MPI_INT, &status));
     }
     offset=offset+sizeof(int);
 
     // Write dimensions
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                     MPI_CHAR, "native", MPI_INFO_NULL ));
     if(idfx::prank==0) {
-      MPI_SAFE_CALL(MPI_File_write(fileHdl, &ndim, 1, MPI_INT, &status));
+      WRITE_SAFE_CALL(MPI_File_write(fileHdl, &ndim, 1, MPI_INT, &status));
     }
     offset=offset+sizeof(int);
 
     for(int n = 0 ; n < ndim ; n++) {
-      MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
+      WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MPI_BYTE,
                                       MPI_CHAR, "native", MPI_INFO_NULL ));
       if(idfx::prank==0) {
-        MPI_SAFE_CALL(MPI_File_write(fileHdl, gdim+n, 1, MPI_INT, &status));
+        WRITE_SAFE_CALL(MPI_File_write(fileHdl, gdim+n, 1, MPI_INT, &status));
       }
       offset=offset+sizeof(int);
       ntot = ntot * dim[n];
@@ -387,9 +486,9 @@ void Dump::WriteDistributed(IdfxFileHandler fileHdl, int ndim, int *dim, int *gd
     if(type == DoubleType) MpiType=MPI_DOUBLE;
     if(type == SingleType) MpiType=MPI_FLOAT;
 
-    MPI_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MpiType,
+    WRITE_SAFE_CALL(MPI_File_set_view(fileHdl, offset, MpiType,
                                     descriptor, "native", MPI_INFO_NULL ));
-    MPI_SAFE_CALL(MPI_File_write_all(fileHdl, data, ntot, MpiType, MPI_STATUS_IGNORE));
+    WRITE_SAFE_CALL(MPI_File_write_all(fileHdl, data, ntot, MpiType, MPI_STATUS_IGNORE));
 
     offset=offset+nglob*sizeof(real);
 
@@ -397,24 +496,24 @@ void Dump::WriteDistributed(IdfxFileHandler fileHdl, int ndim, int *dim, int *gd
     // Write type of data
 
     if(fwrite(&type, sizeof(int), 1, fileHdl) != 1) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
 
     // Write dimensions of array
     // (in serial, dim and gdim are identical, so no need to differentiate)
     if(fwrite(&ndim, sizeof(int), 1, fileHdl) != 1) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
     for(int n = 0 ; n < ndim ; n++) {
       if(fwrite(dim+n, sizeof(int), 1, fileHdl) != 1) {
-        IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+        WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
       }
       ntot = ntot * dim[n];
     }
 
     // Write raw data
     if(fwrite(data, sizeof(real), ntot, fileHdl) != ntot) {
-      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+      WriteError("Unable to write to file. Check your filesystem permissions and disk quota.");
     }
   #endif
 }
@@ -584,6 +683,36 @@ void Dump::ReadDistributed(IdfxFileHandler fileHdl, int ndim, int *dim, int *gdi
   #endif
 }
 
+// Read the box of size "size" starting at "start" of a distributed field of global size gdim
+void Dump::ReadSlab(IdfxFileHandler fileHdl, int ndim, int *gdim,
+                    std::array<int,3> start, std::array<int,3> size, real *data) {
+  IdfxDataDescriptor slab{};
+  #ifdef WITH_MPI
+    int gsize[3];
+    int subsize[3];
+    int substart[3];
+    for(int dir = 0; dir < 3 ; dir++) {
+      gsize[2-dir] = gdim[dir];
+      subsize[2-dir] = size[dir];
+      substart[2-dir] = start[dir];
+    }
+    MPI_SAFE_CALL(MPI_Type_create_subarray(3, gsize, subsize, substart,
+                                           MPI_ORDER_C, realMPI, &slab));
+    MPI_SAFE_CALL(MPI_Type_commit(&slab));
+  #else
+    // Without MPI, the slab is the whole field
+    for(int dir = 0; dir < 3 ; dir++) {
+      if(start[dir] != 0 || size[dir] != gdim[dir]) {
+        IDEFIX_ERROR("Dump::ReadSlab: a serial run should read the whole field");
+      }
+    }
+  #endif
+  ReadDistributed(fileHdl, ndim, size.data(), gdim, slab, data);
+  #ifdef WITH_MPI
+    MPI_SAFE_CALL(MPI_Type_free(&slab));
+  #endif
+}
+
 // Helper function to convert filesystem::file_time into std::time_t
 // see https://stackoverflow.com/questions/56788745/
 // This conversion "hack" is required in C++17 as no proper conversion bewteen
@@ -625,6 +754,82 @@ int Dump::GetLastDumpInDirectory(fs::path &directory) {
   }
   return(num);
 }
+// Read the load profile of the grid from a restart dump. This is called by the Grid before the
+// DataBlock (and hence the Dump object) exists, so the file is scanned serially by rank 0.
+bool Dump::ReadLoadProfile(Input &input, std::array<std::vector<double>,3> &profile) {
+  idfx::pushRegion("Dump::ReadLoadProfile");
+  fs::path readDir = "./";
+  if(input.CheckEntry("Output","dmp_dir")>=0) {
+    readDir = input.Get<std::string>("Output","dmp_dir",0);
+  }
+  int readNumber = input.restartFileNumber;
+  if(readNumber<0) {
+    readNumber = GetLastDumpInDirectory(readDir);
+    if(readNumber<0 && readDir.compare("./")!=0) {
+      readDir = ".";
+      readNumber = GetLastDumpInDirectory(readDir);
+    }
+    if(readNumber<0) {
+      idfx::popRegion();
+      return(false);
+    }
+  }
+
+  std::stringstream ssFileName;
+  ssFileName << "dump." << std::setfill('0') << std::setw(4) << readNumber << ".dmp";
+  fs::path filename = readDir/ssFileName.str();
+
+  int numFound = 0;
+  if(idfx::prank==0) {
+    FILE *fileHdl = fopen(filename.c_str(),"rb");
+    if(fileHdl != NULL) {
+      fseek(fileHdl, HEADERSIZE, SEEK_SET);
+      while(true) {
+        char fieldName[NAMESIZE+1];
+        int type, ndim;
+        int dim[4];
+        if(fread(fieldName, sizeof(char), NAMESIZE, fileHdl) < NAMESIZE) break;
+        fieldName[NAMESIZE] = 0;
+        if(fread(&type, sizeof(int), 1, fileHdl) < 1) break;
+        if(fread(&ndim, sizeof(int), 1, fileHdl) < 1) break;
+        if(ndim<1 || ndim>4) break;
+        if(fread(dim, sizeof(int), ndim, fileHdl) < static_cast<size_t>(ndim)) break;
+
+        std::string name(fieldName);
+        if(name.compare("eof") == 0) break;
+
+        int64_t ntot = 1;
+        for(int n = 0 ; n < ndim ; n++) ntot *= dim[n];
+        int size = sizeof(double);
+        if(type == SingleType) size=sizeof(float);
+        if(type == IntegerType) size=sizeof(int);
+        if(type == BoolType) size=sizeof(bool);
+
+        bool isProfile = false;
+        for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+          if(name.compare("loadProfileX"+std::to_string(dir+1)) == 0
+              && type == DoubleType && ntot == static_cast<int64_t>(profile[dir].size())) {
+            isProfile = (fread(profile[dir].data(), sizeof(double), ntot, fileHdl)
+                          == static_cast<size_t>(ntot));
+            if(isProfile) numFound++;
+          }
+        }
+        if(!isProfile) fseek(fileHdl, ntot*size, SEEK_CUR);
+      }
+      fclose(fileHdl);
+    }
+  }
+  #ifdef WITH_MPI
+    MPI_Bcast(&numFound, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+      MPI_Bcast(profile[dir].data(), profile[dir].size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+  #endif
+
+  idfx::popRegion();
+  return(numFound == DIMENSIONS);
+}
+
 bool Dump::Read(Output& output, int readNumber ) {
   fs::path filename;
   int nx[3];
@@ -637,6 +842,9 @@ bool Dump::Read(Output& output, int readNumber ) {
 
   idfx::pushRegion("Dump::Read");
 
+  // Do not read a file which may still be in the writing process
+  Fence();
+
   fs::path readDir = this->outputDirectory;
 
   if(readNumber<0) {
@@ -690,25 +898,58 @@ bool Dump::Read(Output& output, int readNumber ) {
 #endif
 
   // First thing is compare the total domain size
+  std::array<std::vector<real>,3> xlDump;
+  std::array<std::vector<real>,3> xrDump;
   for(int dir=0 ; dir < 3; dir++) {
     ReadNextFieldProperties(fileHdl, ndim, nx, type, fieldName);
     if(ndim>1) IDEFIX_ERROR("Wrong coordinate array dimensions while reading restart dump");
-    if(nx[0] != data->mygrid->np_int[dir]) {
+    if(nx[0] != data->mygrid->np_int[dir] && !remapRequested) {
       idfx::cout << "dir " << dir << ", restart has " << nx[0] << " points " << std::endl;
-      IDEFIX_ERROR("Domain size from the restart dump is different from the current one");
+      IDEFIX_ERROR("Domain size from the restart dump is different from the current one "
+                   "(use -remap to remap the dump onto the current grid)");
     }
 
     // Read coordinates
-    ReadSerial(fileHdl, ndim, nx, type, scrch);
+    std::vector<real> xDump(nx[0]);
+    ReadSerial(fileHdl, ndim, nx, type, xDump.data());
 
-    // skip left and right edges arrays
-    for (int iside=0; iside < 2; iside++) {
-      ReadNextFieldProperties(fileHdl, ndim, nx, type, fieldName);
-      ReadSerial(fileHdl, ndim, nx, type, scrch);
-    }
-    // Todo: check that coordinates are identical
+    // Read left and right edges arrays
+    ReadNextFieldProperties(fileHdl, ndim, nx, type, fieldName);
+    xlDump[dir].resize(nx[0]);
+    ReadSerial(fileHdl, ndim, nx, type, xlDump[dir].data());
+    ReadNextFieldProperties(fileHdl, ndim, nx, type, fieldName);
+    xrDump[dir].resize(nx[0]);
+    ReadSerial(fileHdl, ndim, nx, type, xrDump[dir].data());
   }
 
+  // Remap the dump if its grid is not the current one
+  std::unique_ptr<DumpRemap> remap;
+  if(remapRequested) {
+    remap = std::make_unique<DumpRemap>(data, xlDump, xrDump);
+    if(remap->IsIdentity()) remap.reset();
+  }
+
+  // Components of the face-centered fields, which are remapped together
+  struct FaceGroup {
+    std::array<DumpRemap::Box,3> component;
+    std::array<const DumpField *,3> field{nullptr, nullptr, nullptr};
+  };
+  std::map<std::string, FaceGroup> faceGroups;
+
+  // Load the active part of a distributed field of local size n
+  auto loadField = [&](const DumpField &scalar, const int *n, const real *in) {
+    auto toRead = scalar.GetHostField<IdefixHostArray3D<real>>();
+    for(int k = 0; k < n[KDIR]; k++) {
+      for(int j = 0 ; j < n[JDIR]; j++) {
+        for(int i = 0; i < n[IDIR]; i++) {
+          toRead(k+data->beg[KDIR],j+data->beg[JDIR],i+data->beg[IDIR]) =
+                                                        in[i + j*n[IDIR] + k*n[IDIR]*n[JDIR]];
+        }
+      }
+    }
+    scalar.SyncFrom(toRead);
+  };
+
   std::unordered_set<std::string> notFound {};
   for(auto it = dumpFieldMap.begin(); it != dumpFieldMap.end(); it++) {
     notFound.insert(it->first);
@@ -730,7 +971,28 @@ bool Dump::Read(Output& output, int readNumber ) {
         // This key has been registered
         notFound.erase(fieldName);
         DumpField &scalar = it->second;
-        if(scalar.GetType() == DumpField::Type::IdefixArray) {
+        if(scalar.GetType() == DumpField::Type::IdefixArray && remap) {
+          // Distributed idefix array on a different grid: read the slab we need and remap it
+          int direction = scalar.GetDirection();
+          std::array<int,3> size = remap->slabSize;
+          if(scalar.GetLocation() == DumpField::ArrayLocation::Edge) {
+            IDEFIX_ERROR("Edge-centered field "+fieldName+" cannot be remapped onto a new grid");
+          }
+          if(scalar.GetLocation() == DumpField::ArrayLocation::Face) {
+            size[direction]++;   // Extra cell in the dir direction for face-centered fields
+          }
+          DumpRemap::Box box(size);
+          ReadSlab(fileHdl, ndim, nxglob, remap->slabStart, size, box.v.data());
+          if(scalar.GetLocation() == DumpField::ArrayLocation::Center) {
+            remap->RemapCell(box);
+            loadField(scalar, box.n.data(), box.v.data());
+          } else {
+            // Components are named after their direction ("BX1s", "BX2s"...)
+            FaceGroup &group = faceGroups[fieldName.substr(0, fieldName.size()-2)];
+            group.component[direction] = std::move(box);
+            group.field[direction] = &scalar;
+          }
+        } else if(scalar.GetType() == DumpField::Type::IdefixArray) {
           // Distributed idefix array
           int direction = scalar.GetDirection();
 
@@ -755,17 +1017,11 @@ bool Dump::Read(Output& output, int readNumber ) {
           } else if(scalar.GetLocation() == DumpField::ArrayLocation::Edge) {
             ReadDistributed(fileHdl, ndim, nx, nxglob, descER[direction], scrch);
           }
-          auto toRead = scalar.GetHostField<IdefixHostArray3D<real>>();
           // Load the scratch space in designated field
-          for(int k = 0; k < nx[KDIR]; k++) {
-            for(int j = 0 ; j < nx[JDIR]; j++) {
-              for(int i = 0; i < nx[IDIR]; i++) {
-                toRead(k+data->beg[KDIR],j+data->beg[JDIR],i+data->beg[IDIR]) =
-                                                        scrch[i + j*nx[IDIR] + k*nx[IDIR]*nx[JDIR]];
-              }
-            }
-          }
-          scalar.SyncFrom(toRead);
+          loadField(scalar, nx, scrch);
+        } else if(remap && nxglob[0] != scalar.GetSize() && fieldName.rfind("loadProfile",0)==0) {
+          // The load profile of the dump grid does not apply to the current grid
+          Skip(fileHdl, ndim, nxglob, type);
         } else {
           // Fundamental Type
           // Check that size matches
@@ -786,6 +1042,20 @@ bool Dump::Read(Output& output, int readNumber ) {
       }
     }
   }
+
+  // Face-centered fields are remapped once all of their components are known
+  for(auto &[name, group] : faceGroups) {
+    for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+      if(group.field[dir] == nullptr) {
+        IDEFIX_ERROR("Cannot remap "+name+"*s: some of its components are missing in the dump");
+      }
+    }
+    remap->RemapFace(group.component);
+    for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+      loadField(*group.field[dir], group.component[dir].n.data(), group.component[dir].v.data());
+    }
+  }
+
   if (notFound.size() > 0) {
     std::stringstream msg {};
     msg << "The following fields were not found in " << filename << ": ";
@@ -801,6 +1071,7 @@ bool Dump::Read(Output& output, int readNumber ) {
   #endif
 
   idfx::cout << "done in " << timer.seconds() << " s." << std::endl;
+  if(remap) idfx::cout << "Dump: the restart dump was remapped on the current grid." << std::endl;
   idfx::cout << "Restarting from t=" << data->t << "." << std::endl;
 
   idfx::popRegion();
@@ -820,10 +1091,13 @@ int Dump::Write(Output& output) {
   #else
   const DataType realType = SingleType;
   #endif
-  IdfxFileHandler fileHdl;
+  IdfxFileHandler fileHdl{};
 
   idfx::pushRegion("Dump::Write");
 
+  // Only one dump can be written at a time
+  Fence();
+
   idfx::cout << "Dump: Write file n " << dumpFileNumber << "..." << std::flush;
 
   // Reset timer
@@ -838,64 +1112,39 @@ int Dump::Write(Output& output) {
 
   dumpFileNumber++;   // For next one
 
-  // Check if file exists, if yes, delete it
-  if(idfx::prank==0) {
-    if(fs::exists(filename)) {
-      fs::remove(filename);
-    }
+  // Records are either written as soon as they are ready, or copied in host memory and written
+  // by the writer thread
+  std::vector<DumpRecord> records;
+  if(!asyncWrite) {
+    fileHdl = OpenForWrite(filename);
   }
+  auto addRecord = [&](DumpRecord &record) {
+    if(asyncWrite) {
+      records.push_back(std::move(record));
+    } else {
+      WriteRecord(fileHdl, record);
+    }
+  };
 
-  // open file
-#ifdef WITH_MPI
-  MPI_Barrier(MPI_COMM_WORLD);
-  // Open file for creating, return error if file already exists.
-  MPI_SAFE_CALL(MPI_File_open(MPI_COMM_WORLD, filename.c_str(),
-                              MPI_MODE_CREATE | MPI_MODE_RDWR
-                              | MPI_MODE_EXCL | MPI_MODE_UNIQUE_OPEN,
-                              MPI_INFO_NULL, &fileHdl));
-  this->offset = 0;
-#else
-  fileHdl = fopen(filename.c_str(),"wb");
-  if(fileHdl == NULL) {
-    std::stringstream msg;
-    msg << "Unable to open file " << filename << std::endl;
-    msg << "Check that you have write access and that you don't exceed your quota." << std::endl;
-    IDEFIX_ERROR(msg);
-  }
-#endif
-  // File is open
   // First thing we need are coordinates: init a host mirror and sync it
   GridHost gridHost(*data->mygrid);
   gridHost.SyncFromDevice();
 
-  // Test endianness
-  std::string endian;
-  int tmp1 = 1;
-  unsigned char *tmp2 = (unsigned char *) &tmp1;
-  if (*tmp2 != 0) {
-    endian = "little";
-  } else {
-    endian = "big";
-  }
-
-  char header[HEADERSIZE];
-  std::snprintf(header, HEADERSIZE, "Idefix %s Dump Data %s endian",
-                IDEFIX_VERSION, endian.c_str());
-  WriteString(fileHdl, header, HEADERSIZE);
-
   for(int dir = 0; dir < 3 ; dir++) {
+    const int np = gridHost.np_int[dir];
+    const int ng = gridHost.nghost[dir];
     // cell centers
     std::snprintf(fieldName, NAMESIZE, "x%d",dir+1);
-    WriteSerial(fileHdl, 1, &gridHost.np_int[dir], realType, fieldName,
-                reinterpret_cast<void*> (gridHost.x[dir].data()+gridHost.nghost[dir]));
+    DumpRecord x(fieldName, realType, np, gridHost.x[dir].data()+ng);
+    addRecord(x);
     // cell left edges
     std::snprintf(fieldName, NAMESIZE, "xl%d",dir+1);
-    WriteSerial(fileHdl, 1, &gridHost.np_int[dir], realType, fieldName,
-                reinterpret_cast<void*> (gridHost.xl[dir].data()+gridHost.nghost[dir]));
+    DumpRecord xl(fieldName, realType, np, gridHost.xl[dir].data()+ng);
+    addRecord(xl);
     // cell right edges
     std::snprintf(fieldName, NAMESIZE, "xr%d",dir+1);
-    WriteSerial(fileHdl, 1, &gridHost.np_int[dir], realType, fieldName,
-                reinterpret_cast<void*> (gridHost.xr[dir].data()+gridHost.nghost[dir]));
+    DumpRecord xr(fieldName, realType, np, gridHost.xr[dir].data()+ng);
+    addRecord(xr);
   }
 
   // Then write raw data from Vc
@@ -929,27 +1178,30 @@ int Dump::Write(Output& output) {
         }
       }
 
-      // Load the dataset in the scratch array
-      for(int k = 0; k < nx[KDIR]; k++) {
-        for(int j = 0 ; j < nx[JDIR]; j++) {
-          for(int i = 0; i < nx[IDIR]; i++) {
-            scrch[i + j*nx[IDIR] + k*nx[IDIR]*nx[JDIR]] = toWrite(k+data->beg[KDIR],
-                                                                  j+data->beg[JDIR],
-                                                                  i+data->beg[IDIR]);
-          }
-        }
-      }
-
+      IdfxDataDescriptor *descriptor = nullptr;
       if(scalar.GetLocation() == DumpField::ArrayLocation::Center) {
-        WriteDistributed(fileHdl, 3, nx, nxtot, fieldName, this->descCW, scrch);
+        descriptor = &this->descCW;
       } else if(scalar.GetLocation() == DumpField::ArrayLocation::Face) {
-        WriteDistributed(fileHdl, 3, nx, nxtot, fieldName, this->descSW[dir], scrch);
+        descriptor = &this->descSW[dir];
       } else if(scalar.GetLocation() == DumpField::ArrayLocation::Edge) {
-         WriteDistributed(fileHdl, 3, nx, nxtot, fieldName, this->descEW[dir], scrch);
+        descriptor = &this->descEW[dir];
       } else {
         IDEFIX_ERROR("Unknown scalar type for dump write");
       }
 
+      // Load the dataset in the record
+      DumpRecord record(fieldName, nx, nxtot, descriptor);
+      real *buffer = record.distributedData.data();
+      for(int k = 0; k < nx[KDIR]; k++) {
+        for(int j = 0 ; j < nx[JDIR]; j++) {
+          for(int i = 0; i < nx[IDIR]; i++) {
+            buffer[i + j*nx[IDIR] + k*nx[IDIR]*nx[JDIR]] = toWrite(k+data->beg[KDIR],
+                                                                   j+data->beg[JDIR],
+                                                                   i+data->beg[IDIR]);
+          }
+        }
+      }
+      addRecord(record);
     } else {
       // Scalar type if a fundamental type, not distributed
       DataType thisType;
@@ -958,28 +1210,131 @@ int Dump::Write(Output& output) {
       if(scalar.GetType()==DumpField::Type::Double) thisType = DataType::DoubleType;
       if(scalar.GetType()==DumpField::Type::Bool) thisType = DataType::BoolType;
 
-      nx[0] = scalar.GetSize();
+      DumpRecord record(fieldName, thisType, scalar.GetSize(), scalar.GetHostField<void*>());
+      addRecord(record);
+    }
+  }
 
-      WriteSerial(fileHdl, 1, nx, thisType, fieldName, scalar.GetHostField<void*>());
+  if(asyncWrite) {
+    // The records are now independent from the state of the code
+    writer = std::thread(&Dump::WriteRecords, this, filename, std::move(records));
+    idfx::cout << "staged in " << timer.seconds() << " s." << std::endl;
+  } else {
+    CloseForWrite(fileHdl);
+    idfx::cout << "done in " << timer.seconds() << " s." << std::endl;
+  }
+
+  idfx::popRegion();
+  // One day, we will have a return code.
+
+  return(0);
+}
+
+IdfxFileHandler Dump::OpenForWrite(const fs::path &filename) {
+  IdfxFileHandler fileHdl;
+  // Check if file exists, if yes, delete it
+  if(idfx::prank==0) {
+    if(fs::exists(filename)) {
+      fs::remove(filename);
     }
   }
 
+  // open file
+#ifdef WITH_MPI
+  MPI_Barrier(ioComm);
+  // Open file for creating, return error if file already exists.
+  WRITE_SAFE_CALL(MPI_File_open(ioComm, filename.c_str(),
+                              MPI_MODE_CREATE | MPI_MODE_RDWR
+                              | MPI_MODE_EXCL | MPI_MODE_UNIQUE_OPEN,
+                              MPI_INFO_NULL, &fileHdl));
+  this->offset = 0;
+#else
+  fileHdl = fopen(filename.c_str(),"wb");
+  if(fileHdl == NULL) {
+    std::stringstream msg;
+    msg << "Unable to open file " << filename << std::endl;
+    msg << "Check that you have write access and that you don't exceed your quota." << std::endl;
+    WriteError(msg.str());
+  }
+#endif
+  // File is open
+
+  // Test endianness
+  std::string endian;
+  int tmp1 = 1;
+  unsigned char *tmp2 = (unsigned char *) &tmp1;
+  if (*tmp2 != 0) {
+    endian = "little";
+  } else {
+    endian = "big";
+  }
+
+  char header[HEADERSIZE];
+  std::snprintf(header, HEADERSIZE, "Idefix %s Dump Data %s endian",
+                IDEFIX_VERSION, endian.c_str());
+  WriteString(fileHdl, header, HEADERSIZE);
+  return(fileHdl);
+}
+
+void Dump::WriteRecord(IdfxFileHandler fileHdl, DumpRecord &record) {
+  char fieldName[NAMESIZE+1];
+  std::snprintf(fieldName, NAMESIZE, "%s", record.name.c_str());
+  if(record.distributed) {
+    WriteDistributed(fileHdl, 3, record.dim.data(), record.gdim.data(), fieldName,
+                     *record.descriptor, record.distributedData.data());
+  } else {
+    WriteSerial(fileHdl, 1, record.dim.data(), record.type, fieldName,
+                reinterpret_cast<void*>(record.serialData.data()));
+  }
+}
+
+void Dump::CloseForWrite(IdfxFileHandler fileHdl) {
+  #ifndef SINGLE_PRECISION
+  const DataType realType = DoubleType;
+  #else
+  const DataType realType = SingleType;
+  #endif
   // Write end of file
-  scrch[0] = 0.0;
-  std::snprintf(fieldName,NAMESIZE,"eof");
-  nx[0] = 1;
-  WriteSerial(fileHdl, 1, nx, realType, fieldName, scrch);
+  real zero = 0.0;
+  DumpRecord eof("eof", realType, 1, &zero);
+  WriteRecord(fileHdl, eof);
 
 #ifdef WITH_MPI
-  MPI_SAFE_CALL(MPI_File_close(&fileHdl));
+  WRITE_SAFE_CALL(MPI_File_close(&fileHdl));
 #else
   fclose(fileHdl);
 #endif
+}
 
+// Body of the writer thread. It only performs file I/O (no Kokkos call), and uses its own
+// communicator, so that it does not interfere with the communications of the main thread.
+void Dump::WriteRecords(fs::path filename, std::vector<DumpRecord> records) {
+  inWriterThread = true;
+  try {
+    IdfxFileHandler fileHdl = OpenForWrite(filename);
+    for(auto &record : records) {
+      WriteRecord(fileHdl, record);
+    }
+    CloseForWrite(fileHdl);
+  } catch(...) {
+    writerError = std::current_exception();
+  }
+}
 
-  idfx::cout << "done in " << timer.seconds() << " s." << std::endl;
-  idfx::popRegion();
-  // One day, we will have a return code.
-
-  return(0);
+void Dump::Fence() {
+  if(writer.joinable()) {
+    idfx::pushRegion("Dump::Fence");
+    writer.join();
+    idfx::popRegion();
+  }
+  // Report the error of the writer thread, if any
+  if(writerError) {
+    std::exception_ptr error = writerError;
+    writerError = nullptr;
+    try {
+      std::rethrow_exception(error);
+    } catch(std::exception &e) {
+      IDEFIX_ERROR(std::string("Asynchronous dump write failed: ")+e.what());
+    }
+  }
 }
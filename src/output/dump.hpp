@@ -10,6 +10,9 @@
 #include <string>
 #include <map>
 #include <array>
+#include <vector>
+#include <exception>
+#include <thread>
 #if __has_include(<filesystem>)
   #include <filesystem> // NOLINT [build/c++17]
   namespace fs = std::filesystem;
@@ -42,7 +45,7 @@ class DataBlock;
 class DumpField {
  public:
   enum Type {Int, Single, Double, Bool, IdefixArray};
-  enum ArrayType {Device3D, Device4D, Host3D, Host4D};
+  enum ArrayType {Device3D, Device4D, Host3D, Host4D, Device4DStore};
   enum ArrayLocation {Center, Face, Edge};
 
   DumpField(IdefixArray4D<real>& in, const int varnum, const ArrayLocation loc, const int dir):
@@ -53,6 +56,14 @@ class DumpField {
     h4Darray{in}, var{varnum}, arrayType{Host4D},
     type{IdefixArray}, arrayLocation{loc}, direction{dir} {};
 
+  #ifdef MIXED_PRECISION
+  // Arrays stored in single precision are written and read back in double precision
+  DumpField(IdefixArray4D<realStore>& in, const int varnum, const ArrayLocation loc,
+            const int dir):
+    s4Darray{in}, var{varnum}, arrayType{Device4DStore},
+    type{IdefixArray}, arrayLocation{loc}, direction{dir} {};
+  #endif
+
   DumpField(IdefixArray3D<real>& in, const ArrayLocation loc, const int dir):
     d3Darray{in}, arrayType{Device3D},
     type{IdefixArray}, arrayLocation{loc}, direction{dir} {};
@@ -97,6 +108,17 @@ class DumpField {
         IdefixHostArray3D<real> arr3D = Kokkos::create_mirror(arrDev3D);
         Kokkos::deep_copy(arr3D,arrDev3D);
         return(arr3D);
+      #ifdef MIXED_PRECISION
+      } else if(arrayType==Device4DStore) {
+        auto arrStore3D = Kokkos::subview(s4Darray, var, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+        IdefixArray3D<real> arrDev3D("DumpField_Convert", arrStore3D.extent(0),
+                                                          arrStore3D.extent(1),
+                                                          arrStore3D.extent(2));
+        Kokkos::deep_copy(arrDev3D,arrStore3D);
+        IdefixHostArray3D<real> arr3D = Kokkos::create_mirror(arrDev3D);
+        Kokkos::deep_copy(arr3D,arrDev3D);
+        return(arr3D);
+      #endif
       } else {
         IDEFIX_ERROR("unknown field");
         return(h3Darray);
@@ -123,6 +145,15 @@ class DumpField {
         IdefixArray3D<real> arrDev3D = Kokkos::subview(
                                        d4Darray, var, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
         Kokkos::deep_copy(arrDev3D,in);
+      #ifdef MIXED_PRECISION
+      } else if(arrayType==Device4DStore) {
+        auto arrStore3D = Kokkos::subview(s4Darray, var, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+        IdefixArray3D<real> arrDev3D("DumpField_Convert", arrStore3D.extent(0),
+                                                          arrStore3D.extent(1),
+                                                          arrStore3D.extent(2));
+        Kokkos::deep_copy(arrDev3D,in);
+        Kokkos::deep_copy(arrStore3D,arrDev3D);
+      #endif
       }
     }
     // Nothing to sync otherwise
@@ -155,6 +186,9 @@ class DumpField {
   IdefixArray3D<real> d3Darray;
   IdefixHostArray4D<real> h4Darray;
   IdefixHostArray3D<real> h3Darray;
+  #ifdef MIXED_PRECISION
+  IdefixArray4D<realStore> s4Darray;
+  #endif
 
   void *rawData;
   int rawSize;
@@ -166,6 +200,24 @@ class DumpField {
   Type type;
 };
 
+// A field of a dump file. Its data are copied in host memory, so that the record can still be
+// written once the state of the code has changed (asynchronous dumps).
+struct DumpRecord {
+  // Serial record of size elements of a given type
+  DumpRecord(std::string, DataType, int size, const void *);
+  // Distributed record of the local size nx and global size nxtot, to be filled by the caller
+  DumpRecord(std::string, int nx[3], int nxtot[3], IdfxDataDescriptor *);
+
+  std::string name;
+  DataType type;
+  bool distributed{false};
+  std::array<int,3> dim{1, 1, 1};
+  std::array<int,3> gdim{1, 1, 1};
+  IdfxDataDescriptor *descriptor{nullptr};
+  std::vector<char> serialData;
+  std::vector<real> distributedData;
+};
+
 struct GridBox {
   std::array<int,3> start;
   std::array<int,3> size;
@@ -181,8 +233,12 @@ class Dump {
 
   // Create a Dump file from the current state of the code
   int Write(Output&);
+  // Wait for the completion of the asynchronous write in progress (if any)
+  void Fence();
   // Read and load a dump file as current state of the code
   bool Read(Output&, int);
+  // Read the load profile of the grid stored in the restart dump, before the grid is built
+  static bool ReadLoadProfile(Input &, std::array<std::vector<double>,3> &);
 
   // Register IdefixArrays
   void RegisterVariable(IdefixArray3D<real>&,
@@ -207,6 +263,14 @@ class Dump {
                         int dir = -1,
                         DumpField::ArrayLocation loc = DumpField::ArrayLocation::Center );
 
+  #ifdef MIXED_PRECISION
+  void RegisterVariable(IdefixArray4D<realStore>&,
+                        std::string,
+                        int varnum,
+                        int dir = -1,
+                        DumpField::ArrayLocation loc = DumpField::ArrayLocation::Center );
+  #endif
+
   // Register any other fundamental type
   template<typename T>
   void RegisterVariable(T*,
@@ -224,6 +288,14 @@ class Dump {
 
   std::map<std::string, DumpField> dumpFieldMap;
 
+  // Asynchronous writes: the dump is staged in host memory and written by a writer thread
+  bool asyncWrite{false};
+  std::thread writer;
+  std::exception_ptr writerError;       // Error of the writer thread, reported by Fence()
+
+  // Restart dumps written on a different grid are remapped onto the current one
+  bool remapRequested{false};
+
 
   // Timer
   Kokkos::Timer timer;
@@ -231,6 +303,7 @@ class Dump {
   // File offset
 #ifdef WITH_MPI
   MPI_Offset offset;
+  MPI_Comm ioComm;     // Communicator used by the writes
 #endif
   // These descriptors are only useful with MPI
   IdfxDataDescriptor descCR;   // Descriptor for cell-centered fields (Read)
@@ -240,14 +313,19 @@ class Dump {
   IdfxDataDescriptor descER[3]; // Descriptor for edge-centered fields (Read)
   IdfxDataDescriptor descEW[3]; // Descriptor for edge-centered fields (Write)
 
+  IdfxFileHandler OpenForWrite(const fs::path &);  // Open a dump file and write its header
+  void WriteRecord(IdfxFileHandler, DumpRecord &);
+  void CloseForWrite(IdfxFileHandler);             // Write the end of file and close it
+  void WriteRecords(fs::path, std::vector<DumpRecord>);  // Body of the writer thread
   void WriteString(IdfxFileHandler, char *, int);
   void WriteSerial(IdfxFileHandler, int, int *, DataType, char*, void*);
   void WriteDistributed(IdfxFileHandler, int, int*, int*, char*, IdfxDataDescriptor&, real*);
   void ReadNextFieldProperties(IdfxFileHandler, int&, int*, DataType&, std::string&);
   void ReadSerial(IdfxFileHandler, int, int*, DataType, void*);
   void ReadDistributed(IdfxFileHandler, int, int*, int*, IdfxDataDescriptor&, void*);
+  void ReadSlab(IdfxFileHandler, int, int*, std::array<int,3>, std::array<int,3>, real*);
   void Skip(IdfxFileHandler, int, int *, DataType);
-  int GetLastDumpInDirectory(fs::path &);
+  static int GetLastDumpInDirectory(fs::path &);
   void CreateMPIDataType(GridBox, bool);
 
   fs::path outputDirectory;
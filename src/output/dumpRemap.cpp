@@ -0,0 +1,391 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include "dumpRemap.hpp"
+#include "dataBlock.hpp"
+#include "gridHost.hpp"
+
+namespace {
+real Minmod(real a, real b) {
+  if(a*b <= 0) return(0.0);
+  return(std::fabs(a) < std::fabs(b) ? a : b);
+}
+
+// Call f(offset of the line in a, offset of the line in b) for each line of direction dir of the
+// boxes a and b, which have the same size in the other directions
+template<typename Function>
+void ForEachLine(const DumpRemap::Box &a, const DumpRemap::Box &b, int dir, Function f) {
+  const int d1 = (dir == IDIR ? JDIR : IDIR);
+  const int d2 = (dir == KDIR ? JDIR : KDIR);
+  for(int i2 = 0 ; i2 < a.n[d2] ; i2++) {
+    for(int i1 = 0 ; i1 < a.n[d1] ; i1++) {
+      f(i1*a.Stride(d1) + i2*a.Stride(d2), i1*b.Stride(d1) + i2*b.Stride(d2));
+    }
+  }
+}
+} // namespace
+
+DumpRemap::DumpRemap(DataBlock *data, const std::array<std::vector<real>,3> &xlDump,
+                                      const std::array<std::vector<real>,3> &xrDump) {
+  idfx::pushRegion("DumpRemap::DumpRemap");
+  GridHost grid(*data->mygrid);
+  grid.SyncFromDevice();
+
+  for(int dir = 0 ; dir < 3 ; dir++) {
+    const int ng = grid.nghost[dir];
+    const int nNew = grid.np_int[dir];
+    const int nDump = xlDump[dir].size();
+    const int start = data->gbeg[dir] - data->nghost[dir];
+    const int size = data->np_int[dir];
+
+    // Active cells of this process
+    local[dir].xl.resize(size);
+    local[dir].xr.resize(size);
+    for(int i = 0 ; i < size ; i++) {
+      local[dir].xl[i] = grid.xl[dir](start+i+ng);
+      local[dir].xr[i] = grid.xr[dir](start+i+ng);
+    }
+
+    // Compare the grids
+    identical[dir] = true;
+    if(dir < DIMENSIONS) {
+      if(nDump != nNew) {
+        identical[dir] = false;
+      } else {
+        for(int i = 0 ; i < nNew ; i++) {
+          const real tol = 1e-6*(grid.xr[dir](i+ng) - grid.xl[dir](i+ng));
+          if(std::fabs(xlDump[dir][i] - grid.xl[dir](i+ng)) > tol ||
+             std::fabs(xrDump[dir][i] - grid.xr[dir](i+ng)) > tol) {
+            identical[dir] = false;
+          }
+        }
+      }
+    }
+    if(identical[dir]) {
+      slabStart[dir] = start;
+      slabSize[dir] = size;
+      dumpSlab[dir] = local[dir];
+      continue;
+    }
+
+    // The domain should be the same
+    const real extent = grid.xr[dir](nNew-1+ng) - grid.xl[dir](ng);
+    if(std::fabs(xlDump[dir][0] - grid.xl[dir](ng)) > 1e-5*extent ||
+       std::fabs(xrDump[dir][nDump-1] - grid.xr[dir](nNew-1+ng)) > 1e-5*extent) {
+      std::stringstream msg;
+      msg << "Cannot remap the restart dump: the extent of the domain in X" << dir+1
+          << " differs from the current one.";
+      IDEFIX_ERROR(msg);
+    }
+
+    // Faces closer than a fraction of the cell size are identified
+    real tol = extent;
+    for(int i = 0 ; i < size ; i++) {
+      tol = std::min<real>(tol, 1e-6*(local[dir].xr[i] - local[dir].xl[i]));
+    }
+
+    // Dump cells overlapping the active cells, plus one cell on each side for the slopes
+    const real left = local[dir].xl[0];
+    const real right = local[dir].xr[size-1];
+    int first = 0;
+    while(first < nDump-1 && xrDump[dir][first] <= left + tol) first++;
+    int last = nDump-1;
+    while(last > 0 && xlDump[dir][last] >= right - tol) last--;
+    first = std::max(first-1, 0);
+    last = std::min(last+1, nDump-1);
+    slabStart[dir] = first;
+    slabSize[dir] = last-first+1;
+    dumpSlab[dir].xl.assign(xlDump[dir].begin()+first, xlDump[dir].begin()+last+1);
+    dumpSlab[dir].xr.assign(xrDump[dir].begin()+first, xrDump[dir].begin()+last+1);
+    for(int i = 0 ; i < slabSize[dir] ; i++) {
+      tol = std::min<real>(tol, 1e-6*(dumpSlab[dir].xr[i] - dumpSlab[dir].xl[i]));
+    }
+
+    // Union of the faces of the dump slab and of the current grid
+    auto dumpFacePos = [&](int f) {
+      return(f < slabSize[dir] ? dumpSlab[dir].xl[f] : dumpSlab[dir].xr[slabSize[dir]-1]);
+    };
+    auto newFacePos = [&](int g) {
+      return(g < nNew ? grid.xl[dir](g+ng) : grid.xr[dir](nNew-1+ng));
+    };
+    std::vector<real> faces;
+    std::vector<int> dumpFace;
+    std::vector<int> newFace;
+    int f = 0;
+    int g = 0;
+    while(g <= nNew && newFacePos(g) < dumpFacePos(0) - tol) g++;
+    while(f <= slabSize[dir]) {
+      const real xd = dumpFacePos(f);
+      if(g <= nNew && std::fabs(newFacePos(g) - xd) <= tol) {
+        faces.push_back(xd);
+        dumpFace.push_back(f++);
+        newFace.push_back(g++);
+      } else if(g <= nNew && newFacePos(g) < xd) {
+        faces.push_back(newFacePos(g));
+        dumpFace.push_back(-1);
+        newFace.push_back(g++);
+      } else {
+        faces.push_back(xd);
+        dumpFace.push_back(f++);
+        newFace.push_back(-1);
+      }
+    }
+
+    Union &u = unions[dir];
+    const int nu = faces.size()-1;
+    u.dumpFace = dumpFace;
+    u.cells.xl.assign(faces.begin(), faces.end()-1);
+    u.cells.xr.assign(faces.begin()+1, faces.end());
+    u.parent.resize(nu);
+    int parent = 0;
+    for(int c = 0 ; c < nu ; c++) {
+      if(dumpFace[c] >= 0) parent = dumpFace[c];
+      u.parent[c] = parent;
+    }
+
+    // Union cells making each active cell
+    std::vector<int> unionFace(nNew+1, -1);
+    for(int c = 0 ; c <= nu ; c++) {
+      if(newFace[c] >= 0) unionFace[newFace[c]] = c;
+    }
+    u.newBeg.resize(size);
+    u.newEnd.resize(size);
+    for(int i = 0 ; i < size ; i++) {
+      u.newBeg[i] = unionFace[start+i];
+      u.newEnd[i] = unionFace[start+i+1];
+      if(u.newBeg[i] < 0 || u.newEnd[i] <= u.newBeg[i]) {
+        IDEFIX_ERROR("DumpRemap: the slab of the restart dump does not cover the local domain");
+      }
+    }
+  }
+  idfx::popRegion();
+}
+
+bool DumpRemap::IsIdentity() const {
+  return(identical[IDIR] && identical[JDIR] && identical[KDIR]);
+}
+
+void DumpRemap::RemapCell(Box &field) const {
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(identical[dir]) continue;
+    const Measure measure = VolumeMeasure(dir);
+    field = CoarsenCells(RefineCells(field, dir, measure), dir, measure);
+  }
+}
+
+void DumpRemap::RemapFace(std::array<Box,3> &field) const {
+  // Cells of the field in each direction, updated as the directions are remapped
+  std::array<Line,3> cells = dumpSlab;
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    if(identical[dir]) continue;
+    std::array<Box,3> refined;
+    for(int d = 0 ; d < DIMENSIONS ; d++) {
+      if(d != dir) refined[d] = RefineCells(field[d], dir, FaceMeasure(d, dir));
+    }
+    cells[dir] = unions[dir].cells;
+    refined[dir] = RefineNormal(field[dir], refined, dir, cells);
+    for(int d = 0 ; d < DIMENSIONS ; d++) {
+      if(d != dir) field[d] = CoarsenCells(refined[d], dir, FaceMeasure(d, dir));
+    }
+    field[dir] = CoarsenNormal(refined[dir], dir);
+    cells[dir] = local[dir];
+  }
+}
+
+// Integral of the weight of a direction (dx, r dr, r^2 dr or sin(theta) dtheta) over [a,b]
+real DumpRemap::MeasureOf(Measure measure, real a, real b) {
+  if(measure == Radial) return((b-a)*(b+a)/2.0);
+  if(measure == Radial2) return((b-a)*(b*b+a*b+a*a)/3.0);
+  if(measure == Sine) return(std::cos(a)-std::cos(b));
+  return(b-a);
+}
+
+// Centroid of [a,b] for the weight of a direction
+real DumpRemap::Centroid(Measure measure, real a, real b) {
+  if(measure == Radial && a+b != 0) return(2.0*(b*b+a*b+a*a)/(3.0*(a+b)));
+  if(measure == Radial2 && a*a+a*b+b*b != 0) {
+    return(3.0*(a+b)*(a*a+b*b)/(4.0*(a*a+a*b+b*b)));
+  }
+  if(measure == Sine && std::cos(a) != std::cos(b)) {
+    return((std::sin(b)-std::sin(a)+a*std::cos(a)-b*std::cos(b))/(std::cos(a)-std::cos(b)));
+  }
+  return((a+b)/2.0);
+}
+
+// Weight of the cell volumes in a direction
+DumpRemap::Measure DumpRemap::VolumeMeasure(int dir) const {
+  #if GEOMETRY == CYLINDRICAL || GEOMETRY == POLAR
+    if(dir == IDIR) return(Radial);
+  #elif GEOMETRY == SPHERICAL
+    if(dir == IDIR) return(Radial2);
+    if(dir == JDIR) return(Sine);
+  #endif
+  return(Linear);
+}
+
+// Weight of the areas of the faces normal to face in the (transverse) direction dir
+DumpRemap::Measure DumpRemap::FaceMeasure(int face, int dir) const {
+  #if GEOMETRY == CYLINDRICAL
+    if(face == JDIR && dir == IDIR) return(Radial);
+  #elif GEOMETRY == POLAR
+    if(face == KDIR && dir == IDIR) return(Radial);
+  #elif GEOMETRY == SPHERICAL
+    if(face == IDIR && dir == JDIR) return(Sine);
+    if(face != IDIR && dir == IDIR) return(Radial);
+  #endif
+  return(Linear);
+}
+
+// Factor of the area of a face normal to face located at x
+real DumpRemap::NormalFactor(int face, real x) const {
+  #if GEOMETRY == CYLINDRICAL || GEOMETRY == POLAR
+    if(face == IDIR) return(std::fabs(x));
+  #elif GEOMETRY == SPHERICAL
+    if(face == IDIR) return(x*x);
+    if(face == JDIR) return(std::fabs(std::sin(x)));
+  #endif
+  return(1.0);
+}
+
+// Dump slab -> union grid, using limited linear slopes around the centroid of each dump cell
+DumpRemap::Box DumpRemap::RefineCells(const Box &in, int dir, Measure measure) const {
+  const Union &u = unions[dir];
+  const Line &dump = dumpSlab[dir];
+  const int nDump = in.n[dir];
+  const int nu = u.parent.size();
+
+  std::vector<real> xDump(nDump);
+  std::vector<real> xUnion(nu);
+  for(int i = 0 ; i < nDump ; i++) xDump[i] = Centroid(measure, dump.xl[i], dump.xr[i]);
+  for(int c = 0 ; c < nu ; c++) xUnion[c] = Centroid(measure, u.cells.xl[c], u.cells.xr[c]);
+
+  std::array<int,3> n = in.n;
+  n[dir] = nu;
+  Box out(n);
+  const size_t sIn = in.Stride(dir);
+  const size_t sOut = out.Stride(dir);
+  ForEachLine(in, out, dir, [&](size_t lineIn, size_t lineOut) {
+    for(int c = 0 ; c < nu ; c++) {
+      const int i = u.parent[c];
+      const real q = in.v[lineIn + i*sIn];
+      real slope = 0.0;
+      if(i > 0 && i < nDump-1) {
+        const real qm = in.v[lineIn + (i-1)*sIn];
+        const real qp = in.v[lineIn + (i+1)*sIn];
+        slope = Minmod((q-qm)/(xDump[i]-xDump[i-1]), (qp-q)/(xDump[i+1]-xDump[i]));
+      }
+      out.v[lineOut + c*sOut] = q + slope*(xUnion[c]-xDump[i]);
+    }
+  });
+  return(out);
+}
+
+// Union grid -> active cells, averaging with the weight of the direction
+DumpRemap::Box DumpRemap::CoarsenCells(const Box &in, int dir, Measure measure) const {
+  const Union &u = unions[dir];
+  const int nu = u.parent.size();
+  const int size = local[dir].xl.size();
+
+  std::vector<real> weight(nu);
+  for(int c = 0 ; c < nu ; c++) weight[c] = MeasureOf(measure, u.cells.xl[c], u.cells.xr[c]);
+
+  std::array<int,3> n = in.n;
+  n[dir] = size;
+  Box out(n);
+  const size_t sIn = in.Stride(dir);
+  const size_t sOut = out.Stride(dir);
+  ForEachLine(in, out, dir, [&](size_t lineIn, size_t lineOut) {
+    for(int i = 0 ; i < size ; i++) {
+      real sum = 0.0;
+      real weightSum = 0.0;
+      for(int c = u.newBeg[i] ; c < u.newEnd[i] ; c++) {
+        sum += weight[c]*in.v[lineIn + c*sIn];
+        weightSum += weight[c];
+      }
+      out.v[lineOut + i*sOut] = (weightSum != 0) ? sum/weightSum
+                                                  : in.v[lineIn + u.newBeg[i]*sIn];
+    }
+  });
+  return(out);
+}
+
+// Normal component on the faces of the union grid. Faces of the dump keep their value, while the
+// flux through the other faces ensures that each union cell is divergence free, given the
+// (already refined) transverse components.
+DumpRemap::Box DumpRemap::RefineNormal(const Box &in, const std::array<Box,3> &transverse,
+                                       int dir, const std::array<Line,3> &cells) const {
+  const Union &u = unions[dir];
+  const int nu = u.parent.size();
+  const int d1 = (dir == IDIR ? JDIR : IDIR);
+  const int d2 = (dir == KDIR ? JDIR : KDIR);
+
+  std::array<int,3> n = in.n;
+  n[dir] = nu+1;
+  Box out(n);
+  std::array<int,3> idx;
+  for(idx[d2] = 0 ; idx[d2] < n[d2] ; idx[d2]++) {
+    for(idx[d1] = 0 ; idx[d1] < n[d1] ; idx[d1]++) {
+      // Transverse factor of the area of the faces of this line
+      real area = 1.0;
+      for(int d : {d1, d2}) {
+        if(d < DIMENSIONS) {
+          area *= MeasureOf(FaceMeasure(dir, d), cells[d].xl[idx[d]], cells[d].xr[idx[d]]);
+        }
+      }
+      for(int f = 0 ; f <= nu ; f++) {
+        idx[dir] = f;
+        if(u.dumpFace[f] >= 0) {
+          std::array<int,3> idxDump = idx;
+          idxDump[dir] = u.dumpFace[f];
+          out(idx) = in(idxDump);
+          continue;
+        }
+        // Zero divergence of the union cell f-1
+        std::array<int,3> idxCell = idx;
+        idxCell[dir] = f-1;
+        real flux = out(idxCell)*NormalFactor(dir, u.cells.xl[f-1])*area;
+        for(int d : {d1, d2}) {
+          if(d >= DIMENSIONS) continue;
+          const int d3 = 3-dir-d;
+          real dArea = MeasureOf(FaceMeasure(d, dir), u.cells.xl[f-1], u.cells.xr[f-1]);
+          if(d3 < DIMENSIONS) {
+            dArea *= MeasureOf(FaceMeasure(d, d3), cells[d3].xl[idx[d3]], cells[d3].xr[idx[d3]]);
+          }
+          std::array<int,3> idxRight = idxCell;
+          idxRight[d]++;
+          flux -= (transverse[d](idxRight)*NormalFactor(d, cells[d].xr[idx[d]])
+                   - transverse[d](idxCell)*NormalFactor(d, cells[d].xl[idx[d]]))*dArea;
+        }
+        const real faceArea = NormalFactor(dir, u.cells.xl[f])*area;
+        out(idx) = (faceArea != 0) ? flux/faceArea : 0.0;
+      }
+    }
+  }
+  return(out);
+}
+
+// Union faces -> faces of the active cells (which are all union faces)
+DumpRemap::Box DumpRemap::CoarsenNormal(const Box &in, int dir) const {
+  const Union &u = unions[dir];
+  const int size = local[dir].xl.size();
+
+  std::array<int,3> n = in.n;
+  n[dir] = size+1;
+  Box out(n);
+  const size_t sIn = in.Stride(dir);
+  const size_t sOut = out.Stride(dir);
+  ForEachLine(in, out, dir, [&](size_t lineIn, size_t lineOut) {
+    for(int i = 0 ; i <= size ; i++) {
+      const int f = (i < size) ? u.newBeg[i] : u.newEnd[size-1];
+      out.v[lineOut + i*sOut] = in.v[lineIn + f*sIn];
+    }
+  });
+  return(out);
+}
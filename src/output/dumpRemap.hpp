@@ -0,0 +1,101 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef OUTPUT_DUMPREMAP_HPP_
+#define OUTPUT_DUMPREMAP_HPP_
+
+#include <array>
+#include <vector>
+#include "idefix.hpp"
+
+// Forward class declaration
+class DataBlock;
+
+// Remap of the fields of a restart dump onto a grid which differs from the grid of the dump
+// (resolution, stretching), the extent of the domain being the same.
+// Each process only reads the slab of the dump which overlaps its own subdomain (plus one cell
+// on each side for the slopes). The fields are then remapped one direction after the other,
+// first on the union of the dump and current grids, and then on the current grid:
+// - cell-centered fields use a limited piecewise linear reconstruction, so that their volume
+//   integral is conserved (restriction is then a volume-weighted average)
+// - face-centered fields are remapped as fluxes. The transverse components conserve their flux
+//   through each face, while the normal component on the faces added by the union grid is
+//   obtained from the zero divergence of each new cell, so that div(B)=0 is preserved.
+class DumpRemap {
+ public:
+  // Cells or faces of a box, stored with i varying fastest
+  struct Box {
+    std::array<int,3> n{1, 1, 1};
+    std::vector<real> v;
+
+    Box() = default;
+    explicit Box(std::array<int,3> size): n{size},
+                 v(static_cast<size_t>(size[IDIR])*size[JDIR]*size[KDIR]) {}
+    size_t Stride(int dir) const {
+      if(dir == IDIR) return(1);
+      if(dir == JDIR) return(n[IDIR]);
+      return(static_cast<size_t>(n[IDIR])*n[JDIR]);
+    }
+    real &operator()(const std::array<int,3> &idx) {
+      return(v[idx[IDIR] + Stride(JDIR)*idx[JDIR] + Stride(KDIR)*idx[KDIR]]);
+    }
+    real operator()(const std::array<int,3> &idx) const {
+      return(v[idx[IDIR] + Stride(JDIR)*idx[JDIR] + Stride(KDIR)*idx[KDIR]]);
+    }
+  };
+
+  DumpRemap(DataBlock *, const std::array<std::vector<real>,3> &xlDump,
+                         const std::array<std::vector<real>,3> &xrDump);
+
+  // Whether the grid of the dump is the current one (no remap is needed)
+  bool IsIdentity() const;
+  // Remap a cell-centered field from the dump slab to the active cells of this process
+  void RemapCell(Box &) const;
+  // Remap the components of a face-centered vector field from the dump slab to the faces of the
+  // active cells of this process
+  void RemapFace(std::array<Box,3> &) const;
+
+  std::array<int,3> slabStart;    // first cell of the dump slab needed by this process
+  std::array<int,3> slabSize;     // number of cells of the dump slab needed by this process
+
+ private:
+  enum Measure {Linear, Radial, Radial2, Sine};
+
+  // Cells of a direction
+  struct Line {
+    std::vector<real> xl;
+    std::vector<real> xr;
+  };
+
+  // Union of the cells of the dump slab and of the current grid in a direction
+  struct Union {
+    Line cells;
+    std::vector<int> parent;     // dump cell containing each union cell
+    std::vector<int> dumpFace;   // dump face matching each union face (-1 if none)
+    std::vector<int> newBeg;     // first union cell of each active cell
+    std::vector<int> newEnd;     // last union cell (excluded) of each active cell
+  };
+
+  static real MeasureOf(Measure, real, real);
+  static real Centroid(Measure, real, real);
+  Measure VolumeMeasure(int) const;
+  Measure FaceMeasure(int, int) const;
+  real NormalFactor(int, real) const;
+
+  Box RefineCells(const Box &, int, Measure) const;
+  Box CoarsenCells(const Box &, int, Measure) const;
+  Box RefineNormal(const Box &, const std::array<Box,3> &, int,
+                   const std::array<Line,3> &) const;
+  Box CoarsenNormal(const Box &, int) const;
+
+  std::array<bool,3> identical;   // whether the dump and current grids are identical
+  std::array<Line,3> dumpSlab;    // cells of the dump slab
+  std::array<Line,3> local;       // active cells of this process
+  std::array<Union,3> unions;
+};
+
+#endif // OUTPUT_DUMPREMAP_HPP_
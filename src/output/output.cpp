@@ -173,6 +173,8 @@ int Output::CheckForWrites(DataBlock &data) {
   if(vtkEnabled) {
     if(data.t >= vtkLast + vtkPeriod) {
       elapsedTime -= timer.seconds();
+      // The blocks of the process are evolved in place of its DataBlock
+      if(data.haveBlocks) data.scheduler->Gather();
       if(userDefVariablesEnabled) {
         if(haveUserDefVariablesFunc) {
           // Call user-def function to fill the userdefined variable arrays
@@ -186,6 +188,7 @@ int Output::CheckForWrites(DataBlock &data) {
       }
       vtkLast += vtkPeriod;
       data.vtk->Write();
+      if(data.haveRefinement) data.refinement->WriteVtk();
       nfiles++;
       elapsedTime += timer.seconds();
 
@@ -203,6 +206,7 @@ int Output::CheckForWrites(DataBlock &data) {
   if(xdmfEnabled) {
     if(data.t >= xdmfLast + xdmfPeriod) {
       elapsedTime -= timer.seconds();
+      if(data.haveBlocks) data.scheduler->Gather();
       if(userDefVariablesEnabled) {
         if(haveUserDefVariablesFunc) {
           // Call user-def function to fill the userdefined variable arrays
@@ -234,6 +238,7 @@ int Output::CheckForWrites(DataBlock &data) {
   if(analysisEnabled) {
     if(data.t >= analysisLast + analysisPeriod) {
       elapsedTime -= timer.seconds();
+      if(data.haveBlocks) data.scheduler->Gather();
       if(!haveAnalysisFunc) {
         IDEFIX_ERROR("Cannot perform a user-defined analysis without "
                      "enrollment of your analysis function");
@@ -265,6 +270,7 @@ int Output::CheckForWrites(DataBlock &data) {
   if(pythonEnabled) {
     if(data.t >= pythonLast + pythonPeriod) {
       elapsedTime -= timer.seconds();
+      if(data.haveBlocks) data.scheduler->Gather();
       pydefix.Output(data,pythonNumber);
       pythonNumber++;
       elapsedTime += timer.seconds();
@@ -304,6 +310,7 @@ int Output::CheckForWrites(DataBlock &data) {
     // so it's important that this part happens last.
     if(havePeriodicDump || haveClockDump) {
       elapsedTime -= timer.seconds();
+      if(data.haveBlocks) data.scheduler->Gather();
       data.dump->Write(*this);
       nfiles++;
       elapsedTime += timer.seconds();
@@ -335,7 +342,12 @@ bool Output::RestartFromDump(DataBlock &data, int readNumber) {
 void Output::ForceWriteDump(DataBlock &data) {
   idfx::pushRegion("Output::ForceWriteDump");
 
-  if(!forceNoWrite) data.dump->Write(*this);
+  if(!forceNoWrite) {
+    if(data.haveBlocks) data.scheduler->Gather();
+    data.dump->Write(*this);
+    // The dump should be complete before the code stops
+    data.dump->Fence();
+  }
 
   idfx::popRegion();
 }
@@ -344,6 +356,7 @@ void Output::ForceWriteVtk(DataBlock &data) {
   idfx::pushRegion("Output::ForceWriteVtk");
 
   if(!forceNoWrite) {
+    if(data.haveBlocks) data.scheduler->Gather();
     if(userDefVariablesEnabled) {
       if(haveUserDefVariablesFunc) {
         // Call user-def function to fill the userdefined variable arrays
@@ -357,6 +370,7 @@ void Output::ForceWriteVtk(DataBlock &data) {
     }
     vtkLast += vtkPeriod;
     data.vtk->Write();
+    if(data.haveRefinement) data.refinement->WriteVtk();
     if(haveSlices) {
       for(int i = 0 ; i < slices.size() ; i++) {
         slices[i]->CheckForWrite(data,true);
@@ -371,6 +385,7 @@ void Output::ForceWriteXdmf(DataBlock &data) {
   idfx::pushRegion("Output::ForceWriteXdmf");
 
   if(!forceNoWrite) {
+    if(data.haveBlocks) data.scheduler->Gather();
     if(userDefVariablesEnabled) {
         if(haveUserDefVariablesFunc) {
           // Call user-def function to fill the userdefined variable arrays
@@ -7,14 +7,16 @@
 
 #ifndef OUTPUT_SCALARFIELD_HPP_
 #define OUTPUT_SCALARFIELD_HPP_
+#include <array>
 #include "idefix.hpp"
+#include "bigEndian.hpp"
 
 
 // Forward class declaration
 
 class ScalarField {
  public:
-  enum Type {Device3D, Device4D, Host3D, Host4D};
+  enum Type {Device3D, Device4D, Host3D, Host4D, Device4DStore};
 
   explicit ScalarField(IdefixArray4D<real>& in, const int varnum):
     d4Darray{in}, var{varnum}, type{Device4D} {};
@@ -24,6 +26,10 @@ class ScalarField {
     d3Darray{in}, type{Device3D} {};
   explicit ScalarField(IdefixHostArray3D<real>& in):
     h3Darray{in}, type{Host3D} {};
+  #ifdef MIXED_PRECISION
+  explicit ScalarField(IdefixArray4D<realStore>& in, const int varnum):
+    s4Darray{in}, var{varnum}, type{Device4DStore} {};
+  #endif
 
   IdefixHostArray3D<real> GetHostField() const {
     if(type==Host3D) {
@@ -42,17 +48,79 @@ class ScalarField {
       IdefixHostArray3D<real> arr3D = Kokkos::create_mirror(arrDev3D);
       Kokkos::deep_copy(arr3D,arrDev3D);
       return(arr3D);
+    #ifdef MIXED_PRECISION
+    } else if(type==Device4DStore) {
+      auto arrStore3D = Kokkos::subview(s4Darray, var, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+      IdefixArray3D<real> arrDev3D("ScalarField_Convert", arrStore3D.extent(0),
+                                                          arrStore3D.extent(1),
+                                                          arrStore3D.extent(2));
+      Kokkos::deep_copy(arrDev3D,arrStore3D);
+      IdefixHostArray3D<real> arr3D = Kokkos::create_mirror(arrDev3D);
+      Kokkos::deep_copy(arr3D,arrDev3D);
+      return(arr3D);
+    #endif
     } else {
       IDEFIX_ERROR("unknown field");
       return(h3Darray);
     }
   }
 
+  // Copy the cells [beg,end) of the field in out (i varying fastest), converted to T and with
+  // their bytes reversed if swap is set. Fields stored on the device are packed by a device kernel
+  // in the scratch array buffer, so that only the packed cells are transferred to the host.
+  template<typename T>
+  void Pack(IdefixHostArray1D<T> out, IdefixArray1D<T> buffer,
+            const std::array<int,3> &beg, const std::array<int,3> &end,
+            const bool swap) const {
+    const int ib = beg[IDIR];
+    const int jb = beg[JDIR];
+    const int kb = beg[KDIR];
+    const int nx = end[IDIR] - ib;
+    const int nxy = nx*(end[JDIR] - jb);
+    if(type==Device3D || type==Device4D) {
+      IdefixArray3D<real> in;
+      if(type==Device3D) {
+        in = d3Darray;
+      } else {
+        in = Kokkos::subview(d4Darray, var, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+      }
+      idefix_for("PackField",kb,end[KDIR],jb,end[JDIR],ib,end[IDIR],
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          const T v = static_cast<T>(in(k,j,i));
+          buffer(i-ib + (j-jb)*nx + (k-kb)*nxy) = swap ? BigEndian::Swap(v) : v;
+        });
+      Kokkos::deep_copy(out, buffer);
+    #ifdef MIXED_PRECISION
+    } else if(type==Device4DStore) {
+      auto in = Kokkos::subview(s4Darray, var, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+      idefix_for("PackField",kb,end[KDIR],jb,end[JDIR],ib,end[IDIR],
+        KOKKOS_LAMBDA (int k, int j, int i) {
+          const T v = static_cast<T>(in(k,j,i));
+          buffer(i-ib + (j-jb)*nx + (k-kb)*nxy) = swap ? BigEndian::Swap(v) : v;
+        });
+      Kokkos::deep_copy(out, buffer);
+    #endif
+    } else {
+      IdefixHostArray3D<real> in = GetHostField();
+      for(int k = kb; k < end[KDIR] ; k++ ) {
+        for(int j = jb; j < end[JDIR] ; j++ ) {
+          for(int i = ib; i < end[IDIR] ; i++ ) {
+            const T v = static_cast<T>(in(k,j,i));
+            out(i-ib + (j-jb)*nx + (k-kb)*nxy) = swap ? BigEndian::Swap(v) : v;
+          }
+        }
+      }
+    }
+  }
+
  private:
   IdefixArray4D<real> d4Darray;
   IdefixArray3D<real> d3Darray;
   IdefixHostArray4D<real> h4Darray;
   IdefixHostArray3D<real> h3Darray;
+  #ifdef MIXED_PRECISION
+  IdefixArray4D<realStore> s4Darray;
+  #endif
   int var;
   Type type;
 };
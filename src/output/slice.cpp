@@ -80,6 +80,7 @@ void Slice::CheckForWrite(DataBlock &data, bool force) {
   idfx::pushRegion("Slice:CheckForWrite");
 
   if(force || data.t >= sliceLast + slicePeriod) {
+    if(data.haveBlocks) data.scheduler->Gather();
     // sync time
     sliceData->t = data.t;
     if(haveUserDefinedVariables) {
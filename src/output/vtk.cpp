@@ -11,6 +11,9 @@
 #include <cstdio>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <utility>
+#include <vector>
 #if __has_include(<filesystem>)
   #include <filesystem> // NOLINT [build/c++17]
   namespace fs = std::filesystem;
@@ -117,8 +120,11 @@ Vtk::Vtk(Input &input, DataBlock *datain, std::string filebase) {
   this->joffset = datain->mygrid->np_tot[JDIR] == 1 ? 0 : 1;
   this->koffset = datain->mygrid->np_tot[KDIR] == 1 ? 0 : 1;
 
-  // Temporary storage on host for 3D arrays
-  this->vect3D = new float[nx1loc*nx2loc*nx3loc];
+  // Number of fields aggregated in each collective write
+  this->fieldsPerWrite = input.GetOrSet<int>("Output","vtk_batch",0,4);
+  if(fieldsPerWrite < 1) {
+    IDEFIX_ERROR("vtk_batch should be a strictly positive integer");
+  }
 
   // Store coordinates for later use
   this->xnode = new float[nx1+ioffset];
@@ -331,19 +337,7 @@ int Vtk::Write() {
 
   WriteHeader(fileHdl, this->data->t);
 
-  // Write field one by one
-  for(auto const& [name, scalar] : vtkScalarMap) {
-    auto Vcin = scalar.GetHostField();
-    for(int k = data->beg[KDIR]; k < data->end[KDIR] ; k++ ) {
-      for(int j = data->beg[JDIR]; j < data->end[JDIR] ; j++ ) {
-        for(int i = data->beg[IDIR]; i < data->end[IDIR] ; i++ ) {
-          vect3D[i-data->beg[IDIR] + (j-data->beg[JDIR])*nx1loc + (k-data->beg[KDIR])*nx1loc*nx2loc]
-              = bigEndian(static_cast<float>(Vcin(k,j,i)));
-        }
-      }
-    }
-    WriteScalar(fileHdl, vect3D, name);
-  }
+  WriteFields(fileHdl);
 
 #ifdef WITH_MPI
   MPI_SAFE_CALL(MPI_File_close(&fileHdl));
@@ -578,32 +572,101 @@ void Vtk::WriteHeader(IdfxFileHandler fvtk, real time) {
 #undef VTK_RECTILINEAR_GRID
 
 /* ********************************************************************* */
-void Vtk::WriteScalar(IdfxFileHandler fvtk, float* Vin,  const std::string &var_name) {
+void Vtk::WriteFields(IdfxFileHandler fvtk) {
 /*!
-* Write VTK scalar field.
+* Write the VTK scalar fields.
+*
+* The active cells of each field are converted to big endian floats on the device before being
+* transferred to the host. With MPI, the fields are written by batches of fieldsPerWrite fields
+* with nonblocking collective calls, so that the packing and transfer of the next batch overlaps
+* the write of the current one.
 *
 *********************************************************************** */
+  const int64_t nloc = nx1loc*nx2loc*nx3loc;
+  const bool swap = bigEndian.ShouldSwap();
+  const int nfields = vtkScalarMap.size();
+  if(nfields == 0) return;
 
-  std::stringstream ssheader;
-
-  ssheader << std::endl << "SCALARS " << var_name.c_str() << " float" << std::endl;
-  ssheader << "LOOKUP_TABLE default" << std::endl;
-  std::string header(ssheader.str());
+  std::vector<std::string> headers;
+  for(auto const& [name, scalar] : vtkScalarMap) {
+    std::stringstream ssheader;
+    ssheader << std::endl << "SCALARS " << name.c_str() << " float" << std::endl;
+    ssheader << "LOOKUP_TABLE default" << std::endl;
+    headers.push_back(ssheader.str());
+  }
 
-  WriteHeaderString(header.c_str(), fvtk);
+  // Allocate the packing buffers
+  const int64_t bufferSize = nloc*std::min(fieldsPerWrite, nfields);
+  if(packHost[0].extent(0) < bufferSize) {
+    packDevice = IdefixArray1D<float>("VtkPackDevice", nloc);
+    packHost[0] = IdefixHostArray1D<float>("VtkPackHost0", bufferSize);
+    packHost[1] = IdefixHostArray1D<float>("VtkPackHost1", bufferSize);
+  }
 
 #ifdef WITH_MPI
-  MPI_SAFE_CALL(MPI_File_set_view(fvtk, this->offset, MPI_FLOAT, this->view,
-                                  "native", MPI_INFO_NULL));
+  // Location of each field in the file
+  std::vector<MPI_Offset> fieldOffset(nfields);
+  for(int n = 0 ; n < nfields ; n++) {
+    fieldOffset[n] = this->offset + headers[n].size();
+    this->offset = fieldOffset[n] + sizeof(float)*nx1*nx2*nx3;
+  }
 
-  int nwrite = nx1loc*nx2loc*nx3loc;
-  //if(idfx::prank != 0) nwrite = 0;
-  MPI_SAFE_CALL(MPI_File_write_all(fvtk, Vin, nwrite, MPI_FLOAT, MPI_STATUS_IGNORE));
+  // The root process writes all the field headers
+  MPI_SAFE_CALL(MPI_File_set_view(fvtk, 0, MPI_BYTE, MPI_CHAR, "native", MPI_INFO_NULL));
+  if(this->isRoot) {
+    for(int n = 0 ; n < nfields ; n++) {
+      MPI_SAFE_CALL(MPI_File_write_at(fvtk, fieldOffset[n]-headers[n].size(), headers[n].c_str(),
+                                      headers[n].size(), MPI_CHAR, MPI_STATUS_IGNORE));
+    }
+  }
+
+  // A single view gathering the subdomain of this process in all the fields, so that the view
+  // is not changed while a write is pending
+  std::vector<int> blockLength(nfields, 1);
+  std::vector<MPI_Aint> displacement(nfields);
+  std::vector<MPI_Datatype> fieldType(nfields, this->view);
+  for(int n = 0 ; n < nfields ; n++) {
+    displacement[n] = fieldOffset[n] - fieldOffset[0];
+  }
+  MPI_Datatype fieldsView;
+  MPI_SAFE_CALL(MPI_Type_create_struct(nfields, blockLength.data(), displacement.data(),
+                                       fieldType.data(), &fieldsView));
+  MPI_SAFE_CALL(MPI_Type_commit(&fieldsView));
+  MPI_SAFE_CALL(MPI_File_set_view(fvtk, fieldOffset[0], MPI_FLOAT, fieldsView,
+                                  "native", MPI_INFO_NULL));
 
-  this->offset = this->offset + sizeof(float)*nx1*nx2*nx3;
+  MPI_Request request = MPI_REQUEST_NULL;
+  int buffer = 0;
+  int first = 0;
+  int n = 0;
+  for(auto const& [name, scalar] : vtkScalarMap) {
+    const int slot = n - first;
+    IdefixHostArray1D<float> packed = Kokkos::subview(packHost[buffer],
+                                                      std::make_pair(slot*nloc, (slot+1)*nloc));
+    scalar.Pack(packed, packDevice, data->beg, data->end, swap);
+    n++;
+    if(n - first == fieldsPerWrite || n == nfields) {
+      // Only one write is pending at a time: the other buffer is then free to be filled
+      MPI_SAFE_CALL(MPI_Wait(&request, MPI_STATUS_IGNORE));
+      MPI_SAFE_CALL(MPI_File_iwrite_at_all(fvtk, first*nloc, packHost[buffer].data(),
+                                           static_cast<int>((n-first)*nloc), MPI_FLOAT,
+                                           &request));
+      buffer = 1 - buffer;
+      first = n;
+    }
+  }
+  MPI_SAFE_CALL(MPI_Wait(&request, MPI_STATUS_IGNORE));
+  MPI_SAFE_CALL(MPI_Type_free(&fieldsView));
 #else
-  if(fwrite(Vin,sizeof(float),nx1loc*nx2loc*nx3loc,fvtk) != nx1loc*nx2loc*nx3loc) {
-    IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+  IdefixHostArray1D<float> packed = Kokkos::subview(packHost[0], std::make_pair(int64_t(0), nloc));
+  int n = 0;
+  for(auto const& [name, scalar] : vtkScalarMap) {
+    WriteHeaderString(headers[n].c_str(), fvtk);
+    scalar.Pack(packed, packDevice, data->beg, data->end, swap);
+    if(fwrite(packed.data(),sizeof(float),nloc,fvtk) != nloc) {
+      IDEFIX_ERROR("Unable to write to file. Check your filesystem permissions and disk quota.");
+    }
+    n++;
   }
 #endif
 }
@@ -105,6 +105,7 @@ class BaseVtk {
 class Vtk : public BaseVtk {
   friend class Dump;
   friend class Slice;
+  friend class StaticRefinement;
 
  public:
   explicit Vtk(Input &, DataBlock *, std::string filebase = "data");   // init VTK object
@@ -133,8 +134,13 @@ class Vtk : public BaseVtk {
 
   IdefixHostArray4D<float> node_coord;
 
-  // Array designed to store the temporary vector array
-  float *vect3D;
+  // Number of fields written by each collective call
+  int fieldsPerWrite;
+
+  // Buffers of the packed fields: fields stored on the device are packed in packDevice and then
+  // copied in one of the two host buffers (double buffering), which are written to disk
+  IdefixArray1D<float> packDevice;
+  IdefixHostArray1D<float> packHost[2];
 
   // File name
   std::string filebase;
@@ -147,7 +153,7 @@ class Vtk : public BaseVtk {
 #endif
 
   void WriteHeader(IdfxFileHandler, real);
-  void WriteScalar(IdfxFileHandler, float*,  const std::string &);
+  void WriteFields(IdfxFileHandler);
   void WriteHeaderNodes(IdfxFileHandler);
 
   // output directory
@@ -175,7 +175,8 @@ Xdmf::Xdmf(Input &input, DataBlock *datain) {
                                                                  cellsubsize[3]);
   */
   // Temporary storage on host for 3D arrays
-  this->vect3D = new DUMP_DATATYPE[nx1loc*nx2loc*nx3loc];
+  this->vect3D = IdefixHostArray1D<DUMP_DATATYPE>("XdmfVect3D", nx1loc*nx2loc*nx3loc);
+  this->packDevice = IdefixArray1D<DUMP_DATATYPE>("XdmfPackDevice", nx1loc*nx2loc*nx3loc);
 
   // fill the node_coord array
   DUMP_DATATYPE x1 = 0.0;
@@ -395,16 +396,9 @@ int Xdmf::Write() {
 
   // Write field one by one
   for(auto const& [name, scalar] : xdmfScalarMap) {
-    auto Vcin = scalar.GetHostField();
-    for(int k = data->beg[KDIR]; k < data->end[KDIR] ; k++ ) {
-      for(int j = data->beg[JDIR]; j < data->end[JDIR] ; j++ ) {
-        for(int i = data->beg[IDIR]; i < data->end[IDIR] ; i++ ) {
-          vect3D[i-data->beg[IDIR] + (j-data->beg[JDIR])*nx1loc + (k-data->beg[KDIR])*nx1loc*nx2loc]
-              = static_cast<DUMP_DATATYPE>(Vcin(k,j,i));
-        }
-      }
-    }
-    WriteScalar(vect3D, name, field_data_size, ssfileName.str(), filename_xmf,
+    // Ghost cells are stripped and the field converted on the device
+    scalar.Pack(vect3D, packDevice, data->beg, data->end, false);
+    WriteScalar(vect3D.data(), name, field_data_size, ssfileName.str(), filename_xmf,
                 memspace, dataspace, plist_id_mpiio, static_cast<hid_t&>(group_fields));
   }
   WriteFooter(ssfileName.str(), filename_xmf);
@@ -74,7 +74,9 @@ class Xdmf {
   // IdefixHostArray3D<DUMP_DATATYPE> field_data;
 
   // Array designed to store the temporary vector array
-  DUMP_DATATYPE *vect3D;
+  IdefixHostArray1D<DUMP_DATATYPE> vect3D;
+  // Device array in which the fields are packed before their transfer to vect3D
+  IdefixArray1D<DUMP_DATATYPE> packDevice;
 
   // Timer
   Kokkos::Timer timer;
@@ -6,8 +6,10 @@
 // ***********************************************************************************
 
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <mutex>    // NOLINT [build/c++11]
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -53,6 +55,53 @@ const char* label, const void* const ptr, const uint64_t size) {
   idfx::prof.spaceSize[space_i] -= size;
 }
 
+// Kernel callbacks (only registered by -kernels or -trace)
+extern "C" void kokkosp_begin_kernel(const char* name, const uint32_t devID, uint64_t* kID) {
+  idfx::prof.BeginKernel(std::string(name));
+}
+
+extern "C" void kokkosp_end_kernel(const uint64_t kID) {
+  idfx::prof.EndKernel();
+}
+
+extern "C" void kokkosp_begin_deep_copy(Kokkos_Profiling_SpaceHandle dstSpace,
+  const char* dstName, const void* dstPtr, Kokkos_Profiling_SpaceHandle srcSpace,
+  const char* srcName, const void* srcPtr, uint64_t size) {
+  // a deep copy reads and writes size bytes
+  idfx::prof.SetKernelBytes(2.0*size);
+  idfx::prof.BeginKernel(std::string("Kokkos::deep_copy [")+dstName+"]");
+}
+
+extern "C" void kokkosp_end_deep_copy() {
+  idfx::prof.EndKernel();
+}
+
+// Maximum # of kernel launches kept in the timeline of each process
+constexpr size_t maxTraceEvents = 1000000;
+
+// Kernels sorted by decreasing total time
+static std::vector<std::pair<const std::string *, const idfx::KernelStats *>>
+SortKernels(const std::map<std::string, idfx::KernelStats> &kernels) {
+  std::vector<std::pair<const std::string *, const idfx::KernelStats *>> sorted;
+  for(auto &it : kernels) {
+    sorted.push_back({&it.first, &it.second});
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    return a.second->totalTime > b.second->totalTime;
+  });
+  return(sorted);
+}
+
+// Names of the kernels in json strings
+static std::string JsonEscape(const std::string &in) {
+  std::string out;
+  for(char c : in) {
+    if(c == '"' || c == '\\') out.push_back('\\');
+    out.push_back(c);
+  }
+  return(out);
+}
+
 ///////////////////////////////////
 // Profiler function definitions //
 ///////////////////////////////////
@@ -108,6 +157,188 @@ void idfx::Profiler::Show() {
     idfx::cout << std::endl;
     idfx::cout << "Profiler: end of performance profiling report." << std::endl;
   }
+
+  if(kernelsEnabled) {
+    ShowKernels();
+    if(traceEnabled) WriteTrace();
+  }
+}
+
+void idfx::Profiler::WriteReport(const std::string &filename, double cellUpdates,
+                                 double runTime, int64_t nCycles) {
+  // Memory high water marks and MPI time, gathered from all of the processes
+  int64_t memoryMax[16];
+  for(int i=0; i < this->numSpaces ; i++) {
+    memoryMax[i] = this->spaceMax[i];
+  }
+  double mpiTime = idfx::mpiCallsTimer;
+  double mpiTimeMax = idfx::mpiCallsTimer;
+  #ifdef WITH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, memoryMax, numSpaces, MPI_INT64_T, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &mpiTime, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &mpiTimeMax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    mpiTime /= idfx::psize;
+  #endif
+  if(idfx::prank != 0) return;
+
+  std::ofstream file(filename);
+  if(!file.is_open()) {
+    std::stringstream msg;
+    msg << "Profiler: cannot open the benchmark report " << filename;
+    IDEFIX_ERROR(msg);
+  }
+  // cell_updates are given per process, as in doc/source/bench.json
+  file << std::scientific << std::setprecision(6);
+  file << "{" << std::endl;
+  file << "  \"nbgpu\": " << idfx::psize << "," << std::endl;
+  file << "  \"cell_updates\": " << cellUpdates << "," << std::endl;
+  file << "  \"cycles\": " << nCycles << "," << std::endl;
+  file << "  \"run_time\": " << runTime << "," << std::endl;
+  file << "  \"mpi_overhead\": " << 100.0*mpiTime/runTime << "," << std::endl;
+  file << "  \"mpi_overhead_max\": " << 100.0*mpiTimeMax/runTime << "," << std::endl;
+  file << "  \"memory\": {";
+  for(int i=0; i < this->numSpaces ; i++) {
+    file << (i > 0 ? ", " : "") << "\"" << this->spaceName[i] << "\": " << memoryMax[i];
+  }
+  file << "}," << std::endl;
+  // Timings of the regions are only available with -profile
+  file << "  \"regions\": [";
+  if(perfEnabled) {
+    bool first = true;
+    file << std::endl;
+    rootRegion.Report(file, "", first);
+    file << std::endl << "  ";
+  }
+  file << "]," << std::endl;
+  // Kernel statistics are only available with -kernels or -trace
+  file << "  \"kernels\": [";
+  bool first = true;
+  for(auto &it : SortKernels(kernels)) {
+    const KernelStats &stats = *it.second;
+    file << (first ? "" : ",") << std::endl;
+    first = false;
+    file << "    {\"name\": \"" << JsonEscape(*it.first) << "\", \"time\": " << stats.totalTime
+         << ", \"calls\": " << stats.nCalls << ", \"min\": " << stats.minTime
+         << ", \"max\": " << stats.maxTime << ", \"bytes\": " << stats.bytes << "}";
+  }
+  if(!first) file << std::endl << "  ";
+  file << "]" << std::endl;
+  file << "}" << std::endl;
+  file.close();
+}
+
+void idfx::Profiler::EnableKernelProfiling(bool trace) {
+  traceEnabled = traceEnabled || trace;
+  if(kernelsEnabled) return;
+  kernelsEnabled = true;
+  idfx::profileKernels = true;
+  Kokkos::Tools::Experimental::set_begin_parallel_for_callback(&kokkosp_begin_kernel);
+  Kokkos::Tools::Experimental::set_end_parallel_for_callback(&kokkosp_end_kernel);
+  Kokkos::Tools::Experimental::set_begin_parallel_reduce_callback(&kokkosp_begin_kernel);
+  Kokkos::Tools::Experimental::set_end_parallel_reduce_callback(&kokkosp_end_kernel);
+  Kokkos::Tools::Experimental::set_begin_parallel_scan_callback(&kokkosp_begin_kernel);
+  Kokkos::Tools::Experimental::set_end_parallel_scan_callback(&kokkosp_end_kernel);
+  Kokkos::Tools::Experimental::set_begin_deep_copy_callback(&kokkosp_begin_deep_copy);
+  Kokkos::Tools::Experimental::set_end_deep_copy_callback(&kokkosp_end_deep_copy);
+  // Common origin of the timelines of all of the processes
+  #ifdef WITH_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+  #endif
+  kernelTimer.reset();
+}
+
+void idfx::Profiler::SetKernelWork(int64_t iterations, size_t captureSize) {
+  // Rough estimate, assuming that each array captured by the kernel is read or written once
+  // per iteration (the other captured variables being negligible)
+  const size_t nArrays = std::max<size_t>(1, captureSize / sizeof(IdefixArray3D<real>));
+  nextBytes = static_cast<double>(iterations) * nArrays * sizeof(real);
+}
+
+void idfx::Profiler::SetKernelBytes(double bytes) {
+  nextBytes = bytes;
+}
+
+void idfx::Profiler::BeginKernel(const std::string &name) {
+  // Kokkos fences the kernels when tool callbacks are registered, so that the time measured
+  // between BeginKernel and EndKernel is the actual execution time of the kernel. Nested kernels
+  // (e.g. launched by a deep_copy) are also counted in the time of the enclosing one.
+  auto it = kernels.try_emplace(name).first;
+  activeKernels.push_back({&it->second, &it->first, kernelTimer.seconds(), nextBytes});
+  nextBytes = 0;
+}
+
+void idfx::Profiler::EndKernel() {
+  if(activeKernels.empty()) return;
+  const ActiveKernel kernel = activeKernels.back();
+  activeKernels.pop_back();
+  const double duration = kernelTimer.seconds() - kernel.start;
+  KernelStats &stats = *kernel.stats;
+  if(stats.nCalls == 0 || duration < stats.minTime) stats.minTime = duration;
+  if(duration > stats.maxTime) stats.maxTime = duration;
+  stats.nCalls++;
+  stats.totalTime += duration;
+  stats.bytes += kernel.bytes;
+  if(traceEnabled && events.size() < maxTraceEvents) {
+    events.push_back({kernel.name, kernel.start, duration});
+  }
+}
+
+void idfx::Profiler::ShowKernels() {
+  double totalTime = 0;
+  for(auto &it : kernels) totalTime += it.second.totalTime;
+
+  idfx::cout << "Profiler: kernel report: " << std::endl;
+  idfx::cout << "-------------------------------------------------------------------------------";
+  idfx::cout << std::endl;
+  idfx::cout << "<total time>  <% of kernel time>  <number of calls>  <mean/min/max time>"
+             << "  <estimated bandwidth>  <name>" << std::endl;
+  idfx::cout << "-------------------------------------------------------------------------------";
+  idfx::cout << std::endl;
+  for(auto &it : SortKernels(kernels)) {
+    const KernelStats &stats = *it.second;
+    idfx::cout << std::scientific << std::setprecision(2) << stats.totalTime << " sec  "
+               << std::fixed << std::setprecision(1) << stats.totalTime/totalTime*100 << "%  "
+               << stats.nCalls << "  "
+               << std::scientific << std::setprecision(2)
+               << stats.totalTime/stats.nCalls << "/" << stats.minTime << "/" << stats.maxTime
+               << " sec  ";
+    if(stats.bytes > 0 && stats.totalTime > 0) {
+      idfx::cout << std::fixed << std::setprecision(1) << stats.bytes/stats.totalTime/1e9
+                 << " GB/s  ";
+    } else {
+      idfx::cout << "- GB/s  ";
+    }
+    idfx::cout << *it.first << std::endl;
+  }
+  idfx::cout << "-------------------------------------------------------------------------------";
+  idfx::cout << std::endl;
+  idfx::cout << "Profiler: end of kernel report." << std::endl;
+}
+
+void idfx::Profiler::WriteTrace() {
+  // One timeline per process, which can be loaded in chrome://tracing or ui.perfetto.dev
+  std::stringstream filename;
+  filename << "idefix.trace." << idfx::prank << ".json";
+  std::ofstream file(filename.str());
+  if(!file.is_open()) {
+    IDEFIX_WARNING("Profiler: cannot open "+filename.str());
+    return;
+  }
+  file << std::fixed << std::setprecision(3);
+  file << "{\"traceEvents\": [" << std::endl;
+  file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << idfx::prank
+       << ", \"args\": {\"name\": \"rank " << idfx::prank << "\"}}";
+  for(const KernelEvent &event : events) {
+    file << "," << std::endl;
+    file << "{\"name\": \"" << JsonEscape(*event.name) << "\", \"cat\": \"kernel\", "
+         << "\"ph\": \"X\", \"ts\": " << event.start*1e6 << ", \"dur\": " << event.duration*1e6
+         << ", \"pid\": " << idfx::prank << ", \"tid\": 0}";
+  }
+  file << std::endl << "]}" << std::endl;
+  file.close();
+  if(events.size() >= maxTraceEvents) {
+    IDEFIX_WARNING("Profiler: the kernel timeline was truncated to its first events");
+  }
 }
 
 void idfx::Profiler::EnablePerformanceProfiling() {
@@ -201,3 +432,14 @@ void idfx::Region::Show(double totTime) {
         }
   }
 }
+
+void idfx::Region::Report(std::ostream &os, const std::string &path, bool &first) {
+  const std::string fullName = path.empty() ? this->name : path + "/" + this->name;
+  if(!first) os << "," << std::endl;
+  first = false;
+  os << "    {\"name\": \"" << fullName << "\", \"time\": " << this->myTime
+     << ", \"calls\": " << this->nCalls << "}";
+  for( auto &it : this->children) {
+    it.second->Report(os, fullName, first);
+  }
+}
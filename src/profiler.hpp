@@ -10,7 +10,9 @@
 
 #include <map>
 #include <mutex>  // NOLINT [build/c++11]
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace idfx {
 
@@ -29,6 +31,7 @@ class Region {
   void Start();
   void Stop();
   void Show(double );
+  void Report(std::ostream &, const std::string &, bool &);   // json timings of the region tree
   Region* GetChild(std::string name);
   double GetTimer();
   static bool Compare(Region *, Region *);
@@ -44,11 +47,49 @@ class Region {
 };
 
 
+// Statistics of the kernels sharing the same name
+struct KernelStats {
+  int64_t nCalls{0};
+  double totalTime{0};
+  double minTime{0};
+  double maxTime{0};
+  double bytes{0};            // estimated # of bytes moved by all of the calls
+};
+
+// A kernel launch in the timeline of this process (Chrome trace format)
+struct KernelEvent {
+  const std::string *name;    // key of the kernel in Profiler::kernels
+  double start;
+  double duration;
+};
+
+// A kernel (or deep_copy) which has begun and not yet ended
+struct ActiveKernel {
+  KernelStats *stats;
+  const std::string *name;    // key of the kernel in Profiler::kernels
+  double start;
+  double bytes;               // estimated # of bytes of the kernel
+};
+
 class Profiler {
  public:
   void Init();
   void Show();
+  // Write a json report of the run, following the results of doc/source/bench.json
+  void WriteReport(const std::string &, double, double, int64_t);
   void EnablePerformanceProfiling();
+
+  // Kernel profiling, from the Kokkos Tools callbacks
+  void EnableKernelProfiling(bool trace);
+  void SetKernelWork(int64_t, size_t);         // work of the next kernel (see loop.hpp)
+  void SetKernelBytes(double);                 // bytes moved by the next kernel
+  void BeginKernel(const std::string &);
+  void EndKernel();
+  void ShowKernels();
+  void WriteTrace();
+  bool kernelsEnabled{false};
+  bool traceEnabled{false};
+
   int numSpaces;
   int64_t spaceSize[16];
   int64_t spaceMax[16];
@@ -58,6 +99,14 @@ class Profiler {
   bool perfEnabled{false};
   Region rootRegion;
   Region *currentRegion;
+
+ private:
+  std::map<std::string, KernelStats> kernels;
+  std::vector<KernelEvent> events;
+  Kokkos::Timer kernelTimer;          // origin of the timeline
+  // Kernels being executed, innermost last (a deep_copy can launch a kernel of its own)
+  std::vector<ActiveKernel> activeKernels;
+  double nextBytes{0};                // estimated # of bytes of the next kernel
 };
 
 
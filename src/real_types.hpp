@@ -24,6 +24,18 @@
   #endif
 #endif // SINGLE_PRECISION
 
+// Storage type of the large cell-centered arrays of the fluids (primitive and conservative
+// variables, Riemann fluxes and RKL registers). In mixed precision, these arrays are stored in
+// single precision while the arithmetic is done in double precision.
+#ifdef MIXED_PRECISION
+  #ifdef SINGLE_PRECISION
+    #error "MIXED_PRECISION and SINGLE_PRECISION are mutually exclusive"
+  #endif
+  using realStore = float;
+#else
+  using realStore = real;
+#endif // MIXED_PRECISION
+
 // math function
 #ifdef SINGLE_PRECISION
 
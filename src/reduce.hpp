@@ -23,6 +23,7 @@ inline void idefix_reduce(const std::string & NAME,
                 const int & IB, const int & IE,
                 Function function,
                 Reducer redFunction) {
+    idfx::KernelWork<Function>(static_cast<int64_t>(IE-IB));
     #ifdef DEBUG
     idfx::pushRegion("idefix_reduce("+NAME+")");
     #endif
@@ -41,6 +42,7 @@ inline void idefix_reduce(const std::string & NAME,
                 const int & IB, const int & IE,
                 Function function,
                 Reducer redFunction) {
+    idfx::KernelWork<Function>(static_cast<int64_t>(JE-JB)*(IE-IB));
     #ifdef DEBUG
     idfx::pushRegion("idefix_reduce("+NAME+")");
     #endif
@@ -67,6 +69,7 @@ inline void idefix_reduce(const std::string & NAME,
                 Reducer redFunction) {
     // We only implement MDRange reductions here since the other implementations are too
     // complicated to be implemented for any reduction operator on any class
+    idfx::KernelWork<Function>(static_cast<int64_t>(KE-KB)*(JE-JB)*(IE-IB));
     #ifdef DEBUG
     idfx::pushRegion("idefix_reduce("+NAME+")");
     #endif
@@ -91,6 +94,7 @@ inline void idefix_reduce(const std::string & NAME,
                 Reducer redFunction) {
     // We only implement MDRange reductions here since the other implementations are too
     // complicated to be implemented for any reduction operator on any class
+    idfx::KernelWork<Function>(static_cast<int64_t>(NE-NB)*(KE-KB)*(JE-JB)*(IE-IB));
     #ifdef DEBUG
     idfx::pushRegion("idefix_reduce("+NAME+")");
     #endif
@@ -35,12 +35,12 @@ class RKLegendre {
   template <int> void CalcParabolicRHS(real);
   void ComputeDt();
   void ShowConfig();
-  void Copy(IdefixArray4D<real>&, IdefixArray4D<real>&);
+  void Copy(IdefixArray4D<realStore>&, IdefixArray4D<realStore>&);
 
-  IdefixArray4D<real> dU;      // variation of main cell-centered conservative variables
-  IdefixArray4D<real> dU0;      // dU of the first stage
-  IdefixArray4D<real> Uc0;      // Uc at initial stage
-  IdefixArray4D<real> Uc1;      // Uc of the previous stage, Uc1 = Uc(stage-1)
+  IdefixArray4D<realStore> dU;      // variation of main cell-centered conservative variables
+  IdefixArray4D<realStore> dU0;      // dU of the first stage
+  IdefixArray4D<realStore> Uc0;      // Uc at initial stage
+  IdefixArray4D<realStore> Uc1;      // Uc of the previous stage, Uc1 = Uc(stage-1)
 
   IdefixArray4D<real> dB;      // Variation of cell-centered magnetic variables
   IdefixArray4D<real> dB0;     // dB of the first stage
@@ -106,7 +106,7 @@ void RKLegendre<Phys>::AddVariable(int var, std::vector<int> &varListHost ) {
 
 // Copy just the variables required by the RK scheme
 template<typename Phys>
-void RKLegendre<Phys>::Copy(IdefixArray4D<real> &out, IdefixArray4D<real> &in) {
+void RKLegendre<Phys>::Copy(IdefixArray4D<realStore> &out, IdefixArray4D<realStore> &in) {
   IdefixArray1D<int> vars = this->varList;
 
   idefix_for("RKL_Copy",
@@ -204,13 +204,13 @@ RKLegendre<Phys>::RKLegendre(Input &input, Fluid<Phys>* hydroin) {
 
   // Variable allocation
 
-  dU = IdefixArray4D<real>("RKL_dU", NVAR,
+  dU = IdefixArray4D<realStore>("RKL_dU", NVAR,
                            data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  dU0 = IdefixArray4D<real>("RKL_dU0", NVAR,
+  dU0 = IdefixArray4D<realStore>("RKL_dU0", NVAR,
                            data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  Uc0 = IdefixArray4D<real>("RKL_Uc0", NVAR,
+  Uc0 = IdefixArray4D<realStore>("RKL_Uc0", NVAR,
                            data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
-  Uc1 = IdefixArray4D<real>("RKL_Uc1", NVAR,
+  Uc1 = IdefixArray4D<realStore>("RKL_Uc1", NVAR,
                            data->np_tot[KDIR], data->np_tot[JDIR], data->np_tot[IDIR]);
 
   if(haveVs) {
@@ -282,11 +282,11 @@ template<typename Phys>
 void RKLegendre<Phys>::Cycle() {
   idfx::pushRegion("RKLegendre::Cycle");
 
-  IdefixArray4D<real> dU = this->dU;
-  IdefixArray4D<real> dU0 = this->dU0;
-  IdefixArray4D<real> Uc = hydro->Uc;
-  IdefixArray4D<real> Uc0 = this->Uc0;
-  IdefixArray4D<real> Uc1 = this->Uc1;
+  IdefixArray4D<realStore> dU = this->dU;
+  IdefixArray4D<realStore> dU0 = this->dU0;
+  IdefixArray4D<realStore> Uc = hydro->Uc;
+  IdefixArray4D<realStore> Uc0 = this->Uc0;
+  IdefixArray4D<realStore> Uc1 = this->Uc1;
 
   IdefixArray4D<real> dB = this->dB;
   IdefixArray4D<real> dB0 = this->dB0;
@@ -557,7 +557,7 @@ void RKLegendre<Phys>::Cycle() {
 template<typename Phys>
 void RKLegendre<Phys>::ResetFlux() {
   idfx::pushRegion("RKLegendre::ResetFlux");
-  IdefixArray4D<real> Flux = hydro->FluxRiemann;
+  IdefixArray4D<realStore> Flux = hydro->FluxRiemann;
   IdefixArray1D<int> vars = this->varList;
   idefix_for("RKL_ResetFlux",
              0,nvarRKL,
@@ -595,8 +595,8 @@ struct RKLegendre_ResetStageFunctor {
     }
   }
 
-  IdefixArray4D<real> dU;
-  IdefixArray4D<real> Flux;
+  IdefixArray4D<realStore> dU;
+  IdefixArray4D<realStore> Flux;
   IdefixArray1D<int> vars;
   IdefixArray4D<real> dA, dB;
   IdefixArray3D<real> ex,ey,ez;
@@ -724,7 +724,7 @@ template <int dir>
 void RKLegendre<Phys>::CalcParabolicRHS(real t) {
   idfx::pushRegion("RKLegendre::CalcParabolicRHS");
 
-  IdefixArray4D<real> Flux = hydro->FluxRiemann;
+  IdefixArray4D<realStore> Flux = hydro->FluxRiemann;
   IdefixArray3D<real> A    = data->A[dir];
   IdefixArray3D<real> dV   = data->dV;
   IdefixArray1D<real> x1m  = data->xl[IDIR];
@@ -738,7 +738,7 @@ void RKLegendre<Phys>::CalcParabolicRHS(real t) {
   IdefixArray3D<real> invDt = hydro->InvDt;
   IdefixArray3D<real> dMax = hydro->dMax;
   IdefixArray4D<real> viscSrc;
-  IdefixArray4D<real> dU = this->dU;
+  IdefixArray4D<realStore> dU = this->dU;
   IdefixArray1D<int> varList = this->varList;
 
   bool haveViscosity = hydro->viscosityStatus.isRKL;
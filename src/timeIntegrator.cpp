@@ -7,6 +7,7 @@
 
 //#define WITH_TEMPERATURE_SENSOR
 
+#include <algorithm>
 #include <cstdio>
 #include <iomanip>
 #include <string>
@@ -44,8 +45,14 @@ TimeIntegrator::TimeIntegrator(Input & input, DataBlock & data) {
   this->cyclePeriod = input.GetOrSet<int>("Output","log",0, 100);
   this->maxRuntime = 3600*input.GetOrSet<double>("TimeIntegrator","max_runtime",0.0,-1.0);
 
+  // Nans can be counted by the kernels which read every cell (ConsToPrim and the timestep
+  // reduction), in which case they are cheap enough to be checked every cycle
+  this->nanTracking = input.GetOrSet<bool>("TimeIntegrator","nan_tracking", 0, false);
+  if(nanTracking) data.EnableNanTracking();
+
   // check nan periodicity every 100 loops
-  this->checkNanPeriodicity = input.GetOrSet<int>("TimeIntegrator","check_nan", 0, 100);
+  this->checkNanPeriodicity = input.GetOrSet<int>("TimeIntegrator","check_nan", 0,
+                                                  nanTracking ? 1 : 100);
 
   #ifndef SINGLE_PRECISION
     const real maxdivBDefault = 1e-6;
@@ -59,15 +66,63 @@ TimeIntegrator::TimeIntegrator(Input & input, DataBlock & data) {
   data.t=0.0;
   ncycles=0;
 
-  if(nstages==2) {
-    wc[0] = 0.5;
-    w0[0] = 0.5;
-  }
-  if(nstages==3) {
-    wc[0] = 0.25;
-    w0[0] = 0.75;
-    wc[1] = 2.0/3.0;
-    w0[1] = 1.0/3.0;
+  // Build the stages of the integrator
+  this->scheme = input.GetOrSet<std::string>("TimeIntegrator","scheme",0,"tvd");
+  stages = std::vector<Stage>(std::max(nstages,1));
+  if(scheme.compare("tvd")==0) {
+    // Classic TVD Runge-Kutta schemes of Shu & Osher (1988)
+    if(nstages==2) {
+      stages[0].store = true;
+      stages[1].combine = true;
+      stages[1].wc = 0.5;
+      stages[1].w0 = 0.5;
+    } else if(nstages==3) {
+      stages[0].store = true;
+      stages[1].combine = true;
+      stages[1].wc = 0.25;
+      stages[1].w0 = 0.75;
+      stages[2].combine = true;
+      stages[2].wc = 2.0/3.0;
+      stages[2].w0 = 1.0/3.0;
+    } else if(nstages!=1) {
+      IDEFIX_ERROR("The tvd time integrator requires nstages=1, 2 or 3");
+    }
+  } else if(scheme.compare("ssprk3")==0) {
+    // Low-storage SSPRK(n^2,3) of Ketcheson (2008): n^2 forward Euler steps of dt/(n^2-n),
+    // a single combination with the state saved before step (n-1)(n-2)/2
+    int n = 2;
+    while(n*n < nstages) n++;
+    if(n*n != nstages) {
+      IDEFIX_ERROR("The ssprk3 time integrator requires nstages to be a perfect square >= 4");
+    }
+    const int r = nstages - n;
+    for(Stage &s : stages) s.dtFactor = ONE_F/r;
+    stages[(n-1)*(n-2)/2].store = true;
+    Stage &s = stages[n*(n+1)/2-1];
+    s.combine = true;
+    s.wc = static_cast<real>(n-1)/(2*n-1);
+    s.w0 = static_cast<real>(n)/(2*n-1);
+    sspCoefficient = r;
+  } else if(scheme.compare("ssprk104")==0) {
+    // Low-storage SSPRK(10,4) of Ketcheson (2008): 10 forward Euler steps of dt/6
+    if(nstages != 10) {
+      IDEFIX_ERROR("The ssprk104 time integrator requires nstages=10");
+    }
+    for(Stage &s : stages) s.dtFactor = ONE_F/6.0;
+    stages[0].store = true;
+    stages[4].combine = true;
+    stages[4].updateBegin = true;
+    stages[4].ab = 1.0/25.0;
+    stages[4].bb = 9.0/25.0;
+    stages[4].wc = -5.0;
+    stages[4].w0 = 15.0;
+    stages[9].combine = true;
+    stages[9].wc = 3.0/5.0;
+    stages[9].w0 = 1.0;
+    sspCoefficient = 6.0;
+  } else {
+    IDEFIX_ERROR("Unknown time integrator scheme "+scheme
+                 +". Possible values are tvd, ssprk3 and ssprk104");
   }
 
   // Init the RKL scheme if it's needed
@@ -81,6 +136,53 @@ TimeIntegrator::TimeIntegrator(Input & input, DataBlock & data) {
     data.states["begin"].AllocateAs(data.states["current"]);
   }
 
+  // Streamlined stages: the conversions between primitive and conservative variables are
+  // restricted to the active cells, and fused with the copy and the combination of the states
+  this->streamlined = input.GetOrSet<bool>("TimeIntegrator","streamlined", 0, false);
+  if(streamlined) {
+    if(data.haveFargo || data.haveGridCoarsening || data.haveFusedDust || data.haveBlocks
+        || data.haveRefinement || data.mygrid->level > 0) {
+      IDEFIX_WARNING("Streamlined stages are not compatible with Fargo, grid coarsening, "
+                     "fused dust, blocks and mesh refinement. Falling back to the standard "
+                     "stages.");
+      streamlined = false;
+    } else {
+      // Memory traffic of the full array passes which are saved (in bytes per cycle)
+      int64_t nTot = 1;
+      int64_t nAct = 1;
+      for(int dir = 0 ; dir < 3 ; dir++) {
+        nTot *= data.np_tot[dir];
+        nAct *= data.np_int[dir];
+      }
+      auto savedBytes = [&](int64_t nu, int64_t nv) {
+        int64_t standard = 0;
+        int64_t fused = 0;
+        for(const Stage &s : stages) {
+          // PrimToCons, CopyFrom, ConsToPrim and AddAndStore of the standard stages
+          standard += 4*nv*nTot + (s.store ? 2*nu*nTot : 0);
+          // PrimToConsAndStore and AddAndConsToPrim
+          fused += 2*nv*nAct + (s.store ? (nv+2*(nu-nv))*nAct : 0);
+          // (stages updating the begin state are combined as in the standard stages)
+          if(s.combine && !s.updateBegin) {
+            standard += 3*nu*nTot;
+            fused += (3*nu+nv)*nAct;
+          } else {
+            fused += 2*nv*nAct;
+          }
+        }
+        return(static_cast<double>((standard-fused)*sizeof(realStore)));
+      };
+      streamlinedSavedBytes = savedBytes(data.hydro->Uc.extent(0),
+                                         data.hydro->Uc.extent(0)-data.hydro->nTracer);
+      if(data.haveDust) {
+        for(int n = 0 ; n < data.dust.size() ; n++) {
+          streamlinedSavedBytes += savedBytes(data.dust[n]->Uc.extent(0),
+                                              data.dust[n]->Uc.extent(0)-data.dust[n]->nTracer);
+        }
+      }
+    }
+  }
+
   idfx::popRegion();
 }
 
@@ -135,7 +237,7 @@ void TimeIntegrator::ShowLog(DataBlock &data) {
 
   #ifdef WITH_MPI
     double imbalance = 0;
-    if(ncycles>=cyclePeriod) imbalance = ComputeBalance();
+    if(ncycles>=cyclePeriod) imbalance = ComputeBalance(data);
   #endif
   idfx::cout << "TimeIntegrator: ";
   idfx::cout << std::scientific;
@@ -193,7 +295,7 @@ void TimeIntegrator::ShowLog(DataBlock &data) {
   idfx::cout << std::endl;
 }
 
-double TimeIntegrator::ComputeBalance() {
+double TimeIntegrator::ComputeBalance(DataBlock &data) {
   // Check MPI imbalance
     double imbalance = 0;
     #ifdef WITH_MPI
@@ -203,6 +305,9 @@ double TimeIntegrator::ComputeBalance() {
                   MPI_COMM_WORLD);
       computeLastLog = 0; // reset timer for all cores
       if(idfx::prank==0) {
+        // Keep track of the load of each part of the grid, to balance the decomposition on restart
+        data.mygrid->AddMeasuredLoad(computeLogPerCore);
+
         // Compute the average, the min and the max
         double computeMin = computeLogPerCore[0];
         double computeMax = computeLogPerCore[0];
@@ -245,9 +350,6 @@ double TimeIntegrator::ComputeBalance() {
 // Compute one full cycle of the time Integrator
 void TimeIntegrator::Cycle(DataBlock &data) {
   // Do one cycle
-  IdefixArray3D<real> InvDt = data.hydro->InvDt;
-  real newdt;
-
   idfx::pushRegion("TimeIntegrator::Cycle");
 
   if(ncycles%cyclePeriod==0) ShowLog(data);
@@ -262,30 +364,104 @@ void TimeIntegrator::Cycle(DataBlock &data) {
   // save t at the begining of the cycle
   const real t0 = data.t;
 
+  EvolveStages(data, true);
+
+  if(haveRKL && (ncycles%2)==0) {    // Runge-Kutta-Legendre cycle
+    data.EvolveRKLStage();
+  }
+
+  // Update planet position
+  if(data.haveplanetarySystem) {
+    data.planetarySystem->EvolveSystem(data, data.dt);
+  }
+
+  // Coarsen the grid
+  if(data.haveGridCoarsening) {
+    data.Coarsen();
+  }
+
+  // Launch user step last
+  data.LaunchUserStepLast();
+
+  // Update current time (should have already been done, but this gets rid of roundoff errors)
+  data.t=t0+data.dt;
+
+  if(haveRKL) {
+    // update next time step
+    real tt = newdt/data.hydro->rkl->dt;
+    newdt *= std::fmin(ONE_F, data.hydro->rkl->rmax_par/(tt));
+  }
+
+  // Next time step
+  if(!haveFixedDt) {
+    if(newdt>cflMaxVar*data.dt) {
+      data.dt=cflMaxVar*data.dt;
+    } else {
+      if(ncycles==0 && newdt < 0.5*data.dt) {
+        std::stringstream msg;
+        msg << "Your guessed first_dt is too large. My next dt=" << newdt << std::endl;
+        msg << "Try to reduce first_dt in the ini file.";
+        IDEFIX_ERROR(msg);
+      }
+      data.dt=newdt;
+    }
+    if(data.dt < 1e-15) {
+      std::stringstream msg;
+      msg << "dt = " << data.dt << " is too small.";
+      throw std::runtime_error(msg.str());
+    }
+  } else {
+    data.dt = fixedDt;
+  }
+
+
+  ncycles++;
+
+  idfx::popRegion();
+}
+
+// Evolve the datablock by the stages of the integrator over data.dt. The next timestep is
+// computed during the first stage, and reduced between the processes of the level when reduceDt
+// is set.
+void TimeIntegrator::EvolveStages(DataBlock &data, bool reduceDt) {
+  idfx::pushRegion("TimeIntegrator::EvolveStages");
+  // save t at the begining of the cycle
+  const real t0 = data.t;
+  // time of the begin state
+  real tBegin = t0;
+  // full time step of the cycle (each stage may only advance by a fraction of it)
+  const real dt = data.dt;
+
   // Reinit datablock for a new stage
   data.ResetStage();
 
-#ifdef WITH_MPI
-  MPI_Request dtReduce;
-#endif
-
   /////////////////////////////////////////////////
   // BEGIN STAGES LOOP                           //
   /////////////////////////////////////////////////
   for(int stage=0; stage < nstages ; stage++) {
-    // Apply Boundary conditions
-    data.SetBoundaries();
+    const Stage &s = stages[stage];
+    // Apply Boundary conditions (MPI exchanges may complete during EvolveStage)
+    data.StartBoundaries();
+
+    // Save the state of the coarse level which is interpolated in the ghost zones of the finer one
+    if(stage==0 && data.haveRefinement) data.refinement->StartStep();
 
     // Remove Fargo velocity so that the integrator works on the residual
     if(data.haveFargo) data.fargo->SubstractVelocity(data.t);
 
-    // Convert current state into conservative variable and save it
-    data.PrimToCons();
+    if(streamlined) {
+      // Convert current state into conservative variable, storing it if required
+      data.PrimToConsAndStore(s.store);
+    } else {
+      // Convert current state into conservative variable and save it
+      data.PrimToCons();
 
-    // Store (deep copy) initial stage for multi-stage time integrators
-    if(nstages>1 && stage==0) {
-      data.states["begin"].CopyFrom(data.states["current"]);
+      // Store (deep copy) the begin stage for multi-stage time integrators
+      if(s.store) {
+        data.states["begin"].CopyFrom(data.states["current"]);
+      }
     }
+    if(s.store) tBegin = data.t;
     // If gravity is needed, update it
     if(data.haveGravity) {
       if(ncycles % data.gravity->skipGravity == 0) data.gravity->ComputeGravity(ncycles);
@@ -293,17 +469,19 @@ void TimeIntegrator::Cycle(DataBlock &data) {
 
     Kokkos::fence();
     computeLastLog -= timer.seconds();
-    // Update Uc & Vs
+    // Update Uc & Vs with a forward Euler step of the stage
+    data.dt = s.dtFactor*dt;
     data.EvolveStage();
     Kokkos::fence();
     computeLastLog += timer.seconds();
 
     // evolve dt accordingly
     data.t += data.dt;
+    data.dt = dt;
 
     // Look for Nans every now and then (this actually cost a lot of time on GPUs
     // because streams are divergent)
-    if(ncycles%checkNanPeriodicity==0) {
+    if(!nanTracking && ncycles%checkNanPeriodicity==0) {
       if(data.CheckNan()>0) {
         throw std::runtime_error(std::string("Nan found after integration cycle"));
       }
@@ -312,25 +490,29 @@ void TimeIntegrator::Cycle(DataBlock &data) {
     // Compute next time_step during first stage
     if(stage==0) {
       if(!haveFixedDt) {
-        newdt = cfl*data.ComputeTimestep();
+        stableDt = data.ComputeTimestep();
+        newdt = cfl*sspCoefficient*stableDt;
         #ifdef WITH_MPI
-          if(idfx::psize>1) {
-            MPI_SAFE_CALL(MPI_Iallreduce(MPI_IN_PLACE, &newdt, 1, realMPI, MPI_MIN, MPI_COMM_WORLD,
-                                        &dtReduce));
+          if(reduceDt && idfx::psize>1) {
+            MPI_SAFE_CALL(MPI_Iallreduce(MPI_IN_PLACE, &newdt, 1, realMPI, MPI_MIN,
+                                        data.mygrid->CartComm, &dtReduce));
           }
         #endif
       }
     }
 
-    // Is this not the first stage?
-    if(stage>0) {
-      // do the partial evolution required by the multi-step
-      real wcs=wc[stage-1];
-      real w0s=w0[stage-1];
-      data.states["current"].AddAndStore(wcs, w0s, data.states["begin"]);
-
+    // Combine with the begin state?
+    if(s.combine) {
+      if(s.updateBegin) {
+        // Both states are updated in a single pass
+        data.states["current"].AddAndStore(s.wc, s.w0, data.states["begin"], s.ab, s.bb);
+        tBegin = s.ab*tBegin + s.bb*data.t;
+      } else if(!streamlined) {
+        // (done along with the conversion to primitive variables in streamlined stages)
+        data.states["current"].AddAndStore(s.wc, s.w0, data.states["begin"]);
+      }
       // update t
-      data.t = wcs*data.t + w0s*t0;
+      data.t = s.wc*data.t + s.w0*tBegin;
     }
     // Shift solution according to fargo if this is our last stage
     if(data.haveFargo && stage==nstages-1) {
@@ -343,7 +525,15 @@ void TimeIntegrator::Cycle(DataBlock &data) {
     }
 
     // Back to using Vc
-    data.ConsToPrim();
+    if(streamlined) {
+      if(s.combine && !s.updateBegin) {
+        data.AddAndConsToPrim(s.wc, s.w0, true);
+      } else {
+        data.AddAndConsToPrim(ONE_F, ZERO_F, false);
+      }
+    } else {
+      data.ConsToPrim();
+    }
 
     // Add back fargo velocity so that boundary conditions are applied on the total V
     if(data.haveFargo) data.fargo->AddVelocity(data.t);
@@ -352,65 +542,41 @@ void TimeIntegrator::Cycle(DataBlock &data) {
   // END STAGES LOOP                             //
   /////////////////////////////////////////////////
 
+  // Nans counted during the stages of this cycle
+  if(nanTracking && ncycles%checkNanPeriodicity==0) {
+    if(data.GetTrackedNans()>0) {
+      // Locate the Nans with a full check
+      data.CheckNan();
+      throw std::runtime_error(std::string("Nan found after integration cycle"));
+    }
+  }
+
   // Wait for dt MPI reduction
 #ifdef WITH_MPI
-  if(!haveFixedDt && idfx::psize>1) {
+  if(reduceDt && !haveFixedDt && idfx::psize>1) {
     MPI_SAFE_CALL(MPI_Wait(&dtReduce, MPI_STATUS_IGNORE));
   }
 #endif
 
-  if(haveRKL && (ncycles%2)==0) {    // Runge-Kutta-Legendre cycle
-    data.EvolveRKLStage();
-  }
-
-  // Update planet position
-  if(data.haveplanetarySystem) {
-    data.planetarySystem->EvolveSystem(data, data.dt);
-  }
-
-  // Coarsen the grid
-  if(data.haveGridCoarsening) {
-    data.Coarsen();
+  // Synchronise the refined levels with this step
+  if(data.haveRefinement) {
+    data.refinement->Advance(t0, dt);
   }
+  idfx::popRegion();
+}
 
-  // Launch user step last
+// Evolve a refined level by one substep of its coarser level (data.dt), and return the largest
+// stable timestep of the level
+real TimeIntegrator::Substep(DataBlock &data) {
+  idfx::pushRegion("TimeIntegrator::Substep");
+  data.LaunchUserStepFirst();
+  const real t0 = data.t;
+  EvolveStages(data, false);
   data.LaunchUserStepLast();
-
-  // Update current time (should have already been done, but this gets rid of roundoff errors)
-  data.t=t0+data.dt;
-
-  if(haveRKL) {
-    // update next time step
-    real tt = newdt/data.hydro->rkl->dt;
-    newdt *= std::fmin(ONE_F, data.hydro->rkl->rmax_par/(tt));
-  }
-
-  // Next time step
-  if(!haveFixedDt) {
-    if(newdt>cflMaxVar*data.dt) {
-      data.dt=cflMaxVar*data.dt;
-    } else {
-      if(ncycles==0 && newdt < 0.5*data.dt) {
-        std::stringstream msg;
-        msg << "Your guessed first_dt is too large. My next dt=" << newdt << std::endl;
-        msg << "Try to reduce first_dt in the ini file.";
-        IDEFIX_ERROR(msg);
-      }
-      data.dt=newdt;
-    }
-    if(data.dt < 1e-15) {
-      std::stringstream msg;
-      msg << "dt = " << data.dt << " is too small.";
-      throw std::runtime_error(msg.str());
-    }
-  } else {
-    data.dt = fixedDt;
-  }
-
-
+  data.t = t0 + data.dt;
   ncycles++;
-
   idfx::popRegion();
+  return(stableDt);
 }
 
 int64_t TimeIntegrator::GetNCycles() {
@@ -446,7 +612,13 @@ bool TimeIntegrator::CheckForMaxRuntime() {
 }
 
 void TimeIntegrator::ShowConfig() {
-  if(nstages==1) {
+  if(scheme.compare("ssprk3")==0) {
+    idfx::cout << "TimeIntegrator: using low-storage 3rd Order SSPRK(" << nstages
+               << ",3) integrator." << std::endl;
+  } else if(scheme.compare("ssprk104")==0) {
+    idfx::cout << "TimeIntegrator: using low-storage 4th Order SSPRK(10,4) integrator."
+               << std::endl;
+  } else if(nstages==1) {
     idfx::cout << "TimeIntegrator: using 1st Order (EULER) integrator." << std::endl;
   } else if(nstages==2) {
     idfx::cout << "TimeIntegrator: using 2nd Order (RK2) integrator." << std::endl;
@@ -460,8 +632,21 @@ void TimeIntegrator::ShowConfig() {
               << std::endl;
   } else {
     idfx::cout << "TimeIntegrator: Using adaptive dt with CFL=" << cfl << " ." << std::endl;
+    if(sspCoefficient != ONE_F) {
+      idfx::cout << "TimeIntegrator: dt is " << sspCoefficient << " times the CFL timestep ("
+                 << sspCoefficient/nstages << " per stage)." << std::endl;
+    }
   }
   if(maxRuntime>0) {
     idfx::cout << "TimeIntegrator: will stop after " << maxRuntime/3600 << " hours." << std::endl;
   }
+  if(streamlined) {
+    idfx::cout << "TimeIntegrator: using streamlined stages, saving "
+               << streamlinedSavedBytes/1024.0/1024.0 << " MB of memory traffic per cycle."
+               << std::endl;
+  }
+  if(nanTracking) {
+    idfx::cout << "TimeIntegrator: Nans tracked by the fluid kernels, checked every "
+               << checkNanPeriodicity << " cycle(s)." << std::endl;
+  }
 }
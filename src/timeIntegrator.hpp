@@ -8,6 +8,9 @@
 #ifndef TIMEINTEGRATOR_HPP_
 #define TIMEINTEGRATOR_HPP_
 
+#include <limits>
+#include <string>
+#include <vector>
 #include "idefix.hpp"
 #include "dataBlock.hpp"
 #include "rkl.hpp"
@@ -24,6 +27,9 @@ class TimeIntegrator {
   // Do one integration cycle
   void Cycle(DataBlock &);
 
+  // Do one substep of a refined level, returning its largest stable timestep
+  real Substep(DataBlock &);
+
   // check whether we have reached the maximum runtime
   bool CheckForMaxRuntime();
 
@@ -33,20 +39,44 @@ class TimeIntegrator {
   bool isSilent{false};   // Whether the integration should proceed silently
 
  private:
-  double ComputeBalance(); // Compute the compute balance between MPI processes
+  double ComputeBalance(DataBlock &); // Compute the compute balance between MPI processes
+  void EvolveStages(DataBlock &, bool);  // Evolve the stages of one cycle
 
   // Whether we have RKL
   bool haveRKL{false};
 
   int nstages;
-  // Weights of time integrator
-  real w0[2];
-  real wc[2];
+  std::string scheme;     // family of the integrator (tvd, ssprk3 or ssprk104)
+
+  // Stages of the integrator. Each stage is a forward Euler step of dtFactor*dt of the
+  // current state, preceded by a copy of the current state into the "begin" state when store is
+  // set. When combine is set, the step is followed by current = wc*current + w0*begin,
+  // which is itself preceded by begin = ab*begin + bb*current when updateBegin is set.
+  struct Stage {
+    real dtFactor{ONE_F};
+    bool store{false};
+    bool combine{false};
+    real wc{ONE_F};
+    real w0{ZERO_F};
+    bool updateBegin{false};
+    real ab{ONE_F};
+    real bb{ZERO_F};
+  };
+  std::vector<Stage> stages;
+  real sspCoefficient{ONE_F};   // CFL of the scheme in units of the forward Euler CFL
 
   int checkNanPeriodicity{1};
+  bool nanTracking{false};    // Whether Nans are counted by the kernels reading every cell
+  bool streamlined{false};    // Whether the streamlined stages are used
+  double streamlinedSavedBytes{0}; // Memory traffic saved by the streamlined stages per cycle
 
   bool haveFixedDt = false;
   real fixedDt;
+  real newdt;             // next timestep, computed during the first stage
+  real stableDt{std::numeric_limits<real>::max()};  // largest stable timestep of the last cycle
+#ifdef WITH_MPI
+  MPI_Request dtReduce;   // reduction of newdt between the processes
+#endif
 
   real cfl;   // CFL number
   real cflMaxVar; // Max CFL variation number
@@ -37,22 +37,30 @@ class BigEndian {
   template <class T>
   T operator() (T in_number) {
     static_assert(std::is_arithmetic_v<T> == true);
-    T out_number;
     if (this->shouldSwapEndian) {
-      constexpr int size = sizeof(T);
-      union {
-        T u;
-        unsigned char byte[size];
-      } in, out;
-      in.u = in_number;
-      for(int n = 0 ; n < size ; n++) {
-        out.byte[size-n-1] = in.byte[n];
-      }
-      out_number = out.u;
-    } else {
-      out_number = in_number;
+      return(Swap(in_number));
     }
-    return(out_number);
+    return(in_number);
+  }
+
+  // Whether the bytes of the numbers should be reversed
+  bool ShouldSwap() const {
+    return(shouldSwapEndian);
+  }
+
+  // Reverse the bytes of a number (also callable from device kernels)
+  template <class T>
+  KOKKOS_INLINE_FUNCTION static T Swap(T in_number) {
+    constexpr int size = sizeof(T);
+    union {
+      T u;
+      unsigned char byte[size];
+    } in, out;
+    in.u = in_number;
+    for(int n = 0 ; n < size ; n++) {
+      out.byte[size-n-1] = in.byte[n];
+    }
+    return(out.u);
   }
 
  private:
@@ -17,44 +17,58 @@
 #include "dataBlock.hpp"
 #include "dataBlockHost.hpp"
 
-Column::Column(int dir, int sign, DataBlock *data)
-                : direction(dir), sign(sign) {
+Column::Column(int dir, int sign, DataBlock *data, int nColumns)
+                : direction(dir), sign(sign), nColumns(nColumns) {
   idfx::pushRegion("Column::Column");
   this->np_tot = data->np_tot;
   this->np_int = data->np_int;
   this->beg = data->beg;
 
   if(dir>= DIMENSIONS || dir < IDIR) IDEFIX_ERROR("Unknown direction for Column constructor");
+  if(nColumns < 1) IDEFIX_ERROR("Column requires at least one variable to integrate");
 
   // Allocate the array on which we do the average
-  this->ColumnArray = IdefixArray3D<real>("ColumnArray",np_tot[KDIR], np_tot[JDIR], np_tot[IDIR]);
+  this->ColumnArray = IdefixArray4D<real>("ColumnArray",nColumns,
+                                          np_tot[KDIR], np_tot[JDIR], np_tot[IDIR]);
+
+  this->varIndex = IdefixArray1D<int>("ColumnVarIndex",nColumns);
+  this->varIndexHost = Kokkos::create_mirror_view(varIndex);
 
   // Elementary volumes and area
   this->Volume = data->dV;
   this->Area = data->A[dir];
 
-  // allocate helper  array
-  if(dir == IDIR) {
-    localSum = IdefixArray2D<real>("localSum",np_tot[KDIR], np_tot[JDIR]);
-  }
-  if(dir == JDIR) {
-    localSum = IdefixArray2D<real>("localSum",np_tot[KDIR], np_tot[IDIR]);
-  }
-  if(dir == KDIR) {
-    localSum = IdefixArray2D<real>("localSum",np_tot[JDIR], np_tot[IDIR]);
-  }
   #ifdef WITH_MPI
+  // allocate helper  arrays
+  int n0 = np_tot[KDIR];
+  int n1 = np_tot[JDIR];
+  if(dir == JDIR) n1 = np_tot[IDIR];
+  if(dir == KDIR) n0 = np_tot[JDIR];
+  if(dir == KDIR) n1 = np_tot[IDIR];
+  localSum = IdefixArray3D<real>("localSum",nColumns, n0, n1);
+  upstreamSum = IdefixArray3D<real>("upstreamSum",nColumns, n0, n1);
+
   // Create sub-MPI communicator dedicated to scan
     int remainDims[3] = {false, false, false};
     remainDims[dir] = true;
-    MPI_Cart_sub(data->mygrid->CartComm, remainDims, &this->ColumnComm);
-    MPI_Comm_rank(this->ColumnComm, &this->MPIrank);
-    MPI_Comm_size(this->ColumnComm, &this->MPIsize);
+    MPI_Comm cartComm;
+    MPI_Cart_sub(data->mygrid->CartComm, remainDims, &cartComm);
+    MPI_Comm_rank(cartComm, &this->MPIrank);
+    MPI_Comm_size(cartComm, &this->MPIsize);
+    if(sign < 0) {
+      // Rank the processes from right to left, so that the scan follows the integration
+      MPI_Comm_split(cartComm, 0, MPIsize-1-MPIrank, &this->ColumnComm);
+      MPI_Comm_free(&cartComm);
+      MPI_Comm_rank(this->ColumnComm, &this->MPIrank);
+    } else {
+      this->ColumnComm = cartComm;
+    }
 
     // create MPI class for boundary Xchanges
-    int ntarget = 0;
     std::vector<int> mapVars;
-    mapVars.push_back(ntarget);
+    for(int n = 0 ; n < nColumns ; n++) {
+      mapVars.push_back(n);
+    }
 
     this->mpi.Init(data->mygrid, mapVars, data->nghost.data(), data->np_int.data());
     this->nproc = data->mygrid->nproc;
@@ -62,8 +76,18 @@ Column::Column(int dir, int sign, DataBlock *data)
   idfx::popRegion();
 }
 
-void Column::ComputeColumn(IdefixArray4D<real> in, const int var) {
-  idfx::pushRegion("Column::ComputeColumn");
+template<typename T>
+void Column::Integrate(IdefixArray4D<T> in, const std::vector<int> &variables) {
+  idfx::pushRegion("Column::Integrate");
+  if(static_cast<int>(variables.size()) != nColumns) {
+    IDEFIX_ERROR("Column: the number of variables differs from the one given to the constructor");
+  }
+  for(int n = 0 ; n < nColumns ; n++) {
+    varIndexHost(n) = variables[n];
+  }
+  Kokkos::deep_copy(varIndex, varIndexHost);
+
+  const int nv = nColumns;
   const int nk = np_int[KDIR];
   const int nj = np_int[JDIR];
   const int ni = np_int[IDIR];
@@ -75,166 +99,194 @@ void Column::ComputeColumn(IdefixArray4D<real> in, const int var) {
   const int ie = ib+ni;
 
   const int direction = this->direction;
+  const int sign = this->sign;
   auto column = this->ColumnArray;
   auto dV = this->Volume;
   auto A = this->Area;
-  auto localSum = this->localSum;
+  auto varIndex = this->varIndex;
 
+  // Each team integrates one line of one variable, from the left (sign>0) or from the right
   if(direction==IDIR) {
     // Inspired from loop.hpp
-    Kokkos::parallel_for("ColumnX1", team_policy (nk*nj, Kokkos::AUTO),
+    Kokkos::parallel_for("ColumnX1", team_policy (nv*nk*nj, Kokkos::AUTO),
       KOKKOS_LAMBDA (member_type team_member) {
-        int k = team_member.league_rank() / nj;
-        int j = team_member.league_rank() - k*nj + jb;
+        int n = team_member.league_rank() / (nk*nj);
+        int k = (team_member.league_rank() - n*nk*nj) / nj;
+        int j = team_member.league_rank() - n*nk*nj - k*nj + jb;
         k += kb;
-        Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member,ib,ie),
-          [=] (int i, real &partial_sum, bool is_final) {
+        const int var = varIndex(n);
+        Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member,0,ni),
+          [=] (int m, real &partial_sum, bool is_final) {
+            const int i = (sign > 0) ? ib + m : ie - 1 - m;
             partial_sum += in(var,k,j,i)*dV(k,j,i) / (0.5*(A(k,j,i)+A(k,j,i+1)));
-            if(is_final) column(k,j,i) = partial_sum;
-            //partial_sum += in(var,k,j,i)*dV(k,j,i) / (0.5*(A(k,j,i)+A(k,j,i+1)));
+            if(is_final) column(n,k,j,i) = partial_sum;
           });
       });
     }
     if(direction==JDIR) {
       // Inspired from loop.hpp
-      Kokkos::parallel_for("ColumnX2", team_policy (nk*ni, Kokkos::AUTO),
+      Kokkos::parallel_for("ColumnX2", team_policy (nv*nk*ni, Kokkos::AUTO),
         KOKKOS_LAMBDA (member_type team_member) {
-          int k = team_member.league_rank() / ni;
-          int i = team_member.league_rank() - k*ni + ib;
+          int n = team_member.league_rank() / (nk*ni);
+          int k = (team_member.league_rank() - n*nk*ni) / ni;
+          int i = team_member.league_rank() - n*nk*ni - k*ni + ib;
           k += kb;
-          Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member,jb,je),
-            [=] (int j, real &partial_sum, bool is_final) {
+          const int var = varIndex(n);
+          Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member,0,nj),
+            [=] (int m, real &partial_sum, bool is_final) {
+              const int j = (sign > 0) ? jb + m : je - 1 - m;
               partial_sum += in(var,k,j,i)*dV(k,j,i) / (0.5*(A(k,j,i)+A(k,j+1,i)));
-              if(is_final) column(k,j,i) = partial_sum;
+              if(is_final) column(n,k,j,i) = partial_sum;
           });
       });
     }
     if(direction==KDIR) {
       // Inspired from loop.hpp
-      Kokkos::parallel_for("ColumnX2", team_policy (nj*ni, Kokkos::AUTO),
+      Kokkos::parallel_for("ColumnX3", team_policy (nv*nj*ni, Kokkos::AUTO),
         KOKKOS_LAMBDA (member_type team_member) {
-          int j = team_member.league_rank() / ni;
-          int i = team_member.league_rank() - j*ni + ib;
+          int n = team_member.league_rank() / (nj*ni);
+          int j = (team_member.league_rank() - n*nj*ni) / ni;
+          int i = team_member.league_rank() - n*nj*ni - j*ni + ib;
           j += jb;
-          Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member,kb,ke),
-            [=] (int k, real &partial_sum, bool is_final) {
+          const int var = varIndex(n);
+          Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member,0,nk),
+            [=] (int m, real &partial_sum, bool is_final) {
+              const int k = (sign > 0) ? kb + m : ke - 1 - m;
               partial_sum += in(var,k,j,i)*dV(k,j,i) / (0.5*(A(k,j,i)+A(k+1,j,i)));
-              if(is_final) column(k,j,i) = partial_sum;
+              if(is_final) column(n,k,j,i) = partial_sum;
           });
       });
     }
+  idfx::popRegion();
+}
 
-    #ifdef WITH_MPI
-    // Load the current sum
-      int dst,src;
-      MPI_Cart_shift(this->ColumnComm,0, 1, &src, &dst);
-      int size = localSum.extent(0)*localSum.extent(1);
-      if(MPIrank>0) {
-        MPI_Status status;
-        // Get the cumulative sum from previous processes
-        Kokkos::fence();
-        MPI_Recv(localSum.data(), size, realMPI, src, 20, ColumnComm, &status);
-        // Add this to our cumulative sum
-        idefix_for("Addsum",kb,ke,jb,je,ib,ie,
-          KOKKOS_LAMBDA(int k, int j, int i) {
-            if(direction == IDIR) column(k,j,i) += localSum(k,j);
-            if(direction == JDIR) column(k,j,i) += localSum(k,i);
-            if(direction == KDIR) column(k,j,i) += localSum(j,i);
-        });
-      } // rank =0
-      // Get the final sum
-      if(MPIrank < MPIsize-1) {
-        if(direction==IDIR) {
-          idefix_for("Loadsum",kb,ke,jb,je,
-            KOKKOS_LAMBDA(int k, int j) {
-              localSum(k,j) = column(k,j,ie-1);
-          });
-        }
-        if(direction==JDIR) {
-          idefix_for("Loadsum",kb,ke,ib,ie,
-            KOKKOS_LAMBDA(int k, int i) {
-              localSum(k,i) = column(k,je-1,i);
-          });
-        }
-        if(direction==KDIR) {
-          idefix_for("Loadsum",jb,je,ib,ie,
-            KOKKOS_LAMBDA(int j, int i) {
-              localSum(j,i) = column(ke-1,j,i);
-          });
-        }
-        // And send it
-        Kokkos::fence();
-        MPI_Send(localSum.data(),size, realMPI, dst, 20, ColumnComm);
-      } // MPIrank small enough
-    #endif
-    // If we need it backwards
-    if(sign<0) {
-      // Compute total cumulative sum in the last subdomain
-      if(direction == IDIR) {
-        idefix_for("Loadsum",kb,ke,jb,je,
-          KOKKOS_LAMBDA(int k, int j) {
-            localSum(k,j) = column(k,j,ie-1) + in(var,k,j,ie-1) * dV(k,j,ie-1)
-                            / (0.5*(A(k,j,ie-1)+A(k,j,ie)));
-        });
-      }
-      if(direction == JDIR) {
-        idefix_for("Loadsum",kb,ke,ib,ie,
-          KOKKOS_LAMBDA(int k, int i) {
-            localSum(k,i) = column(k,je-1,i) + in(var,k,je-1,i) * dV(k,je-1,i)
-                            / (0.5*(A(k,je-1,i)+A(k,je,i)));
-        });
-      }
-      if(direction == KDIR) {
-        idefix_for("Loadsum",jb,je,ib,ie,
-          KOKKOS_LAMBDA(int j, int i) {
-            localSum(j,i) = column(ke-1,j,i) + in(var,ke-1,j,i) * dV(ke-1,j,i)
-                            / (0.5*(A(ke-1,j,i)+A(ke,j,i)));
-        });
-      }
+void Column::StartScan() {
+  #ifdef WITH_MPI
+  if(MPIsize > 1) {
+    idfx::pushRegion("Column::StartScan");
+    const int nv = nColumns;
+    const int kb = beg[KDIR];
+    const int jb = beg[JDIR];
+    const int ib = beg[IDIR];
+    const int ke = kb+np_int[KDIR];
+    const int je = jb+np_int[JDIR];
+    const int ie = ib+np_int[IDIR];
+    auto column = this->ColumnArray;
+    auto localSum = this->localSum;
+
+    // Load the sum over our subdomain, found in the last cell along the integration
+    if(direction==IDIR) {
+      const int il = (sign > 0) ? ie-1 : ib;
+      idefix_for("Loadsum",0,nv,kb,ke,jb,je,
+        KOKKOS_LAMBDA(int n, int k, int j) {
+          localSum(n,k,j) = column(n,k,j,il);
+      });
+    }
+    if(direction==JDIR) {
+      const int jl = (sign > 0) ? je-1 : jb;
+      idefix_for("Loadsum",0,nv,kb,ke,ib,ie,
+        KOKKOS_LAMBDA(int n, int k, int i) {
+          localSum(n,k,i) = column(n,k,jl,i);
+      });
+    }
+    if(direction==KDIR) {
+      const int kl = (sign > 0) ? ke-1 : kb;
+      idefix_for("Loadsum",0,nv,jb,je,ib,ie,
+        KOKKOS_LAMBDA(int n, int j, int i) {
+          localSum(n,j,i) = column(n,kl,j,i);
+      });
+    }
+    // Sum of the subdomains upstream of ours
+    Kokkos::fence();
+    int size = localSum.extent(0)*localSum.extent(1)*localSum.extent(2);
+    MPI_SAFE_CALL(MPI_Iexscan(localSum.data(), upstreamSum.data(), size, realMPI, MPI_SUM,
+                              ColumnComm, &scanRequest));
+    idfx::popRegion();
+  }
+  #endif
+}
 
-      #ifdef WITH_MPI
-      Kokkos::fence();
-      MPI_Bcast(localSum.data(),size, realMPI, MPIsize-1, ColumnComm);
-      #endif
-      // All substract the local column from the full column
-
-      idefix_for("Subsum",kb,ke,jb,je,ib,ie,
-        KOKKOS_LAMBDA(int k, int j, int i) {
-          if(direction==IDIR) column(k,j,i) = localSum(k,j)-column(k,j,i);
-          if(direction==JDIR) column(k,j,i) = localSum(k,i)-column(k,j,i);
-          if(direction==KDIR) column(k,j,i) = localSum(j,i)-column(k,j,i);
+void Column::FinishScan() {
+  #ifdef WITH_MPI
+  idfx::pushRegion("Column::FinishScan");
+  if(MPIsize > 1) {
+    MPI_SAFE_CALL(MPI_Wait(&scanRequest, MPI_STATUS_IGNORE));
+    // The first process of the scan has nothing upstream (and an undefined result)
+    if(MPIrank > 0) {
+      const int direction = this->direction;
+      auto column = this->ColumnArray;
+      auto upstreamSum = this->upstreamSum;
+      idefix_for("Addsum",0,nColumns,beg[KDIR],beg[KDIR]+np_int[KDIR],
+                                     beg[JDIR],beg[JDIR]+np_int[JDIR],
+                                     beg[IDIR],beg[IDIR]+np_int[IDIR],
+        KOKKOS_LAMBDA(int n, int k, int j, int i) {
+          if(direction == IDIR) column(n,k,j,i) += upstreamSum(n,k,j);
+          if(direction == JDIR) column(n,k,j,i) += upstreamSum(n,k,i);
+          if(direction == KDIR) column(n,k,j,i) += upstreamSum(n,j,i);
       });
-    } // sign <0
-    // Xchange boundary elements when using MPI to ensure that column
-    // density in the ghost zones are coherent
-    #ifdef WITH_MPI
-      // Create a 4D array that contains our column data
-      IdefixArray4D<real> arr4D(column.data(), 1, this->np_tot[KDIR],
-                                                        this->np_tot[JDIR],
-                                                        this->np_tot[IDIR]);
-
-      for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
-        // MPI Exchange data when needed
-        if(nproc[dir]>1) {
-          switch(dir) {
-            case 0:
-              this->mpi.ExchangeX1(arr4D);
-              break;
-            case 1:
-              this->mpi.ExchangeX2(arr4D);
-              break;
-            case 2:
-              this->mpi.ExchangeX3(arr4D);
-              break;
-          }
-        }
+    }
+  }
+  // Xchange boundary elements when using MPI to ensure that column
+  // density in the ghost zones are coherent
+  for(int dir = 0 ; dir < DIMENSIONS ; dir++) {
+    // MPI Exchange data when needed
+    if(nproc[dir]>1) {
+      switch(dir) {
+        case 0:
+          this->mpi.ExchangeX1(ColumnArray);
+          break;
+        case 1:
+          this->mpi.ExchangeX2(ColumnArray);
+          break;
+        case 2:
+          this->mpi.ExchangeX3(ColumnArray);
+          break;
       }
-    #endif
+    }
+  }
+  idfx::popRegion();
+  #endif
+}
+
+template<typename T>
+void Column::ComputeColumn(IdefixArray4D<T> in, const std::vector<int> &variables) {
+  idfx::pushRegion("Column::ComputeColumn");
+  Integrate(in, variables);
+  StartScan();
+  FinishScan();
   idfx::popRegion();
 }
 
+template<typename T>
+void Column::ComputeColumn(IdefixArray4D<T> in, const int var) {
+  return this->ComputeColumn(in, std::vector<int>(1, var));
+}
+
 void Column::ComputeColumn(IdefixArray3D<real> in) {
   // 4D alias
   IdefixArray4D<real> arr4D(in.data(), 1, in.extent(0), in.extent(1), in.extent(2));
   return this->ComputeColumn(arr4D,0);
 }
+
+template<typename T>
+void Column::ComputeColumns(const std::vector<Column *> &columns, IdefixArray4D<T> in,
+                            const std::vector<int> &variables) {
+  idfx::pushRegion("Column::ComputeColumns");
+  for(Column *column : columns) column->Integrate(in, variables);
+  // All of the scans are in flight at the same time
+  for(Column *column : columns) column->StartScan();
+  for(Column *column : columns) column->FinishScan();
+  idfx::popRegion();
+}
+
+// Columns of the arrays stored in real and (in mixed precision) in realStore
+template void Column::ComputeColumn(IdefixArray4D<real>, int);
+template void Column::ComputeColumn(IdefixArray4D<real>, const std::vector<int> &);
+template void Column::ComputeColumns(const std::vector<Column *> &, IdefixArray4D<real>,
+                                     const std::vector<int> &);
+#ifdef MIXED_PRECISION
+template void Column::ComputeColumn(IdefixArray4D<realStore>, int);
+template void Column::ComputeColumn(IdefixArray4D<realStore>, const std::vector<int> &);
+template void Column::ComputeColumns(const std::vector<Column *> &, IdefixArray4D<realStore>,
+                                     const std::vector<int> &);
+#endif
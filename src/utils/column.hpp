@@ -17,6 +17,9 @@
 
 
 // A class to implement a parralel cumulative sum
+// Each process integrates its own subdomain, and the sums of the subdomains located upstream
+// along the integration direction are then obtained with a single distributed exclusive scan
+// over the processes of the column (log(nproc) communication steps).
 class Column {
  public:
   ////////////////////////////////////////////////////////////////////////////////////
@@ -24,8 +27,9 @@ class Column {
   /// @param dir direction along which the integration is performed
   /// @param sign: +1 for an integration from left to right, -1 for an integration from right to
   ///              left i.e (backwards)
+  /// @param nColumns: number of variables integrated at once by ComputeColumn
   ///////////////////////////////////////////////////////////////////////////////////
-  Column(int dir, int sign, DataBlock *);
+  Column(int dir, int sign, DataBlock *, int nColumns = 1);
 
   ///////////////////////////////////////////////////////////////////////////////////
   /// @brief Effectively compute integral from the input array in argument
@@ -33,7 +37,17 @@ class Column {
   /// @param variable: index of the variable along which we do the integral (since the
   ///                   intput array is 4D)
   ///////////////////////////////////////////////////////////////////////////////////
-  void ComputeColumn(IdefixArray4D<real> in, int variable);
+  template<typename T>
+  void ComputeColumn(IdefixArray4D<T> in, int variable);
+
+  ///////////////////////////////////////////////////////////////////////////////////
+  /// @brief Compute the integrals of several variables of the input array at once
+  /// @param in: 4D input array
+  /// @param variables: indices of the nColumns variables to be integrated. The column of
+  ///                   variables[n] is then given by GetColumn(n)
+  ///////////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  void ComputeColumn(IdefixArray4D<T> in, const std::vector<int> &variables);
 
     ///////////////////////////////////////////////////////////////////////////////////
   /// @brief Effectively compute integral from the input array in argument
@@ -41,17 +55,35 @@ class Column {
   ///////////////////////////////////////////////////////////////////////////////////
   void ComputeColumn(IdefixArray3D<real> in);
 
+  ///////////////////////////////////////////////////////////////////////////////////
+  /// @brief Compute the integrals of several Column objects (e.g. along several directions)
+  ///        at once, the exchanges between processes of all of the columns being overlapped
+  /// @param columns: Column objects to be computed
+  /// @param in: 4D input array
+  /// @param variables: indices of the variables to be integrated by each Column
+  ///////////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  static void ComputeColumns(const std::vector<Column *> &columns, IdefixArray4D<T> in,
+                             const std::vector<int> &variables);
+
   ///////////////////////////////////////////////////////////////////////////////////
   /// @brief Get a reference to the computed column density array
+  /// @param n: index of the column in the batch of variables
   ///////////////////////////////////////////////////////////////////////////////////
-  IdefixArray3D<real> GetColumn() {
-    return (this->ColumnArray);
+  IdefixArray3D<real> GetColumn(int n = 0) {
+    return (Kokkos::subview(this->ColumnArray, n, Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL()));
   }
 
  private:
-  IdefixArray3D<real> ColumnArray;
+  template<typename T>
+  void Integrate(IdefixArray4D<T>, const std::vector<int> &); // Integrate our subdomain
+  void StartScan();         // Start the scan of the subdomain sums across processes
+  void FinishScan();        // Add the sums of the upstream subdomains and fill the ghost zones
+
+  IdefixArray4D<real> ColumnArray;
   int direction; // The direction along which the column is computed
   int sign;      // whether we integrate from the left or from the right
+  int nColumns;  // # of variables integrated at once
   std::array<int,3> np_tot;
   std::array<int,3> np_int;
   std::array<int,3> beg;
@@ -59,10 +91,15 @@ class Column {
   IdefixArray3D<real> Area;
   IdefixArray3D<real> Volume;
 
-    IdefixArray2D<real> localSum;
+  IdefixArray1D<int> varIndex;      // indices of the variables being integrated
+  IdefixHostArray1D<int> varIndexHost;
+
   #ifdef WITH_MPI
+  IdefixArray3D<real> localSum;     // Sum over our subdomain
+  IdefixArray3D<real> upstreamSum;  // Sum over the subdomains upstream of ours
+  MPI_Request scanRequest;
   Mpi mpi;  // Mpi object when WITH_MPI is set
-  MPI_Comm ColumnComm;
+  MPI_Comm ColumnComm;  // ranked along the integration direction (reversed when sign<0)
   int MPIrank;
   int MPIsize;
 
@@ -0,0 +1,213 @@
+// ***********************************************************************************
+// Idefix MHD astrophysical code
+// Copyright(C) Geoffroy R. J. Lesur <geoffroy.lesur@univ-grenoble-alpes.fr>
+// and other code contributors
+// Licensed under CeCILL 2.1 License, see COPYING for more information
+// ***********************************************************************************
+
+#ifndef UTILS_FFT_HPP_
+#define UTILS_FFT_HPP_
+
+#include <cstdint>
+#include <cmath>
+#include "idefix.hpp"
+
+// A minimal one dimensional complex FFT, applied to batches of lines.
+// The lines are stored as an array lines(nlines, n, 2) (real and imaginary parts), and each
+// line is transformed serially by a single thread. Power of two lengths use an iterative
+// radix-2 Cooley-Tukey algorithm, other lengths use Bluestein's chirp-z algorithm on top of a
+// radix-2 transform. The transforms are not normalised.
+class Fft {
+ public:
+  explicit Fft(int n);
+
+  // Transform the first nlines lines of the array (sign=-1 for forward, +1 for backward)
+  void Transform(IdefixArray3D<real> lines, int nlines, int sign);
+
+  // In-place radix-2 transform of line l of a (of size n, a power of 2).
+  // The twiddle factors are exp(-2 i pi m/n) for m<n/2
+  KOKKOS_INLINE_FUNCTION static void Radix2(const IdefixArray3D<real> &a, const int l,
+                                            const int n, const IdefixArray2D<real> &tw,
+                                            const int sign) {
+    // Bit reversal permutation
+    for(int i = 1, j = 0 ; i < n ; i++) {
+      int bit = n >> 1;
+      for( ; j & bit ; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if(i < j) {
+        const real tr = a(l,i,0);
+        const real ti = a(l,i,1);
+        a(l,i,0) = a(l,j,0);
+        a(l,i,1) = a(l,j,1);
+        a(l,j,0) = tr;
+        a(l,j,1) = ti;
+      }
+    }
+    // Butterflies
+    for(int len = 2 ; len <= n ; len <<= 1) {
+      const int half = len >> 1;
+      const int step = n/len;
+      for(int i = 0 ; i < n ; i += len) {
+        for(int k = 0 ; k < half ; k++) {
+          const real wr = tw(k*step,0);
+          const real wi = -sign*tw(k*step,1);
+          const real ur = a(l,i+k,0);
+          const real ui = a(l,i+k,1);
+          const real xr = a(l,i+k+half,0);
+          const real xi = a(l,i+k+half,1);
+          const real vr = xr*wr - xi*wi;
+          const real vi = xr*wi + xi*wr;
+          a(l,i+k,0) = ur + vr;
+          a(l,i+k,1) = ui + vi;
+          a(l,i+k+half,0) = ur - vr;
+          a(l,i+k+half,1) = ui - vi;
+        }
+      }
+    }
+  }
+
+ private:
+  void InitTwiddles(IdefixArray2D<real> &, int);
+
+  int n;                      // length of the transform
+  int m;                      // length of the underlying radix-2 transform
+  bool isPow2;
+  IdefixArray2D<real> tw;     // twiddle factors of the radix-2 transform
+  IdefixArray2D<real> chirp;  // Bluestein chirp exp(-i pi j^2/n)
+  IdefixArray2D<real> chirpHatFwd;  // transform of the Bluestein filter (forward)
+  IdefixArray2D<real> chirpHatBwd;  // transform of the Bluestein filter (backward)
+  IdefixArray3D<real> work;   // Bluestein work array
+};
+
+inline Fft::Fft(int n) {
+  idfx::pushRegion("Fft::Fft");
+  this->n = n;
+  this->isPow2 = (n > 0) && ((n & (n-1)) == 0);
+  if(n < 1) IDEFIX_ERROR("Fft:: the length of the transform should be positive");
+
+  if(isPow2) {
+    m = n;
+    InitTwiddles(tw, m);
+  } else {
+    // Bluestein: convolution of length m >= 2n-1
+    m = 1;
+    while(m < 2*n-1) m <<= 1;
+    InitTwiddles(tw, m);
+
+    chirp = IdefixArray2D<real>("FFT_chirp", n, 2);
+    IdefixArray2D<real>::HostMirror chirpH = Kokkos::create_mirror_view(chirp);
+    for(int j = 0 ; j < n ; j++) {
+      // j^2 is taken modulo 2n to keep the phase accurate
+      const int64_t j2 = (static_cast<int64_t>(j)*j) % (2*static_cast<int64_t>(n));
+      const double phase = M_PI*static_cast<double>(j2)/n;
+      chirpH(j,0) = std::cos(phase);
+      chirpH(j,1) = -std::sin(phase);
+    }
+    Kokkos::deep_copy(chirp, chirpH);
+
+    // Transform of the filter b_j = conj(chirp_j), symmetric in j, for both signs
+    IdefixArray3D<real> filter("FFT_filter", 2, m, 2);
+    IdefixArray3D<real>::HostMirror filterH = Kokkos::create_mirror_view(filter);
+    for(int s = 0 ; s < 2 ; s++) {
+      // s=0: forward (conj(chirp)), s=1: backward (chirp)
+      const real conj = (s == 0) ? -1.0 : 1.0;
+      for(int j = 0 ; j < m ; j++) {
+        filterH(s,j,0) = 0.0;
+        filterH(s,j,1) = 0.0;
+      }
+      for(int j = 0 ; j < n ; j++) {
+        filterH(s,j,0) = chirpH(j,0);
+        filterH(s,j,1) = conj*chirpH(j,1);
+        if(j > 0) {
+          filterH(s,m-j,0) = chirpH(j,0);
+          filterH(s,m-j,1) = conj*chirpH(j,1);
+        }
+      }
+    }
+    Kokkos::deep_copy(filter, filterH);
+
+    auto tw = this->tw;
+    const int m = this->m;
+    idefix_for("FFT_Filter", 0, 2,
+      KOKKOS_LAMBDA (int s) {
+        Radix2(filter, s, m, tw, -1);
+      });
+
+    chirpHatFwd = Kokkos::subview(filter, 0, Kokkos::ALL(), Kokkos::ALL());
+    chirpHatBwd = Kokkos::subview(filter, 1, Kokkos::ALL(), Kokkos::ALL());
+  }
+  idfx::popRegion();
+}
+
+inline void Fft::InitTwiddles(IdefixArray2D<real> &twiddle, int size) {
+  const int half = (size > 1) ? size/2 : 1;
+  twiddle = IdefixArray2D<real>("FFT_twiddles", half, 2);
+  IdefixArray2D<real>::HostMirror twH = Kokkos::create_mirror_view(twiddle);
+  for(int k = 0 ; k < half ; k++) {
+    const double phase = 2.0*M_PI*k/size;
+    twH(k,0) = std::cos(phase);
+    twH(k,1) = -std::sin(phase);
+  }
+  Kokkos::deep_copy(twiddle, twH);
+}
+
+inline void Fft::Transform(IdefixArray3D<real> lines, int nlines, int sign) {
+  idfx::pushRegion("Fft::Transform");
+  const int n = this->n;
+  const int m = this->m;
+  auto tw = this->tw;
+
+  if(isPow2) {
+    idefix_for("FFT_Radix2", 0, nlines,
+      KOKKOS_LAMBDA (int l) {
+        Radix2(lines, l, n, tw, sign);
+      });
+  } else {
+    if(work.extent(0) < static_cast<size_t>(nlines)) {
+      work = IdefixArray3D<real>("FFT_work", nlines, m, 2);
+    }
+    auto work = this->work;
+    auto chirp = this->chirp;
+    auto chirpHat = (sign < 0) ? this->chirpHatFwd : this->chirpHatBwd;
+    idefix_for("FFT_Bluestein", 0, nlines,
+      KOKKOS_LAMBDA (int l) {
+        // a_j = x_j w_j, with w_j=chirp_j (forward) or conj(chirp_j) (backward)
+        for(int j = 0 ; j < m ; j++) {
+          if(j < n) {
+            const real wr = chirp(j,0);
+            const real wi = -sign*chirp(j,1);
+            const real xr = lines(l,j,0);
+            const real xi = lines(l,j,1);
+            work(l,j,0) = xr*wr - xi*wi;
+            work(l,j,1) = xr*wi + xi*wr;
+          } else {
+            work(l,j,0) = 0.0;
+            work(l,j,1) = 0.0;
+          }
+        }
+        // Convolution with the filter
+        Radix2(work, l, m, tw, -1);
+        for(int j = 0 ; j < m ; j++) {
+          const real ar = work(l,j,0);
+          const real ai = work(l,j,1);
+          const real br = chirpHat(j,0);
+          const real bi = chirpHat(j,1);
+          work(l,j,0) = ar*br - ai*bi;
+          work(l,j,1) = ar*bi + ai*br;
+        }
+        Radix2(work, l, m, tw, 1);
+        // X_k = w_k conv_k / m
+        for(int k = 0 ; k < n ; k++) {
+          const real wr = chirp(k,0);
+          const real wi = -sign*chirp(k,1);
+          const real cr = work(l,k,0)/m;
+          const real ci = work(l,k,1)/m;
+          lines(l,k,0) = cr*wr - ci*wi;
+          lines(l,k,1) = cr*wi + ci*wr;
+        }
+      });
+  }
+  idfx::popRegion();
+}
+
+#endif // UTILS_FFT_HPP_
@@ -36,6 +36,8 @@ class Bicgstab : public IterativeSolver<T> {
   IdefixArray3D<real> work1; // work array
   IdefixArray3D<real> work2; // work array
   IdefixArray3D<real> work3; // work array
+  IdefixArray3D<real> precDir; // preconditioned search direction (when a preconditioner is set)
+  IdefixArray3D<real> precS;   // preconditioned intermediate direction
 };
 
 template <class T>
@@ -114,8 +116,26 @@ void Bicgstab<T>::InitSolver() {
   this->SetRes();
 
   Kokkos::deep_copy(this->res0, this->res); // (Re)setting reference residual
-  Kokkos::deep_copy(this->dir, this->res); // (Re)setting initial searching direction
-  this->linearOperator(this->dir, this->work1); // (Re)setting associated laplacian
+
+  if(this->preconditioner) {
+    // Right preconditioned version, starting from null direction vectors
+    if(this->precDir.extent(0) == 0) {
+      this->precDir = IdefixArray3D<real> ("PrecDirection", this->ntot[KDIR],
+                                                            this->ntot[JDIR],
+                                                            this->ntot[IDIR]);
+      this->precS = IdefixArray3D<real> ("PrecIntermediateDir", this->ntot[KDIR],
+                                                                this->ntot[JDIR],
+                                                                this->ntot[IDIR]);
+    }
+    Kokkos::deep_copy(this->dir, 0.0);
+    Kokkos::deep_copy(this->work1, 0.0);
+    this->rho = 1.0;
+    this->alpha = 1.0;
+    this->omega = 1.0;
+  } else {
+    Kokkos::deep_copy(this->dir, this->res); // (Re)setting initial searching direction
+    this->linearOperator(this->dir, this->work1); // (Re)setting associated laplacian
+  }
 
   // // Resetting parameters
   // this->rho = 1.0;
@@ -139,6 +159,9 @@ void Bicgstab<T>::PerformIter() {
   IdefixArray3D<real> v = this->work1; // Working array, for laplacian dir calculation
   IdefixArray3D<real> s = this->work2; // Working array, for intermediate dir calculation
   IdefixArray3D<real> t = this->work3; // Working array, for laplacian intermediate dir calculation
+  // Directions effectively used to update the solution (preconditioned when required)
+  IdefixArray3D<real> y = this->preconditioner ? this->precDir : dir;
+  IdefixArray3D<real> z = this->preconditioner ? this->precS : s;
   real omega;
   real &alpha = this->alpha;
   real &rhoOld = this->rho;
@@ -191,7 +214,8 @@ void Bicgstab<T>::PerformIter() {
   // From now dir is updated
 
   // ***** Step 4.
-  this->linearOperator(dir, v);
+  if(this->preconditioner) this->preconditioner->ApplyPreconditioner(dir, y);
+  this->linearOperator(y, v);
 
   // from now v is updated (laplacian of dir)
 
@@ -215,7 +239,7 @@ void Bicgstab<T>::PerformIter() {
   // Assumes solution = x_i-1
   idefix_for("FirstUpdatePot", kbeg, kend, jbeg, jend, ibeg, iend,
     KOKKOS_LAMBDA (int k, int j, int i) {
-      solution(k,j,i) = solution(k,j,i) + alpha * dir(k,j,i);
+      solution(k,j,i) = solution(k,j,i) + alpha * y(k,j,i);
     });
 
   // From here solution = h_i
@@ -241,7 +265,8 @@ void Bicgstab<T>::PerformIter() {
     // From here s is updated
 
     // ************** Step 9.
-    this->linearOperator(s, t);
+    if(this->preconditioner) this->preconditioner->ApplyPreconditioner(s, z);
+    this->linearOperator(z, t);
 
     // From here t is updated
 
@@ -265,7 +290,7 @@ void Bicgstab<T>::PerformIter() {
     // solution is h_i from step 6.
     idefix_for("SecondUpdatePot", kbeg, kend, jbeg, jend, ibeg, iend,
       KOKKOS_LAMBDA (int k, int j, int i) {
-        solution(k,j,i) = solution(k,j,i) + omega * s(k,j,i);
+        solution(k,j,i) = solution(k,j,i) + omega * z(k,j,i);
       });
 
     // From here, solution = x_i
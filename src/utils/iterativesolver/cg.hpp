@@ -28,6 +28,7 @@ class Cg : public IterativeSolver<T> {
  private:
   IdefixArray3D<real> p1; // Search direction for gradient descent
   IdefixArray3D<real> s1; // Search direction for gradient descent
+  IdefixArray3D<real> z1; // Preconditioned residual (when a preconditioner is set)
 };
 
 template <class T>
@@ -80,7 +81,17 @@ void Cg<T>::InitSolver() {
   // Residual initialisation
   this->SetRes();
 
-  Kokkos::deep_copy(this->p1, this->res); // (Re)setting reference residual
+  if(this->preconditioner) {
+    if(this->z1.extent(0) == 0) {
+      this->z1 = IdefixArray3D<real> ("z1", this->ntot[KDIR],
+                                            this->ntot[JDIR],
+                                            this->ntot[IDIR]);
+    }
+    this->preconditioner->ApplyPreconditioner(this->res, this->z1);
+    Kokkos::deep_copy(this->p1, this->z1); // (Re)setting preconditioned reference residual
+  } else {
+    Kokkos::deep_copy(this->p1, this->res); // (Re)setting reference residual
+  }
 
   idfx::popRegion();
 }
@@ -94,6 +105,7 @@ void Cg<T>::PerformIter() {
   auto r = this->res;
   auto p1 = this->p1;
   auto s1 = this->s1;
+  auto z1 = this->z1;
 
   int ibeg, iend, jbeg, jend, kbeg, kend;
   ibeg = this->beg[IDIR];
@@ -106,7 +118,8 @@ void Cg<T>::PerformIter() {
   // ***** Step 1.
   this->linearOperator(p1, s1);
 
-  real rr = this->ComputeDotProduct(r,r);
+  // With a preconditioner, rr is the scalar product of the residual with its preconditioned value
+  real rr = this->preconditioner ? this->ComputeDotProduct(r,z1) : this->ComputeDotProduct(r,r);
   //idfx::cout << "rr=" << rr << std::endl;
   real alpha = rr / (this->ComputeDotProduct(p1,s1));
 
@@ -128,7 +141,16 @@ void Cg<T>::PerformIter() {
 
   this->TestErrorL2();
 
-  real beta = this->ComputeDotProduct(r,r) / rr;
+  if(this->preconditioner) {
+    if(this->convStatus) {
+      idfx::popRegion();
+      return;
+    }
+    this->preconditioner->ApplyPreconditioner(r, z1);
+  }
+
+  real beta = this->preconditioner ? this->ComputeDotProduct(r,z1) / rr
+                                   : this->ComputeDotProduct(r,r) / rr;
 
   // Checking for Nans
   if(std::isnan(beta)) {
@@ -138,9 +160,11 @@ void Cg<T>::PerformIter() {
     // IDEFIX_ERROR("rho is nan in step 1");
   }
 
+  // Next search direction, built from the (preconditioned) residual
+  auto z = this->preconditioner ? z1 : r;
   idefix_for("UpdateDir", kbeg, kend, jbeg, jend, ibeg, iend,
     KOKKOS_LAMBDA (int k, int j, int i) {
-      p1(k,j,i) = r(k,j,i) + beta * p1(k,j,i);
+      p1(k,j,i) = z(k,j,i) + beta * p1(k,j,i);
     });
 
   idfx::popRegion();
@@ -23,6 +23,10 @@ class IterativeSolver {
   virtual int Solve(IdefixArray3D<real> &guess, IdefixArray3D<real> &rhs) = 0;
   virtual void ShowConfig() = 0;
 
+  // Preconditioning: out = M^-1 in, with M an approximation of the linear operator
+  void SetPreconditioner(IterativeSolver<T> *);
+  virtual void ApplyPreconditioner(IdefixArray3D<real> &in, IdefixArray3D<real> &out);
+
   // Internal functions (left public for Lambda capture)
   void SetRes();  // Set residual from current guess
   void TestErrorL1();  // Test the convergence status of the current iteration with L1 norm
@@ -37,6 +41,8 @@ class IterativeSolver {
   int maxiter;        // Maximum iteration allowed to achieve convergence
   bool convStatus;    // Convergence status
   bool restart{false};
+  IterativeSolver<T> *preconditioner{nullptr};  // Optional preconditioner (Cg and Bicgstab)
+  bool isPreconditioner{false};    // Whether this solver is used as a preconditioner
   static constexpr bool isVerbose{false}; // Whether the solver should be verbose while iterating
 
   std::array<int,3> beg;
@@ -308,6 +314,17 @@ real IterativeSolver<T>::ComputeDotProduct(IdefixArray3D<real> mat1, IdefixArray
 }
 
 
+template <class T>
+void IterativeSolver<T>::SetPreconditioner(IterativeSolver<T> *precond) {
+  this->preconditioner = precond;
+  precond->isPreconditioner = true;
+}
+
+template <class T>
+void IterativeSolver<T>::ApplyPreconditioner(IdefixArray3D<real> &in, IdefixArray3D<real> &out) {
+  IDEFIX_ERROR("IterativeSolver:: This solver cannot be used as a preconditioner");
+}
+
 template <class T>
 real IterativeSolver<T>::GetError() {
   return(currentError);
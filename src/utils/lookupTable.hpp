@@ -8,6 +8,7 @@
 #ifndef UTILS_LOOKUPTABLE_HPP_
 #define UTILS_LOOKUPTABLE_HPP_
 
+#include <array>
 #include <string>
 #include <vector>
 #include "idefix.hpp"
@@ -49,54 +50,61 @@ class LookupTable {
     real delta[kDim];
 
     for(int n = 0 ; n < kDim ; n++) {
-      real xstart = xin(offset(n));
-      real xend = xin(offset(n)+dimensions(n)-1);
+      // Bounds and spacing of the axis were computed once and for all by InitAxes
+      const int np = axisSize[n];
+      const int off = axisOffset[n];
       real x_n = x[n];
 
       if(std::isnan(x_n)) return(NAN);
 
-      // Compute index of closest element assuming even distribution
       int i;
 
        // Check that we're within bounds
-      if(x_n < xstart) {
+      if(x_n < axisStart[n]) {
         if(errorIfOutOfBound) {
           Kokkos::abort("LookupTable:: ERROR! Attempt to interpolate below your lower bound.");
         } else {
-          x_n = xstart;
+          x_n = axisStart[n];
           i = 0;
         }
-      } else if( x_n > xend) {
+      } else if( x_n > axisEnd[n]) {
         if(errorIfOutOfBound) {
           Kokkos::abort("LookupTable:: ERROR! Attempt to interpolate above your upper bound.");
         } else {
           // We set x_n=xend, and we do the interpolation between xin(dim-2) and xin(dim-1),
           // so i= dim-2
-          i = dimensions(n)-2;
-          x_n = xend;
+          i = np-2;
+          x_n = axisEnd[n];
         }
+      } else if(axisType[n] == Arbitrary) {
+        // Dichotomy: the iterations only depend on the size of the axis
+        int lo = 0;
+        int hi = np-1;
+        while(hi - lo > 1) {
+          const int mid = (lo + hi) / 2;
+          const bool right = xin(off + mid) <= x_n;
+          lo = right ? mid : lo;
+          hi = right ? hi : mid;
+        }
+        i = lo;
       } else {
-        // Bounds are fine,
-        i = static_cast<int> ( (x_n - xstart) / (xend - xstart) * (dimensions(n)-1));
-        if(i == dimensions(n)-1) i = dimensions(n)-2;
-        // Check if resulting bounding elements are correct
-        if(xin(offset(n) + i) > x_n || xin(offset(n) + i+1) < x_n) {
-          // Nop, so the points are not evenly distributed
-          // Search for the correct index (a dicotomy would be more appropriate...)
-
-          i = 0;
-          while(xin(offset(n) + i) < x_n && i < dimensions(n)-1 ) {
-            i++;
-          }
-          i = i-1; // i is overestimated by one
+        // Index of the closest element from the (log-)uniform spacing of the axis
+        if(axisType[n] == Uniform) {
+          i = static_cast<int>((x_n - axisStart[n]) * axisScale[n]);
+        } else {
+          i = static_cast<int>((std::log(x_n) - axisLogStart[n]) * axisScale[n]);
         }
+        i = (i < 0) ? 0 : ((i > np-2) ? np-2 : i);
+        // Correct the rounding errors close to the points of the axis
+        if(xin(off + i) > x_n && i > 0) i--;
+        if(xin(off + i+1) < x_n && i < np-2) i++;
       }
 
       // Store the index
       idx[n] = i;
 
       // Store the elementary ratio
-      delta[n] = (x_n - xin(offset(n) + i) ) / (xin(offset(n) + i+1) - xin(offset(n) + i));
+      delta[n] = (x_n - xin(off + i) ) / (xin(off + i+1) - xin(off + i));
     }
 
     // De a linear interpolation from the neightbouring points to get our value.
@@ -107,7 +115,7 @@ class LookupTable {
       int index = 0;
       real weight = 1.0;
       for(unsigned int m = 0 ; m < kDim ; m++) {
-        index = index * dimensions(m);
+        index = index * axisSize[m];
         unsigned int myBit = 1 << m;
         // If bit is set, we're doing the right vertex, otherwise we're doing the left vertex
         if((n & myBit) > 0) {
@@ -137,8 +145,105 @@ class LookupTable {
   real GetHost(const real x[kDim]) const {
     return(Get(x, dimensionsHost, offsetHost, xinHost, dataHost));
   }
+
+  // Fill out(k,j,i) with the table interpolated at (x[0](k,j,i),...,x[kDim-1](k,j,i)),
+  // in a single kernel
+  void Evaluate(const std::array<IdefixArray3D<real>,kDim> &x, IdefixArray3D<real> out) const {
+    idfx::pushRegion("LookupTable::Evaluate");
+    auto table = *this;
+    IdefixArray3D<real> xArr[kDim];
+    for(int n = 0 ; n < kDim ; n++) xArr[n] = x[n];
+    idefix_for("LookupTable_Evaluate",0,out.extent(0),0,out.extent(1),0,out.extent(2),
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        real xq[kDim];
+        for(int n = 0 ; n < kDim ; n++) xq[n] = xArr[n](k,j,i);
+        out(k,j,i) = table.Get(xq);
+      });
+    idfx::popRegion();
+  }
+
+  // Fill out(k,j,i) with the table interpolated at the coordinates computed on the fly by
+  // coordinates(k,j,i,xq), a KOKKOS_LAMBDA filling the array xq[kDim] (e.g. from Vc)
+  template<typename Function>
+  void Evaluate(Function coordinates, IdefixArray3D<real> out) const {
+    idfx::pushRegion("LookupTable::Evaluate");
+    auto table = *this;
+    idefix_for("LookupTable_Evaluate",0,out.extent(0),0,out.extent(1),0,out.extent(2),
+      KOKKOS_LAMBDA (int k, int j, int i) {
+        real xq[kDim];
+        coordinates(k,j,i,xq);
+        out(k,j,i) = table.Get(xq);
+      });
+    idfx::popRegion();
+  }
+
+ private:
+  // Spacing of the points of an axis, which sets how the interval of x is found
+  enum AxisType {Uniform, LogUniform, Arbitrary};
+
+  void InitAxes();            // Classify the axes, once the coordinates are on the host
+
+  int axisType[kDim];
+  int axisSize[kDim];         // # of points of each axis
+  int axisOffset[kDim];       // offset of each axis in xin
+  real axisStart[kDim];
+  real axisEnd[kDim];
+  real axisLogStart[kDim];    // log(axisStart) (LogUniform axes)
+  real axisScale[kDim];       // 1/dx (Uniform axes) or 1/dlog(x) (LogUniform axes)
 };
 
+// Axes are uniform (resp. log-uniform) when their points (resp. the log of their points) lie
+// within a small fraction of the spacing from a uniform distribution. The index computed from
+// the spacing is then at most one point away from the right one, which Get corrects.
+template <int kDim>
+void LookupTable<kDim>::InitAxes() {
+  const real tolerance = 1e-3;
+  for(int n = 0 ; n < kDim ; n++) {
+    const int np = dimensionsHost(n);
+    const int off = offsetHost(n);
+    if(np < 2) {
+      IDEFIX_ERROR("LookupTable: each axis of the table should have at least 2 points");
+    }
+    for(int i = 0 ; i < np-1 ; i++) {
+      if(xinHost(off+i+1) <= xinHost(off+i)) {
+        std::stringstream msg;
+        msg << "LookupTable: the coordinates of axis " << n
+            << " should be strictly increasing" << std::endl;
+        IDEFIX_ERROR(msg);
+      }
+    }
+    const real xstart = xinHost(off);
+    const real xend = xinHost(off+np-1);
+    axisSize[n] = np;
+    axisOffset[n] = off;
+    axisStart[n] = xstart;
+    axisEnd[n] = xend;
+    axisLogStart[n] = (xstart > 0) ? std::log(xstart) : 0;
+
+    bool uniform = true;
+    bool logUniform = xstart > 0;
+    const real dx = (xend - xstart) / (np-1);
+    const real dlog = logUniform ? (std::log(xend) - axisLogStart[n]) / (np-1) : 0;
+    for(int i = 0 ; i < np ; i++) {
+      const real x = xinHost(off+i);
+      if(std::fabs(x - (xstart + i*dx)) > tolerance*dx) uniform = false;
+      if(logUniform && std::fabs(std::log(x) - (axisLogStart[n] + i*dlog)) > tolerance*dlog) {
+        logUniform = false;
+      }
+    }
+    if(uniform) {
+      axisType[n] = Uniform;
+      axisScale[n] = ONE_F/dx;
+    } else if(logUniform) {
+      axisType[n] = LogUniform;
+      axisScale[n] = ONE_F/dlog;
+    } else {
+      axisType[n] = Arbitrary;
+      axisScale[n] = 0;
+    }
+  }
+}
+
 template <int kDim>
 LookupTable<kDim>::LookupTable(std::vector<std::string> filenames,
                                std::string dataSet,
@@ -233,6 +338,8 @@ LookupTable<kDim>::LookupTable(std::vector<std::string> filenames,
     }
   }
 
+  InitAxes();
+
   // Copy to target
   Kokkos::deep_copy(this->xinDev ,xinHost);
   Kokkos::deep_copy(this->dimensionsDev, dimensionsHost);
@@ -398,6 +505,8 @@ LookupTable<kDim>::LookupTable(std::string filename, char delimiter, bool errOOB
     MPI_Bcast(dataHost.data(),dataHost.extent(0), realMPI, 0, MPI_COMM_WORLD);
   #endif
 
+  InitAxes();
+
   // Copy to target
   Kokkos::deep_copy(this->xinDev ,xinHost);
   Kokkos::deep_copy(this->dimensionsDev, dimensionsHost);
@@ -504,6 +613,8 @@ LookupTable<kDim>::LookupTable(Kokkos::View<T, Args...> array,
     }
   }
 
+  InitAxes();
+
   // Copy to target
   Kokkos::deep_copy(this->xinDev ,xinHost);
   Kokkos::deep_copy(this->dimensionsDev, dimensionsHost);
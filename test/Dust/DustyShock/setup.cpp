@@ -15,7 +15,7 @@ void MyDrag(DataBlock *data, int n, real beta, IdefixArray3D<real> &gamma) {
 }
 
 
-void ApplyBoundary(DataBlock *data, IdefixArray4D<real> Vc, int dir, BoundarySide side) {
+void ApplyBoundary(DataBlock *data, IdefixArray4D<realStore> Vc, int dir, BoundarySide side) {
   if(dir==IDIR) {
     int iref,ibeg,iend;
     if(side == left) {
@@ -25,6 +25,12 @@ def testMe(test):
     test.standardTest()
     test.nonRegressionTest(filename=name,tolerance=1e-14)
 
+  # The fused dust species should give results identical to the separate species
+  for ini in inifiles:
+    test.run(inputFile=ini.replace("idefix","idefix-fused"))
+    test.inifile=ini
+    test.nonRegressionTest(filename=name,tolerance=1e-14)
+
 
 test=tst.idfxTest()
 
@@ -56,7 +56,7 @@ void MyDrag(DataBlock *data, int nSpecie, real beta, IdefixArray3D<real> &gamma)
 
 // User-defined boundaries
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   auto *data = hydro->data;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x3 = data->x[KDIR];
@@ -98,7 +98,7 @@ void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
 }
 
 void UserdefBoundaryDust(Fluid<DustPhysics> *dust, int dir, BoundarySide side, real t) {
-  IdefixArray4D<real> Vc = dust->Vc;
+  IdefixArray4D<realStore> Vc = dust->Vc;
   auto data = dust->data;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x3 = data->x[KDIR];
@@ -24,7 +24,7 @@ void MySoundSpeed(DataBlock &data, const real t, IdefixArray3D<real> &cs) {
 }
 
 void MyViscosity(DataBlock &data, const real t, IdefixArray3D<real> &eta1, IdefixArray3D<real> &eta2) {
-  IdefixArray4D<real> Vc=data.hydro->Vc;
+  IdefixArray4D<realStore> Vc=data.hydro->Vc;
   IdefixArray1D<real> x1=data.x[IDIR];
   real h0 = h0Glob;
   real alpha = alphaGlob;
@@ -40,7 +40,7 @@ void MyViscosity(DataBlock &data, const real t, IdefixArray3D<real> &eta1, Idefi
 
 // User-defined boundaries
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   auto *data = hydro->data;
   IdefixArray1D<real> x1 = data->x[IDIR];
   if(dir==IDIR) {
@@ -6,7 +6,7 @@ void UserdefBoundary(Hydro* hydro, int dir, BoundarySide side, const real t) {
     const real alpha = 60./180.*M_PI;
 
     if( (dir==IDIR) && (side == left)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         int ighost = hydro->data->nghost[IDIR];
         hydro->boundary->BoundaryFor("UserDefBoundaryX1Beg", dir, side,
                     KOKKOS_LAMBDA (int k, int j, int i) {
@@ -19,7 +19,7 @@ void UserdefBoundary(Hydro* hydro, int dir, BoundarySide side, const real t) {
     }
 
     if(dir==JDIR) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray1D<real> x1 = hydro->data->x[IDIR];
         IdefixArray1D<real> x2 = hydro->data->x[JDIR];
         if(side == left) {
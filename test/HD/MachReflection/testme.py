@@ -22,6 +22,22 @@ def testMe(test):
     test.standardTest()
     test.nonRegressionTest(filename="dump.0001.dmp")
 
+  # The fused update should give results identical to the per-direction update
+  test.run(inputFile="idefix-hll-fused.ini")
+  test.inifile="idefix-hll.ini"
+  test.nonRegressionTest(filename="dump.0001.dmp",tolerance=1e-13)
+
+  # Splitting the domain in blocks should not change the results. The blocks split X2, which
+  # cannot be decomposed between the processes: with MPI, the domain is only decomposed along X1
+  if test.mpi:
+    dec=test.dec
+    test.dec=['4','1']
+  test.run(inputFile="idefix-hll-blocks.ini")
+  test.inifile="idefix-hll.ini"
+  test.nonRegressionTest(filename="dump.0001.dmp",tolerance=1e-13)
+  if test.mpi:
+    test.dec=dec
+
 
 test=tst.idfxTest()
 if not test.dec:
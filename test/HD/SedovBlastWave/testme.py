@@ -5,6 +5,7 @@
 @author: glesur
 """
 import os
+import shutil
 import sys
 sys.path.append(os.getenv("IDEFIX_DIR"))
 
@@ -29,6 +30,20 @@ else:
   test.compile()
   test.run(inputFile="idefix.ini")
   test.standardTest()
+  shutil.copy(name,"dump.nooverlap.dmp")
+
+  # Overlap of MPI exchanges with the computation
+  test.run(inputFile="idefix-overlap.ini")
+  with open("idefix.0.log","r") as log:
+    assert "MPI exchanges overlapped with computation ENABLED" in log.read(), \
+           "The overlapped MPI exchanges were not used"
+  test.standardTest()
+  # The overlapped update should reproduce the standard one
+  test.compareDump("dump.nooverlap.dmp",name)
+
+  # Uneven decomposition balanced with a cost model
+  test.run(inputFile="idefix-cost.ini")
+  test.standardTest()
 
   #Spherical validation
   test.configure(definitionFile="definitions-spherical.hpp")
@@ -27,7 +27,7 @@ void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     auto *data = hydro->data;
 
     if( (dir==IDIR) && (side == left)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray1D<real> x1 = data->x[IDIR];
         IdefixArray1D<real> x2 = data->x[JDIR];
 
@@ -50,7 +50,7 @@ void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     }
 
     if( dir==JDIR) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         int jghost;
         int jbeg,jend;
         if(side == left) {
@@ -22,7 +22,7 @@ void MySoundSpeed(DataBlock &data, const real t, IdefixArray3D<real> &cs) {
 }
 
 void MyViscosity(DataBlock &data, const real t, IdefixArray3D<real> &eta1, IdefixArray3D<real> &eta2) {
-  IdefixArray4D<real> Vc=data.hydro->Vc;
+  IdefixArray4D<realStore> Vc=data.hydro->Vc;
   IdefixArray1D<real> r=data.x[IDIR];
   IdefixArray1D<real> th=data.x[JDIR];
   real epsilon = epsilonGlob;
@@ -49,7 +49,7 @@ void FargoVelocity(DataBlock &data, IdefixArray2D<real> &Vphi) {
 // User-defined boundaries
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x2 = data->x[JDIR];
   real epsilon=epsilonGlob;
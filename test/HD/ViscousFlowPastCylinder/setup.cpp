@@ -5,7 +5,7 @@
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, const real t) {
     auto *data = hydro->data;
     if(dir==IDIR) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray1D<real> th = data->x[JDIR];
         if(side==right) {
           int ighost = data->end[IDIR]-1;
@@ -1,3 +1,4 @@
+#include <limits>
 #include "idefix.hpp"
 #include "setup.hpp"
 
@@ -10,13 +11,36 @@ generators on different architectures.
 /*********************************************/
 
 
-// Default constructor
+// Global cell where a Nan is planted to test the Nan tracking (-1: none)
+int nanCellGlob = -1;
+real nanTimeGlob;
 
+// Plant a Nan in the density of the cell nanCellGlob, once t>=nanTimeGlob
+void PlantNan(Hydro *hydro, const real t, const real dt) {
+  if(t < nanTimeGlob) return;
+  auto *data = hydro->data;
+  // Local index of the cell
+  const int i0 = nanCellGlob - data->gbeg[IDIR] + data->nghost[IDIR] + data->beg[IDIR];
+  if(i0 < data->beg[IDIR] || i0 >= data->end[IDIR]) return;
+
+  IdefixArray4D<realStore> Uc = hydro->Uc;
+  const int j0 = data->beg[JDIR];
+  const int k0 = data->beg[KDIR];
+  const real nan = std::numeric_limits<real>::quiet_NaN();
+  idefix_for("PlantNan", 0, 1,
+              KOKKOS_LAMBDA (int n) {
+                Uc(RHO,k0,j0,i0) = nan;
+              });
+}
 
 // Initialisation routine. Can be used to allocate
 // Arrays or variables which are used later on
 Setup::Setup(Input &input, Grid &grid, DataBlock &data, Output &output) {
-
+  if(input.CheckEntry("Setup","nanCell")>=0) {
+    nanCellGlob = input.Get<int>("Setup","nanCell",0);
+    nanTimeGlob = input.Get<real>("Setup","nanTime",0);
+    data.hydro->EnrollUserSourceTerm(&PlantNan);
+  }
 }
 
 // This routine initialize the flow
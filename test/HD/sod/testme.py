@@ -12,6 +12,17 @@ import pytools.idfx_test as tst
 
 name="dump.0001.dmp"
 
+# Check that the Nans found by the tracking are reported in the planted cell
+def checkNanLocation(cell):
+  locations=[]
+  with open('./idefix.0.log','r') as file:
+    for line in file:
+      if "global (i,j,k) = (" in line:
+        locations.append(line.split("(")[-1].split(")")[0])
+  assert locations, "The planted Nan was not reported"
+  for loc in locations:
+    assert loc == "%d, 0, 0"%cell, "Nan reported in (%s), expected (%d, 0, 0)"%(loc,cell)
+
 def testMe(test):
   test.configure()
   test.compile()
@@ -27,6 +38,21 @@ def testMe(test):
     test.standardTest()
     test.nonRegressionTest(filename=name)
 
+  # The streamlined Runge-Kutta stages should not change the results
+  if test.reconstruction != 4:
+    test.run(inputFile="idefix-tvdlf-streamlined.ini")
+    test.inifile="idefix-tvdlf.ini"
+    test.nonRegressionTest(filename=name)
+
+    # The Nan tracking should not change the results either
+    test.run(inputFile="idefix-hllc-nantracking.ini")
+    test.inifile="idefix-hllc.ini"
+    test.nonRegressionTest(filename=name)
+
+    # A Nan planted in the flow should be caught and located
+    test.run(inputFile="idefix-nan.ini")
+    checkNanLocation(250)
+
 
 test=tst.idfxTest()
 
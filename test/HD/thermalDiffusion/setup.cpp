@@ -24,7 +24,7 @@ void Analysis(DataBlock & data) {
 }
 
 void InternalBoundary(Fluid<DefaultPhysics> * hydro, const real t) {
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   idefix_for("InternalBoundary",0,hydro->data->np_tot[KDIR],
                                 0,hydro->data->np_tot[JDIR],
                                 0,hydro->data->np_tot[IDIR],
@@ -16,7 +16,7 @@ static real cs;
 
 void AmbipolarFunction(DataBlock &data, real t, IdefixArray3D<real> &xAin ) {
     IdefixArray3D<real> xA = xAin;
-    IdefixArray4D<real> Vc = data.hydro->Vc;
+    IdefixArray4D<realStore> Vc = data.hydro->Vc;
     idefix_for("AmbipolarFunction",0,data.np_tot[KDIR],0,data.np_tot[JDIR],0,data.np_tot[IDIR],
     KOKKOS_LAMBDA (int k, int j, int i) {
         xA(k,j,i) = 2.0/Vc(RHO,k,j,i);
@@ -27,7 +27,7 @@ void AmbipolarFunction(DataBlock &data, real t, IdefixArray3D<real> &xAin ) {
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     auto *data = hydro->data;
     if( (dir==IDIR) && (side == left)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray4D<real> Vs = hydro->Vs;
 
         int ighost = data->nghost[IDIR];
@@ -53,7 +53,7 @@ void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
         });
     }
     if( (dir==IDIR) && (side == right)) {
-            IdefixArray4D<real> Vc = hydro->Vc;
+            IdefixArray4D<realStore> Vc = hydro->Vc;
             IdefixArray4D<real> Vs = hydro->Vs;
 
             int ighost = data->end[IDIR]-1;
@@ -44,7 +44,7 @@ void Ambipolar(DataBlock& data, real t, IdefixArray3D<real> &xAin) {
   IdefixArray3D<real> xA = xAin;
   IdefixArray1D<real> x1=data.x[IDIR];
   IdefixArray1D<real> x2=data.x[JDIR];
-  IdefixArray4D<real> Vc=data.hydro->Vc;
+  IdefixArray4D<realStore> Vc=data.hydro->Vc;
 
   real Hideal = HidealGlob;
   real epsilon = epsilonGlob;
@@ -84,7 +84,7 @@ void Resistivity(DataBlock& data, real t, IdefixArray3D<real> &etain) {
   IdefixArray3D<real> eta = etain;
   IdefixArray1D<real> x1=data.x[IDIR];
   IdefixArray1D<real> x2=data.x[JDIR];
-  IdefixArray4D<real> Vc=data.hydro->Vc;
+  IdefixArray4D<realStore> Vc=data.hydro->Vc;
 
   real epsilon = epsilonGlob;
 
@@ -97,8 +97,8 @@ void Resistivity(DataBlock& data, real t, IdefixArray3D<real> &etain) {
 
 void MySourceTerm(Hydro *hydro, const real t, const real dtin) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
-  IdefixArray4D<real> Uc = hydro->Uc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Uc = hydro->Uc;
   IdefixArray1D<real> x1=data->x[IDIR];
   IdefixArray1D<real> x2=data->x[JDIR];
   real epsilonTop = epsilonTopGlob;
@@ -168,7 +168,7 @@ void MySourceTerm(Hydro *hydro, const real t, const real dtin) {
 
 void InternalBoundary(Hydro *hydro, const real t) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   IdefixArray4D<real> Vs = hydro->Vs;
   IdefixArray1D<real> x1=data->x[IDIR];
   IdefixArray1D<real> x2=data->x[JDIR];
@@ -217,7 +217,7 @@ void InternalBoundary(Hydro *hydro, const real t) {
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     auto *data = hydro->data;
     if( (dir==IDIR) && (side == left)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray4D<real> Vs = hydro->Vs;
         IdefixArray1D<real> x1 = data->x[IDIR];
         IdefixArray1D<real> x2 = data->x[JDIR];
@@ -263,7 +263,7 @@ void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     }
 
     if( (dir==IDIR) && (side == right)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray4D<real> Vs = hydro->Vs;
         IdefixArray1D<real> x1 = data->x[IDIR];
         IdefixArray1D<real> x2 = data->x[JDIR];
@@ -335,7 +335,7 @@ void EmfBoundary(DataBlock& data, const real t) {
 }
 
 void FluxBoundary(DataBlock & data, int dir, BoundarySide side, const real t) {
-    IdefixArray4D<real> Flux = data.hydro->FluxRiemann;
+    IdefixArray4D<realStore> Flux = data.hydro->FluxRiemann;
     if( dir==IDIR && side == left) {
         int iref = data.beg[IDIR];
 
@@ -372,7 +372,7 @@ void ComputeUserVars(DataBlock & data, UserDefVariablesContainer &variables) {
 
   IdefixHostArray1D<real> x1=d.x[IDIR];
   IdefixHostArray1D<real> x2=d.x[JDIR];
-  IdefixHostArray4D<real> Vc=d.Vc;
+  IdefixHostArray4D<realStore> Vc=d.Vc;
   IdefixArray3D<real>::HostMirror scrhHost = Kokkos::create_mirror_view(scrh);
   Kokkos::deep_copy(scrhHost,scrh);
 
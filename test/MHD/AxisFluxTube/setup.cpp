@@ -42,7 +42,7 @@ void ComputeUserVars(DataBlock & data, UserDefVariablesContainer &variables) {
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     auto *data = hydro->data;
     if( (dir==IDIR) && (side == right)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         IdefixArray4D<real> Vs = hydro->Vs;
         IdefixArray1D<real> x1Arr = data->x[IDIR];
         IdefixArray1D<real> x2Arr = data->x[JDIR];
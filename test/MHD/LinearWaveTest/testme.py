@@ -23,6 +23,10 @@ def testMe(test):
     test.standardTest()
     test.nonRegressionTest(filename="dump.0001.dmp",tolerance=mytol)
 
+  # low-storage SSPRK(10,4) integrator: checked against the analytical solution only
+  test.run(inputFile="idefix-fast-ssprk.ini")
+  test.standardTest()
+
 
 test=tst.idfxTest()
 if not test.dec:
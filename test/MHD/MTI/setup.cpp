@@ -40,7 +40,7 @@ void Potential(DataBlock& data, const real t, IdefixArray1D<real>& x1, IdefixArr
 
 
 void MyBragThermalConductivity(DataBlock &data, const real t, std::vector<IdefixArray3D<real>> &userdefArr) {
-  IdefixArray4D<real> Vc = data.hydro->Vc;
+  IdefixArray4D<realStore> Vc = data.hydro->Vc;
   IdefixArray1D<real> x2 = data.x[JDIR];
 
   IdefixArray3D<real> kparArr = userdefArr.at(0);
@@ -59,7 +59,7 @@ void MyViscosity(DataBlock &data, const real t, IdefixArray3D<real> &etaBrag) {
   IdefixArray1D<real> x2 = data.x[JDIR];
   real ksi = ksiGlob;
   real pr = prGlob;
-  IdefixArray4D<real> Vc = data.hydro->Vc;
+  IdefixArray4D<realStore> Vc = data.hydro->Vc;
   idefix_for("MyViscosity",0,data.np_tot[KDIR],0,data.np_tot[JDIR],0,data.np_tot[IDIR],
               KOKKOS_LAMBDA (int k, int j, int i) {
                 etaBrag(k,j,i) = ksi*pr*Vc(RHO,k,j,i);
@@ -74,7 +74,7 @@ void UserDefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
   real g0 = 1.;
   real rho0 = 1.; //initial density
   real P0 = rho0*T0; //initial pressure
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   IdefixArray4D<real> Vs = hydro->Vs;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x2 = data->x[JDIR];
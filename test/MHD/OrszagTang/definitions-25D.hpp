@@ -0,0 +1,4 @@
+#define     COMPONENTS      3
+#define     DIMENSIONS      2
+
+#define     GEOMETRY        CARTESIAN
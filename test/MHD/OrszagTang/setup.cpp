@@ -40,6 +40,11 @@ void Setup::InitFlow(DataBlock &data) {
                 d.Vc(PRS,k,j,i) = 5.0/(12.0*M_PI);
                 d.Vc(VX1,k,j,i) = -sin(2.0*M_PI*y);
                 d.Vc(VX2,k,j,i) = sin(2.0*M_PI*x);
+                #if COMPONENTS == 3
+                  // 2.5D variant: out-of-plane velocity and field
+                  d.Vc(VX3,k,j,i) = 0.5*sin(2.0*M_PI*(x+y));
+                  d.Vc(BX3,k,j,i) = 0.5*B0*cos(2.0*M_PI*(x-y));
+                #endif
                 #ifdef EVOLVE_VECTOR_POTENTIAL
                   x=d.xl[IDIR](i);
                   y=d.xl[JDIR](j);
@@ -5,11 +5,26 @@
 @author: glesur
 """
 import os
+import shutil
 import sys
 sys.path.append(os.getenv("IDEFIX_DIR"))
 
+import numpy as np
 import pytools.idfx_test as tst
+from pytools.dump_io import readDump
 tolerance=1e-12
+
+# Total mass and energy of a dump of the (uniform, periodic) 2D Orszag-Tang domain
+def totals(filename, gamma=5.0/3.0):
+  V=readDump(filename)
+  rho=V.data["Vc-RHO"]
+  v2=V.data["Vc-VX1"]**2+V.data["Vc-VX2"]**2
+  # cell-centered field, which is used in the total energy
+  bx=0.5*(V.data["Vs-BX1s"][:-1,:,:]+V.data["Vs-BX1s"][1:,:,:])
+  by=0.5*(V.data["Vs-BX2s"][:,:-1,:]+V.data["Vs-BX2s"][:,1:,:])
+  energy=V.data["Vc-PRS"]/(gamma-1.0)+0.5*rho*v2+0.5*(bx**2+by**2)
+  return np.sum(rho,dtype=np.float64), np.sum(energy,dtype=np.float64)
+
 def testMe(test):
   test.configure()
   test.compile()
@@ -32,6 +47,53 @@ def testMe(test):
 
     test.nonRegressionTest(filename="dump.0001.dmp",tolerance=mytol)
 
+  # Caching the face states should not change the results
+  test.run(inputFile="idefix-hlld-cache.ini")
+  test.inifile="idefix-hlld.ini"
+  test.nonRegressionTest(filename="dump.0001.dmp",tolerance=mytol)
+
+  # Restart from the last dump on a finer grid (vector potentials cannot be remapped). The remap
+  # conserves the volume integral of the density, and so does the evolution of the periodic
+  # domain: the mean density should be that of the coarse dump. The remapped field should also
+  # be divergence free.
+  if not test.vectPot:
+    test.run(inputFile="idefix-remap.ini", restart=1, remap=True)
+    V=readDump("dump.0002.dmp")
+    rho0=np.mean(readDump("dump.0001.dmp").data["Vc-RHO"],dtype=np.float64)
+    rho1=np.mean(V.data["Vc-RHO"],dtype=np.float64)
+    contol = 1e-5 if (test.single or test.mixed) else tolerance
+    assert abs(rho1-rho0) <= contol*abs(rho0), "Mass not conserved by the remap (%e)"%(rho1/rho0-1)
+    bx=V.data["Vs-BX1s"].astype(np.float64)
+    by=V.data["Vs-BX2s"].astype(np.float64)
+    nx,ny=V.data["Vc-RHO"].shape[0:2]
+    divB=(bx[1:,:,:]-bx[:-1,:,:])*nx+(by[:,1:,:]-by[:,:-1,:])*ny
+    bmax=max(np.max(np.abs(bx)),np.max(np.abs(by)))
+    assert np.max(np.abs(divB)) <= 10*contol*bmax*max(nx,ny), \
+           "Remapped field is not divergence free (%e)"%np.max(np.abs(divB))
+    print("Mass conserved and divergence-free field with the remap")
+
+  # Static mesh refinement of the center of the domain (the run fails if the prolongation or
+  # the flux correction create magnetic monopoles). The refluxing should conserve the total mass
+  # and energy of the periodic domain up to round-off errors.
+  if not test.vectPot:
+    test.run(inputFile="idefix-refine.ini")
+    mass0, energy0 = totals("dump.0000.dmp")
+    mass1, energy1 = totals("dump.0001.dmp")
+    contol = 1e-5 if (test.single or test.mixed) else tolerance
+    assert abs(mass1-mass0) <= contol*abs(mass0), "Mass not conserved (%e)"%(mass1/mass0-1)
+    assert abs(energy1-energy0) <= contol*abs(energy0), \
+           "Energy not conserved (%e)"%(energy1/energy0-1)
+    print("Mass and energy conserved with the refinement")
+
+  # 2.5D variant: the streamlined Runge-Kutta stages should give the results of the standard
+  # stages, including for the out-of-plane field which is not face-centered
+  test.configure(definitionFile="definitions-25D.hpp")
+  test.compile()
+  test.run(inputFile="idefix-hlld.ini")
+  shutil.copy("dump.0001.dmp","dump.standard.dmp")
+  test.run(inputFile="idefix-hlld-streamlined.ini")
+  test.compareDump("dump.standard.dmp","dump.0001.dmp",tolerance=mytol)
+
 
 test=tst.idfxTest()
 if not test.dec:
@@ -7,7 +7,7 @@
 void Analysis(DataBlock & data) {
   double etot = 0;
   double etotGlob;
-  IdefixArray4D<real> Vc = data.hydro->Vc;
+  IdefixArray4D<realStore> Vc = data.hydro->Vc;
 
   idefix_reduce("Analysis", data.beg[KDIR],data.end[KDIR],
                 data.beg[JDIR],data.end[JDIR],
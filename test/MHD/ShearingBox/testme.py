@@ -28,7 +28,7 @@ def testMe(test):
 
 test=tst.idfxTest()
 if not test.dec:
-  test.dec=['2','1','2']
+  test.dec=['2','2','2']
 
 if not test.all:
   if(test.check):
@@ -14,7 +14,7 @@ const real kB{1.3807e-16};
 const real mp{1.6726e-24};
 
 void MyClessThermalConductivity(DataBlock &data, const real t, std::vector<IdefixArray3D<real>> &userdefArr) {
-  IdefixArray4D<real> Vc = data.hydro->Vc;
+  IdefixArray4D<realStore> Vc = data.hydro->Vc;
   IdefixArray1D<real> x1 = data.x[IDIR];
   IdefixArray1D<real> x2 = data.x[JDIR];
 
@@ -41,7 +41,7 @@ void UserDefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
   DataBlock *data = hydro->data;
 
   if( (dir==IDIR) && (side == left)) {
-    IdefixArray4D<real> Vc = hydro->Vc;
+    IdefixArray4D<realStore> Vc = hydro->Vc;
     IdefixArray4D<real> Vs = hydro->Vs;
     IdefixArray1D<real> x1 = data->x[IDIR];
 
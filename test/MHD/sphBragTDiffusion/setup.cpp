@@ -5,7 +5,7 @@
 real amplitude;
 void InternalBoundary(Hydro *hydro, const real t) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = data->hydro->Vc;
+  IdefixArray4D<realStore> Vc = data->hydro->Vc;
   idefix_for("InternalBoundary",0,data->np_tot[KDIR],0,data->np_tot[JDIR],0,data->np_tot[IDIR],
               KOKKOS_LAMBDA (int k, int j, int i) {
                 // Cancel any motion that could be happening
@@ -18,7 +18,7 @@ void InternalBoundary(Hydro *hydro, const real t) {
 void UserDefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
   auto *data = hydro->data;
   real B0 = 0.01;
-  IdefixArray4D<real> Vc = data->hydro->Vc;
+  IdefixArray4D<realStore> Vc = data->hydro->Vc;
   IdefixArray4D<real> Vs = data->hydro->Vs;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x2 = data->x[JDIR];
@@ -129,9 +129,10 @@ void BragViscosity::EnrollBragViscousDiffusivity(DiffusivityFunc myFunc) {
 // (this avoids an extra array)
 // Associated source terms, present in non-cartesian geometry are also computed
 // and stored in this->viscSrc for later use (in calcRhs).
-void BragViscosity::AddBragViscousFlux(int dir, const real t, const IdefixArray4D<real> &Flux) {
+void BragViscosity::AddBragViscousFlux(int dir, const real t,
+                                       const IdefixArray4D<realStore> &Flux) {
   idfx::pushRegion("BragViscosity::AddBragViscousFlux");
-  IdefixArray4D<real> Vc = this->Vc;
+  IdefixArray4D<realStore> Vc = this->Vc;
   IdefixArray4D<real> Vs = this->Vs;
   IdefixArray4D<real> bragViscSrc = this->bragViscSrc;
   IdefixArray3D<real> dMax = this->dMax;
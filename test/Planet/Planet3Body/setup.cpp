@@ -29,8 +29,8 @@ void MySoundSpeed(DataBlock &data, const real t, IdefixArray3D<real> &cs) {
 
 void Damping(Hydro *hydro, const real t, const real dtin) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
-  IdefixArray4D<real> Uc = hydro->Uc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Uc = hydro->Uc;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x2 = data->x[JDIR];
 
@@ -120,7 +120,7 @@ void Damping(Hydro *hydro, const real t, const real dtin) {
 // User-defined boundaries
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   IdefixArray1D<real> x1 = data->x[IDIR];
   real sigmaSlope=sigmaSlopeGlob;
   real omega = omegaGlob;
@@ -30,7 +30,7 @@ void MySoundSpeed(DataBlock &data, const real t, IdefixArray3D<real> &cs) {
 
 
 void MyViscosity(DataBlock &data, const real t, IdefixArray3D<real> &eta1, IdefixArray3D<real> &eta2) {
-  IdefixArray4D<real> Vc=data.hydro->Vc;
+  IdefixArray4D<realStore> Vc=data.hydro->Vc;
   IdefixArray1D<real> x1=data.x[IDIR];
   real h0 = h0Glob;
   real flaringIndex = flaringIndexGlob;
@@ -47,8 +47,8 @@ void MyViscosity(DataBlock &data, const real t, IdefixArray3D<real> &eta1, Idefi
 
 void Damping(Hydro *hydro, const real t, const real dtin) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
-  IdefixArray4D<real> Uc = hydro->Uc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Uc = hydro->Uc;
   IdefixArray1D<real> x1 = data->x[IDIR];
   IdefixArray1D<real> x2 = data->x[JDIR];
 
@@ -138,7 +138,7 @@ void Damping(Hydro *hydro, const real t, const real dtin) {
 // User-defined boundaries
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
   auto *data = hydro->data;
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   IdefixArray1D<real> x1 = data->x[IDIR];
   real sigmaSlope=sigmaSlopeGlob;
   real omega = omegaGlob;
@@ -18,7 +18,7 @@ tolerance=1e-12
 def testMe(test):
   test.configure()
   test.compile()
-  inifiles=["idefix.ini","idefix-cg.ini"]
+  inifiles=["idefix.ini","idefix-cg.ini","idefix-adaptive.ini"]
 
   # loop on all the ini files for this test
   for ini in inifiles:
@@ -13,7 +13,7 @@ import pytools.idfx_test as tst
 def testMe(test):
   test.configure()
   test.compile()
-  inifiles=["idefix.ini","idefix-cg.ini","idefix-minres.ini"]
+  inifiles=["idefix.ini","idefix-cg.ini","idefix-minres.ini","idefix-mgbicgstab.ini"]
 
   # loop on all the ini files for this test
   for ini in inifiles:
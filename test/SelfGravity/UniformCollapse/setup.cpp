@@ -41,7 +41,7 @@ void ComputeUserVars(DataBlock & data, UserDefVariablesContainer &variables) {
 void UserdefBoundary(Hydro *hydro, int dir, BoundarySide side, real t) {
     auto *data = hydro->data;
     if((dir==IDIR) && (side == left)) {
-        IdefixArray4D<real> Vc = hydro->Vc;
+        IdefixArray4D<realStore> Vc = hydro->Vc;
         int ighost = data->nghost[IDIR];
         IdefixArray1D<real> r = data->x[IDIR];
 
@@ -65,7 +65,7 @@ void FluxBoundary(Fluid<DefaultPhysics> *hydro, int dir, BoundarySide side, cons
     if((dir==IDIR) && (side == left)) {
       // Loading needed data
       DataBlock &data = *hydro->data;
-      IdefixArray4D<real> Flux = hydro->FluxRiemann;
+      IdefixArray4D<realStore> Flux = hydro->FluxRiemann;
       real halfDt = data.dt/2.; // RK2, dt is actually half at each flux calculation
       int iref = data.nghost[IDIR];
       real rin = data.xbeg[IDIR];
@@ -124,7 +124,7 @@ void Setup::InitFlow(DataBlock &data) {
     DataBlockHost d(data);
 
     // Grid and block parameters
-    IdefixHostArray4D<real> Vc = d.Vc;
+    IdefixHostArray4D<realStore> Vc = d.Vc;
     IdefixHostArray1D<real> r = d.x[IDIR];
     real Rcloud = RcloudGlob;
 
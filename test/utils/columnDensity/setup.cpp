@@ -9,6 +9,7 @@ Column *columnX2Left;
 Column *columnX2Right;
 Column *columnX3Left;
 Column *columnX3Right;
+Column *columnX1Batch;
 
 // Analyse data to check that column density works as expected
 void Analysis(DataBlock & data) {
@@ -19,6 +20,9 @@ void Analysis(DataBlock & data) {
   columnX1Left->ComputeColumn(data.hydro->Vc,RHO);
   columnX1Right->ComputeColumn(data.hydro->Vc,RHO);
 
+  // Try the batched interface (RHO and PRS are both 1 in this setup)
+  Column::ComputeColumns({columnX1Batch}, data.hydro->Vc, {RHO, PRS});
+
   // Try the 3D array interface
   IdefixArray3D<real> rho("rho",data.np_tot[KDIR],data.np_tot[JDIR],data.np_tot[IDIR]);
   auto Vc = data.hydro->Vc;
@@ -59,6 +63,20 @@ void Analysis(DataBlock & data) {
       }
     }
   }
+  // Batched columns, integrated from the right
+  for(int n = 0 ; n < 2 ; n++) {
+    columnDensityRight = columnX1Batch->GetColumn(n);
+    columnDensityRightHost = Kokkos::create_mirror_view(columnDensityRight);
+    Kokkos::deep_copy(columnDensityRightHost,columnDensityRight);
+    for(int k = data.beg[KDIR]; k < data.end[KDIR] ; k++) {
+      for(int j = data.beg[JDIR]; j < data.end[JDIR] ; j++) {
+        for(int i = data.beg[IDIR]; i < data.end[IDIR] ; i++) {
+          real err = std::fabs(columnDensityRightHost(k,j,i)-(1-d.xl[IDIR](i)));
+          if(err>errMax) errMax=err;
+        }
+      }
+    }
+  }
   idfx::cout << "Error on column density in IDIR=" << std::scientific << errMax << std::endl;
   if(errMax>1e-14) {
     IDEFIX_ERROR("Error above tolerance");
@@ -115,7 +133,7 @@ void Analysis(DataBlock & data) {
 }
 
 void InternalBoundary(Fluid<DefaultPhysics> * hydro, const real t) {
-  IdefixArray4D<real> Vc = hydro->Vc;
+  IdefixArray4D<realStore> Vc = hydro->Vc;
   idefix_for("InternalBoundary",0,hydro->data->np_tot[KDIR],
                                 0,hydro->data->np_tot[JDIR],
                                 0,hydro->data->np_tot[IDIR],
@@ -140,6 +158,7 @@ Setup::Setup(Input &input, Grid &grid, DataBlock &data, Output &output) {
   columnX2Right = new Column(JDIR, -1, &data);
   columnX3Left = new Column(KDIR, 1, &data);
   columnX3Right = new Column(KDIR, -1, &data);
+  columnX1Batch = new Column(IDIR, -1, &data, 2);
   // Initialise the output file
 }
 
@@ -152,6 +152,54 @@ int main( int argc, char* argv[] )
       exit(1);
     }
     idfx::cout << "Success" << std::endl;
+
+    idfx::cout << "--------------------------------------" << std::endl;
+    idfx::cout << "Testing batched evaluation of log-uniform and arbitrary axes." << std::endl;
+    // x is log-uniform, y is arbitrary. Tabulate f=2x+3y, which is exactly interpolated.
+    const int nx = 50;
+    const int ny = 20;
+    IdefixHostArray1D<real> xTab("xTab",nx);
+    IdefixHostArray1D<real> yTab("yTab",ny);
+    IdefixHostArray2D<real> fTab("fTab",ny,nx);
+    for(int i = 0 ; i < nx ; i++) xTab(i) = std::pow(10.0, 0.1*i);
+    for(int j = 0 ; j < ny ; j++) yTab(j) = j*j;
+    for(int j = 0 ; j < ny ; j++) {
+      for(int i = 0 ; i < nx ; i++) {
+        fTab(j,i) = 2*xTab(i) + 3*yTab(j);
+      }
+    }
+    LookupTable<2> table(fTab, {xTab, yTab});
+
+    const int nk = 4, nj = 5, ni = 6;
+    IdefixArray3D<real> xq("xq",nk,nj,ni);
+    IdefixArray3D<real> yq("yq",nk,nj,ni);
+    IdefixArray3D<real> fq("fq",nk,nj,ni);
+    idefix_for("coords",0,nk,0,nj,0,ni, KOKKOS_LAMBDA (int k, int j, int i) {
+      xq(k,j,i) = std::pow(10.0, 0.037*(k*nj*ni + j*ni + i));
+      yq(k,j,i) = 2.9*(k*nj*ni + j*ni + i);
+    });
+    table.Evaluate({xq, yq}, fq);
+
+    auto xqHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), xq);
+    auto yqHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), yq);
+    auto fqHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), fq);
+    real errMax = 0;
+    for(int k = 0 ; k < nk ; k++) {
+      for(int j = 0 ; j < nj ; j++) {
+        for(int i = 0 ; i < ni ; i++) {
+          const real expected = 2*xqHost(k,j,i) + 3*yqHost(k,j,i);
+          errMax = std::fmax(errMax, std::fabs(fqHost(k,j,i) - expected)/expected);
+        }
+      }
+    }
+    idfx::cout << "error=" << errMax << std::endl;
+    if(errMax>1e-13) {
+      idfx::cerr << std::scientific;
+      idfx::cerr << "ERROR!!" << std::endl;
+      idfx::cerr << errMax;
+      exit(1);
+    }
+    idfx::cout << "Success" << std::endl;
     idfx::cout << "--------------------------------------" << std::endl;
     idfx::cout << "Done." << std::endl;
 